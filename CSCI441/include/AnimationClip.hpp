@@ -0,0 +1,439 @@
+/** @file AnimationClip.hpp
+ * @brief Quantized skeletal animation clip with cached frame decoding and batched interpolation
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Each joint of each keyframe is stored in 12 bytes: its position as three 16-bit
+ *	values within the joint's range over the clip, and its orientation with the
+ *	smallest three components as 15-bit values, the index of the dropped largest
+ *	component held in the two remaining bits.
+ *
+ *	Decoded frames are kept in a small cache so instances sampling the same clip
+ *	near the same time decode each keyframe once.  Poses are stored as structure of
+ *	arrays and interpolated four joints at a time with SSE, using a corrected nlerp
+ *	that stays within about a milliradian of slerp without any trigonometry.
+ *
+ *	@warning This header file depends upon glm
+ *	@warning sampling is not thread safe as it updates the decoded frame cache
+ */
+
+#ifndef CSCI441_ANIMATION_CLIP_HPP
+#define CSCI441_ANIMATION_CLIP_HPP
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CSCI441_ANIMATION_CLIP_SSE
+    #include <xmmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class AnimationClip
+     * @brief stores a skeletal animation as quantized keyframes
+     */
+    class [[maybe_unused]] AnimationClip final {
+    public:
+        /**
+         * @brief a skeleton pose stored as structure of arrays
+         * @note arrays are padded to a multiple of four joints
+         */
+        struct Pose {
+            /// number of joints in the pose
+            GLint numJoints = 0;
+            /// joint positions
+            std::vector<GLfloat> px, py, pz;
+            /// joint orientations
+            std::vector<GLfloat> qx, qy, qz, qw;
+
+            /**
+             * @brief sizes the pose for a number of joints, padding joints are identity
+             * @param joints number of joints
+             */
+            void resize( GLint joints );
+            /**
+             * @brief returns the position of a joint
+             */
+            [[nodiscard]] glm::vec3 position( GLint joint ) const { return { px[joint], py[joint], pz[joint] }; }
+            /**
+             * @brief returns the orientation of a joint
+             */
+            [[nodiscard]] glm::quat orientation( GLint joint ) const { return { qw[joint], qx[joint], qy[joint], qz[joint] }; }
+            /**
+             * @brief sets the position and orientation of a joint
+             */
+            void setJoint( GLint joint, const glm::vec3& position, const glm::quat& orientation );
+        };
+
+        /**
+         * @brief creates an empty clip
+         */
+        AnimationClip() = default;
+
+        /**
+         * @brief quantizes a sequence of skeleton frames into the clip
+         * @tparam Joint joint type with members glm::vec3 position and glm::quat orientation
+         * @param frames array of numFrames skeletons of numJoints joints each
+         * @param numFrames number of keyframes
+         * @param numJoints number of joints in each keyframe
+         * @param frameRate keyframes per second
+         */
+        template<typename Joint>
+        [[maybe_unused]] void quantize( const Joint* const* frames, GLint numFrames, GLint numJoints, GLint frameRate );
+
+        /**
+         * @brief copies previously quantized keyframes into the clip
+         * @param numFrames number of keyframes
+         * @param numJoints number of joints in each keyframe
+         * @param frameRate keyframes per second
+         * @param keyframes getKeyframeDataSize() bytes as returned by getKeyframeData() of the quantized clip
+         * @param positionMin numJoints entries as returned by getPositionMin()
+         * @param positionScale numJoints entries as returned by getPositionScale()
+         */
+        [[maybe_unused]] void setQuantized( GLint numFrames, GLint numJoints, GLint frameRate, const void* keyframes,
+                                            const glm::vec3* positionMin, const glm::vec3* positionScale );
+        /**
+         * @brief returns the quantized keyframes, getKeyframeDataSize() bytes
+         */
+        [[maybe_unused]] [[nodiscard]] const void* getKeyframeData() const { return _frames.data(); }
+        /**
+         * @brief returns the size of the quantized keyframes in bytes
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getKeyframeDataSize() const { return _frames.size() * sizeof(QuantizedJoint); }
+        /**
+         * @brief returns the minimum position of each joint over the clip
+         */
+        [[maybe_unused]] [[nodiscard]] const glm::vec3* getPositionMin() const { return _positionMin.data(); }
+        /**
+         * @brief returns the position quantization step of each joint
+         */
+        [[maybe_unused]] [[nodiscard]] const glm::vec3* getPositionScale() const { return _positionScale.data(); }
+
+        /**
+         * @brief returns the number of keyframes
+         */
+        [[maybe_unused]] [[nodiscard]] GLint getNumberOfFrames() const { return _numFrames; }
+        /**
+         * @brief returns the number of joints in each keyframe
+         */
+        [[maybe_unused]] [[nodiscard]] GLint getNumberOfJoints() const { return _numJoints; }
+        /**
+         * @brief returns the number of keyframes per second
+         */
+        [[maybe_unused]] [[nodiscard]] GLint getFrameRate() const { return _frameRate; }
+        /**
+         * @brief returns the length of the looping clip in seconds
+         */
+        [[maybe_unused]] [[nodiscard]] GLfloat getDuration() const { return _frameRate > 0 ? static_cast<GLfloat>(_numFrames) / static_cast<GLfloat>(_frameRate) : 0.0f; }
+        /**
+         * @brief returns the bytes used by the quantized keyframes and their ranges
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getMemorySize() const;
+
+        /**
+         * @brief interpolates between two keyframes
+         * @param frameA first keyframe
+         * @param frameB second keyframe
+         * @param interp interpolation amount from frameA to frameB in [0, 1]
+         * @param pose resulting pose, resized as needed
+         */
+        [[maybe_unused]] void sampleFrames( GLint frameA, GLint frameB, GLfloat interp, Pose& pose ) const;
+        /**
+         * @brief samples the looping clip at a time
+         * @param time seconds since the start of the clip
+         * @param pose resulting pose, resized as needed
+         */
+        [[maybe_unused]] void sample( GLfloat time, Pose& pose ) const;
+
+        /**
+         * @brief interpolates every joint of two poses
+         * @param poseA pose at weight 0
+         * @param poseB pose at weight 1
+         * @param weight amount of poseB in [0, 1]
+         * @param result resulting pose, may be poseA or poseB
+         */
+        [[maybe_unused]] static void blend( const Pose& poseA, const Pose& poseB, GLfloat weight, Pose& result );
+        /**
+         * @brief samples two clips of the same skeleton and blends the results
+         * @param clipA first clip
+         * @param timeA time within the first clip
+         * @param clipB second clip
+         * @param timeB time within the second clip
+         * @param weight amount of the second clip in [0, 1]
+         * @param pose resulting pose
+         */
+        [[maybe_unused]] static void sampleBlended( const AnimationClip& clipA, GLfloat timeA,
+                                                    const AnimationClip& clipB, GLfloat timeB,
+                                                    GLfloat weight, Pose& pose );
+
+    private:
+        struct QuantizedJoint {
+            GLushort position[3];
+            GLushort rotation[3];   // smallest three, top bits of [0] and [1] hold the largest index
+        };
+
+        static constexpr GLint CACHE_SIZE = 8;
+
+        GLint _numFrames = 0;
+        GLint _numJoints = 0;
+        GLint _frameRate = 0;
+        std::vector<QuantizedJoint> _frames;
+        std::vector<glm::vec3> _positionMin;
+        std::vector<glm::vec3> _positionScale;
+
+        // direct mapped by frame index
+        mutable GLint _cachedFrame[CACHE_SIZE] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+        mutable Pose _cachedPose[CACHE_SIZE];
+        // first frame of a blended pair, kept so its storage is reused between samples
+        mutable Pose _pairPose;
+
+        [[nodiscard]] const Pose& _decodedFrame( GLint frame ) const;
+        static QuantizedJoint _encode( const glm::vec3& position, const glm::quat& orientation, const glm::vec3& minimum, const glm::vec3& scale );
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+inline void CSCI441::AnimationClip::Pose::resize( const GLint joints ) {
+    numJoints = joints;
+    const auto padded = static_cast<size_t>( (joints + 3) & ~3 );
+    px.assign( padded, 0.0f ); py.assign( padded, 0.0f ); pz.assign( padded, 0.0f );
+    qx.assign( padded, 0.0f ); qy.assign( padded, 0.0f ); qz.assign( padded, 0.0f ); qw.assign( padded, 1.0f );
+}
+
+inline void CSCI441::AnimationClip::Pose::setJoint( const GLint joint, const glm::vec3& position, const glm::quat& orientation ) {
+    px[joint] = position.x; py[joint] = position.y; pz[joint] = position.z;
+    qx[joint] = orientation.x; qy[joint] = orientation.y; qz[joint] = orientation.z; qw[joint] = orientation.w;
+}
+
+template<typename Joint>
+[[maybe_unused]]
+inline void CSCI441::AnimationClip::quantize( const Joint* const* frames, const GLint numFrames, const GLint numJoints, const GLint frameRate ) {
+    _numFrames = numFrames;
+    _numJoints = numJoints;
+    _frameRate = frameRate;
+    std::fill( _cachedFrame, _cachedFrame + CACHE_SIZE, -1 );
+
+    // position range of each joint over the clip
+    _positionMin.assign( numJoints, glm::vec3( 0.0f ) );
+    _positionScale.assign( numJoints, glm::vec3( 0.0f ) );
+    for( GLint j = 0; j < numJoints; j++ ) {
+        glm::vec3 minimum = frames[0][j].position, maximum = frames[0][j].position;
+        for( GLint f = 1; f < numFrames; f++ ) {
+            minimum = glm::min( minimum, frames[f][j].position );
+            maximum = glm::max( maximum, frames[f][j].position );
+        }
+        _positionMin[j] = minimum;
+        _positionScale[j] = ( maximum - minimum ) / 65535.0f;
+    }
+
+    _frames.resize( static_cast<size_t>(numFrames) * numJoints );
+    for( GLint f = 0; f < numFrames; f++ ) {
+        for( GLint j = 0; j < numJoints; j++ ) {
+            _frames[ static_cast<size_t>(f) * numJoints + j ] = _encode( frames[f][j].position, frames[f][j].orientation, _positionMin[j], _positionScale[j] );
+        }
+    }
+}
+
+[[maybe_unused]]
+inline void CSCI441::AnimationClip::setQuantized( const GLint numFrames, const GLint numJoints, const GLint frameRate, const void* keyframes,
+                                                  const glm::vec3* positionMin, const glm::vec3* positionScale ) {
+    _numFrames = numFrames;
+    _numJoints = numJoints;
+    _frameRate = frameRate;
+    std::fill( _cachedFrame, _cachedFrame + CACHE_SIZE, -1 );
+
+    const auto* frames = static_cast<const QuantizedJoint*>( keyframes );
+    _frames.assign( frames, frames + static_cast<size_t>(numFrames) * numJoints );
+    _positionMin.assign( positionMin, positionMin + numJoints );
+    _positionScale.assign( positionScale, positionScale + numJoints );
+}
+
+[[maybe_unused]]
+inline size_t CSCI441::AnimationClip::getMemorySize() const {
+    return _frames.size() * sizeof(QuantizedJoint) + ( _positionMin.size() + _positionScale.size() ) * sizeof(glm::vec3);
+}
+
+[[maybe_unused]]
+inline void CSCI441::AnimationClip::sampleFrames( const GLint frameA, const GLint frameB, const GLfloat interp, Pose& pose ) const {
+    if( _numFrames == 0 ) return;
+    if( interp <= 0.0f || frameA == frameB ) {
+        pose = _decodedFrame( frameA );
+        return;
+    }
+    // frames CACHE_SIZE apart share a slot, so copy the first pose before decoding the second
+    _pairPose = _decodedFrame( frameA );
+    blend( _pairPose, _decodedFrame( frameB ), interp, pose );
+}
+
+[[maybe_unused]]
+inline void CSCI441::AnimationClip::sample( const GLfloat time, Pose& pose ) const {
+    if( _numFrames == 0 ) return;
+    GLfloat frame = std::fmod( time * static_cast<GLfloat>(_frameRate), static_cast<GLfloat>(_numFrames) );
+    if( frame < 0.0f ) frame += static_cast<GLfloat>(_numFrames);
+    const GLint frameA = std::min( static_cast<GLint>(frame), _numFrames - 1 );
+    sampleFrames( frameA, (frameA + 1) % _numFrames, frame - static_cast<GLfloat>(frameA), pose );
+}
+
+[[maybe_unused]]
+inline void CSCI441::AnimationClip::blend( const Pose& poseA, const Pose& poseB, const GLfloat weight, Pose& result ) {
+    if( result.numJoints != poseA.numJoints ) result.resize( poseA.numJoints );
+    const GLint n = static_cast<GLint>( poseA.px.size() );
+    GLint j = 0;
+
+#ifdef CSCI441_ANIMATION_CLIP_SSE
+    const __m128 t = _mm_set1_ps( weight );
+    const __m128 tHalf = _mm_set1_ps( weight - 0.5f );
+    const __m128 tCorrection = _mm_set1_ps( weight * (weight - 0.5f) * (weight - 1.0f) );
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 signBit = _mm_set1_ps( -0.0f );
+    for( ; j + 4 <= n; j += 4 ) {
+        // positions
+        __m128 a = _mm_loadu_ps( &poseA.px[j] );
+        _mm_storeu_ps( &result.px[j], _mm_add_ps( a, _mm_mul_ps( t, _mm_sub_ps( _mm_loadu_ps( &poseB.px[j] ), a ) ) ) );
+        a = _mm_loadu_ps( &poseA.py[j] );
+        _mm_storeu_ps( &result.py[j], _mm_add_ps( a, _mm_mul_ps( t, _mm_sub_ps( _mm_loadu_ps( &poseB.py[j] ), a ) ) ) );
+        a = _mm_loadu_ps( &poseA.pz[j] );
+        _mm_storeu_ps( &result.pz[j], _mm_add_ps( a, _mm_mul_ps( t, _mm_sub_ps( _mm_loadu_ps( &poseB.pz[j] ), a ) ) ) );
+
+        // orientations, flip b onto a's hemisphere
+        const __m128 ax = _mm_loadu_ps( &poseA.qx[j] ), ay = _mm_loadu_ps( &poseA.qy[j] ), az = _mm_loadu_ps( &poseA.qz[j] ), aw = _mm_loadu_ps( &poseA.qw[j] );
+        __m128 bx = _mm_loadu_ps( &poseB.qx[j] ), by = _mm_loadu_ps( &poseB.qy[j] ), bz = _mm_loadu_ps( &poseB.qz[j] ), bw = _mm_loadu_ps( &poseB.qw[j] );
+        const __m128 cosine = _mm_add_ps( _mm_add_ps( _mm_mul_ps( ax, bx ), _mm_mul_ps( ay, by ) ), _mm_add_ps( _mm_mul_ps( az, bz ), _mm_mul_ps( aw, bw ) ) );
+        const __m128 flip = _mm_and_ps( _mm_cmplt_ps( cosine, zero ), signBit );
+        bx = _mm_xor_ps( bx, flip ); by = _mm_xor_ps( by, flip ); bz = _mm_xor_ps( bz, flip ); bw = _mm_xor_ps( bw, flip );
+        const __m128 d = _mm_andnot_ps( signBit, cosine );
+
+        // corrected interpolation parameter, see the scalar loop below
+        const __m128 A = _mm_add_ps( _mm_set1_ps( 1.0904f ), _mm_mul_ps( d, _mm_add_ps( _mm_set1_ps( -3.2452f ), _mm_mul_ps( d, _mm_sub_ps( _mm_set1_ps( 3.55645f ), _mm_mul_ps( d, _mm_set1_ps( 1.43519f ) ) ) ) ) ) );
+        const __m128 B = _mm_add_ps( _mm_set1_ps( 0.848013f ), _mm_mul_ps( d, _mm_add_ps( _mm_set1_ps( -1.06021f ), _mm_mul_ps( d, _mm_set1_ps( 0.215638f ) ) ) ) );
+        const __m128 k = _mm_add_ps( _mm_mul_ps( A, _mm_mul_ps( tHalf, tHalf ) ), B );
+        const __m128 ot = _mm_add_ps( t, _mm_mul_ps( tCorrection, k ) );
+
+        __m128 x = _mm_add_ps( ax, _mm_mul_ps( ot, _mm_sub_ps( bx, ax ) ) );
+        __m128 y = _mm_add_ps( ay, _mm_mul_ps( ot, _mm_sub_ps( by, ay ) ) );
+        __m128 z = _mm_add_ps( az, _mm_mul_ps( ot, _mm_sub_ps( bz, az ) ) );
+        __m128 w = _mm_add_ps( aw, _mm_mul_ps( ot, _mm_sub_ps( bw, aw ) ) );
+        const __m128 length = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_add_ps( _mm_mul_ps( z, z ), _mm_mul_ps( w, w ) ) ) );
+        _mm_storeu_ps( &result.qx[j], _mm_div_ps( x, length ) );
+        _mm_storeu_ps( &result.qy[j], _mm_div_ps( y, length ) );
+        _mm_storeu_ps( &result.qz[j], _mm_div_ps( z, length ) );
+        _mm_storeu_ps( &result.qw[j], _mm_div_ps( w, length ) );
+    }
+#endif
+
+    // remaining joints, or all of them without SSE
+    for( ; j < n; j++ ) {
+        result.px[j] = poseA.px[j] + weight * ( poseB.px[j] - poseA.px[j] );
+        result.py[j] = poseA.py[j] + weight * ( poseB.py[j] - poseA.py[j] );
+        result.pz[j] = poseA.pz[j] + weight * ( poseB.pz[j] - poseA.pz[j] );
+
+        GLfloat bx = poseB.qx[j], by = poseB.qy[j], bz = poseB.qz[j], bw = poseB.qw[j];
+        const GLfloat cosine = poseA.qx[j] * bx + poseA.qy[j] * by + poseA.qz[j] * bz + poseA.qw[j] * bw;
+        if( cosine < 0.0f ) { bx = -bx; by = -by; bz = -bz; bw = -bw; }
+        const GLfloat d = std::fabs( cosine );
+
+        // nlerp with t corrected by a fit of slerp's angular velocity over the angle between the orientations
+        const GLfloat A = 1.0904f + d * ( -3.2452f + d * ( 3.55645f - d * 1.43519f ) );
+        const GLfloat B = 0.848013f + d * ( -1.06021f + d * 0.215638f );
+        const GLfloat k = A * ( weight - 0.5f ) * ( weight - 0.5f ) + B;
+        const GLfloat ot = weight + weight * ( weight - 0.5f ) * ( weight - 1.0f ) * k;
+
+        const GLfloat x = poseA.qx[j] + ot * ( bx - poseA.qx[j] );
+        const GLfloat y = poseA.qy[j] + ot * ( by - poseA.qy[j] );
+        const GLfloat z = poseA.qz[j] + ot * ( bz - poseA.qz[j] );
+        const GLfloat w = poseA.qw[j] + ot * ( bw - poseA.qw[j] );
+        const GLfloat length = std::sqrt( x * x + y * y + z * z + w * w );
+        result.qx[j] = x / length; result.qy[j] = y / length; result.qz[j] = z / length; result.qw[j] = w / length;
+    }
+}
+
+[[maybe_unused]]
+inline void CSCI441::AnimationClip::sampleBlended( const AnimationClip& clipA, const GLfloat timeA,
+                                                   const AnimationClip& clipB, const GLfloat timeB,
+                                                   const GLfloat weight, Pose& pose ) {
+    Pose poseB;
+    clipA.sample( timeA, pose );
+    clipB.sample( timeB, poseB );
+    blend( pose, poseB, weight, pose );
+}
+
+//**********************************************************************************
+// Internal implementations
+
+inline const CSCI441::AnimationClip::Pose& CSCI441::AnimationClip::_decodedFrame( const GLint frame ) const {
+    const GLint slot = frame % CACHE_SIZE;
+    Pose& pose = _cachedPose[slot];
+    if( _cachedFrame[slot] == frame ) return pose;
+
+    constexpr GLfloat SQRT_HALF = 0.70710678f;
+    if( pose.numJoints != _numJoints ) pose.resize( _numJoints );
+    const QuantizedJoint* joints = &_frames[ static_cast<size_t>(frame) * _numJoints ];
+    for( GLint j = 0; j < _numJoints; j++ ) {
+        const QuantizedJoint& joint = joints[j];
+        pose.px[j] = _positionMin[j].x + static_cast<GLfloat>( joint.position[0] ) * _positionScale[j].x;
+        pose.py[j] = _positionMin[j].y + static_cast<GLfloat>( joint.position[1] ) * _positionScale[j].y;
+        pose.pz[j] = _positionMin[j].z + static_cast<GLfloat>( joint.position[2] ) * _positionScale[j].z;
+
+        const GLint largest = ( joint.rotation[0] >> 15 ) | ( ( joint.rotation[1] >> 15 ) << 1 );
+        GLfloat components[4];
+        GLfloat sumSquares = 0.0f;
+        for( GLint c = 0, s = 0; c < 4; c++ ) {
+            if( c == largest ) continue;
+            const GLfloat value = ( static_cast<GLfloat>( joint.rotation[s++] & 0x7FFF ) / 32767.0f * 2.0f - 1.0f ) * SQRT_HALF;
+            components[c] = value;
+            sumSquares += value * value;
+        }
+        components[largest] = std::sqrt( std::max( 0.0f, 1.0f - sumSquares ) );
+
+        pose.qx[j] = components[0]; pose.qy[j] = components[1]; pose.qz[j] = components[2]; pose.qw[j] = components[3];
+    }
+
+    _cachedFrame[slot] = frame;
+    return pose;
+}
+
+inline CSCI441::AnimationClip::QuantizedJoint CSCI441::AnimationClip::_encode( const glm::vec3& position, const glm::quat& orientation, const glm::vec3& minimum, const glm::vec3& scale ) {
+    QuantizedJoint joint = {};
+    for( GLint c = 0; c < 3; c++ ) {
+        const GLfloat normalized = scale[c] > 0.0f ? ( position[c] - minimum[c] ) / scale[c] : 0.0f;
+        joint.position[c] = static_cast<GLushort>( std::lround( std::min( std::max( normalized, 0.0f ), 65535.0f ) ) );
+    }
+
+    const glm::quat q = glm::normalize( orientation );
+    GLfloat components[4] = { q.x, q.y, q.z, q.w };
+    GLint largest = 0;
+    for( GLint c = 1; c < 4; c++ ) {
+        if( std::fabs( components[c] ) > std::fabs( components[largest] ) ) largest = c;
+    }
+    // q and -q are the same rotation, keep the dropped component positive
+    const GLfloat sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+    constexpr GLfloat SQRT_TWO = 1.41421356f;
+    for( GLint c = 0, s = 0; c < 4; c++ ) {
+        if( c == largest ) continue;
+        const GLfloat normalized = ( components[c] * sign * SQRT_TWO + 1.0f ) * 0.5f;
+        joint.rotation[s++] = static_cast<GLushort>( std::lround( std::min( std::max( normalized, 0.0f ), 1.0f ) * 32767.0f ) );
+    }
+    joint.rotation[0] |= static_cast<GLushort>( ( largest & 1 ) << 15 );
+    joint.rotation[1] |= static_cast<GLushort>( ( largest >> 1 ) << 15 );
+    return joint;
+}
+
+#endif // CSCI441_ANIMATION_CLIP_HPP
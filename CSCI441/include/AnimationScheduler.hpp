@@ -0,0 +1,227 @@
+/** @file AnimationScheduler.hpp
+ * @brief Throttles animation updates by screen size and visibility
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Each frame, entities report their bounding sphere for every view they are drawn
+ *	in.  At the start of the next frame each entity is placed in a band by its
+ *	largest screen size: updated every frame, every second frame, every fourth
+ *	frame, or frozen when it was not visible in any view.  Entities are given
+ *	staggered phases so throttled updates spread evenly across frames.
+ *
+ *	update() accumulates the time since an entity's last update and returns it when
+ *	the entity is due, so the animation advances by the full elapsed time.  Between
+ *	updates getTimeSinceUpdate() lets the entity extrapolate its pose when drawing.
+ *
+ *	@warning This header file depends upon glm
+ */
+
+#ifndef CSCI441_ANIMATION_SCHEDULER_HPP
+#define CSCI441_ANIMATION_SCHEDULER_HPP
+
+#include "LODSelector.hpp"
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class AnimationScheduler
+     * @brief decides which entities update their animation each frame
+     */
+    class [[maybe_unused]] AnimationScheduler final {
+    public:
+        /**
+         * @brief update rate bands
+         */
+        enum Band : GLuint {
+            /// updated every frame
+            EVERY_FRAME,
+            /// updated every second frame
+            EVERY_SECOND_FRAME,
+            /// updated every fourth frame
+            EVERY_FOURTH_FRAME,
+            /// not visible, not updated
+            FROZEN,
+            /// number of bands
+            NUM_BANDS
+        };
+
+        /**
+         * @brief creates a scheduler with the default band thresholds
+         * @note every frame above 15% of the screen height, every second frame above 5%
+         */
+        AnimationScheduler() : AnimationScheduler( 0.15f, 0.05f ) {}
+        /**
+         * @brief creates a scheduler with custom band thresholds
+         * @param everyFrameSize minimum screen size to update every frame
+         * @param everySecondFrameSize minimum screen size to update every second frame, smaller visible entities update every fourth frame
+         */
+        AnimationScheduler( float everyFrameSize, float everySecondFrameSize );
+
+        /**
+         * @brief registers an entity
+         * @returns entity ID to pass to the other functions
+         * @note new entities update every frame until first observed
+         */
+        [[maybe_unused]] GLuint addEntity();
+
+        /**
+         * @brief places entities in bands from the previous frame's observations and starts counting a new frame
+         * @note call once per frame before any update()
+         */
+        [[maybe_unused]] void beginFrame();
+
+        /**
+         * @brief reports where an entity is drawn this frame
+         * @param entity entity ID
+         * @param worldCenter center of the entity's bounding sphere in world space
+         * @param worldRadius radius of the entity's bounding sphere in world space
+         * @param viewMtx view matrix of the view being drawn
+         * @param projMtx perspective projection matrix of the view being drawn
+         * @note call for every view the entity is drawn in, the largest visible size is used
+         */
+        [[maybe_unused]] void observe( GLuint entity, const glm::vec3& worldCenter, float worldRadius,
+                                       const glm::mat4& viewMtx, const glm::mat4& projMtx );
+
+        /**
+         * @brief accumulates frame time for an entity and reports if it should update
+         * @param entity entity ID
+         * @param deltaTime time since the last frame
+         * @returns time to advance the animation by if the entity updates this frame, 0 otherwise
+         */
+        [[maybe_unused]] GLfloat update( GLuint entity, GLfloat deltaTime );
+
+        /**
+         * @brief returns the time accumulated since the entity last updated, for extrapolating its pose
+         */
+        [[maybe_unused]] [[nodiscard]] GLfloat getTimeSinceUpdate( GLuint entity ) const { return _entities[entity].pendingTime; }
+        /**
+         * @brief returns the band an entity is currently in
+         */
+        [[maybe_unused]] [[nodiscard]] Band getBand( GLuint entity ) const { return _entities[entity].band; }
+        /**
+         * @brief returns the number of entities in a band this frame
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint getNumberOfEntities( Band band ) const { return _entityCounts[band]; }
+        /**
+         * @brief returns the number of entities of a band that updated this frame
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint getNumberOfUpdates( Band band ) const { return _updateCounts[band]; }
+
+        /**
+         * @brief tests a bounding sphere against the view frustum
+         * @param worldCenter center of the sphere in world space
+         * @param worldRadius radius of the sphere in world space
+         * @param viewProjMtx projection matrix times view matrix
+         * @returns true if any part of the sphere may be inside the frustum
+         */
+        [[maybe_unused]] [[nodiscard]] static bool isVisible( const glm::vec3& worldCenter, float worldRadius, const glm::mat4& viewProjMtx );
+
+    private:
+        struct Entity {
+            GLuint phase = 0;
+            Band band = EVERY_FRAME;
+            GLfloat observedSize = -1.0f;   // negative until seen this frame
+            GLfloat pendingTime = 0.0f;
+        };
+
+        static constexpr GLuint PERIOD[NUM_BANDS] = { 1, 2, 4, 0 };
+
+        GLfloat _everyFrameSize;
+        GLfloat _everySecondFrameSize;
+        std::vector<Entity> _entities;
+        GLuint _frame;
+        GLuint _entityCounts[NUM_BANDS];
+        GLuint _updateCounts[NUM_BANDS];
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+inline CSCI441::AnimationScheduler::AnimationScheduler( const float everyFrameSize, const float everySecondFrameSize )
+    : _everyFrameSize(everyFrameSize), _everySecondFrameSize(everySecondFrameSize), _frame(0),
+      _entityCounts{ 0, 0, 0, 0 }, _updateCounts{ 0, 0, 0, 0 } {
+}
+
+[[maybe_unused]]
+inline GLuint CSCI441::AnimationScheduler::addEntity() {
+    Entity entity;
+    // consecutive entities alternate every second frame and cycle every fourth frame
+    entity.phase = static_cast<GLuint>( _entities.size() % 4 );
+    // not yet observed, treated as full size until the first frame is drawn
+    entity.observedSize = std::numeric_limits<GLfloat>::max();
+    _entities.push_back( entity );
+    return static_cast<GLuint>( _entities.size() - 1 );
+}
+
+[[maybe_unused]]
+inline void CSCI441::AnimationScheduler::beginFrame() {
+    _frame++;
+    std::fill( _entityCounts, _entityCounts + NUM_BANDS, 0 );
+    std::fill( _updateCounts, _updateCounts + NUM_BANDS, 0 );
+
+    for( auto& entity : _entities ) {
+        if( entity.observedSize < 0.0f )                    entity.band = FROZEN;
+        else if( entity.observedSize >= _everyFrameSize )       entity.band = EVERY_FRAME;
+        else if( entity.observedSize >= _everySecondFrameSize ) entity.band = EVERY_SECOND_FRAME;
+        else                                                    entity.band = EVERY_FOURTH_FRAME;
+        entity.observedSize = -1.0f;
+        _entityCounts[entity.band]++;
+    }
+}
+
+[[maybe_unused]]
+inline void CSCI441::AnimationScheduler::observe( const GLuint entity, const glm::vec3& worldCenter, const float worldRadius,
+                                                  const glm::mat4& viewMtx, const glm::mat4& projMtx ) {
+    if( !isVisible( worldCenter, worldRadius, projMtx * viewMtx ) ) return;
+    const GLfloat size = LODSelector::projectedScreenSize( worldCenter, worldRadius, viewMtx, projMtx );
+    _entities[entity].observedSize = std::max( _entities[entity].observedSize, size );
+}
+
+[[maybe_unused]]
+inline GLfloat CSCI441::AnimationScheduler::update( const GLuint entity, const GLfloat deltaTime ) {
+    Entity& state = _entities[entity];
+    state.pendingTime += deltaTime;
+
+    const GLuint period = PERIOD[state.band];
+    if( period == 0 || (_frame + state.phase) % period != 0 ) return 0.0f;
+
+    _updateCounts[state.band]++;
+    const GLfloat elapsed = state.pendingTime;
+    state.pendingTime = 0.0f;
+    return elapsed;
+}
+
+[[maybe_unused]]
+inline bool CSCI441::AnimationScheduler::isVisible( const glm::vec3& worldCenter, const float worldRadius, const glm::mat4& viewProjMtx ) {
+    // planes are sums and differences of the fourth row with the other rows
+    const glm::vec4 point( worldCenter, 1.0f );
+    for( GLint row = 0; row < 3; row++ ) {
+        for( const float sign : { 1.0f, -1.0f } ) {
+            glm::vec4 plane;
+            for( GLint column = 0; column < 4; column++ ) {
+                plane[column] = viewProjMtx[column][3] + sign * viewProjMtx[column][row];
+            }
+            const float length = glm::length( glm::vec3( plane ) );
+            if( glm::dot( plane, point ) < -worldRadius * length ) return false;
+        }
+    }
+    return true;
+}
+
+#endif // CSCI441_ANIMATION_SCHEDULER_HPP
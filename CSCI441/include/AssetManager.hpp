@@ -0,0 +1,513 @@
+/** @file AssetManager.hpp
+ * @brief Process-wide cache of GPU textures and meshes shared by reference count
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Assets are keyed by the content hash of the file(s) they were created from together
+ *	with any load parameters that affect the GPU object.  The canonical path of each file
+ *	is remembered along with its modification time so a file is only re-hashed when it
+ *	changes on disk.  Two different paths to identical bytes share one upload.
+ *
+ *	Every acquire must be paired with a release.  Assets whose reference count drops to
+ *	zero stay resident in least recently used order until the memory budget is exceeded,
+ *	at which point they are evicted oldest first.
+ *
+ *	@warning This header file depends upon GLAD (or alternatively GLEW)
+ *	@warning Acquire and release must be called from the thread owning the OpenGL context
+ */
+
+#ifndef CSCI441_ASSET_MANAGER_HPP
+#define CSCI441_ASSET_MANAGER_HPP
+
+#include "AsyncTextureLoader.hpp"
+#include "TextureUtils.hpp"
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class AssetManager
+     * @brief shares textures and meshes across all users within the process
+     */
+    class [[maybe_unused]] AssetManager final {
+    public:
+        /**
+         * @brief callback used to create a texture when it is not already resident
+         * @param[out] bytes must be set to the approximate GPU memory used by the texture
+         * @returns handle of the created texture, or 0 on failure
+         */
+        using TextureCreator = std::function<GLuint(size_t& bytes)>;
+
+        /**
+         * @brief returns the single process-wide asset manager
+         */
+        static AssetManager& instance();
+
+        /**
+         * @brief do not allow the manager to be copied
+         */
+        AssetManager(const AssetManager&) = delete;
+        /**
+         * @brief do not allow the manager to be copied
+         */
+        AssetManager& operator=(const AssetManager&) = delete;
+
+        /**
+         * @brief acquires a reference to a 2D texture, loading it on first use
+         * @note If a cooked .ktx with the same name and the requested orientation exists next to the file,
+         * calls through to TextureUtils::loadAndRegisterKTXTexture() on a cache miss.  Otherwise calls through to
+         * AsyncTextureLoader::load2DTexture() if a loader is set, or TextureUtils::loadAndRegister2DTexture()
+         * @param filename name of texture to load
+         * @param minFilter minification filter to apply (default: GL_LINEAR)
+         * @param magFilter magnification filter to apply (default: GL_LINEAR)
+         * @param wrapS wrapping to apply to S coordinate (default: GL_REPEAT)
+         * @param wrapT wrapping to apply to T coordinate (default: GL_REPEAT)
+         * @param flipOnY flip the image along the vertical on load (default: GL_TRUE)
+         * @param printAllMessages prints debug/error messages to terminal
+         * @returns texture handle corresponding to the texture, or 0 if the texture could not be loaded
+         */
+        [[maybe_unused]] GLuint acquireTexture( const char* filename,
+                                                GLint minFilter = GL_LINEAR,
+                                                GLint magFilter = GL_LINEAR,
+                                                GLint wrapS = GL_REPEAT,
+                                                GLint wrapT = GL_REPEAT,
+                                                GLboolean flipOnY = GL_TRUE,
+                                                GLboolean printAllMessages = GL_TRUE );
+
+        /**
+         * @brief acquires a reference to a texture built from one or more files
+         * @param filenames all files the texture is created from (e.g. the six faces of a cube map)
+         * @param variant extra text distinguishing textures created from the same files with different parameters
+         * @param creator called to create the texture if it is not already resident
+         * @returns texture handle corresponding to the texture, or 0 if a file could not be read or creation failed
+         */
+        [[maybe_unused]] GLuint acquireTexture( const std::vector<std::string>& filenames,
+                                                const std::string& variant,
+                                                const TextureCreator& creator );
+
+        /**
+         * @brief releases one reference to a texture previously acquired from the manager
+         * @param textureHandle handle returned by acquireTexture()
+         * @note handles not owned by the manager are ignored
+         */
+        [[maybe_unused]] void releaseTexture( GLuint textureHandle );
+
+        /**
+         * @brief acquires a reference to a mesh loaded from file, loading it on first use
+         * @tparam MeshType type providing loadModelFile(), getNumberOfVertices() and getNumberOfIndices()
+         * such as CSCI441::ModelLoader
+         * @note the material libraries named by an .obj and the texture maps they name are part of the key,
+         * so editing any of them loads a new copy of the mesh
+         * @param filename name of mesh to load
+         * @returns pointer to the shared mesh, or nullptr if the mesh could not be loaded
+         * @warning the returned mesh must not be deleted, release it with releaseMesh()
+         */
+        template<typename MeshType>
+        [[maybe_unused]] MeshType* acquireMesh( const char* filename );
+
+        /**
+         * @brief releases one reference to a mesh previously acquired from the manager
+         * @param pMesh pointer returned by acquireMesh()
+         * @note pointers not owned by the manager are ignored
+         */
+        [[maybe_unused]] void releaseMesh( const void* pMesh );
+
+        /**
+         * @brief sets the number of bytes unreferenced assets may occupy before being evicted
+         * @param bytes memory budget in bytes (default: 256 MB)
+         * @note referenced assets are never evicted, so resident memory may exceed the budget
+         */
+        [[maybe_unused]] void setMemoryBudget( size_t bytes );
+        /**
+         * @brief returns the current memory budget in bytes
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getMemoryBudget() const { return _memoryBudget; }
+        /**
+         * @brief returns the approximate number of bytes used by all resident assets
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getResidentBytes() const { return _residentBytes; }
+        /**
+         * @brief returns the number of resident assets, referenced or not
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getNumberOfAssets() const { return _assets.size(); }
+
+        /**
+         * @brief evicts every unreferenced asset regardless of the memory budget
+         */
+        [[maybe_unused]] void evictUnused();
+
+        /**
+         * @brief routes file based texture loads through a background loader
+         * @param pLoader loader to use, or nullptr to load synchronously (default)
+         * @note the loader must outlive every texture acquired while it was set
+         */
+        [[maybe_unused]] void setAsyncTextureLoader( AsyncTextureLoader* pLoader ) { _pAsyncTextureLoader = pLoader; }
+        /**
+         * @brief returns the background loader in use, or nullptr if textures load synchronously
+         */
+        [[maybe_unused]] [[nodiscard]] AsyncTextureLoader* getAsyncTextureLoader() const { return _pAsyncTextureLoader; }
+
+    private:
+        AssetManager() = default;
+        ~AssetManager();
+
+        // one resident GPU asset
+        struct Asset {
+            GLuint textureHandle = 0;
+            void* pMesh = nullptr;
+            std::function<void(void*)> meshDeleter;
+            size_t bytes = 0;
+            unsigned int refCount = 0;
+            std::list<std::string>::iterator lruPosition;
+        };
+
+        // content hash of a file remembered until the file changes on disk
+        struct FileHash {
+            std::filesystem::file_time_type writeTime;
+            uintmax_t size;
+            uint64_t hash;
+            std::vector<std::string> references;                // mtllib of an .obj, map_* of an .mtl
+        };
+
+        bool _makeKey( const std::vector<std::string>& filenames, const std::string& variant, std::string& key );
+        bool _hashFile( const std::string& filename, uint64_t& hash, std::vector<std::string>* pReferences = nullptr );
+        bool _collectMeshFiles( const std::string& filename, std::vector<std::string>& filenames );
+        static void _readReferences( const std::filesystem::path& filename, std::vector<std::string>& references );
+        GLuint _retainTexture( const std::string& key );
+        void* _retainMesh( const std::string& key );
+        void _insert( const std::string& key, Asset asset );
+        void _release( std::map<std::string, Asset>::iterator assetIter );
+        void _evict( size_t budget );
+        void _destroy( Asset& asset );
+
+        std::recursive_mutex _mutex;
+
+        std::map< std::string, Asset > _assets;                 // all resident assets by key
+        std::map< GLuint, std::string > _textureKeys;           // reverse lookup from texture handle
+        std::map< const void*, std::string > _meshKeys;         // reverse lookup from mesh pointer
+        std::map< std::string, FileHash > _fileHashes;          // content hashes by canonical path
+        std::list< std::string > _unused;                       // unreferenced assets, least recently used first
+
+        size_t _memoryBudget = 256u * 1024u * 1024u;
+        size_t _residentBytes = 0;
+
+        AsyncTextureLoader* _pAsyncTextureLoader = nullptr;
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+inline CSCI441::AssetManager& CSCI441::AssetManager::instance() {
+    static AssetManager sInstance;
+    return sInstance;
+}
+
+inline CSCI441::AssetManager::~AssetManager() {
+    // the OpenGL context is usually gone by the time static objects are destroyed, and deleting a
+    // mesh frees its buffers and releases its textures back into this manager.  anything still
+    // resident is left to the operating system, call evictUnused() before shutdown to free it
+}
+
+[[maybe_unused]]
+inline GLuint CSCI441::AssetManager::acquireTexture( const char* filename, const GLint minFilter, const GLint magFilter, const GLint wrapS, const GLint wrapT, const GLboolean flipOnY, const GLboolean printAllMessages ) {
+    char variant[64];
+    snprintf( variant, 64, "tex2D:%x:%x:%x:%x:%d", minFilter, magFilter, wrapS, wrapT, flipOnY );
+
+    // prefer a cooked container next to the source image, it needs neither decoding nor mip generation.
+    // its rows are uploaded as stored, so it is only used if it was cooked with the same flip
+    std::error_code errorCode;
+    const std::string cookedFilename = std::filesystem::path( filename ).replace_extension( ".ktx" ).string();
+    KTXUtils::Texture cookedHeader;
+    if( std::filesystem::exists( cookedFilename, errorCode )
+        && KTXUtils::readKTX( cookedFilename.c_str(), cookedHeader, true )
+        && cookedHeader.flippedOnY == (flipOnY == GL_TRUE) ) {
+        const GLuint cookedHandle = acquireTexture( { cookedFilename }, variant, [=](size_t& bytes) {
+            return TextureUtils::loadAndRegisterKTXTexture( cookedFilename.c_str(), minFilter, magFilter, wrapS, wrapT, printAllMessages, &bytes );
+        } );
+        if( cookedHandle != 0 ) return cookedHandle;
+    }
+
+    return acquireTexture( { filename }, variant, [=](size_t& bytes) {
+        if( _pAsyncTextureLoader != nullptr ) {
+            bytes = AsyncTextureLoader::estimateBytes( filename, 1, true );
+            return _pAsyncTextureLoader->load2DTexture( filename, minFilter, magFilter, wrapS, wrapT, flipOnY );
+        }
+
+        GLuint texHandle = TextureUtils::loadAndRegister2DTexture( filename, minFilter, magFilter, wrapS, wrapT, flipOnY, printAllMessages );
+        if( texHandle != 0 ) {
+            GLint width = 0, height = 0;
+            glGetTexLevelParameteriv( GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width );
+            glGetTexLevelParameteriv( GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height );
+            // RGBA8 storage plus a full mip chain
+            bytes = static_cast<size_t>(width) * static_cast<size_t>(height) * 4 * 4 / 3;
+        }
+        return texHandle;
+    } );
+}
+
+[[maybe_unused]]
+inline GLuint CSCI441::AssetManager::acquireTexture( const std::vector<std::string>& filenames, const std::string& variant, const TextureCreator& creator ) {
+    std::lock_guard<std::recursive_mutex> lock( _mutex );
+
+    std::string key;
+    if( !_makeKey( filenames, variant, key ) ) return 0;
+
+    GLuint texHandle = _retainTexture( key );
+    if( texHandle != 0 ) return texHandle;
+
+    Asset asset;
+    asset.textureHandle = creator( asset.bytes );
+    if( asset.textureHandle == 0 ) return 0;
+
+    texHandle = asset.textureHandle;
+    _textureKeys[ texHandle ] = key;
+    _insert( key, std::move(asset) );
+    return texHandle;
+}
+
+[[maybe_unused]]
+inline void CSCI441::AssetManager::releaseTexture( const GLuint textureHandle ) {
+    std::lock_guard<std::recursive_mutex> lock( _mutex );
+
+    auto keyIter = _textureKeys.find( textureHandle );
+    if( keyIter == _textureKeys.end() ) return;
+    _release( _assets.find( keyIter->second ) );
+}
+
+template<typename MeshType>
+[[maybe_unused]]
+inline MeshType* CSCI441::AssetManager::acquireMesh( const char* filename ) {
+    std::lock_guard<std::recursive_mutex> lock( _mutex );
+
+    std::vector<std::string> filenames;
+    std::string key;
+    if( !_collectMeshFiles( filename, filenames ) || !_makeKey( filenames, "mesh", key ) ) return nullptr;
+
+    void* pShared = _retainMesh( key );
+    if( pShared != nullptr ) return static_cast<MeshType*>( pShared );
+
+    auto pMesh = new MeshType();
+    if( !pMesh->loadModelFile( filename ) ) {
+        delete pMesh;
+        return nullptr;
+    }
+
+    Asset asset;
+    asset.pMesh = pMesh;
+    asset.meshDeleter = [](void* p) { delete static_cast<MeshType*>( p ); };
+    // positions, normals and texture coordinates plus 32-bit indices
+    asset.bytes = static_cast<size_t>( pMesh->getNumberOfVertices() ) * sizeof(GLfloat) * 8
+                + static_cast<size_t>( pMesh->getNumberOfIndices() ) * sizeof(GLuint);
+
+    _meshKeys[ pMesh ] = key;
+    _insert( key, std::move(asset) );
+    return pMesh;
+}
+
+[[maybe_unused]]
+inline void CSCI441::AssetManager::releaseMesh( const void* pMesh ) {
+    std::lock_guard<std::recursive_mutex> lock( _mutex );
+
+    auto keyIter = _meshKeys.find( pMesh );
+    if( keyIter == _meshKeys.end() ) return;
+    _release( _assets.find( keyIter->second ) );
+}
+
+[[maybe_unused]]
+inline void CSCI441::AssetManager::setMemoryBudget( const size_t bytes ) {
+    std::lock_guard<std::recursive_mutex> lock( _mutex );
+    _memoryBudget = bytes;
+    _evict( _memoryBudget );
+}
+
+[[maybe_unused]]
+inline void CSCI441::AssetManager::evictUnused() {
+    std::lock_guard<std::recursive_mutex> lock( _mutex );
+    _evict( 0 );
+}
+
+//**********************************************************************************
+// Private implementations
+
+inline bool CSCI441::AssetManager::_makeKey( const std::vector<std::string>& filenames, const std::string& variant, std::string& key ) {
+    key = variant;
+    for( const auto& filename : filenames ) {
+        uint64_t hash;
+        if( !_hashFile( filename, hash ) ) return false;
+
+        char hashText[20];
+        snprintf( hashText, 20, "|%016llx", static_cast<unsigned long long>(hash) );
+        key += hashText;
+    }
+    return true;
+}
+
+inline bool CSCI441::AssetManager::_hashFile( const std::string& filename, uint64_t& hash, std::vector<std::string>* pReferences ) {
+    std::error_code errorCode;
+    const std::filesystem::path canonicalPath = std::filesystem::weakly_canonical( filename, errorCode );
+    if( errorCode ) return false;
+
+    const auto writeTime = std::filesystem::last_write_time( canonicalPath, errorCode );
+    if( errorCode ) return false;
+    const auto fileSize = std::filesystem::file_size( canonicalPath, errorCode );
+    if( errorCode ) return false;
+
+    auto hashIter = _fileHashes.find( canonicalPath.string() );
+    if( hashIter != _fileHashes.end()
+        && hashIter->second.writeTime == writeTime
+        && hashIter->second.size == fileSize ) {
+        hash = hashIter->second.hash;
+        if( pReferences != nullptr ) *pReferences = hashIter->second.references;
+        return true;
+    }
+
+    std::ifstream in( canonicalPath, std::ios::binary );
+    if( !in.is_open() ) return false;
+
+    // 64-bit FNV-1a over the file contents
+    hash = 14695981039346656037ull;
+    char buffer[65536];
+    while( in.read( buffer, sizeof(buffer) ) || in.gcount() > 0 ) {
+        const std::streamsize numRead = in.gcount();
+        for( std::streamsize i = 0; i < numRead; i++ ) {
+            hash ^= static_cast<unsigned char>( buffer[i] );
+            hash *= 1099511628211ull;
+        }
+    }
+
+    FileHash& fileHash = _fileHashes[ canonicalPath.string() ];
+    fileHash = { writeTime, fileSize, hash, {} };
+    _readReferences( canonicalPath, fileHash.references );
+    if( pReferences != nullptr ) *pReferences = fileHash.references;
+    return true;
+}
+
+inline bool CSCI441::AssetManager::_collectMeshFiles( const std::string& filename, std::vector<std::string>& filenames ) {
+    // referenced files are resolved the way ModelLoader opens them, against the working
+    // directory first and then the model's folder.  missing ones are skipped as it skips them
+    const size_t lastSlash = filename.find_last_of( '/' );
+    const std::string folder = lastSlash == std::string::npos ? "./" : filename.substr( 0, lastSlash + 1 );
+
+    filenames = { filename };
+    for( size_t i = 0; i < filenames.size(); i++ ) {
+        uint64_t hash;
+        std::vector<std::string> references;
+        if( !_hashFile( filenames[i], hash, &references ) ) {
+            if( i == 0 ) return false;
+            continue;
+        }
+
+        for( const auto& reference : references ) {
+            std::error_code errorCode;
+            const std::string resolved = std::filesystem::exists( reference, errorCode ) ? reference : folder + reference;
+            if( !std::filesystem::exists( resolved, errorCode ) ) continue;
+            if( std::find( filenames.begin(), filenames.end(), resolved ) == filenames.end() ) filenames.push_back( resolved );
+        }
+    }
+    return true;
+}
+
+inline void CSCI441::AssetManager::_readReferences( const std::filesystem::path& filename, std::vector<std::string>& references ) {
+    const std::string extension = filename.extension().string();
+    const bool isOBJ = extension == ".obj" || extension == ".OBJ";
+    const bool isMTL = extension == ".mtl" || extension == ".MTL";
+    if( !isOBJ && !isMTL ) return;
+
+    std::ifstream in( filename );
+    std::string line;
+    while( std::getline( in, line ) ) {
+        std::istringstream tokens( line );
+        std::string keyword, referenceName;
+        if( !( tokens >> keyword >> referenceName ) ) continue;
+        if( ( isOBJ && keyword == "mtllib" ) || ( isMTL && keyword.compare( 0, 4, "map_" ) == 0 ) ) {
+            references.push_back( referenceName );
+        }
+    }
+}
+
+inline GLuint CSCI441::AssetManager::_retainTexture( const std::string& key ) {
+    auto assetIter = _assets.find( key );
+    if( assetIter == _assets.end() ) return 0;
+
+    Asset& asset = assetIter->second;
+    if( asset.refCount++ == 0 ) _unused.erase( asset.lruPosition );
+    return asset.textureHandle;
+}
+
+inline void* CSCI441::AssetManager::_retainMesh( const std::string& key ) {
+    auto assetIter = _assets.find( key );
+    if( assetIter == _assets.end() ) return nullptr;
+
+    Asset& asset = assetIter->second;
+    if( asset.refCount++ == 0 ) _unused.erase( asset.lruPosition );
+    return asset.pMesh;
+}
+
+inline void CSCI441::AssetManager::_insert( const std::string& key, Asset asset ) {
+    asset.refCount = 1;
+    asset.lruPosition = _unused.end();
+    _residentBytes += asset.bytes;
+    _assets.emplace( key, std::move(asset) );
+    _evict( _memoryBudget );
+}
+
+inline void CSCI441::AssetManager::_release( const std::map<std::string, Asset>::iterator assetIter ) {
+    if( assetIter == _assets.end() ) return;
+
+    Asset& asset = assetIter->second;
+    if( asset.refCount == 0 ) return;
+    if( --asset.refCount == 0 ) {
+        asset.lruPosition = _unused.insert( _unused.end(), assetIter->first );
+        _evict( _memoryBudget );
+    }
+}
+
+inline void CSCI441::AssetManager::_evict( const size_t budget ) {
+    while( _residentBytes > budget && !_unused.empty() ) {
+        auto assetIter = _assets.find( _unused.front() );
+        _unused.pop_front();
+
+        Asset& asset = assetIter->second;
+        _residentBytes -= asset.bytes;
+        if( asset.textureHandle != 0 ) _textureKeys.erase( asset.textureHandle );
+        if( asset.pMesh != nullptr )   _meshKeys.erase( asset.pMesh );
+        _destroy( asset );
+        _assets.erase( assetIter );
+    }
+}
+
+inline void CSCI441::AssetManager::_destroy( Asset& asset ) {
+    if( asset.textureHandle != 0 ) {
+        if( _pAsyncTextureLoader != nullptr ) _pAsyncTextureLoader->cancel( asset.textureHandle );
+        glDeleteTextures( 1, &asset.textureHandle );
+        asset.textureHandle = 0;
+    }
+    if( asset.pMesh != nullptr ) {
+        asset.meshDeleter( asset.pMesh );
+        asset.pMesh = nullptr;
+    }
+}
+
+#endif // CSCI441_ASSET_MANAGER_HPP
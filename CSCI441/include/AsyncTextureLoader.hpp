@@ -0,0 +1,536 @@
+/** @file AsyncTextureLoader.hpp
+ * @brief Decodes images on worker threads and streams them to the GPU through pixel buffer objects
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Requesting a texture returns a valid texture handle immediately.  The handle holds a
+ *	small placeholder image until the file has been decoded by a worker thread and uploaded
+ *	by update().  Each call to update() uploads at most the configured number of bytes so
+ *	that large images are spread across several frames instead of stalling one.  A texture
+ *	whose image could not be decoded, or a cube map whose faces differ in size, keeps the
+ *	placeholder and reports hasFailed() so the caller can fall back.
+ *
+ *	@warning This header file depends upon GLAD (or alternatively GLEW)
+ *	@warning This header file depends upon stb_image
+ *	@warning stb_image v2.23 stores the vertical flip setting globally.  Workers decode
+ *	unflipped and flip with TextureUtils::flipImageRows(), so the setting must be left off
+ *	while loads are pending.  None of the CSCI441 loaders turn it on.
+ */
+
+#ifndef CSCI441_ASYNC_TEXTURE_LOADER_HPP
+#define CSCI441_ASYNC_TEXTURE_LOADER_HPP
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include "Logger.hpp"
+#include "Profiler.hpp"
+#include "TextureUtils.hpp"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class AsyncTextureLoader
+     * @brief thread-pooled image decoding with budgeted texture uploads on the OpenGL thread
+     */
+    class [[maybe_unused]] AsyncTextureLoader final {
+    public:
+        /**
+         * @brief creates the worker threads and placeholder image
+         * @param numThreads number of decode threads to create (default: 0 uses one less than the number of hardware threads)
+         * @param bytesPerFrame maximum number of bytes uploaded by each call to update() (default: 4 MB)
+         * @note must be created on the thread owning the OpenGL context
+         */
+        explicit AsyncTextureLoader( unsigned int numThreads = 0, size_t bytesPerFrame = 4u * 1024u * 1024u );
+        /**
+         * @brief stops the worker threads and frees the pixel buffer objects
+         * @note textures that were handed out are not deleted
+         */
+        ~AsyncTextureLoader();
+
+        /**
+         * @brief do not allow loaders to be copied
+         */
+        AsyncTextureLoader(const AsyncTextureLoader&) = delete;
+        /**
+         * @brief do not allow loaders to be copied
+         */
+        AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
+
+        /**
+         * @brief queues a 2D texture to be loaded in the background
+         * @param filename name of texture to load
+         * @param minFilter minification filter to apply (default: GL_LINEAR)
+         * @param magFilter magnification filter to apply (default: GL_LINEAR)
+         * @param wrapS wrapping to apply to S coordinate (default: GL_REPEAT)
+         * @param wrapT wrapping to apply to T coordinate (default: GL_REPEAT)
+         * @param flipOnY flip the image along the vertical on load (default: GL_TRUE)
+         * @returns texture handle that holds the placeholder image until the texture is resident,
+         * or 0 if the file could not be found
+         * @note mipmaps are generated once the image is resident if the minification filter uses them
+         */
+        [[maybe_unused]] GLuint load2DTexture( const char* filename,
+                                               GLint minFilter = GL_LINEAR,
+                                               GLint magFilter = GL_LINEAR,
+                                               GLint wrapS = GL_REPEAT,
+                                               GLint wrapT = GL_REPEAT,
+                                               GLboolean flipOnY = GL_TRUE );
+        /**
+         * @brief queues a cube map to be loaded in the background
+         * @param faces names of the six face images in the order +X, -X, +Y, -Y, +Z, -Z
+         * @param minFilter minification filter to apply (default: GL_LINEAR)
+         * @param magFilter magnification filter to apply (default: GL_LINEAR)
+         * @returns texture handle that holds the placeholder image until the texture is resident,
+         * or 0 if six faces were not provided
+         * @note all coordinates are clamped to edge
+         */
+        [[maybe_unused]] GLuint loadCubeMapTexture( const std::vector<std::string>& faces,
+                                                    GLint minFilter = GL_LINEAR,
+                                                    GLint magFilter = GL_LINEAR );
+
+        /**
+         * @brief uploads decoded images to the GPU up to the per frame byte budget
+         * @note must be called on the thread owning the OpenGL context, typically once per frame
+         */
+        [[maybe_unused]] void update();
+        /**
+         * @brief blocks until every queued texture is resident, ignoring the byte budget
+         */
+        [[maybe_unused]] void finish();
+        /**
+         * @brief stops uploading to a texture that is about to be deleted and forgets if it failed
+         * @param textureHandle handle returned by one of the load methods
+         * @note any decode already in flight is discarded when it completes
+         */
+        [[maybe_unused]] void cancel( GLuint textureHandle );
+
+        /**
+         * @brief returns true once the texture is no longer showing the placeholder
+         * @param textureHandle handle returned by one of the load methods
+         */
+        [[maybe_unused]] [[nodiscard]] bool isResident( GLuint textureHandle ) const;
+        /**
+         * @brief returns true if the texture finished loading without its image and keeps the placeholder
+         * @param textureHandle handle returned by one of the load methods
+         * @note a texture fails when an image could not be decoded or a cube map face differs in size from the first
+         */
+        [[maybe_unused]] [[nodiscard]] bool hasFailed( GLuint textureHandle ) const;
+        /**
+         * @brief returns the number of textures still showing the placeholder
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getNumberOfPendingTextures() const { return _pendingTextures.size(); }
+
+        /**
+         * @brief sets the maximum number of bytes uploaded by each call to update()
+         * @param bytesPerFrame upload budget in bytes
+         * @note at least one row of one image is always uploaded per update
+         */
+        [[maybe_unused]] void setBytesPerFrame( size_t bytesPerFrame ) { _bytesPerFrame = bytesPerFrame; }
+
+        /**
+         * @brief estimates the GPU memory a texture loaded from file will occupy once resident
+         * @param filename name of image to query, only the header is read
+         * @param numLayers number of images of the same size (6 for a cube map)
+         * @param mipmaps if a full mip chain will be generated
+         * @returns approximate number of bytes, or 0 if the file could not be read
+         */
+        [[maybe_unused]] static size_t estimateBytes( const char* filename, int numLayers = 1, bool mipmaps = false );
+
+    private:
+        // an image waiting to be decoded by a worker
+        struct DecodeJob {
+            GLuint textureHandle;
+            // texture names are reused once deleted, so a job belongs to one request, not to a name
+            GLuint64 request;
+            GLenum target;
+            std::string filename;
+            bool flipOnY;
+        };
+
+        // a decoded image waiting to be uploaded
+        struct DecodedImage {
+            DecodeJob job;
+            int width, height, channels;
+            unsigned char* data;
+            int rowsUploaded;
+        };
+
+        // a texture still showing the placeholder
+        struct PendingTexture {
+            GLuint64 request;
+            GLenum bindTarget;
+            int layersRemaining;
+            bool mipmaps;
+            bool allocated;
+            // size of the base level once allocated, every cube map face must match it
+            int width, height;
+            // set when a layer could not be uploaded, the texture keeps the placeholder
+            bool failed;
+        };
+
+        void _workerLoop();
+        void _queue( const DecodeJob& job );
+        [[nodiscard]] PendingTexture* _findPending( const DecodeJob& job );
+        [[nodiscard]] static bool _isUploadable( const PendingTexture& pending, const DecodedImage& image );
+        void _upload( PendingTexture& pending, DecodedImage& image, size_t& budget );
+        void _allocate( PendingTexture& pending, const DecodedImage& image );
+        void _finishImage( const DecodedImage& image );
+        static void _setPlaceholder( GLenum target );
+        static GLenum _format( int channels );
+
+        std::vector< std::thread > _workers;
+        std::mutex _jobMutex;
+        std::condition_variable _jobCondition;
+        std::deque< DecodeJob > _jobs;
+        bool _stopWorkers;
+
+        std::mutex _decodedMutex;
+        std::deque< DecodedImage > _decoded;         // finished by workers, not yet picked up
+        std::deque< DecodedImage > _uploads;         // owned by the OpenGL thread
+
+        std::map< GLuint, PendingTexture > _pendingTextures;
+        std::set< GLuint > _failedTextures;
+        GLuint64 _nextRequest;
+
+        static constexpr int NUM_PBOS = 3;
+        GLuint _pbos[NUM_PBOS];
+        size_t _pboSizes[NUM_PBOS];
+        int _currentPBO;
+        size_t _bytesPerFrame;
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+inline CSCI441::AsyncTextureLoader::AsyncTextureLoader( unsigned int numThreads, const size_t bytesPerFrame )
+        : _stopWorkers(false), _nextRequest(1), _currentPBO(0), _bytesPerFrame(bytesPerFrame) {
+    glGenBuffers( NUM_PBOS, _pbos );
+    for( auto& pboSize : _pboSizes ) pboSize = 0;
+
+    if( numThreads == 0 ) {
+        const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        numThreads = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+    for( unsigned int i = 0; i < numThreads; i++ ) {
+        _workers.emplace_back( &AsyncTextureLoader::_workerLoop, this );
+    }
+}
+
+inline CSCI441::AsyncTextureLoader::~AsyncTextureLoader() {
+    {
+        std::lock_guard<std::mutex> lock( _jobMutex );
+        _stopWorkers = true;
+    }
+    _jobCondition.notify_all();
+    for( auto& worker : _workers ) worker.join();
+
+    for( auto& image : _decoded ) stbi_image_free( image.data );
+    for( auto& image : _uploads ) stbi_image_free( image.data );
+
+    glDeleteBuffers( NUM_PBOS, _pbos );
+}
+
+[[maybe_unused]]
+inline GLuint CSCI441::AsyncTextureLoader::load2DTexture( const char* filename, const GLint minFilter, const GLint magFilter, const GLint wrapS, const GLint wrapT, const GLboolean flipOnY ) {
+    int width, height, channels;
+    if( !stbi_info( filename, &width, &height, &channels ) ) {
+        CSCI441_LOG_ERROR( "CSCI441::AsyncTextureLoader::load2DTexture(): Could not load texture \"%s\"", filename );
+        return 0;
+    }
+
+    GLuint texHandle;
+    glGenTextures( 1, &texHandle );
+    glBindTexture(   GL_TEXTURE_2D,  texHandle );
+    glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_MIN_FILTER, minFilter );
+    glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_MAG_FILTER, magFilter );
+    glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_WRAP_S,     wrapS );
+    glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_WRAP_T,     wrapT );
+    // only the base level exists until the image is resident
+    glTexParameteri( GL_TEXTURE_2D,  GL_TEXTURE_MAX_LEVEL,  0 );
+    _setPlaceholder( GL_TEXTURE_2D );
+
+    const bool MIPMAPS = (minFilter != GL_NEAREST && minFilter != GL_LINEAR);
+    const GLuint64 REQUEST = _nextRequest++;
+    _pendingTextures[ texHandle ] = { REQUEST, GL_TEXTURE_2D, 1, MIPMAPS, false, 0, 0, false };
+    _failedTextures.erase( texHandle );
+    _queue( { texHandle, REQUEST, GL_TEXTURE_2D, filename, flipOnY == GL_TRUE } );
+
+    return texHandle;
+}
+
+[[maybe_unused]]
+inline GLuint CSCI441::AsyncTextureLoader::loadCubeMapTexture( const std::vector<std::string>& faces, const GLint minFilter, const GLint magFilter ) {
+    if( faces.size() != 6 ) {
+        CSCI441_LOG_ERROR( "CSCI441::AsyncTextureLoader::loadCubeMapTexture(): Expected 6 faces, received %zu", faces.size() );
+        return 0;
+    }
+
+    GLuint texHandle;
+    glGenTextures( 1, &texHandle );
+    glBindTexture(   GL_TEXTURE_CUBE_MAP,  texHandle );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP,  GL_TEXTURE_MIN_FILTER, minFilter );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP,  GL_TEXTURE_MAG_FILTER, magFilter );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP,  GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP,  GL_TEXTURE_WRAP_T,     GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP,  GL_TEXTURE_WRAP_R,     GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_CUBE_MAP,  GL_TEXTURE_MAX_LEVEL,  0 );
+    for( GLenum i = 0; i < 6; i++ ) {
+        _setPlaceholder( GL_TEXTURE_CUBE_MAP_POSITIVE_X + i );
+    }
+
+    const bool MIPMAPS = (minFilter != GL_NEAREST && minFilter != GL_LINEAR);
+    const GLuint64 REQUEST = _nextRequest++;
+    _pendingTextures[ texHandle ] = { REQUEST, GL_TEXTURE_CUBE_MAP, 6, MIPMAPS, false, 0, 0, false };
+    _failedTextures.erase( texHandle );
+    for( GLenum i = 0; i < 6; i++ ) {
+        _queue( { texHandle, REQUEST, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, faces[i], false } );
+    }
+
+    return texHandle;
+}
+
+[[maybe_unused]]
+inline void CSCI441::AsyncTextureLoader::update() {
+    {
+        std::lock_guard<std::mutex> lock( _decodedMutex );
+        while( !_decoded.empty() ) {
+            _uploads.push_back( _decoded.front() );
+            _decoded.pop_front();
+        }
+    }
+
+    size_t budget = _bytesPerFrame;
+    bool uploadedAny = false;
+    while( !_uploads.empty() && (budget > 0 || !uploadedAny) ) {
+        DecodedImage& image = _uploads.front();
+        // cancelled or evicted since it was queued, or its texture name now belongs to another texture
+        PendingTexture* pPending = _findPending( image.job );
+        if( pPending == nullptr ) {
+            stbi_image_free( image.data );
+            _uploads.pop_front();
+            continue;
+        }
+        if( !pPending->failed && _isUploadable( *pPending, image ) ) {
+            _upload( *pPending, image, budget );
+            uploadedAny = true;
+            if( image.rowsUploaded < image.height ) continue;
+        } else {
+            // the remaining layers are still counted so the texture finishes once all have arrived
+            pPending->failed = true;
+        }
+        _finishImage( image );
+        _uploads.pop_front();
+    }
+}
+
+[[maybe_unused]]
+inline void CSCI441::AsyncTextureLoader::finish() {
+    const size_t BUDGET = _bytesPerFrame;
+    _bytesPerFrame = static_cast<size_t>(-1);
+    while( !_pendingTextures.empty() ) {
+        update();
+        if( !_pendingTextures.empty() ) std::this_thread::yield();
+    }
+    _bytesPerFrame = BUDGET;
+}
+
+[[maybe_unused]]
+inline void CSCI441::AsyncTextureLoader::cancel( const GLuint textureHandle ) {
+    _pendingTextures.erase( textureHandle );
+    _failedTextures.erase( textureHandle );
+}
+
+[[maybe_unused]]
+inline bool CSCI441::AsyncTextureLoader::isResident( const GLuint textureHandle ) const {
+    return _pendingTextures.find( textureHandle ) == _pendingTextures.end() && !hasFailed( textureHandle );
+}
+
+[[maybe_unused]]
+inline bool CSCI441::AsyncTextureLoader::hasFailed( const GLuint textureHandle ) const {
+    return _failedTextures.find( textureHandle ) != _failedTextures.end();
+}
+
+[[maybe_unused]]
+inline size_t CSCI441::AsyncTextureLoader::estimateBytes( const char* filename, const int numLayers, const bool mipmaps ) {
+    int width, height, channels;
+    if( !stbi_info( filename, &width, &height, &channels ) ) return 0;
+    // drivers pad RGB to RGBA
+    size_t bytes = static_cast<size_t>(width) * static_cast<size_t>(height) * 4 * numLayers;
+    if( mipmaps ) bytes = bytes * 4 / 3;
+    return bytes;
+}
+
+//**********************************************************************************
+// Private implementations
+
+inline void CSCI441::AsyncTextureLoader::_workerLoop() {
+    CSCI441_PROFILE_THREAD_NAME( "Texture Decode" );
+    while( true ) {
+        DecodeJob job;
+        {
+            std::unique_lock<std::mutex> lock( _jobMutex );
+            _jobCondition.wait( lock, [this]() { return _stopWorkers || !_jobs.empty(); } );
+            if( _stopWorkers ) return;
+            job = _jobs.front();
+            _jobs.pop_front();
+        }
+
+        CSCI441_PROFILE_ZONE( "Decode Texture" );
+        DecodedImage image = { job, 0, 0, 0, nullptr, 0 };
+        image.data = stbi_load( job.filename.c_str(), &image.width, &image.height, &image.channels, 0 );
+
+        if( image.data != nullptr && job.flipOnY ) {
+            TextureUtils::flipImageRows( image.data, image.width, image.height, image.channels );
+        }
+
+        std::lock_guard<std::mutex> lock( _decodedMutex );
+        _decoded.push_back( image );
+    }
+}
+
+inline void CSCI441::AsyncTextureLoader::_queue( const DecodeJob& job ) {
+    {
+        std::lock_guard<std::mutex> lock( _jobMutex );
+        _jobs.push_back( job );
+    }
+    _jobCondition.notify_one();
+}
+
+inline CSCI441::AsyncTextureLoader::PendingTexture* CSCI441::AsyncTextureLoader::_findPending( const DecodeJob& job ) {
+    auto pendingIter = _pendingTextures.find( job.textureHandle );
+    if( pendingIter == _pendingTextures.end() || pendingIter->second.request != job.request ) return nullptr;
+    return &pendingIter->second;
+}
+
+inline bool CSCI441::AsyncTextureLoader::_isUploadable( const PendingTexture& pending, const DecodedImage& image ) {
+    if( image.data == nullptr ) {
+        CSCI441_LOG_ERROR( "CSCI441::AsyncTextureLoader::update(): Could not load texture \"%s\"", image.job.filename.c_str() );
+        return false;
+    }
+    if( pending.allocated && (image.width != pending.width || image.height != pending.height) ) {
+        CSCI441_LOG_ERROR( "CSCI441::AsyncTextureLoader::update(): Cube map face \"%s\" is %dx%d, the texture was allocated at %dx%d",
+                           image.job.filename.c_str(), image.width, image.height, pending.width, pending.height );
+        return false;
+    }
+    return true;
+}
+
+inline void CSCI441::AsyncTextureLoader::_upload( PendingTexture& pending, DecodedImage& image, size_t& budget ) {
+    glBindTexture( pending.bindTarget, image.job.textureHandle );
+    if( !pending.allocated ) _allocate( pending, image );
+
+    const size_t ROW_BYTES = static_cast<size_t>(image.width) * image.channels;
+    const int ROWS_REMAINING = image.height - image.rowsUploaded;
+    const int NUM_ROWS = std::clamp( static_cast<int>(budget / ROW_BYTES), 1, ROWS_REMAINING );
+    const size_t NUM_BYTES = ROW_BYTES * NUM_ROWS;
+
+    // cycle through the PBOs so the driver is never asked to overwrite one still being read
+    const GLuint PBO = _pbos[ _currentPBO ];
+    glBindBuffer( GL_PIXEL_UNPACK_BUFFER, PBO );
+    if( _pboSizes[ _currentPBO ] < NUM_BYTES ) {
+        _pboSizes[ _currentPBO ] = NUM_BYTES;
+    }
+    glBufferData( GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(_pboSizes[ _currentPBO ]), nullptr, GL_STREAM_DRAW );
+    void* pMapped = glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(NUM_BYTES), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT );
+    if( pMapped != nullptr ) {
+        memcpy( pMapped, image.data + ROW_BYTES * image.rowsUploaded, NUM_BYTES );
+        glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER );
+
+        GLint unpackAlignment;
+        glGetIntegerv( GL_UNPACK_ALIGNMENT, &unpackAlignment );
+        glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+        glTexSubImage2D( image.job.target, 0, 0, image.rowsUploaded, image.width, NUM_ROWS, _format( image.channels ), GL_UNSIGNED_BYTE, nullptr );
+        glPixelStorei( GL_UNPACK_ALIGNMENT, unpackAlignment );
+    }
+    glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+    _currentPBO = (_currentPBO + 1) % NUM_PBOS;
+
+    image.rowsUploaded += NUM_ROWS;
+    budget -= std::min( budget, NUM_BYTES );
+}
+
+inline void CSCI441::AsyncTextureLoader::_allocate( PendingTexture& pending, const DecodedImage& image ) {
+    // every face of a cube map must be the same size to be complete, so all are
+    // sized by the first one to arrive and later faces of another size are rejected
+    const GLenum FORMAT = _format( image.channels );
+    const GLint INTERNAL_FORMAT = (image.channels == 4 ? GL_RGBA : GL_RGB);
+    if( pending.bindTarget == GL_TEXTURE_CUBE_MAP ) {
+        for( GLenum i = 0; i < 6; i++ ) {
+            glTexImage2D( GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, INTERNAL_FORMAT, image.width, image.height, 0, FORMAT, GL_UNSIGNED_BYTE, nullptr );
+        }
+    } else {
+        glTexImage2D( image.job.target, 0, INTERNAL_FORMAT, image.width, image.height, 0, FORMAT, GL_UNSIGNED_BYTE, nullptr );
+    }
+    pending.allocated = true;
+    pending.width = image.width;
+    pending.height = image.height;
+}
+
+inline void CSCI441::AsyncTextureLoader::_finishImage( const DecodedImage& image ) {
+    stbi_image_free( image.data );
+
+    auto pendingIter = _pendingTextures.find( image.job.textureHandle );
+    if( pendingIter == _pendingTextures.end() || pendingIter->second.request != image.job.request ) return;
+
+    PendingTexture& pending = pendingIter->second;
+    if( --pending.layersRemaining > 0 ) return;
+
+    if( pending.failed ) {
+        // a partially uploaded texture would sample garbage, so go back to the placeholder
+        glBindTexture( pending.bindTarget, image.job.textureHandle );
+        if( pending.bindTarget == GL_TEXTURE_CUBE_MAP ) {
+            for( GLenum i = 0; i < 6; i++ ) _setPlaceholder( GL_TEXTURE_CUBE_MAP_POSITIVE_X + i );
+        } else {
+            _setPlaceholder( pending.bindTarget );
+        }
+        CSCI441_LOG_ERROR( "CSCI441::AsyncTextureLoader::update(): Texture with handle %u failed to load and keeps its placeholder", image.job.textureHandle );
+        _failedTextures.insert( image.job.textureHandle );
+    } else {
+        if( pending.mipmaps && pending.allocated ) {
+            glBindTexture( pending.bindTarget, image.job.textureHandle );
+            glTexParameteri( pending.bindTarget, GL_TEXTURE_MAX_LEVEL, 1000 );
+            glGenerateMipmap( pending.bindTarget );
+        }
+        CSCI441_LOG_INFO( "Successfully loaded texture \"%s\" with handle %u", image.job.filename.c_str(), image.job.textureHandle );
+    }
+    _pendingTextures.erase( pendingIter );
+}
+
+inline void CSCI441::AsyncTextureLoader::_setPlaceholder( const GLenum target ) {
+    // 2x2 grey checkerboard
+    static const unsigned char PLACEHOLDER[16] = { 96, 96, 96, 255,    160, 160, 160, 255,
+                                                   160, 160, 160, 255, 96, 96, 96, 255 };
+    glTexImage2D( target, 0, GL_RGBA, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, PLACEHOLDER );
+}
+
+inline GLenum CSCI441::AsyncTextureLoader::_format( const int channels ) {
+    switch( channels ) {
+        case 1:  return GL_RED;
+        case 2:  return GL_RG;
+        case 3:  return GL_RGB;
+        default: return GL_RGBA;
+    }
+}
+
+#endif // CSCI441_ASYNC_TEXTURE_LOADER_HPP
@@ -0,0 +1,456 @@
+/** @file CPUSkinner.hpp
+ * @brief SIMD, multithreaded linear blend skinning on the CPU
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Used when vertices cannot be skinned in the vertex shader.  At load time the
+ *	weights of each mesh are sorted into groups of vertices with the same number
+ *	of influences and stored as structure-of-arrays streams, with the bias already
+ *	multiplied into each weight position.  Each frame the skeleton is converted
+ *	once to 3x4 joint matrices, then every group is skinned four vertices at a
+ *	time with SSE, split into ranges across worker threads.  The worker threads
+ *	belong to a WorkerPool shared by every skinner in the process, so a skinner
+ *	only holds the streams of its own meshes.
+ *
+ *	The result is identical to summing bias * (jointPosition + jointOrientation * weightPosition)
+ *	over each vertex's weights, as MD5 meshes are defined.
+ *
+ *	@warning This header file depends upon glm
+ */
+
+#ifndef CSCI441_CPU_SKINNER_HPP
+#define CSCI441_CPU_SKINNER_HPP
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CSCI441_CPU_SKINNER_SSE
+    #include <xmmintrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class CPUSkinner
+     * @brief skins the meshes of a skeletal model on the CPU
+     */
+    class [[maybe_unused]] CPUSkinner final {
+    public:
+        /**
+         * @brief most weights kept per vertex, vertices with more keep their largest renormalized
+         */
+        static constexpr GLuint MAX_INFLUENCES = 8;
+
+        /**
+         * @class WorkerPool
+         * @brief threads that skin the vertex ranges of one mesh at a time, shared between skinners
+         */
+        class [[maybe_unused]] WorkerPool final {
+        public:
+            /**
+             * @brief starts the worker threads
+             * @param numThreads number of threads working in parallel including the calling thread
+             * (default: 0 which uses one per hardware thread)
+             */
+            explicit WorkerPool( GLuint numThreads = 0 );
+            /**
+             * @brief stops the worker threads
+             */
+            ~WorkerPool();
+
+            /**
+             * @brief do not allow pools to be copied
+             */
+            WorkerPool(const WorkerPool&) = delete;
+            /**
+             * @brief do not allow pools to be copied
+             */
+            WorkerPool& operator=(const WorkerPool&) = delete;
+
+            /**
+             * @brief returns the pool used by skinners created without one, started on first use
+             */
+            static WorkerPool& shared();
+
+            /**
+             * @brief calls task once for each index in [0, numTasks) across the workers and the calling thread
+             * @param numTasks number of tasks to run
+             * @param task function run for each task index
+             * @note returns once every task has finished.  calls from several threads run one after another
+             */
+            [[maybe_unused]] void run( size_t numTasks, const std::function<void(size_t)>& task );
+
+            /**
+             * @brief returns the number of threads working in parallel, including the calling thread
+             */
+            [[maybe_unused]] [[nodiscard]] GLuint getNumberOfThreads() const { return static_cast<GLuint>( _workers.size() ) + 1; }
+
+        private:
+            void _workerLoop();
+
+            std::vector< std::thread > _workers;
+            std::mutex _runMutex;                               // one job at a time
+            std::mutex _jobMutex;
+            std::condition_variable _jobCondition;
+            std::condition_variable _doneCondition;
+            const std::function<void(size_t)>* _jobTask;
+            size_t _jobSize;
+            std::atomic<size_t> _nextTask;
+            size_t _activeWorkers;
+            GLuint _jobGeneration;
+            bool _stop;
+        };
+
+        /**
+         * @brief creates a skinner without any meshes
+         * @param pWorkers pool skinning the vertex ranges (default: nullptr which uses WorkerPool::shared())
+         * @note the pool must outlive the skinner
+         */
+        explicit CPUSkinner( WorkerPool* pWorkers = nullptr );
+
+        /**
+         * @brief do not allow skinners to be copied
+         */
+        CPUSkinner(const CPUSkinner&) = delete;
+        /**
+         * @brief do not allow skinners to be copied
+         */
+        CPUSkinner& operator=(const CPUSkinner&) = delete;
+
+        /**
+         * @brief sorts the weights of a mesh into skinning streams
+         * @tparam Vertex vertex type with GLint members start and count indexing the weight array
+         * @tparam Weight weight type with members GLint joint, GLfloat bias, and glm::vec3 position
+         * @param vertices array of mesh vertices
+         * @param numVertices number of vertices in the array
+         * @param weights array of mesh weights
+         * @returns index of the mesh to pass to skin()
+         */
+        template<typename Vertex, typename Weight>
+        [[maybe_unused]] GLuint addMesh( const Vertex* vertices, GLint numVertices, const Weight* weights );
+
+        /**
+         * @brief converts the current skeleton pose to joint matrices
+         * @tparam Joint joint type with members glm::vec3 position and glm::quat orientation
+         * @param joints array of joints in object space
+         * @param numJoints number of joints in the array
+         * @note call once per frame before skinning any mesh of the model
+         */
+        template<typename Joint>
+        [[maybe_unused]] void setPose( const Joint* joints, GLint numJoints );
+
+        /**
+         * @brief computes the skinned vertex positions of a mesh for the current pose
+         * @param mesh index returned by addMesh()
+         * @param positions array of at least as many entries as the mesh has vertices
+         */
+        [[maybe_unused]] void skin( GLuint mesh, glm::vec3* positions );
+
+        /**
+         * @brief returns the number of threads skinning in parallel, including the calling thread
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint getNumberOfThreads() const { return _pWorkers->getNumberOfThreads(); }
+
+    private:
+        // vertices sharing a number of influences, streams indexed [influence * numVertices + vertex]
+        struct InfluenceGroup {
+            GLuint numInfluences = 0;
+            GLuint numVertices = 0;
+            std::vector<GLuint> vertexIndices;
+            std::vector<GLuint> jointOffsets;       // joint index * 12
+            std::vector<GLfloat> x, y, z;           // bias * weight position
+            std::vector<GLfloat> bias;
+        };
+        struct Mesh {
+            std::vector<InfluenceGroup> groups;
+        };
+        // a range of vertices of one group, the unit of work handed to threads
+        struct Range {
+            const InfluenceGroup* group;
+            GLuint begin, end;
+        };
+
+        static constexpr GLuint RANGE_SIZE = 2048;
+
+        std::vector<Mesh> _meshes;
+        std::vector<GLfloat> _jointMatrices;       // row major 3x4 per joint
+
+        std::vector<Range> _ranges;                 // ranges of the mesh being skinned
+
+        WorkerPool* _pWorkers;
+
+        static void _skinRange( const Range& range, const GLfloat* jointMatrices, glm::vec3* positions );
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+inline CSCI441::CPUSkinner::WorkerPool::WorkerPool( const GLuint numThreads )
+    : _jobTask(nullptr), _jobSize(0), _nextTask(0), _activeWorkers(0), _jobGeneration(0), _stop(false) {
+    GLuint threads = numThreads;
+    if( threads == 0 ) threads = std::max( 1u, std::thread::hardware_concurrency() );
+    for( GLuint i = 1; i < threads; i++ ) {
+        _workers.emplace_back( &WorkerPool::_workerLoop, this );
+    }
+}
+
+inline CSCI441::CPUSkinner::WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock( _jobMutex );
+        _stop = true;
+    }
+    _jobCondition.notify_all();
+    for( auto& worker : _workers ) worker.join();
+}
+
+inline CSCI441::CPUSkinner::WorkerPool& CSCI441::CPUSkinner::WorkerPool::shared() {
+    static WorkerPool sWorkers;
+    return sWorkers;
+}
+
+[[maybe_unused]]
+inline void CSCI441::CPUSkinner::WorkerPool::run( const size_t numTasks, const std::function<void(size_t)>& task ) {
+    // small jobs are not worth waking the workers
+    if( _workers.empty() || numTasks <= 1 ) {
+        for( size_t t = 0; t < numTasks; t++ ) task( t );
+        return;
+    }
+
+    std::lock_guard<std::mutex> runLock( _runMutex );
+    {
+        std::lock_guard<std::mutex> lock( _jobMutex );
+        _jobTask = &task;
+        _jobSize = numTasks;
+        _nextTask = 0;
+        _activeWorkers = _workers.size();
+        _jobGeneration++;
+    }
+    _jobCondition.notify_all();
+
+    // the calling thread works through tasks as well
+    for( size_t t = _nextTask++; t < numTasks; t = _nextTask++ ) {
+        task( t );
+    }
+
+    std::unique_lock<std::mutex> lock( _jobMutex );
+    _doneCondition.wait( lock, [this] { return _activeWorkers == 0; } );
+    _jobTask = nullptr;
+}
+
+inline CSCI441::CPUSkinner::CPUSkinner( WorkerPool* pWorkers )
+    : _pWorkers( pWorkers != nullptr ? pWorkers : &WorkerPool::shared() ) {
+}
+
+template<typename Vertex, typename Weight>
+[[maybe_unused]]
+inline GLuint CSCI441::CPUSkinner::addMesh( const Vertex* vertices, const GLint numVertices, const Weight* weights ) {
+    Mesh mesh;
+    mesh.groups.resize( MAX_INFLUENCES );
+    for( GLuint i = 0; i < MAX_INFLUENCES; i++ ) mesh.groups[i].numInfluences = i + 1;
+
+    // bucket vertices by influence count, keeping the largest weights
+    std::vector< std::vector< std::pair<GLuint, std::vector<const Weight*>> > > buckets( MAX_INFLUENCES );
+    for( GLint v = 0; v < numVertices; v++ ) {
+        std::vector<const Weight*> influences;
+        for( GLint w = 0; w < vertices[v].count; w++ ) influences.push_back( &weights[ vertices[v].start + w ] );
+        if( influences.empty() ) continue;
+        std::stable_sort( influences.begin(), influences.end(), []( const Weight* a, const Weight* b ) { return a->bias > b->bias; } );
+        if( influences.size() > MAX_INFLUENCES ) influences.resize( MAX_INFLUENCES );
+        buckets[ influences.size() - 1 ].emplace_back( static_cast<GLuint>(v), std::move(influences) );
+    }
+
+    for( GLuint g = 0; g < MAX_INFLUENCES; g++ ) {
+        InfluenceGroup& group = mesh.groups[g];
+        const auto& bucket = buckets[g];
+        const auto n = static_cast<GLuint>( bucket.size() );
+        group.numVertices = n;
+        group.vertexIndices.resize( n );
+        group.jointOffsets.resize( n * group.numInfluences );
+        group.x.resize( n * group.numInfluences );
+        group.y.resize( n * group.numInfluences );
+        group.z.resize( n * group.numInfluences );
+        group.bias.resize( n * group.numInfluences );
+
+        for( GLuint v = 0; v < n; v++ ) {
+            group.vertexIndices[v] = bucket[v].first;
+
+            // renormalize only if weights were dropped so exact inputs stay exact
+            GLfloat scale = 1.0f;
+            if( static_cast<GLint>( group.numInfluences ) < vertices[ bucket[v].first ].count ) {
+                GLfloat total = 0.0f;
+                for( const auto* weight : bucket[v].second ) total += weight->bias;
+                if( total > 0.0f ) scale = 1.0f / total;
+            }
+
+            for( GLuint s = 0; s < group.numInfluences; s++ ) {
+                const Weight* weight = bucket[v].second[s];
+                const GLfloat bias = weight->bias * scale;
+                const GLuint stream = s * n + v;
+                group.jointOffsets[stream] = static_cast<GLuint>( weight->joint ) * 12;
+                group.x[stream] = weight->position.x * bias;
+                group.y[stream] = weight->position.y * bias;
+                group.z[stream] = weight->position.z * bias;
+                group.bias[stream] = bias;
+            }
+        }
+    }
+
+    // drop empty groups so skinning only visits populated streams
+    mesh.groups.erase( std::remove_if( mesh.groups.begin(), mesh.groups.end(), []( const InfluenceGroup& group ) { return group.numVertices == 0; } ), mesh.groups.end() );
+
+    _meshes.push_back( std::move(mesh) );
+    return static_cast<GLuint>( _meshes.size() - 1 );
+}
+
+template<typename Joint>
+[[maybe_unused]]
+inline void CSCI441::CPUSkinner::setPose( const Joint* joints, const GLint numJoints ) {
+    _jointMatrices.resize( static_cast<size_t>(numJoints) * 12 );
+    for( GLint j = 0; j < numJoints; j++ ) {
+        const glm::mat3 rotation = glm::mat3_cast( joints[j].orientation );
+        GLfloat* m = &_jointMatrices[ static_cast<size_t>(j) * 12 ];
+        for( GLint row = 0; row < 3; row++ ) {
+            m[row * 4 + 0] = rotation[0][row];
+            m[row * 4 + 1] = rotation[1][row];
+            m[row * 4 + 2] = rotation[2][row];
+            m[row * 4 + 3] = joints[j].position[row];
+        }
+    }
+}
+
+[[maybe_unused]]
+inline void CSCI441::CPUSkinner::skin( const GLuint mesh, glm::vec3* positions ) {
+    if( mesh >= _meshes.size() || _jointMatrices.empty() ) return;
+
+    _ranges.clear();
+    for( const auto& group : _meshes[mesh].groups ) {
+        for( GLuint begin = 0; begin < group.numVertices; begin += RANGE_SIZE ) {
+            _ranges.push_back( { &group, begin, std::min( begin + RANGE_SIZE, group.numVertices ) } );
+        }
+    }
+
+    // captures a single pointer so the task fits in std::function without allocating
+    struct Job {
+        const CPUSkinner* skinner;
+        glm::vec3* positions;
+    } job = { this, positions };
+    _pWorkers->run( _ranges.size(), [&job]( const size_t r ) {
+        _skinRange( job.skinner->_ranges[r], job.skinner->_jointMatrices.data(), job.positions );
+    } );
+}
+
+//**********************************************************************************
+// Internal implementations
+
+inline void CSCI441::CPUSkinner::WorkerPool::_workerLoop() {
+    GLuint seenGeneration = 0;
+    while( true ) {
+        const std::function<void(size_t)>* task;
+        size_t numTasks;
+        {
+            std::unique_lock<std::mutex> lock( _jobMutex );
+            _jobCondition.wait( lock, [this, seenGeneration] { return _stop || _jobGeneration != seenGeneration; } );
+            if( _stop ) return;
+            seenGeneration = _jobGeneration;
+            task = _jobTask;
+            numTasks = _jobSize;
+        }
+
+        for( size_t t = _nextTask++; t < numTasks; t = _nextTask++ ) {
+            (*task)( t );
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( _jobMutex );
+            _activeWorkers--;
+        }
+        _doneCondition.notify_one();
+    }
+}
+
+inline void CSCI441::CPUSkinner::_skinRange( const Range& range, const GLfloat* jointMatrices, glm::vec3* positions ) {
+    const InfluenceGroup& group = *range.group;
+    const GLuint n = group.numVertices;
+    GLuint v = range.begin;
+
+#ifdef CSCI441_CPU_SKINNER_SSE
+    // four vertices per iteration, one per SSE lane
+    for( ; v + 4 <= range.end; v += 4 ) {
+        __m128 outX = _mm_setzero_ps(), outY = _mm_setzero_ps(), outZ = _mm_setzero_ps();
+        for( GLuint s = 0; s < group.numInfluences; s++ ) {
+            const GLuint stream = s * n + v;
+            const GLuint* joints = &group.jointOffsets[stream];
+            const __m128 px = _mm_loadu_ps( &group.x[stream] );
+            const __m128 py = _mm_loadu_ps( &group.y[stream] );
+            const __m128 pz = _mm_loadu_ps( &group.z[stream] );
+            const __m128 b  = _mm_loadu_ps( &group.bias[stream] );
+
+            // transpose each matrix row of the four lanes' joints into per-element vectors
+            __m128 r0 = _mm_loadu_ps( jointMatrices + joints[0] );
+            __m128 r1 = _mm_loadu_ps( jointMatrices + joints[1] );
+            __m128 r2 = _mm_loadu_ps( jointMatrices + joints[2] );
+            __m128 r3 = _mm_loadu_ps( jointMatrices + joints[3] );
+            _MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+            outX = _mm_add_ps( outX, _mm_add_ps( _mm_add_ps( _mm_mul_ps( r0, px ), _mm_mul_ps( r1, py ) ), _mm_add_ps( _mm_mul_ps( r2, pz ), _mm_mul_ps( r3, b ) ) ) );
+
+            r0 = _mm_loadu_ps( jointMatrices + joints[0] + 4 );
+            r1 = _mm_loadu_ps( jointMatrices + joints[1] + 4 );
+            r2 = _mm_loadu_ps( jointMatrices + joints[2] + 4 );
+            r3 = _mm_loadu_ps( jointMatrices + joints[3] + 4 );
+            _MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+            outY = _mm_add_ps( outY, _mm_add_ps( _mm_add_ps( _mm_mul_ps( r0, px ), _mm_mul_ps( r1, py ) ), _mm_add_ps( _mm_mul_ps( r2, pz ), _mm_mul_ps( r3, b ) ) ) );
+
+            r0 = _mm_loadu_ps( jointMatrices + joints[0] + 8 );
+            r1 = _mm_loadu_ps( jointMatrices + joints[1] + 8 );
+            r2 = _mm_loadu_ps( jointMatrices + joints[2] + 8 );
+            r3 = _mm_loadu_ps( jointMatrices + joints[3] + 8 );
+            _MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+            outZ = _mm_add_ps( outZ, _mm_add_ps( _mm_add_ps( _mm_mul_ps( r0, px ), _mm_mul_ps( r1, py ) ), _mm_add_ps( _mm_mul_ps( r2, pz ), _mm_mul_ps( r3, b ) ) ) );
+        }
+
+        alignas(16) GLfloat x[4], y[4], z[4];
+        _mm_store_ps( x, outX );
+        _mm_store_ps( y, outY );
+        _mm_store_ps( z, outZ );
+        for( GLuint lane = 0; lane < 4; lane++ ) {
+            positions[ group.vertexIndices[v + lane] ] = glm::vec3( x[lane], y[lane], z[lane] );
+        }
+    }
+#endif
+
+    // remaining vertices, or all of them without SSE
+    for( ; v < range.end; v++ ) {
+        glm::vec3 out( 0.0f );
+        for( GLuint s = 0; s < group.numInfluences; s++ ) {
+            const GLuint stream = s * n + v;
+            const GLfloat* m = jointMatrices + group.jointOffsets[stream];
+            const GLfloat px = group.x[stream], py = group.y[stream], pz = group.z[stream], b = group.bias[stream];
+            out.x += m[0] * px + m[1] * py + m[2]  * pz + m[3]  * b;
+            out.y += m[4] * px + m[5] * py + m[6]  * pz + m[7]  * b;
+            out.z += m[8] * px + m[9] * py + m[10] * pz + m[11] * b;
+        }
+        positions[ group.vertexIndices[v] ] = out;
+    }
+}
+
+#endif // CSCI441_CPU_SKINNER_HPP
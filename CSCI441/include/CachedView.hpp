@@ -0,0 +1,240 @@
+/** @file CachedView.hpp
+ * @brief Offscreen view rendered into a texture at its own resolution and update rate
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	For secondary views such as a picture-in-picture inset or a minimap.  The
+ *	view is drawn between begin() and end() into a color texture with its own
+ *	depth buffer, only on the frames isUpdateDue() allows, and the texture is
+ *	composited every frame, usually as a HUD quad.  At 30 Hz inside a 60 Hz loop
+ *	the view costs half of its draw submission, and its resolution is independent
+ *	of the window.
+ *
+ *	When the view shows the same camera as an image already in a framebuffer,
+ *	copyFrom() scales that image into the texture instead of drawing it again.
+ *
+ *	Create, use and delete it with the context current.
+ */
+
+#ifndef CSCI441_CACHED_VIEW_HPP
+#define CSCI441_CACHED_VIEW_HPP
+
+#include "Logger.hpp"
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class CachedView
+     * @brief texture render target refreshed at a fixed rate
+     */
+    class [[maybe_unused]] CachedView final {
+    public:
+        /**
+         * @brief creates the texture and depth buffer
+         * @param width width of the texture in pixels
+         * @param height height of the texture in pixels
+         * @param updateRate refreshes per second, 0 to refresh every frame
+         */
+        CachedView( GLint width, GLint height, GLfloat updateRate = 0.0f );
+        /**
+         * @brief deletes the texture, depth buffer and framebuffer
+         */
+        ~CachedView();
+
+        /**
+         * @brief do not allow views to be copied
+         */
+        CachedView(const CachedView&) = delete;
+        /**
+         * @brief do not allow views to be copied
+         */
+        CachedView& operator=(const CachedView&) = delete;
+
+        /**
+         * @brief reallocates the texture at a new size, the next isUpdateDue() returns true
+         */
+        [[maybe_unused]] void resize( GLint width, GLint height );
+        /**
+         * @brief sets the refreshes per second, 0 to refresh every frame
+         */
+        [[maybe_unused]] void setUpdateRate( GLfloat updateRate ) noexcept { _updateInterval = updateRate > 0.0f ? 1.0f / updateRate : 0.0f; }
+        /**
+         * @brief makes the next isUpdateDue() return true, e.g. when the view is shown again
+         */
+        [[maybe_unused]] void invalidate() noexcept { _isValid = false; }
+
+        /**
+         * @brief advances the view's clock and returns true if it should be refreshed this frame
+         * @param deltaTime seconds since the previous frame
+         * @note call once per frame, also on frames the view is not refreshed
+         */
+        [[maybe_unused]] [[nodiscard]] bool isUpdateDue( GLfloat deltaTime );
+
+        /**
+         * @brief binds and clears the view's framebuffer and sets the viewport to the texture size
+         */
+        [[maybe_unused]] void begin();
+        /**
+         * @brief binds the default framebuffer again, the caller restores its viewport
+         */
+        [[maybe_unused]] void end();
+        /**
+         * @brief scales a rectangle of the bound read framebuffer into the texture
+         */
+        [[maybe_unused]] void copyFrom( GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1 );
+
+        /**
+         * @brief returns the color texture, lower left origin
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint getTexture() const noexcept { return _colorTexture; }
+        /**
+         * @brief returns the width of the texture in pixels
+         */
+        [[maybe_unused]] [[nodiscard]] GLint getWidth() const noexcept { return _width; }
+        /**
+         * @brief returns the height of the texture in pixels
+         */
+        [[maybe_unused]] [[nodiscard]] GLint getHeight() const noexcept { return _height; }
+        /**
+         * @brief returns the width over the height of the texture
+         */
+        [[maybe_unused]] [[nodiscard]] GLfloat getAspectRatio() const noexcept { return static_cast<GLfloat>(_width) / static_cast<GLfloat>(_height); }
+        /**
+         * @brief returns how many times the view was drawn or copied
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint64 getNumberOfUpdates() const noexcept { return _numUpdates; }
+
+    private:
+        GLint _width;
+        GLint _height;
+        GLuint _fbo;
+        GLuint _colorTexture;
+        GLuint _depthRBO;
+
+        GLfloat _updateInterval;
+        GLfloat _timeSinceUpdate;
+        bool _isValid;
+        GLuint64 _numUpdates;
+
+        void _createTarget();
+        void _deleteTarget();
+    };
+}
+
+//**********************************************************************************
+//**********************************************************************************
+// Outward facing function implementations
+
+inline CSCI441::CachedView::CachedView( const GLint width, const GLint height, const GLfloat updateRate ) :
+    _width( width ),
+    _height( height ),
+    _fbo( 0 ),
+    _colorTexture( 0 ),
+    _depthRBO( 0 ),
+    _updateInterval( 0.0f ),
+    _timeSinceUpdate( 0.0f ),
+    _isValid( false ),
+    _numUpdates( 0 ) {
+
+    setUpdateRate( updateRate );
+    _createTarget();
+}
+
+inline CSCI441::CachedView::~CachedView() {
+    _deleteTarget();
+}
+
+[[maybe_unused]]
+inline void CSCI441::CachedView::resize( const GLint width, const GLint height ) {
+    if( width == _width && height == _height ) return;
+    _width = width;
+    _height = height;
+    _deleteTarget();
+    _createTarget();
+    _isValid = false;
+}
+
+[[maybe_unused]]
+inline bool CSCI441::CachedView::isUpdateDue( const GLfloat deltaTime ) {
+    _timeSinceUpdate += deltaTime;
+    if( _isValid && _timeSinceUpdate < _updateInterval ) return false;
+
+    // keep the phase so 30 Hz in a 60 Hz loop alternates frames, but never bank more than one interval
+    _timeSinceUpdate = _timeSinceUpdate >= 2.0f * _updateInterval ? 0.0f : _timeSinceUpdate - _updateInterval;
+    if( _timeSinceUpdate < 0.0f ) _timeSinceUpdate = 0.0f;
+    _isValid = true;
+    return true;
+}
+
+[[maybe_unused]]
+inline void CSCI441::CachedView::begin() {
+    glBindFramebuffer( GL_FRAMEBUFFER, _fbo );
+    glViewport( 0, 0, _width, _height );
+    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+    _numUpdates++;
+}
+
+[[maybe_unused]]
+inline void CSCI441::CachedView::end() {
+    glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+}
+
+[[maybe_unused]]
+inline void CSCI441::CachedView::copyFrom( const GLint srcX0, const GLint srcY0, const GLint srcX1, const GLint srcY1 ) {
+    GLint readFramebuffer = 0;
+    glGetIntegerv( GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer );
+    glBindFramebuffer( GL_DRAW_FRAMEBUFFER, _fbo );
+    glBlitFramebuffer( srcX0, srcY0, srcX1, srcY1,
+                       0, 0, _width, _height,
+                       GL_COLOR_BUFFER_BIT, GL_LINEAR );
+    glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+    glBindFramebuffer( GL_READ_FRAMEBUFFER, static_cast<GLuint>(readFramebuffer) );
+    _numUpdates++;
+}
+
+//**********************************************************************************
+//**********************************************************************************
+// Internal implementations
+
+inline void CSCI441::CachedView::_createTarget() {
+    glGenTextures( 1, &_colorTexture );
+    glBindTexture( GL_TEXTURE_2D, _colorTexture );
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, _width, _height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+    glBindTexture( GL_TEXTURE_2D, 0 );
+
+    glGenRenderbuffers( 1, &_depthRBO );
+    glBindRenderbuffer( GL_RENDERBUFFER, _depthRBO );
+    glRenderbufferStorage( GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, _width, _height );
+    glBindRenderbuffer( GL_RENDERBUFFER, 0 );
+
+    glGenFramebuffers( 1, &_fbo );
+    glBindFramebuffer( GL_FRAMEBUFFER, _fbo );
+    glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _colorTexture, 0 );
+    glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depthRBO );
+    if( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE ) {
+        CSCI441_LOG_ERROR( "CSCI441::CachedView: %dx%d framebuffer is incomplete", _width, _height );
+    }
+    glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+}
+
+inline void CSCI441::CachedView::_deleteTarget() {
+    if( _fbo != 0 )          glDeleteFramebuffers( 1, &_fbo );
+    if( _colorTexture != 0 ) glDeleteTextures( 1, &_colorTexture );
+    if( _depthRBO != 0 )     glDeleteRenderbuffers( 1, &_depthRBO );
+    _fbo = _colorTexture = _depthRBO = 0;
+}
+
+#endif // CSCI441_CACHED_VIEW_HPP
@@ -0,0 +1,400 @@
+/** @file DrawBatcher.hpp
+ * @brief Batched submission of indexed meshes that share one vertex and element buffer
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Draws are recorded on the CPU as a range of a shared element buffer plus the
+ *	per-draw data the vertex shader would otherwise read from uniforms.  Each state
+ *	bucket is then submitted at once: draws of the same mesh become one instance
+ *	range, and the per-draw data is read as instanced vertex attributes.
+ *
+ *	Where ARB_multi_draw_indirect and ARB_base_instance are available (OpenGL 4.3)
+ *	a bucket is a single glMultiDrawElementsIndirect() call.  On OpenGL 4.1 there is
+ *	no way to offset instanced attributes per draw inside one multi-draw, so each
+ *	distinct mesh of the bucket is one glDrawElementsInstancedBaseVertex() call.
+ *	Either way the number of draw calls depends on the number of distinct meshes,
+ *	not on the number of entities.
+ *
+ *	submit() sorts the bucket in lists taken from FrameArena::forThisThread(), so
+ *	the submitting thread must reset its arena once per frame.
+ *
+ *	The vertex shader declares the per-draw data as attributes instead of uniforms:
+ *
+ *		in mat4 mvpMatrix;
+ *		in mat3 normalMatrix;
+ *		in vec3 materialAmbientColor;
+ *		in vec3 materialDiffuseColor;
+ *		in vec3 materialSpecularColor;
+ *		in float materialShininess;
+ *
+ *	@warning This header file depends upon glm
+ */
+
+#ifndef CSCI441_DRAW_BATCHER_HPP
+#define CSCI441_DRAW_BATCHER_HPP
+
+#include "FrameArena.hpp"
+#include "Logger.hpp"
+#include "VertexFormat.hpp"
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class DrawBatcher
+     * @brief records draws of meshes in a shared buffer and submits each state bucket with as few draw calls as possible
+     */
+    class [[maybe_unused]] DrawBatcher final {
+    public:
+        /**
+         * @brief range of the shared element buffer forming one mesh
+         */
+        struct Mesh {
+            /// number of indices to draw
+            GLuint numIndices = 0;
+            /// offset of the first index, in indices
+            GLuint firstIndex = 0;
+            /// value added to every index to find the vertex
+            GLint baseVertex = 0;
+        };
+
+        /**
+         * @brief per-draw data read by the vertex shader
+         */
+        struct DrawData {
+            /// model view projection matrix
+            glm::mat4 mvpMtx;
+            /// normal matrix
+            glm::mat3 normalMtx;
+            /// material ambient color
+            glm::vec3 materialAmbientColor;
+            /// material diffuse color
+            glm::vec3 materialDiffuseColor;
+            /// material specular color
+            glm::vec3 materialSpecularColor;
+            /// material shininess
+            GLfloat materialShininess;
+        };
+
+        /**
+         * @brief attribute locations of the batched shader program, -1 if unused
+         */
+        struct AttributeLocations {
+            /// vertex position
+            GLint vPos = -1;
+            /// vertex normal
+            GLint vNormal = -1;
+            /// vertex texture coordinate
+            GLint vTexCoord = -1;
+            /// per-draw model view projection matrix, uses four consecutive locations
+            GLint mvpMatrix = -1;
+            /// per-draw normal matrix, uses three consecutive locations
+            GLint normalMatrix = -1;
+            /// per-draw material ambient color
+            GLint materialAmbientColor = -1;
+            /// per-draw material diffuse color
+            GLint materialDiffuseColor = -1;
+            /// per-draw material specular color
+            GLint materialSpecularColor = -1;
+            /// per-draw material shininess
+            GLint materialShininess = -1;
+        };
+
+        /**
+         * @brief creates an empty batcher, setup() must be called once an OpenGL context exists
+         */
+        DrawBatcher() = default;
+        /**
+         * @brief deletes the vertex array and buffers owned by the batcher
+         * @note the shared vertex and element buffers are not deleted
+         */
+        ~DrawBatcher();
+
+        /**
+         * @brief do not allow batchers to be copied
+         */
+        DrawBatcher(const DrawBatcher&) = delete;
+        /**
+         * @brief do not allow batchers to be copied
+         */
+        DrawBatcher& operator=(const DrawBatcher&) = delete;
+
+        /**
+         * @brief creates the vertex array reading the shared buffers and the per-draw data
+         * @param vertexBuffer buffer holding the vertices of every mesh
+         * @param indexBuffer buffer holding the GL_UNSIGNED_INT indices of every mesh
+         * @param vertexFormat layout of the vertex buffer
+         * @param locations attribute locations of the shader program used to submit
+         * @note checks for multi draw indirect support, the context must be current
+         */
+        [[maybe_unused]] void setup( GLuint vertexBuffer, GLuint indexBuffer, const VertexFormat& vertexFormat, const AttributeLocations& locations );
+
+        /**
+         * @brief removes all recorded draws and resets the draw call count
+         * @note call before recording the draws of each view
+         */
+        [[maybe_unused]] void clear();
+
+        /**
+         * @brief records a draw
+         * @param mesh range of the shared buffers to draw
+         * @param drawData per-draw data
+         * @param bucket state bucket to record the draw in (default: 0)
+         */
+        [[maybe_unused]] void add( const Mesh& mesh, const DrawData& drawData, GLuint bucket = 0 );
+
+        /**
+         * @brief draws every recorded draw of a bucket
+         * @param bucket state bucket to submit
+         * @note the shader program and any other state of the bucket must already be bound
+         */
+        [[maybe_unused]] void submit( GLuint bucket = 0 );
+
+        /**
+         * @brief returns if the driver supports submitting a bucket with one glMultiDrawElementsIndirect() call
+         */
+        [[maybe_unused]] [[nodiscard]] bool isMultiDrawIndirectSupported() const { return _multiDrawIndirectSupported; }
+        /**
+         * @brief allows or prevents the multi draw indirect path, to compare it against the OpenGL 4.1 path
+         * @param enabled true to use multi draw indirect where supported
+         */
+        [[maybe_unused]] void setMultiDrawIndirectEnabled( bool enabled ) { _multiDrawIndirectEnabled = enabled; }
+        /**
+         * @brief returns the number of draws recorded since the last clear()
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint getNumberOfDraws() const;
+        /**
+         * @brief returns the number of OpenGL draw calls issued since the last clear()
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint getNumberOfDrawCalls() const { return _numDrawCalls; }
+
+    private:
+        // layout of GL_DRAW_INDIRECT_BUFFER entries
+        struct DrawElementsIndirectCommand {
+            GLuint count;
+            GLuint instanceCount;
+            GLuint firstIndex;
+            GLint baseVertex;
+            GLuint baseInstance;
+        };
+
+        struct Bucket {
+            std::vector<Mesh> meshes;
+            std::vector<DrawData> drawData;
+        };
+
+        GLuint _vaod = 0;
+        GLuint _drawDataVBO = 0;
+        GLuint _commandBuffer = 0;
+        AttributeLocations _locations;
+        bool _multiDrawIndirectSupported = false;
+        bool _multiDrawIndirectEnabled = true;
+
+        std::vector<Bucket> _buckets;
+        GLuint _numDrawCalls = 0;
+
+        void _setDrawAttributePointers( GLuint firstDraw ) const;
+        static bool _isMultiDrawIndirectAvailable();
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+inline CSCI441::DrawBatcher::~DrawBatcher() {
+    glDeleteVertexArrays( 1, &_vaod );
+    glDeleteBuffers( 1, &_drawDataVBO );
+    glDeleteBuffers( 1, &_commandBuffer );
+}
+
+[[maybe_unused]]
+inline void CSCI441::DrawBatcher::setup( const GLuint vertexBuffer, const GLuint indexBuffer, const VertexFormat& vertexFormat, const AttributeLocations& locations ) {
+    _locations = locations;
+    _multiDrawIndirectSupported = _isMultiDrawIndirectAvailable();
+
+    if( _vaod == 0 ) {
+        glGenVertexArrays( 1, &_vaod );
+        glGenBuffers( 1, &_drawDataVBO );
+        glGenBuffers( 1, &_commandBuffer );
+    }
+    glBindVertexArray( _vaod );
+
+    glBindBuffer( GL_ARRAY_BUFFER, vertexBuffer );
+    vertexFormat.setAttributePointers( locations.vPos, locations.vNormal, locations.vTexCoord );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, indexBuffer );
+
+    // per-draw data advances once per instance
+    const GLint drawLocations[] = { locations.mvpMatrix, locations.mvpMatrix + 1, locations.mvpMatrix + 2, locations.mvpMatrix + 3,
+                                    locations.normalMatrix, locations.normalMatrix + 1, locations.normalMatrix + 2,
+                                    locations.materialAmbientColor, locations.materialDiffuseColor,
+                                    locations.materialSpecularColor, locations.materialShininess };
+    const GLint firstLocations[] = { locations.mvpMatrix, locations.mvpMatrix, locations.mvpMatrix, locations.mvpMatrix,
+                                     locations.normalMatrix, locations.normalMatrix, locations.normalMatrix,
+                                     locations.materialAmbientColor, locations.materialDiffuseColor,
+                                     locations.materialSpecularColor, locations.materialShininess };
+    glBindBuffer( GL_ARRAY_BUFFER, _drawDataVBO );
+    for( size_t i = 0; i < sizeof(drawLocations) / sizeof(GLint); i++ ) {
+        if( firstLocations[i] == -1 ) continue;
+        glEnableVertexAttribArray( drawLocations[i] );
+        glVertexAttribDivisor( drawLocations[i], 1 );
+    }
+    _setDrawAttributePointers( 0 );
+
+    glBindVertexArray( 0 );
+}
+
+[[maybe_unused]]
+inline void CSCI441::DrawBatcher::clear() {
+    for( auto& bucket : _buckets ) {
+        bucket.meshes.clear();
+        bucket.drawData.clear();
+    }
+    _numDrawCalls = 0;
+}
+
+[[maybe_unused]]
+inline void CSCI441::DrawBatcher::add( const Mesh& mesh, const DrawData& drawData, const GLuint bucket ) {
+    if( bucket >= _buckets.size() ) _buckets.resize( bucket + 1 );
+    _buckets[bucket].meshes.push_back( mesh );
+    _buckets[bucket].drawData.push_back( drawData );
+}
+
+[[maybe_unused]]
+inline void CSCI441::DrawBatcher::submit( const GLuint bucket ) {
+    if( _vaod == 0 ) {
+        CSCI441_LOG_ERROR( "CSCI441::DrawBatcher::submit(): setup() has not been called" );
+        return;
+    }
+    if( bucket >= _buckets.size() || _buckets[bucket].meshes.empty() ) return;
+    const Bucket& draws = _buckets[bucket];
+    const auto NUM_DRAWS = static_cast<GLuint>( draws.meshes.size() );
+
+    // the submit's scratch lists come from the calling thread's frame arena
+    FrameArena& arena = FrameArena::forThisThread();
+    FrameVector<GLuint> order( NUM_DRAWS, arena );
+    FrameVector<DrawData> sortedDrawData( NUM_DRAWS, arena );
+    FrameVector<DrawElementsIndirectCommand> commands( arena );
+    commands.reserve( NUM_DRAWS );
+
+    // group draws of the same mesh so each group is one instance range; ties keep
+    // the recording order without std::stable_sort, which allocates a buffer per call
+    std::iota( order.begin(), order.end(), 0 );
+    std::sort( order.begin(), order.end(), [&draws]( const GLuint a, const GLuint b ) {
+        const Mesh& lhs = draws.meshes[a];
+        const Mesh& rhs = draws.meshes[b];
+        if( lhs.firstIndex != rhs.firstIndex ) return lhs.firstIndex < rhs.firstIndex;
+        if( lhs.baseVertex != rhs.baseVertex ) return lhs.baseVertex < rhs.baseVertex;
+        if( lhs.numIndices != rhs.numIndices ) return lhs.numIndices < rhs.numIndices;
+        return a < b;
+    } );
+
+    for( GLuint i = 0; i < NUM_DRAWS; i++ ) {
+        const Mesh& mesh = draws.meshes[order[i]];
+        sortedDrawData[i] = draws.drawData[order[i]];
+        if( !commands.empty() ) {
+            DrawElementsIndirectCommand& previous = commands.back();
+            if( previous.firstIndex == mesh.firstIndex && previous.baseVertex == mesh.baseVertex && previous.count == mesh.numIndices ) {
+                previous.instanceCount++;
+                continue;
+            }
+        }
+        commands.push_back( { mesh.numIndices, 1, mesh.firstIndex, mesh.baseVertex, i } );
+    }
+
+    glBindVertexArray( _vaod );
+    glBindBuffer( GL_ARRAY_BUFFER, _drawDataVBO );
+    glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(DrawData) * NUM_DRAWS), sortedDrawData.data(), GL_STREAM_DRAW );
+
+    if( _multiDrawIndirectSupported && _multiDrawIndirectEnabled ) {
+        // baseInstance offsets the per-draw attributes of each command
+        _setDrawAttributePointers( 0 );
+        glBindBuffer( GL_DRAW_INDIRECT_BUFFER, _commandBuffer );
+        glBufferData( GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(sizeof(DrawElementsIndirectCommand) * commands.size()), commands.data(), GL_STREAM_DRAW );
+        glMultiDrawElementsIndirect( GL_TRIANGLES, GL_UNSIGNED_INT, (void*)nullptr, static_cast<GLsizei>(commands.size()), 0 );
+        glBindBuffer( GL_DRAW_INDIRECT_BUFFER, 0 );
+        _numDrawCalls++;
+    } else {
+        // without base instance the per-draw attributes are pointed at each command's range
+        for( const auto& command : commands ) {
+            _setDrawAttributePointers( command.baseInstance );
+            glDrawElementsInstancedBaseVertex( GL_TRIANGLES, static_cast<GLsizei>(command.count), GL_UNSIGNED_INT,
+                                               (void*)(sizeof(GLuint) * command.firstIndex), static_cast<GLsizei>(command.instanceCount), command.baseVertex );
+            _numDrawCalls++;
+        }
+    }
+}
+
+[[maybe_unused]]
+inline GLuint CSCI441::DrawBatcher::getNumberOfDraws() const {
+    GLuint numDraws = 0;
+    for( const auto& bucket : _buckets ) numDraws += static_cast<GLuint>( bucket.meshes.size() );
+    return numDraws;
+}
+
+//**********************************************************************************
+// Internal implementations
+
+inline void CSCI441::DrawBatcher::_setDrawAttributePointers( const GLuint firstDraw ) const {
+    const auto STRIDE = static_cast<GLsizei>( sizeof(DrawData) );
+    const size_t BASE = sizeof(DrawData) * firstDraw;
+    if( _locations.mvpMatrix != -1 ) {
+        for( GLint column = 0; column < 4; column++ ) {
+            glVertexAttribPointer( _locations.mvpMatrix + column, 4, GL_FLOAT, GL_FALSE, STRIDE,
+                                   (void*)(BASE + offsetof(DrawData, mvpMtx) + sizeof(glm::vec4) * column) );
+        }
+    }
+    if( _locations.normalMatrix != -1 ) {
+        for( GLint column = 0; column < 3; column++ ) {
+            glVertexAttribPointer( _locations.normalMatrix + column, 3, GL_FLOAT, GL_FALSE, STRIDE,
+                                   (void*)(BASE + offsetof(DrawData, normalMtx) + sizeof(glm::vec3) * column) );
+        }
+    }
+    if( _locations.materialAmbientColor != -1 ) {
+        glVertexAttribPointer( _locations.materialAmbientColor, 3, GL_FLOAT, GL_FALSE, STRIDE, (void*)(BASE + offsetof(DrawData, materialAmbientColor)) );
+    }
+    if( _locations.materialDiffuseColor != -1 ) {
+        glVertexAttribPointer( _locations.materialDiffuseColor, 3, GL_FLOAT, GL_FALSE, STRIDE, (void*)(BASE + offsetof(DrawData, materialDiffuseColor)) );
+    }
+    if( _locations.materialSpecularColor != -1 ) {
+        glVertexAttribPointer( _locations.materialSpecularColor, 3, GL_FLOAT, GL_FALSE, STRIDE, (void*)(BASE + offsetof(DrawData, materialSpecularColor)) );
+    }
+    if( _locations.materialShininess != -1 ) {
+        glVertexAttribPointer( _locations.materialShininess, 1, GL_FLOAT, GL_FALSE, STRIDE, (void*)(BASE + offsetof(DrawData, materialShininess)) );
+    }
+}
+
+inline bool CSCI441::DrawBatcher::_isMultiDrawIndirectAvailable() {
+    GLint majorVersion = 0, minorVersion = 0;
+    glGetIntegerv( GL_MAJOR_VERSION, &majorVersion );
+    glGetIntegerv( GL_MINOR_VERSION, &minorVersion );
+    if( majorVersion > 4 || (majorVersion == 4 && minorVersion >= 3) ) return true;
+
+    bool hasMultiDrawIndirect = false, hasBaseInstance = false;
+    GLint numExtensions = 0;
+    glGetIntegerv( GL_NUM_EXTENSIONS, &numExtensions );
+    for( GLint i = 0; i < numExtensions; i++ ) {
+        const char* extension = (const char*)glGetStringi( GL_EXTENSIONS, i );
+        if( strcmp( extension, "GL_ARB_multi_draw_indirect" ) == 0 ) hasMultiDrawIndirect = true;
+        if( strcmp( extension, "GL_ARB_base_instance" ) == 0 )       hasBaseInstance = true;
+    }
+    return hasMultiDrawIndirect && hasBaseInstance;
+}
+
+#endif // CSCI441_DRAW_BATCHER_HPP
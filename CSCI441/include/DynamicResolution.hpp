@@ -0,0 +1,316 @@
+/** @file DynamicResolution.hpp
+ * @brief Renders the scene at a reduced resolution that adapts to the GPU frame time
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Between begin() and end() the scene is drawn into an offscreen framebuffer at
+ *	getScale() times the window size.  end() upsamples it with a linear blit into
+ *	the window's back buffer, after which the HUD can be drawn at full resolution.
+ *	At full scale the scene goes straight to the back buffer and nothing is copied.
+ *
+ *	The framebuffer is allocated at full window size and the scaled image uses
+ *	its lower left corner, so changing the scale never reallocates; only resize()
+ *	does.  GPU time between begin() and end() is measured with timestamp queries
+ *	read NUM_TIMER_FRAMES frames later, so the pipeline never stalls on them.
+ *	update() lowers the scale when the scene takes more than SCALE_DOWN_FRACTION
+ *	of the budget and raises it a step at a time once it has stayed under
+ *	SCALE_UP_FRACTION for FRAMES_BEFORE_SCALE_UP frames.  Lowering the resolution
+ *	only saves GPU time, so the scale follows the GPU time alone.
+ *
+ *	Requires OpenGL 3.3 or ARB_timer_query.  Create, use and delete it with the
+ *	context current.
+ */
+
+#ifndef CSCI441_DYNAMIC_RESOLUTION_HPP
+#define CSCI441_DYNAMIC_RESOLUTION_HPP
+
+#include "Logger.hpp"
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class DynamicResolution
+     * @brief offscreen scene target whose resolution keeps the GPU within a frame budget
+     */
+    class [[maybe_unused]] DynamicResolution final {
+    public:
+        /**
+         * @brief frames between issuing a GPU timer query and reading it
+         */
+        static constexpr GLuint NUM_TIMER_FRAMES = 4;
+        /**
+         * @brief the scale drops when the scene takes more than this fraction of the budget
+         */
+        static constexpr GLfloat SCALE_DOWN_FRACTION = 0.9f;
+        /**
+         * @brief the scale rises after the scene stays under this fraction of the budget
+         */
+        static constexpr GLfloat SCALE_UP_FRACTION = 0.7f;
+        /**
+         * @brief consecutive frames under SCALE_UP_FRACTION before raising the scale
+         */
+        static constexpr GLuint FRAMES_BEFORE_SCALE_UP = 30;
+        /**
+         * @brief amount the scale rises at a time
+         */
+        static constexpr GLfloat SCALE_UP_STEP = 0.05f;
+
+        /**
+         * @brief creates a target at full scale, no OpenGL objects are made until resize()
+         * @param minimumScale smallest fraction of the window size to render at
+         * @param maximumScale largest fraction of the window size to render at, at most 1
+         */
+        explicit DynamicResolution( GLfloat minimumScale = 0.5f, GLfloat maximumScale = 1.0f );
+        /**
+         * @brief deletes the framebuffer and queries
+         */
+        ~DynamicResolution();
+
+        /**
+         * @brief do not allow targets to be copied
+         */
+        DynamicResolution(const DynamicResolution&) = delete;
+        /**
+         * @brief do not allow targets to be copied
+         */
+        DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+        /**
+         * @brief sets the window framebuffer size, reallocating the offscreen target when it changes
+         */
+        [[maybe_unused]] void resize( GLint width, GLint height );
+
+        /**
+         * @brief when disabled the scene is always drawn at full scale
+         */
+        [[maybe_unused]] void setEnabled( bool isEnabled ) noexcept { _isEnabled = isEnabled; }
+        /**
+         * @brief returns true if the scale adapts to the GPU time
+         */
+        [[maybe_unused]] [[nodiscard]] bool isEnabled() const noexcept { return _isEnabled; }
+
+        /**
+         * @brief reads finished GPU timings and adjusts the scale for the next frame
+         * @param gpuBudgetMs time the scene may take on the GPU, 0 keeps the current scale
+         * @note call once per frame before begin()
+         */
+        [[maybe_unused]] void update( GLfloat gpuBudgetMs );
+
+        /**
+         * @brief binds and clears the scene target and sets the viewport to the scaled size
+         */
+        [[maybe_unused]] void begin();
+        /**
+         * @brief upsamples the scene into the back buffer, which is left bound with a full size viewport
+         */
+        [[maybe_unused]] void end();
+
+        /**
+         * @brief returns the fraction of the window size the scene is drawn at
+         */
+        [[maybe_unused]] [[nodiscard]] GLfloat getScale() const noexcept { return _isEnabled ? _scale : 1.0f; }
+        /**
+         * @brief returns the width the scene is drawn at
+         */
+        [[maybe_unused]] [[nodiscard]] GLint getRenderWidth() const noexcept { return _scaled( _width ); }
+        /**
+         * @brief returns the height the scene is drawn at
+         */
+        [[maybe_unused]] [[nodiscard]] GLint getRenderHeight() const noexcept { return _scaled( _height ); }
+        /**
+         * @brief returns the last measured GPU time between begin() and end() in milliseconds
+         */
+        [[maybe_unused]] [[nodiscard]] GLfloat getGPUTime() const noexcept { return _gpuTimeMs; }
+
+    private:
+        GLfloat _minimumScale;
+        GLfloat _maximumScale;
+        GLfloat _scale;
+        bool _isEnabled;
+
+        GLint _width;
+        GLint _height;
+        GLuint _fbo;
+        GLuint _colorRBO;
+        GLuint _depthRBO;
+        bool _isUpsampling;                     // set by begin() for this frame
+
+        GLuint _queries[2 * NUM_TIMER_FRAMES];  // begin and end timestamps of each frame in flight
+        bool _isQueryIssued[NUM_TIMER_FRAMES];
+        GLuint _frameIndex;
+        GLfloat _gpuTimeMs;
+        GLuint _numFramesUnderBudget;
+        GLuint _numFramesSinceChange;           // timings of earlier frames still show the old scale
+
+        [[nodiscard]] GLint _scaled( GLint size ) const noexcept;
+        bool _readTimer();
+        void _deleteTarget();
+    };
+}
+
+//**********************************************************************************
+//**********************************************************************************
+// Outward facing function implementations
+
+inline CSCI441::DynamicResolution::DynamicResolution( const GLfloat minimumScale, const GLfloat maximumScale ) :
+    _minimumScale( minimumScale ),
+    _maximumScale( std::min( maximumScale, 1.0f ) ),
+    _scale( std::min( maximumScale, 1.0f ) ),
+    _isEnabled( true ),
+    _width( 0 ),
+    _height( 0 ),
+    _fbo( 0 ),
+    _colorRBO( 0 ),
+    _depthRBO( 0 ),
+    _isUpsampling( false ),
+    _queries(),
+    _isQueryIssued(),
+    _frameIndex( 0 ),
+    _gpuTimeMs( 0.0f ),
+    _numFramesUnderBudget( 0 ),
+    _numFramesSinceChange( 0 ) {
+
+}
+
+inline CSCI441::DynamicResolution::~DynamicResolution() {
+    _deleteTarget();
+    if( _queries[0] != 0 ) {
+        glDeleteQueries( 2 * NUM_TIMER_FRAMES, _queries );
+    }
+}
+
+[[maybe_unused]]
+inline void CSCI441::DynamicResolution::resize( const GLint width, const GLint height ) {
+    if( width == _width && height == _height ) return;
+    _width = width;
+    _height = height;
+
+    _deleteTarget();
+    if( _queries[0] == 0 ) {
+        glGenQueries( 2 * NUM_TIMER_FRAMES, _queries );
+    }
+    // a minimized window has no framebuffer
+    if( width <= 0 || height <= 0 ) return;
+
+    glGenRenderbuffers( 1, &_colorRBO );
+    glBindRenderbuffer( GL_RENDERBUFFER, _colorRBO );
+    glRenderbufferStorage( GL_RENDERBUFFER, GL_RGBA8, width, height );
+    glGenRenderbuffers( 1, &_depthRBO );
+    glBindRenderbuffer( GL_RENDERBUFFER, _depthRBO );
+    glRenderbufferStorage( GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height );
+    glBindRenderbuffer( GL_RENDERBUFFER, 0 );
+
+    glGenFramebuffers( 1, &_fbo );
+    glBindFramebuffer( GL_FRAMEBUFFER, _fbo );
+    glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _colorRBO );
+    glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depthRBO );
+    if( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE ) {
+        CSCI441_LOG_ERROR( "CSCI441::DynamicResolution::resize(): offscreen framebuffer is incomplete, drawing at full resolution" );
+        _deleteTarget();
+    }
+    glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+}
+
+[[maybe_unused]]
+inline void CSCI441::DynamicResolution::update( const GLfloat gpuBudgetMs ) {
+    if( !_readTimer() || !_isEnabled || gpuBudgetMs <= 0.0f ) return;
+
+    if( ++_numFramesSinceChange < NUM_TIMER_FRAMES ) return;
+
+    const GLfloat previousScale = _scale;
+    if( _gpuTimeMs > gpuBudgetMs * SCALE_DOWN_FRACTION ) {
+        // the cost follows the number of pixels, the square of the scale; aim under the threshold
+        const GLfloat ratio = std::sqrt( gpuBudgetMs * SCALE_UP_FRACTION / _gpuTimeMs );
+        _scale *= std::max( 0.75f, std::min( ratio, 0.95f ) );
+        _numFramesUnderBudget = 0;
+    } else if( _gpuTimeMs < gpuBudgetMs * SCALE_UP_FRACTION ) {
+        if( ++_numFramesUnderBudget >= FRAMES_BEFORE_SCALE_UP ) {
+            _scale += SCALE_UP_STEP;
+            _numFramesUnderBudget = 0;
+        }
+    } else {
+        _numFramesUnderBudget = 0;
+    }
+    _scale = std::max( _minimumScale, std::min( _scale, _maximumScale ) );
+    if( _scale != previousScale ) _numFramesSinceChange = 0;
+}
+
+[[maybe_unused]]
+inline void CSCI441::DynamicResolution::begin() {
+    _isUpsampling = _fbo != 0 && getScale() < 1.0f;
+    if( _isUpsampling ) {
+        glBindFramebuffer( GL_FRAMEBUFFER, _fbo );
+        glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+    }
+    glViewport( 0, 0, getRenderWidth(), getRenderHeight() );
+
+    if( _queries[0] != 0 ) {
+        glQueryCounter( _queries[2 * _frameIndex], GL_TIMESTAMP );
+    }
+}
+
+[[maybe_unused]]
+inline void CSCI441::DynamicResolution::end() {
+    if( _queries[0] != 0 ) {
+        glQueryCounter( _queries[2 * _frameIndex + 1], GL_TIMESTAMP );
+        _isQueryIssued[_frameIndex] = true;
+        _frameIndex = ( _frameIndex + 1 ) % NUM_TIMER_FRAMES;
+    }
+
+    if( _isUpsampling ) {
+        glBindFramebuffer( GL_READ_FRAMEBUFFER, _fbo );
+        glBindFramebuffer( GL_DRAW_FRAMEBUFFER, 0 );
+        glBlitFramebuffer( 0, 0, getRenderWidth(), getRenderHeight(),
+                           0, 0, _width, _height,
+                           GL_COLOR_BUFFER_BIT, GL_LINEAR );
+        glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+        _isUpsampling = false;
+    }
+    glViewport( 0, 0, _width, _height );
+}
+
+//**********************************************************************************
+//**********************************************************************************
+// Internal implementations
+
+inline GLint CSCI441::DynamicResolution::_scaled( const GLint size ) const noexcept {
+    if( _fbo == 0 ) return size;
+    return std::max( 1, static_cast<GLint>( std::lround( static_cast<GLfloat>(size) * getScale() ) ) );
+}
+
+inline bool CSCI441::DynamicResolution::_readTimer() {
+    // the slot about to be reused holds the oldest frame in flight
+    if( !_isQueryIssued[_frameIndex] ) return false;
+
+    GLint isAvailable = GL_FALSE;
+    glGetQueryObjectiv( _queries[2 * _frameIndex + 1], GL_QUERY_RESULT_AVAILABLE, &isAvailable );
+    if( !isAvailable ) return false;
+
+    GLuint64 beginTime = 0, endTime = 0;
+    glGetQueryObjectui64v( _queries[2 * _frameIndex], GL_QUERY_RESULT, &beginTime );
+    glGetQueryObjectui64v( _queries[2 * _frameIndex + 1], GL_QUERY_RESULT, &endTime );
+    _isQueryIssued[_frameIndex] = false;
+    _gpuTimeMs = static_cast<GLfloat>( static_cast<double>(endTime - beginTime) / 1.0e6 );
+    return true;
+}
+
+inline void CSCI441::DynamicResolution::_deleteTarget() {
+    if( _fbo != 0 )      glDeleteFramebuffers( 1, &_fbo );
+    if( _colorRBO != 0 ) glDeleteRenderbuffers( 1, &_colorRBO );
+    if( _depthRBO != 0 ) glDeleteRenderbuffers( 1, &_depthRBO );
+    _fbo = _colorRBO = _depthRBO = 0;
+}
+
+#endif // CSCI441_DYNAMIC_RESOLUTION_HPP
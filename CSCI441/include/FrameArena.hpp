@@ -0,0 +1,325 @@
+/** @file FrameArena.hpp
+ * @brief Linear per-frame allocator for transient data, one per thread
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Allocation bumps an offset into a block; nothing is freed individually, the
+ *	whole arena is rewound by reset() at the end of the frame.  When a frame
+ *	needs more than the current block, further blocks are chained on.  The next
+ *	reset() replaces the chain by a single block large enough for that frame, so
+ *	after the first few frames the arena no longer touches the heap.
+ *
+ *	FrameArena::forThisThread() returns the calling thread's arena.  Each thread
+ *	resets its own arena at the end of its frame or step.  FrameArenaAllocator
+ *	adapts an arena to STL containers:
+ *
+ *		CSCI441::FrameVector<GLuint> visible( CSCI441::FrameArena::forThisThread() );
+ *
+ *	@warning memory handed out by an arena, and any container using it, is
+ *	invalid after the next reset() of that arena
+ */
+
+#ifndef CSCI441_FRAME_ARENA_HPP
+#define CSCI441_FRAME_ARENA_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class FrameArena
+     * @brief bump allocator rewound once per frame
+     */
+    class [[maybe_unused]] FrameArena final {
+    public:
+        /**
+         * @brief size of the first block of every arena
+         */
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        /**
+         * @brief creates an arena and registers it for the high water mark report
+         * @param name label used in the report, must outlive the arena
+         * @param blockSize size of the first block in bytes
+         */
+        explicit FrameArena( const char* name = "Frame Arena", size_t blockSize = DEFAULT_BLOCK_SIZE );
+        /**
+         * @brief frees all blocks and keeps the arena's last statistics in the report
+         */
+        ~FrameArena();
+
+        /**
+         * @brief do not allow arenas to be copied
+         */
+        FrameArena(const FrameArena&) = delete;
+        /**
+         * @brief do not allow arenas to be copied
+         */
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        /**
+         * @brief returns the calling thread's arena, created on first use
+         */
+        [[maybe_unused]] static FrameArena& forThisThread();
+
+        /**
+         * @brief renames the arena in the report
+         * @param name label used in the report, must outlive the arena
+         */
+        [[maybe_unused]] void setName( const char* name );
+
+        /**
+         * @brief returns uninitialized memory valid until the next reset()
+         * @param bytes size of the allocation
+         * @param alignment power of two alignment of the allocation, at most alignof(std::max_align_t)
+         */
+        [[maybe_unused]] [[nodiscard]] void* allocate( size_t bytes, size_t alignment = alignof(std::max_align_t) );
+        /**
+         * @brief returns uninitialized storage for count objects of type T, valid until the next reset()
+         */
+        template<typename T>
+        [[maybe_unused]] [[nodiscard]] T* allocate( size_t count ) { return static_cast<T*>( allocate( sizeof(T) * count, alignof(T) ) ); }
+
+        /**
+         * @brief rewinds the arena, invalidating every allocation made since the last reset
+         * @note if the frame spilled into more than one block, they are replaced by one block that fits the frame
+         */
+        [[maybe_unused]] void reset();
+
+        /**
+         * @brief returns the number of bytes allocated since the last reset, including alignment padding
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getBytesUsed() const { return _blockOffset + _previousBlocksUsed; }
+        /**
+         * @brief returns the most bytes used in a single frame
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getHighWaterMark() const { return _highWaterMark.load( std::memory_order_relaxed ); }
+        /**
+         * @brief returns the total size of the arena's blocks
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getCapacity() const { return _capacity.load( std::memory_order_relaxed ); }
+
+        /**
+         * @brief writes the high water mark and capacity of every arena created so far
+         * @param fp stream to write to
+         */
+        [[maybe_unused]] static void writeReport( FILE* fp = stdout );
+
+    private:
+        struct Block {
+            Block* previous;
+            size_t size;
+            // the data follows the header
+        };
+        static constexpr size_t BLOCK_HEADER_SIZE = ( sizeof(Block) + alignof(std::max_align_t) - 1 ) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+        // statistics kept for the report after the arena is destroyed
+        struct Record {
+            const char* name;
+            const FrameArena* arena;
+            size_t highWaterMark;
+            size_t capacity;
+        };
+
+        Block* _block;                          // current block, earlier ones of this frame are linked through previous
+        size_t _blockOffset;
+        size_t _previousBlocksUsed;             // bytes used in the earlier blocks of this frame
+        size_t _firstBlockSize;
+        std::atomic<size_t> _highWaterMark;
+        std::atomic<size_t> _capacity;
+        size_t _recordIndex;
+
+        static Block* _allocateBlock( size_t size, Block* previous );
+        void _freeBlocks();
+        size_t _frameHighWaterMark() const;
+
+        static std::mutex& _registryMutex();
+        static std::vector<Record>& _registry();
+    };
+
+    /**
+     * @class FrameArenaAllocator
+     * @brief STL allocator that takes memory from a FrameArena and never frees it individually
+     * @tparam T value type of the container
+     */
+    template<typename T>
+    class [[maybe_unused]] FrameArenaAllocator {
+    public:
+        /**
+         * @brief value type of the allocator
+         */
+        using value_type = T;
+
+        /**
+         * @brief allocates from the given arena
+         */
+        FrameArenaAllocator( FrameArena& arena ) noexcept : _pArena( &arena ) {}
+        /**
+         * @brief rebinds an allocator of another type to the same arena
+         */
+        template<typename U>
+        FrameArenaAllocator( const FrameArenaAllocator<U>& other ) noexcept : _pArena( other.getArena() ) {}
+
+        /**
+         * @brief returns storage for n objects from the arena
+         */
+        [[nodiscard]] T* allocate( size_t n ) { return _pArena->allocate<T>( n ); }
+        /**
+         * @brief does nothing, the storage is reclaimed when the arena is reset
+         */
+        void deallocate( T*, size_t ) noexcept {}
+
+        /**
+         * @brief returns the arena the allocator draws from
+         */
+        [[nodiscard]] FrameArena* getArena() const noexcept { return _pArena; }
+
+    private:
+        FrameArena* _pArena;
+    };
+
+    /**
+     * @brief allocators are equal when they draw from the same arena
+     */
+    template<typename T, typename U>
+    bool operator==( const FrameArenaAllocator<T>& lhs, const FrameArenaAllocator<U>& rhs ) noexcept { return lhs.getArena() == rhs.getArena(); }
+    /**
+     * @brief allocators are equal when they draw from the same arena
+     */
+    template<typename T, typename U>
+    bool operator!=( const FrameArenaAllocator<T>& lhs, const FrameArenaAllocator<U>& rhs ) noexcept { return !( lhs == rhs ); }
+
+    /**
+     * @brief vector whose storage lives in a FrameArena, invalid after the arena's next reset()
+     */
+    template<typename T>
+    using FrameVector = std::vector< T, FrameArenaAllocator<T> >;
+}
+
+//**********************************************************************************
+//**********************************************************************************
+// Outward facing function implementations
+
+inline CSCI441::FrameArena::FrameArena( const char* name, const size_t blockSize ) :
+    _block( _allocateBlock( blockSize, nullptr ) ),
+    _blockOffset( 0 ),
+    _previousBlocksUsed( 0 ),
+    _firstBlockSize( blockSize ),
+    _highWaterMark( 0 ),
+    _capacity( blockSize ) {
+
+    std::lock_guard<std::mutex> lock( _registryMutex() );
+    _recordIndex = _registry().size();
+    _registry().push_back( { name, this, 0, blockSize } );
+}
+
+inline CSCI441::FrameArena::~FrameArena() {
+    {
+        std::lock_guard<std::mutex> lock( _registryMutex() );
+        Record& record = _registry()[_recordIndex];
+        record.arena = nullptr;
+        record.highWaterMark = _frameHighWaterMark();
+        record.capacity = getCapacity();
+    }
+    _freeBlocks();
+}
+
+[[maybe_unused]]
+inline CSCI441::FrameArena& CSCI441::FrameArena::forThisThread() {
+    static thread_local FrameArena arena;
+    return arena;
+}
+
+[[maybe_unused]]
+inline void CSCI441::FrameArena::setName( const char* name ) {
+    std::lock_guard<std::mutex> lock( _registryMutex() );
+    _registry()[_recordIndex].name = name;
+}
+
+[[maybe_unused]]
+inline void* CSCI441::FrameArena::allocate( const size_t bytes, const size_t alignment ) {
+    auto start = ( _blockOffset + alignment - 1 ) & ~( alignment - 1 );
+    if( start + bytes > _block->size ) {
+        // chain a block at least as large as the current one so a growing frame spills only a few times
+        _previousBlocksUsed += _blockOffset;
+        const size_t size = std::max( _block->size * 2, bytes + alignment );
+        _block = _allocateBlock( size, _block );
+        _capacity.store( _capacity.load( std::memory_order_relaxed ) + size, std::memory_order_relaxed );
+        start = 0;
+    }
+    _blockOffset = start + bytes;
+    return reinterpret_cast<unsigned char*>( _block ) + BLOCK_HEADER_SIZE + start;
+}
+
+[[maybe_unused]]
+inline void CSCI441::FrameArena::reset() {
+    const size_t used = getBytesUsed();
+    _highWaterMark.store( _frameHighWaterMark(), std::memory_order_relaxed );
+
+    if( _block->previous != nullptr ) {
+        // this frame needed several blocks, the next one gets them as one
+        const size_t size = std::max( used, _firstBlockSize );
+        _freeBlocks();
+        _block = _allocateBlock( size, nullptr );
+        _capacity.store( size, std::memory_order_relaxed );
+    }
+    _blockOffset = 0;
+    _previousBlocksUsed = 0;
+}
+
+[[maybe_unused]]
+inline void CSCI441::FrameArena::writeReport( FILE* fp ) {
+    std::lock_guard<std::mutex> lock( _registryMutex() );
+    for( const auto& record : _registry() ) {
+        // a live arena is read from another thread, so only its statistics as of its last reset
+        const size_t highWaterMark = record.arena != nullptr ? record.arena->getHighWaterMark() : record.highWaterMark;
+        const size_t capacity = record.arena != nullptr ? record.arena->getCapacity() : record.capacity;
+        fprintf( fp, "[INFO]: %s high water mark %.1f KiB of %.1f KiB\n",
+                 record.name, static_cast<double>(highWaterMark) / 1024.0, static_cast<double>(capacity) / 1024.0 );
+    }
+}
+
+//**********************************************************************************
+//**********************************************************************************
+// Internal implementations
+
+inline CSCI441::FrameArena::Block* CSCI441::FrameArena::_allocateBlock( const size_t size, Block* previous ) {
+    auto block = static_cast<Block*>( ::operator new( BLOCK_HEADER_SIZE + size ) );
+    block->previous = previous;
+    block->size = size;
+    return block;
+}
+
+inline void CSCI441::FrameArena::_freeBlocks() {
+    while( _block != nullptr ) {
+        Block* previous = _block->previous;
+        ::operator delete( _block );
+        _block = previous;
+    }
+}
+
+inline size_t CSCI441::FrameArena::_frameHighWaterMark() const {
+    return std::max( _highWaterMark.load( std::memory_order_relaxed ), getBytesUsed() );
+}
+
+inline std::mutex& CSCI441::FrameArena::_registryMutex() {
+    static std::mutex registryMutex;
+    return registryMutex;
+}
+
+inline std::vector<CSCI441::FrameArena::Record>& CSCI441::FrameArena::_registry() {
+    static std::vector<Record> registry;
+    return registry;
+}
+
+#endif // CSCI441_FRAME_ARENA_HPP
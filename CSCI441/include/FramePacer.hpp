@@ -0,0 +1,205 @@
+/** @file FramePacer.hpp
+ * @brief Frame rate limiter and adaptive vertical sync policy for a target frame time
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	limit() holds the loop until the next frame deadline, one target frame time
+ *	after the previous one.  It sleeps until SPIN_MARGIN_MS before the deadline,
+ *	because the operating system may oversleep by a millisecond or more, and spins
+ *	the rest of the way.  A frame that overran its deadline does not try to catch
+ *	up; the schedule restarts from the late frame.  While the swap waits for
+ *	vertical sync on a display no faster than the target, the display already
+ *	paces the frames and limit() returns at once; a second, slightly different
+ *	clock would drift against the refresh and make frames miss it.
+ *
+ *	update() is given the time each frame spent working, CPU or GPU, excluding any
+ *	wait for vertical sync, and returns the swap interval to use:
+ *
+ *		1	wait for vertical sync, while frames fit the budget
+ *		-1	adaptive vertical sync (swap tear), after frames start missing the budget
+ *		0	no vertical sync, when swap tear is not supported
+ *
+ *	With vertical sync, a frame that misses a refresh waits for the next one,
+ *	halving the frame rate until the load drops.  Presenting late frames
+ *	immediately trades a torn frame for a steady rate.  Synchronization comes
+ *	back once frames fit the budget with room to spare for RECOVERY_FRAMES frames.
+ */
+
+#ifndef CSCI441_FRAME_PACER_HPP
+#define CSCI441_FRAME_PACER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class FramePacer
+     * @brief holds frames to a target frame time and decides when to wait for vertical sync
+     */
+    class [[maybe_unused]] FramePacer final {
+    public:
+        /**
+         * @brief time before the deadline when limit() stops sleeping and spins
+         */
+        static constexpr double SPIN_MARGIN_MS = 1.5;
+        /**
+         * @brief number of the last MISS_WINDOW frames that must miss the budget to stop waiting for vertical sync
+         */
+        static constexpr unsigned int MISSES_TO_UNSYNC = 3;
+        /**
+         * @brief number of frames considered when counting misses
+         */
+        static constexpr unsigned int MISS_WINDOW = 8;
+        /**
+         * @brief consecutive frames under RECOVERY_FRACTION of the budget before waiting for vertical sync again
+         */
+        static constexpr unsigned int RECOVERY_FRAMES = 60;
+        /**
+         * @brief fraction of the budget a frame must stay under to count towards recovery
+         */
+        static constexpr double RECOVERY_FRACTION = 0.8;
+
+        /**
+         * @brief creates a pacer for the given frame rate
+         * @param targetFramesPerSecond frame rate to hold, 0 disables the limiter
+         * @param isSwapTearSupported true if the driver supports a negative swap interval
+         */
+        explicit FramePacer( double targetFramesPerSecond = 60.0, bool isSwapTearSupported = false );
+
+        /**
+         * @brief changes the frame rate to hold, 0 disables the limiter
+         */
+        [[maybe_unused]] void setTargetFrameRate( double targetFramesPerSecond );
+        /**
+         * @brief returns the time one frame may take in milliseconds, 0 when unlimited
+         */
+        [[maybe_unused]] [[nodiscard]] double getTargetFrameTime() const noexcept { return _targetFrameTimeMs; }
+
+        /**
+         * @brief sets the refresh rate of the display, 0 if unknown
+         */
+        [[maybe_unused]] void setRefreshRate( double refreshRate ) noexcept { _refreshRate = refreshRate; }
+
+        /**
+         * @brief sets whether a negative swap interval may be returned
+         */
+        [[maybe_unused]] void setSwapTearSupported( bool isSwapTearSupported ) noexcept { _isSwapTearSupported = isSwapTearSupported; }
+
+        /**
+         * @brief records how long a frame worked and returns the swap interval for the next one
+         * @param workTimeMs time the frame spent on the CPU or the GPU, whichever is longer, without waiting for vertical sync
+         */
+        [[maybe_unused]] int update( double workTimeMs );
+        /**
+         * @brief returns the swap interval update() returned last
+         */
+        [[maybe_unused]] [[nodiscard]] int getSwapInterval() const noexcept { return _swapInterval; }
+
+        /**
+         * @brief blocks until the next frame deadline
+         */
+        [[maybe_unused]] void limit();
+
+        /**
+         * @brief returns the number of frames that worked longer than the target frame time
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getNumberOfMissedFrames() const noexcept { return _numMissedFrames; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        double _targetFrameTimeMs;
+        double _refreshRate;
+        bool _isSwapTearSupported;
+        int _swapInterval;
+
+        unsigned int _recentMisses;             // one bit per frame of the last MISS_WINDOW
+        unsigned int _numRecoveryFrames;
+        size_t _numMissedFrames;
+
+        Clock::time_point _deadline;
+    };
+}
+
+//**********************************************************************************
+//**********************************************************************************
+// Outward facing function implementations
+
+inline CSCI441::FramePacer::FramePacer( const double targetFramesPerSecond, const bool isSwapTearSupported ) :
+    _targetFrameTimeMs( 0.0 ),
+    _refreshRate( 0.0 ),
+    _isSwapTearSupported( isSwapTearSupported ),
+    _swapInterval( 1 ),
+    _recentMisses( 0 ),
+    _numRecoveryFrames( 0 ),
+    _numMissedFrames( 0 ),
+    _deadline( Clock::now() ) {
+
+    setTargetFrameRate( targetFramesPerSecond );
+}
+
+[[maybe_unused]]
+inline void CSCI441::FramePacer::setTargetFrameRate( const double targetFramesPerSecond ) {
+    _targetFrameTimeMs = targetFramesPerSecond > 0.0 ? 1000.0 / targetFramesPerSecond : 0.0;
+    _deadline = Clock::now();
+}
+
+[[maybe_unused]]
+inline int CSCI441::FramePacer::update( const double workTimeMs ) {
+    if( _targetFrameTimeMs <= 0.0 ) return _swapInterval;
+
+    const bool isMiss = workTimeMs > _targetFrameTimeMs;
+    if( isMiss ) _numMissedFrames++;
+    _recentMisses = ( (_recentMisses << 1) | (isMiss ? 1u : 0u) ) & ( (1u << MISS_WINDOW) - 1 );
+
+    if( _swapInterval == 1 ) {
+        unsigned int numRecentMisses = 0;
+        for( unsigned int misses = _recentMisses; misses != 0; misses &= misses - 1 ) numRecentMisses++;
+        if( numRecentMisses >= MISSES_TO_UNSYNC ) {
+            _swapInterval = _isSwapTearSupported ? -1 : 0;
+            _numRecoveryFrames = 0;
+        }
+    } else {
+        _numRecoveryFrames = workTimeMs < _targetFrameTimeMs * RECOVERY_FRACTION ? _numRecoveryFrames + 1 : 0;
+        if( _numRecoveryFrames >= RECOVERY_FRAMES ) {
+            _swapInterval = 1;
+            _recentMisses = 0;
+        }
+    }
+    return _swapInterval;
+}
+
+[[maybe_unused]]
+inline void CSCI441::FramePacer::limit() {
+    if( _targetFrameTimeMs <= 0.0 ) return;
+    // allow a few percent so a 59.94 Hz display counts as 60 Hz
+    if( _swapInterval != 0 && _refreshRate > 0.0 && 1000.0 / _refreshRate >= _targetFrameTimeMs * 0.95 ) {
+        _deadline = Clock::now();
+        return;
+    }
+
+    const auto frameTime = std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double, std::milli>( _targetFrameTimeMs ) );
+    const auto spinMargin = std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double, std::milli>( SPIN_MARGIN_MS ) );
+
+    _deadline += frameTime;
+    auto now = Clock::now();
+    if( now >= _deadline ) {
+        // late, start the schedule over from this frame instead of rushing the next ones
+        _deadline = now;
+        return;
+    }
+
+    if( _deadline - now > spinMargin ) {
+        std::this_thread::sleep_for( _deadline - now - spinMargin );
+    }
+    while( Clock::now() < _deadline ) {
+        std::this_thread::yield();
+    }
+}
+
+#endif // CSCI441_FRAME_PACER_HPP
@@ -0,0 +1,204 @@
+/** @file FrameStatistics.hpp
+ * @brief Per-frame timings and call counts summarised as percentiles and written as JSON
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Records one sample per frame: the frame time plus the number of draw calls
+ *	and state changes it issued (see GLCallCounter.hpp).  Percentiles interpolate
+ *	linearly between the two closest ranks of the sorted frame times.
+ *
+ *	The JSON report has the shape
+ *
+ *		{
+ *		  "metadata": { "<key>": "<value>", ... },
+ *		  "frames": N,
+ *		  "frame_time_ms": { "mean", "min", "p50", "p90", "p95", "p99", "max" },
+ *		  "draw_calls": { "mean", "max", "total" },
+ *		  "state_changes": { "mean", "max", "total" }
+ *		}
+ */
+
+#ifndef CSCI441_FRAME_STATISTICS_HPP
+#define CSCI441_FRAME_STATISTICS_HPP
+
+#include "Logger.hpp"
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class FrameStatistics
+     * @brief collects frame times and call counts and reports their distribution
+     */
+    class [[maybe_unused]] FrameStatistics final {
+    public:
+        /**
+         * @brief measurements of a single frame
+         */
+        struct Sample {
+            /// time from the start of the frame until its rendering finished, in milliseconds
+            double frameTimeMs;
+            /// draw calls issued during the frame
+            GLuint64 drawCalls;
+            /// state changes issued during the frame
+            GLuint64 stateChanges;
+        };
+
+        /**
+         * @brief reserves room for a number of frames so recording does not allocate
+         * @param numFrames expected number of frames
+         */
+        [[maybe_unused]] void reserve( const size_t numFrames ) { _samples.reserve(numFrames); }
+        /**
+         * @brief records one frame
+         * @param frameTimeMs frame time in milliseconds
+         * @param drawCalls draw calls issued during the frame
+         * @param stateChanges state changes issued during the frame
+         */
+        [[maybe_unused]] void addFrame( double frameTimeMs, GLuint64 drawCalls, GLuint64 stateChanges );
+        /**
+         * @brief removes all recorded frames
+         */
+        [[maybe_unused]] void clear() { _samples.clear(); }
+
+        /**
+         * @brief returns the number of recorded frames
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getNumberOfFrames() const { return _samples.size(); }
+        /**
+         * @brief returns the recorded frames in order
+         */
+        [[maybe_unused]] [[nodiscard]] const std::vector<Sample>& getSamples() const { return _samples; }
+        /**
+         * @brief returns a frame time percentile in milliseconds
+         * @param percentile value between 0 and 100
+         * @note returns 0 when no frame has been recorded
+         */
+        [[maybe_unused]] [[nodiscard]] double getFrameTimePercentile( double percentile ) const;
+        /**
+         * @brief returns the mean frame time in milliseconds
+         */
+        [[maybe_unused]] [[nodiscard]] double getMeanFrameTime() const;
+
+        /**
+         * @brief writes the summary of the recorded frames as JSON
+         * @param filename file to create or overwrite
+         * @param metadata key and value strings copied into the "metadata" object
+         * @returns true if the file was written
+         */
+        [[maybe_unused]] bool writeJSON( const char* filename, const std::vector< std::pair<std::string, std::string> >& metadata ) const;
+
+    private:
+        std::vector<Sample> _samples;
+
+        static std::string _escapeJSON( const std::string& text );
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+[[maybe_unused]]
+inline void CSCI441::FrameStatistics::addFrame( const double frameTimeMs, const GLuint64 drawCalls, const GLuint64 stateChanges ) {
+    _samples.push_back( { frameTimeMs, drawCalls, stateChanges } );
+}
+
+[[maybe_unused]]
+inline double CSCI441::FrameStatistics::getFrameTimePercentile( const double percentile ) const {
+    if( _samples.empty() ) return 0.0;
+
+    std::vector<double> frameTimes( _samples.size() );
+    std::transform( _samples.begin(), _samples.end(), frameTimes.begin(), [](const Sample& sample) { return sample.frameTimeMs; } );
+    std::sort( frameTimes.begin(), frameTimes.end() );
+
+    const double rank = std::clamp( percentile, 0.0, 100.0 ) / 100.0 * static_cast<double>(frameTimes.size() - 1);
+    const auto lower = static_cast<size_t>( std::floor(rank) );
+    const size_t upper = std::min( lower + 1, frameTimes.size() - 1 );
+    return frameTimes[lower] + (frameTimes[upper] - frameTimes[lower]) * (rank - static_cast<double>(lower));
+}
+
+[[maybe_unused]]
+inline double CSCI441::FrameStatistics::getMeanFrameTime() const {
+    if( _samples.empty() ) return 0.0;
+
+    double total = 0.0;
+    for( const Sample& sample : _samples ) total += sample.frameTimeMs;
+    return total / static_cast<double>(_samples.size());
+}
+
+[[maybe_unused]]
+inline bool CSCI441::FrameStatistics::writeJSON( const char* filename, const std::vector< std::pair<std::string, std::string> >& metadata ) const {
+    FILE* file = fopen( filename, "w" );
+    if( file == nullptr ) {
+        CSCI441_LOG_ERROR( "CSCI441::FrameStatistics::writeJSON(): Could not open \"%s\" for writing", filename );
+        return false;
+    }
+
+    GLuint64 totalDrawCalls = 0, maxDrawCalls = 0, totalStateChanges = 0, maxStateChanges = 0;
+    for( const Sample& sample : _samples ) {
+        totalDrawCalls += sample.drawCalls;
+        maxDrawCalls = std::max( maxDrawCalls, sample.drawCalls );
+        totalStateChanges += sample.stateChanges;
+        maxStateChanges = std::max( maxStateChanges, sample.stateChanges );
+    }
+    const double numFrames = _samples.empty() ? 1.0 : static_cast<double>(_samples.size());
+
+    fprintf( file, "{\n  \"metadata\": {" );
+    for( size_t i = 0; i < metadata.size(); i++ ) {
+        fprintf( file, "%s\n    \"%s\": \"%s\"", i == 0 ? "" : ",", _escapeJSON(metadata[i].first).c_str(), _escapeJSON(metadata[i].second).c_str() );
+    }
+    fprintf( file, "%s},\n", metadata.empty() ? "" : "\n  " );
+    fprintf( file, "  \"frames\": %zu,\n", _samples.size() );
+    fprintf( file, "  \"frame_time_ms\": { \"mean\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+             getMeanFrameTime(), getFrameTimePercentile(0.0), getFrameTimePercentile(50.0), getFrameTimePercentile(90.0),
+             getFrameTimePercentile(95.0), getFrameTimePercentile(99.0), getFrameTimePercentile(100.0) );
+    fprintf( file, "  \"draw_calls\": { \"mean\": %.2f, \"max\": %llu, \"total\": %llu },\n",
+             static_cast<double>(totalDrawCalls) / numFrames, static_cast<unsigned long long>(maxDrawCalls), static_cast<unsigned long long>(totalDrawCalls) );
+    fprintf( file, "  \"state_changes\": { \"mean\": %.2f, \"max\": %llu, \"total\": %llu }\n}\n",
+             static_cast<double>(totalStateChanges) / numFrames, static_cast<unsigned long long>(maxStateChanges), static_cast<unsigned long long>(totalStateChanges) );
+
+    fclose( file );
+    return true;
+}
+
+//**********************************************************************************
+// Internal implementations
+
+inline std::string CSCI441::FrameStatistics::_escapeJSON( const std::string& text ) {
+    std::string escaped;
+    escaped.reserve( text.size() );
+    for( const char c : text ) {
+        switch( c ) {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n";  break;
+            case '\t': escaped += "\\t";  break;
+            default:
+                if( static_cast<unsigned char>(c) < 0x20 ) {
+                    char code[8];
+                    snprintf( code, sizeof(code), "\\u%04x", static_cast<unsigned int>(c) );
+                    escaped += code;
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+#endif // CSCI441_FRAME_STATISTICS_HPP
@@ -0,0 +1,238 @@
+/** @file GLCallCounter.hpp
+ * @brief Counts draw calls, state changes, uniform updates and buffer uploads issued through the OpenGL function pointers
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	install() replaces the glad function pointers of the counted
+ *	entry points with wrappers that increment a counter and forward the call, so
+ *	every call made anywhere in the program is counted without touching the call
+ *	sites.  uninstall() restores the original pointers; when not installed there
+ *	is no cost at all.
+ *
+ *	Counted draw calls: glDrawArrays, glDrawArraysInstanced, glDrawElements,
+ *	glDrawElementsInstanced, glDrawElementsBaseVertex, glDrawElementsInstancedBaseVertex,
+ *	glMultiDrawElementsBaseVertex and glMultiDrawElementsIndirect.
+ *
+ *	Counted state changes: glUseProgram, glBindVertexArray, glBindBuffer,
+ *	glBindTexture, glActiveTexture, glBindFramebuffer, glEnable, glDisable,
+ *	glBlendFunc, glDepthFunc and glViewport.
+ *
+ *	Counted uniform updates: the float, int and unsigned int scalar and vector
+ *	forms of glProgramUniform and glUniform, and their mat3 and mat4 forms.
+ *
+ *	Counted buffer bytes: the size given to glBufferSubData, and to glBufferData
+ *	when it is given data (allocating without data uploads nothing).
+ *
+ *	@warning requires glad, has no effect when built with CSCI441_USE_GLEW
+ *	@warning install() must be called after the OpenGL function pointers are loaded
+ */
+
+#ifndef CSCI441_GL_CALL_COUNTER_HPP
+#define CSCI441_GL_CALL_COUNTER_HPP
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @namespace GLCallCounter
+     * @brief counts draw calls and state changes made through OpenGL
+     */
+    namespace GLCallCounter {
+        /**
+         * @brief starts counting by wrapping the OpenGL function pointers
+         * @note calling install() again while installed has no effect
+         */
+        [[maybe_unused]] void install();
+        /**
+         * @brief stops counting and restores the OpenGL function pointers
+         */
+        [[maybe_unused]] void uninstall();
+        /**
+         * @brief sets both counters back to zero
+         */
+        [[maybe_unused]] void reset();
+
+        /**
+         * @brief returns the number of draw calls since the last reset
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint64 getDrawCalls();
+        /**
+         * @brief returns the number of state changes since the last reset
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint64 getStateChanges();
+        /**
+         * @brief returns the number of uniform updates since the last reset
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint64 getUniformUpdates();
+        /**
+         * @brief returns the number of bytes uploaded to buffers since the last reset
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint64 getBufferBytesUploaded();
+    }
+}
+
+//**********************************************************************************
+
+namespace CSCI441_INTERNAL::GLCallCounter {
+    inline GLuint64 drawCalls = 0;
+    inline GLuint64 stateChanges = 0;
+    inline GLuint64 uniformUpdates = 0;
+    inline GLuint64 bufferBytes = 0;
+
+#ifndef CSCI441_USE_GLEW
+    // how much a call adds to its counter
+    struct CountCall {
+        template<typename... Args> static GLuint64 weigh(Args...) { return 1; }
+    };
+    struct BufferDataBytes {
+        static GLuint64 weigh(GLenum, GLsizeiptr size, const void* data, GLenum) { return data != nullptr ? static_cast<GLuint64>(size) : 0; }
+    };
+    struct BufferSubDataBytes {
+        static GLuint64 weigh(GLenum, GLintptr, GLsizeiptr size, const void*) { return static_cast<GLuint64>(size); }
+    };
+
+    // wraps the function pointer stored in POINTER with one that adds WEIGHT to COUNTER first
+    template<typename PFN, PFN* POINTER, GLuint64* COUNTER, typename WEIGHT = CountCall> struct Hook;
+
+    template<typename R, typename... Args, R (GLAD_API_PTR **POINTER)(Args...), GLuint64* COUNTER, typename WEIGHT>
+    struct Hook<R (GLAD_API_PTR *)(Args...), POINTER, COUNTER, WEIGHT> {
+        inline static R (GLAD_API_PTR *original)(Args...) = nullptr;
+
+        static R GLAD_API_PTR call(Args... args) {
+            *COUNTER += WEIGHT::weigh(args...);
+            return original(args...);
+        }
+        static void install() {
+            // entry points the context does not provide stay null
+            if( original == nullptr && *POINTER != nullptr ) {
+                original = *POINTER;
+                *POINTER = &call;
+            }
+        }
+        static void uninstall() {
+            if( original != nullptr ) {
+                *POINTER = original;
+                original = nullptr;
+            }
+        }
+    };
+
+    template<typename... Hooks>
+    struct HookList {
+        static void install() { (Hooks::install(), ...); }
+        static void uninstall() { (Hooks::uninstall(), ...); }
+    };
+
+    using DrawHooks = HookList<
+        Hook<PFNGLDRAWARRAYSPROC, &glad_glDrawArrays, &drawCalls>,
+        Hook<PFNGLDRAWARRAYSINSTANCEDPROC, &glad_glDrawArraysInstanced, &drawCalls>,
+        Hook<PFNGLDRAWELEMENTSPROC, &glad_glDrawElements, &drawCalls>,
+        Hook<PFNGLDRAWELEMENTSINSTANCEDPROC, &glad_glDrawElementsInstanced, &drawCalls>,
+        Hook<PFNGLDRAWELEMENTSBASEVERTEXPROC, &glad_glDrawElementsBaseVertex, &drawCalls>,
+        Hook<PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC, &glad_glDrawElementsInstancedBaseVertex, &drawCalls>,
+        Hook<PFNGLMULTIDRAWELEMENTSBASEVERTEXPROC, &glad_glMultiDrawElementsBaseVertex, &drawCalls>,
+        Hook<PFNGLMULTIDRAWELEMENTSINDIRECTPROC, &glad_glMultiDrawElementsIndirect, &drawCalls>>;
+
+    using StateHooks = HookList<
+        Hook<PFNGLUSEPROGRAMPROC, &glad_glUseProgram, &stateChanges>,
+        Hook<PFNGLBINDVERTEXARRAYPROC, &glad_glBindVertexArray, &stateChanges>,
+        Hook<PFNGLBINDBUFFERPROC, &glad_glBindBuffer, &stateChanges>,
+        Hook<PFNGLBINDTEXTUREPROC, &glad_glBindTexture, &stateChanges>,
+        Hook<PFNGLACTIVETEXTUREPROC, &glad_glActiveTexture, &stateChanges>,
+        Hook<PFNGLBINDFRAMEBUFFERPROC, &glad_glBindFramebuffer, &stateChanges>,
+        Hook<PFNGLENABLEPROC, &glad_glEnable, &stateChanges>,
+        Hook<PFNGLDISABLEPROC, &glad_glDisable, &stateChanges>,
+        Hook<PFNGLBLENDFUNCPROC, &glad_glBlendFunc, &stateChanges>,
+        Hook<PFNGLDEPTHFUNCPROC, &glad_glDepthFunc, &stateChanges>,
+        Hook<PFNGLVIEWPORTPROC, &glad_glViewport, &stateChanges>>;
+
+    using UniformHooks = HookList<
+        Hook<PFNGLPROGRAMUNIFORM1FPROC, &glad_glProgramUniform1f, &uniformUpdates>,
+        Hook<PFNGLPROGRAMUNIFORM2FPROC, &glad_glProgramUniform2f, &uniformUpdates>,
+        Hook<PFNGLPROGRAMUNIFORM3FPROC, &glad_glProgramUniform3f, &uniformUpdates>,
+        Hook<PFNGLPROGRAMUNIFORM4FPROC, &glad_glProgramUniform4f, &uniformUpdates>,
+        Hook<PFNGLPROGRAMUNIFORM1IPROC, &glad_glProgramUniform1i, &uniformUpdates>,
+        Hook<PFNGLPROGRAMUNIFORM1UIPROC, &glad_glProgramUniform1ui, &uniformUpdates>,
+        Hook<PFNGLPROGRAMUNIFORM1FVPROC, &glad_glProgramUniform1fv, &uniformUpdates>,
+        Hook<PFNGLPROGRAMUNIFORM2FVPROC, &glad_glProgramUniform2fv, &uniformUpdates>,
+        Hook<PFNGLPROGRAMUNIFORM3FVPROC, &glad_glProgramUniform3fv, &uniformUpdates>,
+        Hook<PFNGLPROGRAMUNIFORM4FVPROC, &glad_glProgramUniform4fv, &uniformUpdates>,
+        Hook<PFNGLPROGRAMUNIFORM1IVPROC, &glad_glProgramUniform1iv, &uniformUpdates>,
+        Hook<PFNGLPROGRAMUNIFORM1UIVPROC, &glad_glProgramUniform1uiv, &uniformUpdates>,
+        Hook<PFNGLPROGRAMUNIFORMMATRIX3FVPROC, &glad_glProgramUniformMatrix3fv, &uniformUpdates>,
+        Hook<PFNGLPROGRAMUNIFORMMATRIX4FVPROC, &glad_glProgramUniformMatrix4fv, &uniformUpdates>,
+        Hook<PFNGLUNIFORM1FPROC, &glad_glUniform1f, &uniformUpdates>,
+        Hook<PFNGLUNIFORM3FPROC, &glad_glUniform3f, &uniformUpdates>,
+        Hook<PFNGLUNIFORM4FPROC, &glad_glUniform4f, &uniformUpdates>,
+        Hook<PFNGLUNIFORM1IPROC, &glad_glUniform1i, &uniformUpdates>,
+        Hook<PFNGLUNIFORM3FVPROC, &glad_glUniform3fv, &uniformUpdates>,
+        Hook<PFNGLUNIFORM4FVPROC, &glad_glUniform4fv, &uniformUpdates>,
+        Hook<PFNGLUNIFORMMATRIX3FVPROC, &glad_glUniformMatrix3fv, &uniformUpdates>,
+        Hook<PFNGLUNIFORMMATRIX4FVPROC, &glad_glUniformMatrix4fv, &uniformUpdates>>;
+
+    using BufferHooks = HookList<
+        Hook<PFNGLBUFFERDATAPROC, &glad_glBufferData, &bufferBytes, BufferDataBytes>,
+        Hook<PFNGLBUFFERSUBDATAPROC, &glad_glBufferSubData, &bufferBytes, BufferSubDataBytes>>;
+#endif
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+[[maybe_unused]]
+inline void CSCI441::GLCallCounter::install() {
+#ifndef CSCI441_USE_GLEW
+    CSCI441_INTERNAL::GLCallCounter::DrawHooks::install();
+    CSCI441_INTERNAL::GLCallCounter::StateHooks::install();
+    CSCI441_INTERNAL::GLCallCounter::UniformHooks::install();
+    CSCI441_INTERNAL::GLCallCounter::BufferHooks::install();
+#endif
+}
+
+[[maybe_unused]]
+inline void CSCI441::GLCallCounter::uninstall() {
+#ifndef CSCI441_USE_GLEW
+    CSCI441_INTERNAL::GLCallCounter::DrawHooks::uninstall();
+    CSCI441_INTERNAL::GLCallCounter::StateHooks::uninstall();
+    CSCI441_INTERNAL::GLCallCounter::UniformHooks::uninstall();
+    CSCI441_INTERNAL::GLCallCounter::BufferHooks::uninstall();
+#endif
+}
+
+[[maybe_unused]]
+inline void CSCI441::GLCallCounter::reset() {
+    CSCI441_INTERNAL::GLCallCounter::drawCalls = 0;
+    CSCI441_INTERNAL::GLCallCounter::stateChanges = 0;
+    CSCI441_INTERNAL::GLCallCounter::uniformUpdates = 0;
+    CSCI441_INTERNAL::GLCallCounter::bufferBytes = 0;
+}
+
+[[maybe_unused]]
+inline GLuint64 CSCI441::GLCallCounter::getDrawCalls() {
+    return CSCI441_INTERNAL::GLCallCounter::drawCalls;
+}
+
+[[maybe_unused]]
+inline GLuint64 CSCI441::GLCallCounter::getStateChanges() {
+    return CSCI441_INTERNAL::GLCallCounter::stateChanges;
+}
+
+[[maybe_unused]]
+inline GLuint64 CSCI441::GLCallCounter::getUniformUpdates() {
+    return CSCI441_INTERNAL::GLCallCounter::uniformUpdates;
+}
+
+[[maybe_unused]]
+inline GLuint64 CSCI441::GLCallCounter::getBufferBytesUploaded() {
+    return CSCI441_INTERNAL::GLCallCounter::bufferBytes;
+}
+
+#endif // CSCI441_GL_CALL_COUNTER_HPP
@@ -0,0 +1,164 @@
+/** @file HeapAllocationCheck.hpp
+ * @brief Debug check that steady-state frames make no global heap allocations
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	When CSCI441_CHECK_HEAP_ALLOCATIONS is defined, the global operator new is
+ *	replaced to count allocations per thread.  Exactly one translation unit must
+ *	define CSCI441_HEAP_ALLOCATION_HOOKS_IMPLEMENTATION before including this file
+ *	to emit the replacement.  Only C++ allocations are seen; malloc() from C
+ *	libraries and the OpenGL driver is not counted.
+ *
+ *	Each thread calls endFrame() once per frame.  After beginSteadyState() on that
+ *	thread, a frame that allocated reports an error and fails an assertion,
+ *	unless skipFrame() marked it as one that is expected to allocate (loading,
+ *	compiling a shader variant, ...).
+ *
+ *	Without CSCI441_CHECK_HEAP_ALLOCATIONS nothing is counted and endFrame() never
+ *	fails.
+ */
+
+#ifndef CSCI441_HEAP_ALLOCATION_CHECK_HPP
+#define CSCI441_HEAP_ALLOCATION_CHECK_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class HeapAllocationCheck
+     * @brief counts the calling thread's heap allocations per frame and asserts there are none in steady state
+     */
+    class [[maybe_unused]] HeapAllocationCheck final {
+    public:
+        /**
+         * @brief true when operator new is hooked and allocations are counted
+         */
+#ifdef CSCI441_CHECK_HEAP_ALLOCATIONS
+        static constexpr bool IS_ENABLED = true;
+#else
+        static constexpr bool IS_ENABLED = false;
+#endif
+
+        /**
+         * @brief counts one allocation on the calling thread
+         * @note called by the operator new replacement
+         */
+        static void recordAllocation( size_t bytes ) noexcept;
+
+        /**
+         * @brief from the next endFrame() on, frames on the calling thread must not allocate
+         */
+        [[maybe_unused]] static void beginSteadyState() noexcept;
+        /**
+         * @brief allows the calling thread's current frame to allocate
+         */
+        [[maybe_unused]] static void skipFrame() noexcept;
+        /**
+         * @brief checks the calling thread's frame and starts counting the next one
+         * @param frameName label for the error message
+         */
+        [[maybe_unused]] static void endFrame( const char* frameName = "frame" ) noexcept;
+
+        /**
+         * @brief returns the number of allocations on the calling thread since the last endFrame()
+         */
+        [[maybe_unused]] [[nodiscard]] static size_t getAllocationCount() noexcept;
+        /**
+         * @brief returns the number of bytes allocated on the calling thread since the last endFrame()
+         */
+        [[maybe_unused]] [[nodiscard]] static size_t getAllocatedBytes() noexcept;
+    };
+}
+
+//**********************************************************************************
+//**********************************************************************************
+// Internal implementations
+
+namespace CSCI441_INTERNAL {
+    // trivially constructed so the operator new hook may run before or during any other initialization
+    struct HeapAllocationState {
+        size_t numAllocations;
+        size_t numBytes;
+        bool isSteadyState;
+        bool isFrameSkipped;
+    };
+    inline thread_local HeapAllocationState heapAllocationState;
+}
+
+//**********************************************************************************
+//**********************************************************************************
+// Outward facing function implementations
+
+inline void CSCI441::HeapAllocationCheck::recordAllocation( const size_t bytes ) noexcept {
+    CSCI441_INTERNAL::heapAllocationState.numAllocations++;
+    CSCI441_INTERNAL::heapAllocationState.numBytes += bytes;
+}
+
+[[maybe_unused]]
+inline void CSCI441::HeapAllocationCheck::beginSteadyState() noexcept {
+    CSCI441_INTERNAL::heapAllocationState.isSteadyState = true;
+}
+
+[[maybe_unused]]
+inline void CSCI441::HeapAllocationCheck::skipFrame() noexcept {
+    CSCI441_INTERNAL::heapAllocationState.isFrameSkipped = true;
+}
+
+[[maybe_unused]]
+inline void CSCI441::HeapAllocationCheck::endFrame( const char* frameName ) noexcept {
+    auto& state = CSCI441_INTERNAL::heapAllocationState;
+    if( state.isSteadyState && !state.isFrameSkipped && state.numAllocations > 0 ) {
+        fprintf( stderr, "[ERROR]: CSCI441::HeapAllocationCheck::endFrame(): %zu heap allocations (%zu bytes) in a steady-state %s\n",
+                 state.numAllocations, state.numBytes, frameName );
+        assert( state.numAllocations == 0 && "heap allocation in a steady-state frame" );
+    }
+    state.numAllocations = 0;
+    state.numBytes = 0;
+    state.isFrameSkipped = false;
+}
+
+[[maybe_unused]]
+inline size_t CSCI441::HeapAllocationCheck::getAllocationCount() noexcept {
+    return CSCI441_INTERNAL::heapAllocationState.numAllocations;
+}
+
+[[maybe_unused]]
+inline size_t CSCI441::HeapAllocationCheck::getAllocatedBytes() noexcept {
+    return CSCI441_INTERNAL::heapAllocationState.numBytes;
+}
+
+#endif // CSCI441_HEAP_ALLOCATION_CHECK_HPP
+
+//**********************************************************************************
+//**********************************************************************************
+// Global operator new replacement, emitted once
+
+#if defined(CSCI441_CHECK_HEAP_ALLOCATIONS) && defined(CSCI441_HEAP_ALLOCATION_HOOKS_IMPLEMENTATION) && !defined(CSCI441_HEAP_ALLOCATION_HOOKS_DEFINED)
+#define CSCI441_HEAP_ALLOCATION_HOOKS_DEFINED
+
+#include <cstdlib>
+#include <new>
+
+// the array, nothrow and sized forms forward to these
+void* operator new( std::size_t size ) {
+    CSCI441::HeapAllocationCheck::recordAllocation( size );
+    void* ptr = std::malloc( size > 0 ? size : 1 );
+    if( ptr == nullptr ) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete( void* ptr ) noexcept {
+    std::free( ptr );
+}
+
+void operator delete( void* ptr, std::size_t ) noexcept {
+    std::free( ptr );
+}
+
+#endif // CSCI441_HEAP_ALLOCATION_HOOKS_IMPLEMENTATION
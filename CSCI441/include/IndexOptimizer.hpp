@@ -0,0 +1,239 @@
+/** @file IndexOptimizer.hpp
+ * @brief Reorders triangle indices and vertices for the post-transform cache and vertex fetch
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Triangles are reordered with Tipsify (Sander, Nehab & Barczak 2007) so vertices are reused
+ *	while still in the post-transform cache, then vertices are renumbered in the order the
+ *	triangles first reference them so vertex fetch walks memory linearly.
+ *
+ *	Cache efficiency is reported as ACMR (average cache miss ratio, vertex shader invocations
+ *	per triangle, ideally approaching 0.5) and ATVR (average transformed vertex ratio, vertex
+ *	shader invocations per referenced vertex, ideally 1.0).
+ *
+ *	@warning NOTE: This header file depends upon GLAD (or alternatively GLEW)
+ */
+
+#ifndef CSCI441_INDEX_OPTIMIZER_HPP
+#define CSCI441_INDEX_OPTIMIZER_HPP
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @namespace IndexOptimizer
+     * @brief index buffer optimization functions
+     */
+    namespace IndexOptimizer {
+
+        /**
+         * @brief default number of entries in the simulated post-transform cache
+         */
+        constexpr GLuint DEFAULT_CACHE_SIZE = 16;
+
+        /**
+         * @brief post-transform cache efficiency of a triangle list
+         */
+        struct Statistics {
+            /// vertex shader invocations per triangle
+            GLfloat acmr = 0.0f;
+            /// vertex shader invocations per referenced vertex
+            GLfloat atvr = 0.0f;
+        };
+
+        /**
+         * @brief simulates a FIFO post-transform cache over a triangle list
+         * @param indices triangle list indices
+         * @param numIndices number of indices, a multiple of three
+         * @param numVertices number of vertices the indices refer to
+         * @param cacheSize number of cache entries to simulate (default: 16)
+         * @returns ACMR and ATVR of the triangle list
+         */
+        [[maybe_unused]] Statistics analyzeVertexCache( const GLuint* indices, GLuint numIndices, GLuint numVertices,
+                                                        GLuint cacheSize = DEFAULT_CACHE_SIZE );
+
+        /**
+         * @brief reorders triangles in place to improve post-transform cache reuse
+         * @param indices triangle list indices, reordered in place
+         * @param numIndices number of indices, a multiple of three
+         * @param numVertices number of vertices the indices refer to
+         * @param cacheSize number of cache entries to optimize for (default: 16)
+         * @note the winding of each triangle is preserved
+         */
+        [[maybe_unused]] void optimizeVertexCache( GLuint* indices, GLuint numIndices, GLuint numVertices,
+                                                   GLuint cacheSize = DEFAULT_CACHE_SIZE );
+
+        /**
+         * @brief renumbers vertices in the order the triangle list first references them
+         * @param indices triangle list indices, rewritten in place to the new vertex numbering
+         * @param numIndices number of indices
+         * @param numVertices number of vertices the indices refer to
+         * @returns remap table where remap[oldVertex] is the new position of the vertex.
+         * Vertices not referenced by any triangle are moved to the end.
+         * @note apply the table to every vertex attribute array with remapVertices()
+         */
+        [[maybe_unused]] std::vector<GLuint> optimizeVertexFetch( GLuint* indices, GLuint numIndices, GLuint numVertices );
+
+        /**
+         * @brief moves vertex attributes to the positions given by a remap table
+         * @tparam T vertex attribute type
+         * @param attributes attribute array of numVertices entries, reordered in place
+         * @param remap remap table returned by optimizeVertexFetch()
+         */
+        template<typename T>
+        [[maybe_unused]] void remapVertices( T* attributes, const std::vector<GLuint>& remap );
+    }
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+[[maybe_unused]]
+inline CSCI441::IndexOptimizer::Statistics CSCI441::IndexOptimizer::analyzeVertexCache( const GLuint* indices, const GLuint numIndices, const GLuint numVertices, const GLuint cacheSize ) {
+    Statistics statistics;
+    if( numIndices < 3 || numVertices == 0 ) return statistics;
+
+    // FIFO cache, an entry is live while fewer than cacheSize misses have occurred since it was inserted
+    std::vector<GLuint> insertedAt( numVertices, 0 );
+    std::vector<bool> referenced( numVertices, false );
+    GLuint misses = 0, numReferenced = 0;
+    for( GLuint i = 0; i < numIndices; i++ ) {
+        const GLuint vertex = indices[i];
+        if( !referenced[vertex] ) {
+            referenced[vertex] = true;
+            numReferenced++;
+        }
+        if( insertedAt[vertex] == 0 || misses - insertedAt[vertex] + 1 > cacheSize ) {
+            misses++;
+            insertedAt[vertex] = misses;
+        }
+    }
+
+    statistics.acmr = static_cast<GLfloat>(misses) / static_cast<GLfloat>(numIndices / 3);
+    statistics.atvr = static_cast<GLfloat>(misses) / static_cast<GLfloat>(numReferenced);
+    return statistics;
+}
+
+[[maybe_unused]]
+inline void CSCI441::IndexOptimizer::optimizeVertexCache( GLuint* indices, const GLuint numIndices, const GLuint numVertices, const GLuint cacheSize ) {
+    const GLuint numTriangles = numIndices / 3;
+    if( numTriangles == 0 || numVertices == 0 ) return;
+
+    // vertex -> triangle adjacency in compressed rows
+    std::vector<GLuint> liveTriangles( numVertices, 0 );
+    for( GLuint i = 0; i < numTriangles * 3; i++ ) liveTriangles[ indices[i] ]++;
+
+    std::vector<GLuint> adjacencyOffset( numVertices + 1, 0 );
+    for( GLuint v = 0; v < numVertices; v++ ) adjacencyOffset[v + 1] = adjacencyOffset[v] + liveTriangles[v];
+    std::vector<GLuint> adjacency( adjacencyOffset[numVertices] );
+    {
+        std::vector<GLuint> fill( adjacencyOffset.begin(), adjacencyOffset.end() - 1 );
+        for( GLuint t = 0; t < numTriangles; t++ ) {
+            for( GLuint c = 0; c < 3; c++ ) adjacency[ fill[ indices[t * 3 + c] ]++ ] = t;
+        }
+    }
+
+    std::vector<GLuint> cacheTime( numVertices, 0 );
+    std::vector<bool> emitted( numTriangles, false );
+    std::vector<GLuint> deadEnd;
+    std::vector<GLuint> candidates;
+    std::vector<GLuint> output;
+    output.reserve( numTriangles * 3 );
+
+    GLuint timeStamp = cacheSize + 1;
+    GLuint cursor = 0;
+    GLint fanningVertex = 0;
+
+    while( fanningVertex >= 0 ) {
+        candidates.clear();
+
+        // emit every remaining triangle around the fanning vertex
+        for( GLuint a = adjacencyOffset[fanningVertex]; a < adjacencyOffset[fanningVertex + 1]; a++ ) {
+            const GLuint t = adjacency[a];
+            if( emitted[t] ) continue;
+            for( GLuint c = 0; c < 3; c++ ) {
+                const GLuint v = indices[t * 3 + c];
+                output.push_back( v );
+                deadEnd.push_back( v );
+                candidates.push_back( v );
+                liveTriangles[v]--;
+                if( timeStamp - cacheTime[v] > cacheSize ) {
+                    cacheTime[v] = timeStamp++;
+                }
+            }
+            emitted[t] = true;
+        }
+
+        // prefer the candidate that has been in the cache longest but will still be there after its fan
+        fanningVertex = -1;
+        GLint bestPriority = -1;
+        for( const auto& v : candidates ) {
+            if( liveTriangles[v] == 0 ) continue;
+            GLint priority = 0;
+            if( timeStamp - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize ) {
+                priority = static_cast<GLint>( timeStamp - cacheTime[v] );
+            }
+            if( priority > bestPriority ) {
+                bestPriority = priority;
+                fanningVertex = static_cast<GLint>( v );
+            }
+        }
+
+        // dead end, back up through recently used vertices and then scan forward
+        if( fanningVertex < 0 ) {
+            while( !deadEnd.empty() ) {
+                const GLuint v = deadEnd.back();
+                deadEnd.pop_back();
+                if( liveTriangles[v] > 0 ) {
+                    fanningVertex = static_cast<GLint>( v );
+                    break;
+                }
+            }
+        }
+        if( fanningVertex < 0 ) {
+            while( cursor < numVertices && liveTriangles[cursor] == 0 ) cursor++;
+            if( cursor < numVertices ) fanningVertex = static_cast<GLint>( cursor );
+        }
+    }
+
+    std::copy( output.begin(), output.end(), indices );
+}
+
+[[maybe_unused]]
+inline std::vector<GLuint> CSCI441::IndexOptimizer::optimizeVertexFetch( GLuint* indices, const GLuint numIndices, const GLuint numVertices ) {
+    constexpr GLuint UNASSIGNED = 0xFFFFFFFF;
+    std::vector<GLuint> remap( numVertices, UNASSIGNED );
+
+    GLuint nextVertex = 0;
+    for( GLuint i = 0; i < numIndices; i++ ) {
+        GLuint& newVertex = remap[ indices[i] ];
+        if( newVertex == UNASSIGNED ) newVertex = nextVertex++;
+        indices[i] = newVertex;
+    }
+    for( auto& newVertex : remap ) {
+        if( newVertex == UNASSIGNED ) newVertex = nextVertex++;
+    }
+    return remap;
+}
+
+template<typename T>
+[[maybe_unused]]
+inline void CSCI441::IndexOptimizer::remapVertices( T* attributes, const std::vector<GLuint>& remap ) {
+    std::vector<T> original( attributes, attributes + remap.size() );
+    for( size_t v = 0; v < remap.size(); v++ ) {
+        attributes[ remap[v] ] = original[v];
+    }
+}
+
+#endif // CSCI441_INDEX_OPTIMIZER_HPP
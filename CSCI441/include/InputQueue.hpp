@@ -0,0 +1,144 @@
+/** @file InputQueue.hpp
+ * @brief Lock-free queue of timestamped key events from the window thread to the simulation
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	The key callback pushes each key event with the time it was received.  Mouse
+ *	input only moves the camera, which is drawn by the window thread, so it is not
+ *	queued.  The simulation pops every pending event at the start
+ *	of its step, so it sees input as late as possible and in the order it
+ *	happened: a key pressed and released between two steps is still seen, and
+ *	the timestamps tell how long the input took to reach the screen.
+ *
+ *	The queue is a fixed size ring buffer with one atomic index per side, so
+ *	neither side locks, waits or allocates.  When the ring is full new events are
+ *	dropped and counted.
+ *
+ *	@warning exactly one producer thread and one consumer thread
+ */
+
+#ifndef CSCI441_INPUT_QUEUE_HPP
+#define CSCI441_INPUT_QUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @struct InputEvent
+     * @brief one key event as received from the window
+     */
+    struct InputEvent {
+        /**
+         * @brief key that changed
+         */
+        int key;
+        /**
+         * @brief press, repeat or release
+         */
+        int action;
+        /**
+         * @brief when the event was received from the window system
+         */
+        std::chrono::steady_clock::time_point timestamp;
+    };
+
+    /**
+     * @class InputQueue
+     * @brief bounded lock free single producer, single consumer queue of InputEvents
+     */
+    class [[maybe_unused]] InputQueue final {
+    public:
+        /**
+         * @brief number of events the queue holds before dropping new ones, a power of two
+         */
+        static constexpr size_t CAPACITY = 256;
+
+        /**
+         * @brief creates an empty queue
+         */
+        InputQueue() : _events(), _head(0), _tail(0), _numDropped(0) {}
+
+        /**
+         * @brief do not allow queues to be copied
+         */
+        InputQueue(const InputQueue&) = delete;
+        /**
+         * @brief do not allow queues to be copied
+         */
+        InputQueue& operator=(const InputQueue&) = delete;
+
+        /**
+         * @brief adds an event to the back of the queue
+         * @returns false if the queue was full and the event was dropped
+         * @note producer only
+         */
+        [[maybe_unused]] bool push( const InputEvent& event );
+        /**
+         * @brief adds a key event stamped with the current time
+         * @returns false if the queue was full and the event was dropped
+         * @note producer only
+         */
+        [[maybe_unused]] bool pushKey( int key, int action );
+
+        /**
+         * @brief removes the oldest event
+         * @param event set to the removed event
+         * @returns false if the queue was empty
+         * @note consumer only
+         */
+        [[maybe_unused]] bool pop( InputEvent& event );
+
+        /**
+         * @brief returns the number of events dropped because the queue was full
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getNumberOfDroppedEvents() const { return _numDropped.load( std::memory_order_relaxed ); }
+
+    private:
+        static_assert( (CAPACITY & (CAPACITY - 1)) == 0, "InputQueue::CAPACITY must be a power of two" );
+
+        InputEvent _events[CAPACITY];
+        // each index is written by one side only; on their own cache lines so the sides do not contend
+        alignas(64) std::atomic<size_t> _head;      // next event to pop, consumer
+        alignas(64) std::atomic<size_t> _tail;      // next slot to push, producer
+        std::atomic<size_t> _numDropped;
+    };
+}
+
+//**********************************************************************************
+//**********************************************************************************
+// Outward facing function implementations
+
+[[maybe_unused]]
+inline bool CSCI441::InputQueue::push( const InputEvent& event ) {
+    const size_t tail = _tail.load( std::memory_order_relaxed );
+    if( tail - _head.load( std::memory_order_acquire ) == CAPACITY ) {
+        _numDropped.fetch_add( 1, std::memory_order_relaxed );
+        return false;
+    }
+    _events[tail & (CAPACITY - 1)] = event;
+    _tail.store( tail + 1, std::memory_order_release );
+    return true;
+}
+
+[[maybe_unused]]
+inline bool CSCI441::InputQueue::pushKey( const int key, const int action ) {
+    return push( { key, action, std::chrono::steady_clock::now() } );
+}
+
+[[maybe_unused]]
+inline bool CSCI441::InputQueue::pop( InputEvent& event ) {
+    const size_t head = _head.load( std::memory_order_relaxed );
+    if( head == _tail.load( std::memory_order_acquire ) ) return false;
+
+    event = _events[head & (CAPACITY - 1)];
+    _head.store( head + 1, std::memory_order_release );
+    return true;
+}
+
+#endif // CSCI441_INPUT_QUEUE_HPP
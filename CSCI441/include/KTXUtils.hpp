@@ -0,0 +1,559 @@
+/** @file KTXUtils.hpp
+ * @brief Reads and writes KTX 1.1 texture containers with block compressed mip chains
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	These functions run entirely on the CPU so they may be used by offline tools that never
+ *	create an OpenGL context.  See TextureUtils::loadAndRegisterKTXTexture() to upload a
+ *	container to the GPU.
+ *
+ *	Supported encodings:
+ *		BC1 (DXT1)  - opaque RGB, 4 bits per pixel
+ *		BC3 (DXT5)  - RGBA with interpolated alpha, 8 bits per pixel
+ *		BC7 (BPTC)  - RGBA using mode 6 only, 8 bits per pixel
+ *		RGBA8       - uncompressed fallback, 32 bits per pixel
+ */
+
+#ifndef CSCI441_KTX_UTILS_HPP
+#define CSCI441_KTX_UTILS_HPP
+
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @namespace KTXUtils
+     * @brief KTX container and block compression utility functions
+     */
+    namespace KTXUtils {
+
+        /**
+         * @brief OpenGL internal format enumerants stored in the container, named here
+         * so this header does not depend upon an OpenGL loader
+         */
+        enum class Format : uint32_t {
+            /// uncompressed 8-bit RGBA (GL_RGBA8)
+            RGBA8 = 0x8058,
+            /// BC1 / DXT1 (GL_COMPRESSED_RGB_S3TC_DXT1_EXT)
+            BC1 = 0x83F0,
+            /// BC3 / DXT5 (GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+            BC3 = 0x83F3,
+            /// BC7 (GL_COMPRESSED_RGBA_BPTC_UNORM)
+            BC7 = 0x8E8C
+        };
+
+        /**
+         * @brief a single mip level of an RGBA8 image
+         */
+        struct Image {
+            /// width of the image in pixels
+            uint32_t width = 0;
+            /// height of the image in pixels
+            uint32_t height = 0;
+            /// tightly packed RGBA pixels, top row first
+            std::vector<uint8_t> pixels;
+        };
+
+        /**
+         * @brief an encoded texture with every face and mip level
+         */
+        struct Texture {
+            /// encoding of every level
+            Format format = Format::RGBA8;
+            /// width of the base level
+            uint32_t width = 0;
+            /// height of the base level
+            uint32_t height = 0;
+            /// 1 for a 2D texture, 6 for a cube map
+            uint32_t numFaces = 1;
+            /// true if rows are stored bottom first, matching stbi_set_flip_vertically_on_load(true)
+            bool flippedOnY = false;
+            /// encoded bytes indexed by [level][face]
+            std::vector< std::vector< std::vector<uint8_t> > > levels;
+        };
+
+        /**
+         * @brief builds a full mip chain down to 1x1 with a 2x2 box filter
+         * @param base level 0 image
+         * @returns all levels, base first
+         */
+        [[maybe_unused]] std::vector<Image> generateMipChain( const Image& base );
+
+        /**
+         * @brief returns true if any pixel of the image is not fully opaque
+         * @param image image to inspect
+         */
+        [[maybe_unused]] bool hasAlpha( const Image& image );
+
+        /**
+         * @brief encodes an image into the requested format
+         * @param image image to encode
+         * @param format encoding to use
+         * @returns encoded bytes, blocks in row major order
+         */
+        [[maybe_unused]] std::vector<uint8_t> encode( const Image& image, Format format );
+
+        /**
+         * @brief writes a texture to a KTX 1.1 file
+         * @param filename name of file to write
+         * @param texture texture to write
+         * @returns true if the file was written, false otherwise
+         */
+        [[maybe_unused]] bool writeKTX( const char* filename, const Texture& texture );
+
+        /**
+         * @brief reads a KTX 1.1 file written by writeKTX()
+         * @param filename name of file to read
+         * @param[out] texture will contain the texture upon successful completion
+         * @param headerOnly if true, stops after the format, size and orientation and leaves levels empty (default: false)
+         * @returns true if the file was read, false otherwise
+         */
+        [[maybe_unused]] bool readKTX( const char* filename, Texture& texture, bool headerOnly = false );
+
+        /**
+         * @brief returns the number of bytes one encoded level occupies
+         * @param format encoding of the level
+         * @param width width of the level in pixels
+         * @param height height of the level in pixels
+         */
+        [[maybe_unused]] size_t levelSize( Format format, uint32_t width, uint32_t height );
+    }
+}
+
+//**********************************************************************************
+// Internal helper implementations
+
+namespace CSCI441_INTERNAL {
+    void encodeBC1Block( const uint8_t rgba[64], uint8_t* out );
+    void encodeBC3AlphaBlock( const uint8_t rgba[64], uint8_t* out );
+    void encodeBC7Block( const uint8_t rgba[64], uint8_t* out );
+    inline const uint8_t KTX_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    inline const char KTX_ORIENTATION_KEY[] = "KTXorientation";
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+[[maybe_unused]]
+inline std::vector<CSCI441::KTXUtils::Image> CSCI441::KTXUtils::generateMipChain( const Image& base ) {
+    std::vector<Image> chain;
+    chain.push_back( base );
+    while( chain.back().width > 1 || chain.back().height > 1 ) {
+        const Image& src = chain.back();
+        Image dst;
+        dst.width = std::max( 1u, src.width / 2 );
+        dst.height = std::max( 1u, src.height / 2 );
+        dst.pixels.resize( static_cast<size_t>(dst.width) * dst.height * 4 );
+        for( uint32_t y = 0; y < dst.height; y++ ) {
+            const uint32_t y0 = std::min( y * 2, src.height - 1 ), y1 = std::min( y * 2 + 1, src.height - 1 );
+            for( uint32_t x = 0; x < dst.width; x++ ) {
+                const uint32_t x0 = std::min( x * 2, src.width - 1 ), x1 = std::min( x * 2 + 1, src.width - 1 );
+                for( int c = 0; c < 4; c++ ) {
+                    const unsigned int sum = src.pixels[(y0 * src.width + x0) * 4 + c] + src.pixels[(y0 * src.width + x1) * 4 + c]
+                                           + src.pixels[(y1 * src.width + x0) * 4 + c] + src.pixels[(y1 * src.width + x1) * 4 + c];
+                    dst.pixels[(y * dst.width + x) * 4 + c] = static_cast<uint8_t>( (sum + 2) / 4 );
+                }
+            }
+        }
+        chain.push_back( std::move(dst) );
+    }
+    return chain;
+}
+
+[[maybe_unused]]
+inline bool CSCI441::KTXUtils::hasAlpha( const Image& image ) {
+    for( size_t i = 3; i < image.pixels.size(); i += 4 ) {
+        if( image.pixels[i] != 255 ) return true;
+    }
+    return false;
+}
+
+[[maybe_unused]]
+inline size_t CSCI441::KTXUtils::levelSize( const Format format, const uint32_t width, const uint32_t height ) {
+    const size_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    switch( format ) {
+        case Format::BC1:   return blocksX * blocksY * 8;
+        case Format::BC3:
+        case Format::BC7:   return blocksX * blocksY * 16;
+        default:            return static_cast<size_t>(width) * height * 4;
+    }
+}
+
+[[maybe_unused]]
+inline std::vector<uint8_t> CSCI441::KTXUtils::encode( const Image& image, const Format format ) {
+    if( format == Format::RGBA8 ) return image.pixels;
+
+    std::vector<uint8_t> out( levelSize( format, image.width, image.height ) );
+    const size_t BLOCK_BYTES = (format == Format::BC1 ? 8 : 16);
+    const uint32_t blocksX = (image.width + 3) / 4, blocksY = (image.height + 3) / 4;
+
+    uint8_t block[64];
+    for( uint32_t by = 0; by < blocksY; by++ ) {
+        for( uint32_t bx = 0; bx < blocksX; bx++ ) {
+            // gather the 4x4 block, repeating edge pixels for sizes that are not a multiple of four
+            for( uint32_t py = 0; py < 4; py++ ) {
+                const uint32_t y = std::min( by * 4 + py, image.height - 1 );
+                for( uint32_t px = 0; px < 4; px++ ) {
+                    const uint32_t x = std::min( bx * 4 + px, image.width - 1 );
+                    memcpy( block + (py * 4 + px) * 4, image.pixels.data() + (static_cast<size_t>(y) * image.width + x) * 4, 4 );
+                }
+            }
+
+            uint8_t* dst = out.data() + (static_cast<size_t>(by) * blocksX + bx) * BLOCK_BYTES;
+            switch( format ) {
+                case Format::BC1:
+                    CSCI441_INTERNAL::encodeBC1Block( block, dst );
+                    break;
+                case Format::BC3:
+                    CSCI441_INTERNAL::encodeBC3AlphaBlock( block, dst );
+                    CSCI441_INTERNAL::encodeBC1Block( block, dst + 8 );
+                    break;
+                default:
+                    CSCI441_INTERNAL::encodeBC7Block( block, dst );
+                    break;
+            }
+        }
+    }
+    return out;
+}
+
+[[maybe_unused]]
+inline bool CSCI441::KTXUtils::writeKTX( const char* filename, const Texture& texture ) {
+    FILE* fp = fopen( filename, "wb" );
+    if( !fp ) {
+        CSCI441_LOG_ERROR( "CSCI441::KTXUtils::writeKTX(): Could not open \"%s\" for writing", filename );
+        return false;
+    }
+
+    const bool COMPRESSED = texture.format != Format::RGBA8;
+
+    // orientation is stored as a key/value pair, padded to four bytes
+    const std::string orientation = texture.flippedOnY ? "S=r,T=u" : "S=r,T=d";
+    const uint32_t keyValueSize = static_cast<uint32_t>( sizeof(CSCI441_INTERNAL::KTX_ORIENTATION_KEY) + orientation.size() + 1 );
+    const uint32_t keyValuePadding = (4 - keyValueSize % 4) % 4;
+
+    const uint32_t header[13] = {
+        0x04030201,                                         // endianness
+        COMPRESSED ? 0u : 0x1401u,                          // glType (GL_UNSIGNED_BYTE)
+        1,                                                  // glTypeSize
+        COMPRESSED ? 0u : 0x1908u,                          // glFormat (GL_RGBA)
+        static_cast<uint32_t>(texture.format),              // glInternalFormat
+        0x1908,                                             // glBaseInternalFormat (GL_RGBA)
+        texture.width,
+        texture.height,
+        0,                                                  // pixelDepth
+        0,                                                  // numberOfArrayElements
+        texture.numFaces,
+        static_cast<uint32_t>(texture.levels.size()),
+        4 + keyValueSize + keyValuePadding                  // bytesOfKeyValueData
+    };
+    const uint8_t zeros[4] = { 0, 0, 0, 0 };
+
+    fwrite( CSCI441_INTERNAL::KTX_IDENTIFIER, 1, 12, fp );
+    fwrite( header, sizeof(uint32_t), 13, fp );
+    fwrite( &keyValueSize, sizeof(uint32_t), 1, fp );
+    fwrite( CSCI441_INTERNAL::KTX_ORIENTATION_KEY, 1, sizeof(CSCI441_INTERNAL::KTX_ORIENTATION_KEY), fp );
+    fwrite( orientation.c_str(), 1, orientation.size() + 1, fp );
+    fwrite( zeros, 1, keyValuePadding, fp );
+
+    for( const auto& faces : texture.levels ) {
+        const auto imageSize = static_cast<uint32_t>( faces.front().size() );
+        fwrite( &imageSize, sizeof(uint32_t), 1, fp );
+        for( const auto& face : faces ) {
+            fwrite( face.data(), 1, face.size(), fp );
+            fwrite( zeros, 1, (4 - face.size() % 4) % 4, fp );
+        }
+    }
+
+    const bool SUCCESS = !ferror( fp );
+    fclose( fp );
+    return SUCCESS;
+}
+
+[[maybe_unused]]
+inline bool CSCI441::KTXUtils::readKTX( const char* filename, Texture& texture, const bool headerOnly ) {
+    FILE* fp = fopen( filename, "rb" );
+    if( !fp ) return false;
+
+    uint8_t identifier[12];
+    uint32_t header[13];
+    if( fread( identifier, 1, 12, fp ) != 12
+        || memcmp( identifier, CSCI441_INTERNAL::KTX_IDENTIFIER, 12 ) != 0
+        || fread( header, sizeof(uint32_t), 13, fp ) != 13
+        || header[0] != 0x04030201 ) {
+        CSCI441_LOG_ERROR( "CSCI441::KTXUtils::readKTX(): \"%s\" is not a little endian KTX 1.1 file", filename );
+        fclose( fp );
+        return false;
+    }
+
+    texture.format = static_cast<Format>( header[4] );
+    if( texture.format != Format::RGBA8 && texture.format != Format::BC1
+        && texture.format != Format::BC3 && texture.format != Format::BC7 ) {
+        CSCI441_LOG_ERROR( "CSCI441::KTXUtils::readKTX(): \"%s\" uses unsupported internal format 0x%X", filename, header[4] );
+        fclose( fp );
+        return false;
+    }
+    texture.width = header[6];
+    texture.height = std::max( 1u, header[7] );
+    texture.numFaces = header[10];
+    const uint32_t numLevels = std::max( 1u, header[11] );
+
+    // every size below comes from the header, so check it against the file before allocating
+    const long HEADER_END = ftell( fp );
+    fseek( fp, 0, SEEK_END );
+    const long FILE_SIZE = ftell( fp );
+    fseek( fp, HEADER_END, SEEK_SET );
+    const auto bytesRemaining = [fp, FILE_SIZE]() { return static_cast<size_t>( FILE_SIZE - ftell( fp ) ); };
+
+    uint32_t maxLevels = 1;
+    while( maxLevels < 32 && std::max( texture.width, texture.height ) >> maxLevels ) maxLevels++;
+    if( texture.width == 0 || (texture.numFaces != 1 && texture.numFaces != 6) || numLevels > maxLevels ) {
+        CSCI441_LOG_ERROR( "CSCI441::KTXUtils::readKTX(): \"%s\" has an invalid header (%ux%u, %u faces, %u levels)",
+                           filename, header[6], header[7], header[10], header[11] );
+        fclose( fp );
+        return false;
+    }
+
+    // scan the key/value pairs for the orientation
+    texture.flippedOnY = false;
+    if( header[12] > bytesRemaining() ) {
+        CSCI441_LOG_ERROR( "CSCI441::KTXUtils::readKTX(): \"%s\" is truncated in its key/value data", filename );
+        fclose( fp );
+        return false;
+    }
+    std::vector<uint8_t> keyValueData( header[12] );
+    if( !keyValueData.empty() && fread( keyValueData.data(), 1, keyValueData.size(), fp ) != keyValueData.size() ) {
+        fclose( fp );
+        return false;
+    }
+    for( size_t offset = 0; offset + 4 <= keyValueData.size(); ) {
+        uint32_t pairSize;
+        memcpy( &pairSize, keyValueData.data() + offset, 4 );
+        const char* pair = reinterpret_cast<const char*>( keyValueData.data() + offset + 4 );
+        if( offset + 4 + pairSize <= keyValueData.size()
+            && pairSize > sizeof(CSCI441_INTERNAL::KTX_ORIENTATION_KEY)
+            && strcmp( pair, CSCI441_INTERNAL::KTX_ORIENTATION_KEY ) == 0 ) {
+            texture.flippedOnY = strstr( pair + sizeof(CSCI441_INTERNAL::KTX_ORIENTATION_KEY), "T=u" ) != nullptr;
+        }
+        offset += 4 + pairSize + (4 - pairSize % 4) % 4;
+    }
+
+    texture.levels.clear();
+    if( headerOnly ) {
+        fclose( fp );
+        return true;
+    }
+
+    texture.levels.assign( numLevels, std::vector< std::vector<uint8_t> >( texture.numFaces ) );
+    for( uint32_t level = 0; level < numLevels; level++ ) {
+        uint32_t imageSize;
+        if( fread( &imageSize, sizeof(uint32_t), 1, fp ) != 1 ) {
+            fclose( fp );
+            return false;
+        }
+        // each face is exactly one encoded level, padded to four bytes
+        const size_t EXPECTED_SIZE = levelSize( texture.format, std::max( 1u, texture.width >> level ), std::max( 1u, texture.height >> level ) );
+        const size_t PADDED_SIZE = static_cast<size_t>(imageSize) + (4 - imageSize % 4) % 4;
+        if( imageSize != EXPECTED_SIZE ) {
+            CSCI441_LOG_ERROR( "CSCI441::KTXUtils::readKTX(): \"%s\" level %u holds %u bytes per face, expected %zu",
+                               filename, level, imageSize, EXPECTED_SIZE );
+            texture.levels.clear();
+            fclose( fp );
+            return false;
+        }
+        if( PADDED_SIZE * texture.numFaces > bytesRemaining() ) {
+            CSCI441_LOG_ERROR( "CSCI441::KTXUtils::readKTX(): \"%s\" is truncated in level %u", filename, level );
+            texture.levels.clear();
+            fclose( fp );
+            return false;
+        }
+        for( auto& face : texture.levels[level] ) {
+            face.resize( imageSize );
+            uint8_t padding[4];
+            if( fread( face.data(), 1, imageSize, fp ) != imageSize
+                || fread( padding, 1, (4 - imageSize % 4) % 4, fp ) != (4 - imageSize % 4) % 4 ) {
+                fclose( fp );
+                return false;
+            }
+        }
+    }
+
+    fclose( fp );
+    return true;
+}
+
+//**********************************************************************************
+// Internal block encoders
+
+inline void CSCI441_INTERNAL::encodeBC1Block( const uint8_t rgba[64], uint8_t* out ) {
+    // bounding box endpoints inset by 1/16 of the range to reduce error at the extremes
+    int minColor[3] = { 255, 255, 255 }, maxColor[3] = { 0, 0, 0 };
+    for( int i = 0; i < 16; i++ ) {
+        for( int c = 0; c < 3; c++ ) {
+            minColor[c] = std::min( minColor[c], static_cast<int>( rgba[i * 4 + c] ) );
+            maxColor[c] = std::max( maxColor[c], static_cast<int>( rgba[i * 4 + c] ) );
+        }
+    }
+    for( int c = 0; c < 3; c++ ) {
+        const int inset = (maxColor[c] - minColor[c]) >> 4;
+        minColor[c] = std::min( 255, minColor[c] + inset );
+        maxColor[c] = std::max( 0, maxColor[c] - inset );
+    }
+
+    auto to565 = []( const int* color ) -> uint16_t {
+        return static_cast<uint16_t>( ((color[0] >> 3) << 11) | ((color[1] >> 2) << 5) | (color[2] >> 3) );
+    };
+    uint16_t c0 = to565( maxColor ), c1 = to565( minColor );
+    if( c0 < c1 ) std::swap( c0, c1 );
+
+    // expand the quantized endpoints back to 8 bits to build the palette
+    int palette[4][3];
+    const uint16_t endpoints[2] = { c0, c1 };
+    for( int e = 0; e < 2; e++ ) {
+        const int r = (endpoints[e] >> 11) & 31, g = (endpoints[e] >> 5) & 63, b = endpoints[e] & 31;
+        palette[e][0] = (r << 3) | (r >> 2);
+        palette[e][1] = (g << 2) | (g >> 4);
+        palette[e][2] = (b << 3) | (b >> 2);
+    }
+    for( int c = 0; c < 3; c++ ) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+    }
+
+    uint32_t indices = 0;
+    if( c0 != c1 ) {
+        for( int i = 0; i < 16; i++ ) {
+            int bestIndex = 0, bestError = 1 << 30;
+            for( int p = 0; p < 4; p++ ) {
+                int error = 0;
+                for( int c = 0; c < 3; c++ ) {
+                    const int d = rgba[i * 4 + c] - palette[p][c];
+                    error += d * d;
+                }
+                if( error < bestError ) { bestError = error; bestIndex = p; }
+            }
+            indices |= static_cast<uint32_t>( bestIndex ) << (i * 2);
+        }
+    }
+
+    out[0] = c0 & 0xFF; out[1] = c0 >> 8;
+    out[2] = c1 & 0xFF; out[3] = c1 >> 8;
+    for( int i = 0; i < 4; i++ ) out[4 + i] = static_cast<uint8_t>( indices >> (i * 8) );
+}
+
+inline void CSCI441_INTERNAL::encodeBC3AlphaBlock( const uint8_t rgba[64], uint8_t* out ) {
+    int a0 = 0, a1 = 255;
+    for( int i = 0; i < 16; i++ ) {
+        a0 = std::max( a0, static_cast<int>( rgba[i * 4 + 3] ) );
+        a1 = std::min( a1, static_cast<int>( rgba[i * 4 + 3] ) );
+    }
+
+    uint64_t indices = 0;
+    if( a0 != a1 ) {
+        // a0 > a1 selects the eight value palette
+        int palette[8] = { a0, a1 };
+        for( int p = 1; p < 7; p++ ) palette[p + 1] = ((7 - p) * a0 + p * a1 + 3) / 7;
+        for( int i = 0; i < 16; i++ ) {
+            int bestIndex = 0, bestError = 256;
+            for( int p = 0; p < 8; p++ ) {
+                const int error = std::abs( rgba[i * 4 + 3] - palette[p] );
+                if( error < bestError ) { bestError = error; bestIndex = p; }
+            }
+            indices |= static_cast<uint64_t>( bestIndex ) << (i * 3);
+        }
+    }
+
+    out[0] = static_cast<uint8_t>( a0 );
+    out[1] = static_cast<uint8_t>( a1 );
+    for( int i = 0; i < 6; i++ ) out[2 + i] = static_cast<uint8_t>( indices >> (i * 8) );
+}
+
+inline void CSCI441_INTERNAL::encodeBC7Block( const uint8_t rgba[64], uint8_t* out ) {
+    // mode 6: one subset, 7-bit RGBA endpoints with a unique p-bit each, 4-bit indices
+    static const int WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    int lo[4] = { 255, 255, 255, 255 }, hi[4] = { 0, 0, 0, 0 };
+    for( int i = 0; i < 16; i++ ) {
+        for( int c = 0; c < 4; c++ ) {
+            lo[c] = std::min( lo[c], static_cast<int>( rgba[i * 4 + c] ) );
+            hi[c] = std::max( hi[c], static_cast<int>( rgba[i * 4 + c] ) );
+        }
+    }
+
+    // quantize each endpoint, choosing the p-bit that best reproduces it
+    int q[2][4], pBit[2], endpoint[2][4];
+    const int* targets[2] = { lo, hi };
+    for( int e = 0; e < 2; e++ ) {
+        int bestError = 1 << 30;
+        for( int p = 0; p < 2; p++ ) {
+            int candidate[4], error = 0;
+            for( int c = 0; c < 4; c++ ) {
+                candidate[c] = std::clamp( (targets[e][c] - p + 1) >> 1, 0, 127 );
+                error += std::abs( ((candidate[c] << 1) | p) - targets[e][c] );
+            }
+            if( error < bestError ) {
+                bestError = error;
+                pBit[e] = p;
+                memcpy( q[e], candidate, sizeof(candidate) );
+            }
+        }
+        for( int c = 0; c < 4; c++ ) endpoint[e][c] = (q[e][c] << 1) | pBit[e];
+    }
+
+    int indices[16];
+    for( int i = 0; i < 16; i++ ) {
+        int bestIndex = 0, bestError = 1 << 30;
+        for( int w = 0; w < 16; w++ ) {
+            int error = 0;
+            for( int c = 0; c < 4; c++ ) {
+                const int value = ((64 - WEIGHTS[w]) * endpoint[0][c] + WEIGHTS[w] * endpoint[1][c] + 32) >> 6;
+                const int d = rgba[i * 4 + c] - value;
+                error += d * d;
+            }
+            if( error < bestError ) { bestError = error; bestIndex = w; }
+        }
+        indices[i] = bestIndex;
+    }
+
+    // the anchor index drops its high bit, so the first pixel must use the lower half
+    if( indices[0] >= 8 ) {
+        std::swap( q[0], q[1] );
+        std::swap( pBit[0], pBit[1] );
+        for( int& index : indices ) index = 15 - index;
+    }
+
+    uint64_t bits[2] = { 0, 0 };
+    int position = 0;
+    auto put = [&]( uint64_t value, int numBits ) {
+        for( int b = 0; b < numBits; b++, position++ ) {
+            bits[position / 64] |= ((value >> b) & 1ull) << (position % 64);
+        }
+    };
+    put( 1ull << 6, 7 );
+    for( int c = 0; c < 4; c++ ) {
+        put( q[0][c], 7 );
+        put( q[1][c], 7 );
+    }
+    put( pBit[0], 1 );
+    put( pBit[1], 1 );
+    put( indices[0], 3 );
+    for( int i = 1; i < 16; i++ ) put( indices[i], 4 );
+
+    for( int i = 0; i < 8; i++ ) {
+        out[i]     = static_cast<uint8_t>( bits[0] >> (i * 8) );
+        out[8 + i] = static_cast<uint8_t>( bits[1] >> (i * 8) );
+    }
+}
+
+#endif // CSCI441_KTX_UTILS_HPP
@@ -0,0 +1,113 @@
+/** @file LODSelector.hpp
+ * @brief Chooses a level of detail from an object's projected size on screen
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Screen size is measured as the projected diameter of an object's bounding sphere
+ *	divided by the viewport height, so the same thresholds work at any resolution and
+ *	in any viewport, including picture-in-picture views.
+ *
+ *	@warning This header file depends upon glm
+ */
+
+#ifndef CSCI441_LOD_SELECTOR_HPP
+#define CSCI441_LOD_SELECTOR_HPP
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include <glm/glm.hpp>
+
+#include <initializer_list>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class LODSelector
+     * @brief maps projected screen size to a level of detail
+     */
+    class [[maybe_unused]] LODSelector final {
+    public:
+        /**
+         * @brief creates a selector with the default thresholds for four levels
+         * @note level 0 above 25% of the screen height, 1 above 10%, 2 above 4%, 3 otherwise
+         */
+        LODSelector() : _thresholds{ 0.25f, 0.10f, 0.04f } {}
+        /**
+         * @brief creates a selector with custom thresholds
+         * @param thresholds minimum screen size for each level, in decreasing order. An object
+         * smaller than every threshold uses the last level, thresholds.size()
+         */
+        [[maybe_unused]] LODSelector( std::initializer_list<float> thresholds ) : _thresholds(thresholds) {}
+
+        /**
+         * @brief returns the number of levels the selector chooses between
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint getNumberOfLevels() const { return static_cast<GLuint>( _thresholds.size() ) + 1; }
+
+        /**
+         * @brief selects the level of detail for an object
+         * @param worldCenter center of the object's bounding sphere in world space
+         * @param worldRadius radius of the object's bounding sphere in world space
+         * @param viewMtx current view matrix
+         * @param projMtx current perspective projection matrix
+         * @returns level of detail, 0 being the most detailed
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint select( const glm::vec3& worldCenter, float worldRadius,
+                                                      const glm::mat4& viewMtx, const glm::mat4& projMtx ) const;
+        /**
+         * @brief selects the level of detail for a given screen size
+         * @param screenSize projected diameter as a fraction of the viewport height
+         * @returns level of detail, 0 being the most detailed
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint select( float screenSize ) const;
+
+        /**
+         * @brief computes the projected diameter of a bounding sphere as a fraction of the viewport height
+         * @param worldCenter center of the sphere in world space
+         * @param worldRadius radius of the sphere in world space
+         * @param viewMtx current view matrix
+         * @param projMtx current perspective projection matrix
+         * @returns screen size, greater than 1 if the sphere is taller than the viewport
+         */
+        [[maybe_unused]] [[nodiscard]] static float projectedScreenSize( const glm::vec3& worldCenter, float worldRadius,
+                                                                         const glm::mat4& viewMtx, const glm::mat4& projMtx );
+
+    private:
+        std::vector<float> _thresholds;
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+[[maybe_unused]]
+inline GLuint CSCI441::LODSelector::select( const glm::vec3& worldCenter, const float worldRadius, const glm::mat4& viewMtx, const glm::mat4& projMtx ) const {
+    return select( projectedScreenSize( worldCenter, worldRadius, viewMtx, projMtx ) );
+}
+
+[[maybe_unused]]
+inline GLuint CSCI441::LODSelector::select( const float screenSize ) const {
+    GLuint level = 0;
+    while( level < _thresholds.size() && screenSize < _thresholds[level] ) level++;
+    return level;
+}
+
+[[maybe_unused]]
+inline float CSCI441::LODSelector::projectedScreenSize( const glm::vec3& worldCenter, const float worldRadius, const glm::mat4& viewMtx, const glm::mat4& projMtx ) {
+    const glm::vec4 viewCenter = viewMtx * glm::vec4( worldCenter, 1.0f );
+    const float depth = -viewCenter.z;
+    // inside or touching the sphere it covers the whole screen
+    if( depth <= worldRadius ) return 1.0f;
+    // projMtx[1][1] is cot(fovy/2), mapping view space height to NDC which spans two units
+    return worldRadius * projMtx[1][1] / depth;
+}
+
+#endif // CSCI441_LOD_SELECTOR_HPP
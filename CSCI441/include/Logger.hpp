@@ -0,0 +1,454 @@
+/** @file Logger.hpp
+ * @brief Asynchronous logging with deferred formatting and per call site rate limiting
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	The CSCI441_LOG_* macros take a printf format string and its arguments.  The
+ *	calling thread only copies the arguments into a fixed size record of a
+ *	lock-free ring buffer (strings are copied, truncated if the record is full);
+ *	a background thread formats the records and writes them, flushing once per
+ *	batch instead of once per line.  Any number of threads may log at once.
+ *
+ *		CSCI441_LOG_ERROR( "Could not open \"%s\"", filename );
+ *
+ *	prints "[ERROR]: Could not open "..."" followed by a newline.  Debug and info
+ *	messages go to stdout, warnings and errors to stderr.  Each call site prints at
+ *	most MAX_MESSAGES_PER_SECOND messages per second; the next message it prints
+ *	after a burst tells how many were suppressed.  When the ring buffer is full
+ *	the message is dropped rather than blocking the caller.
+ *
+ *	@warning the format string must be a string literal
+ */
+
+#ifndef CSCI441_LOGGER_HPP
+#define CSCI441_LOGGER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+//**********************************************************************************
+
+#define CSCI441_LOG( SEVERITY, FORMAT, ... ) do {                                           \
+        static CSCI441::LogRateLimiter csci441LogRateLimiter;                               \
+        if( CSCI441::Logger::instance().isEnabled( SEVERITY ) ) {                           \
+            (void)sizeof( printf( FORMAT, ##__VA_ARGS__ ) );   /* format checking only */   \
+            unsigned int csci441LogSuppressed;                                              \
+            if( csci441LogRateLimiter.allow( csci441LogSuppressed ) )                       \
+                CSCI441::Logger::instance().log( SEVERITY, csci441LogSuppressed, FORMAT, ##__VA_ARGS__ ); \
+        }                                                                                   \
+    } while( false )
+
+/// logs a debug message, printed only after setMinimumSeverity( SEVERITY_DEBUG )
+#define CSCI441_LOG_DEBUG( FORMAT, ... )   CSCI441_LOG( CSCI441::Logger::SEVERITY_DEBUG,   FORMAT, ##__VA_ARGS__ )
+/// logs an info message to stdout
+#define CSCI441_LOG_INFO( FORMAT, ... )    CSCI441_LOG( CSCI441::Logger::SEVERITY_INFO,    FORMAT, ##__VA_ARGS__ )
+/// logs a warning to stderr
+#define CSCI441_LOG_WARNING( FORMAT, ... ) CSCI441_LOG( CSCI441::Logger::SEVERITY_WARNING, FORMAT, ##__VA_ARGS__ )
+/// logs an error to stderr
+#define CSCI441_LOG_ERROR( FORMAT, ... )   CSCI441_LOG( CSCI441::Logger::SEVERITY_ERROR,   FORMAT, ##__VA_ARGS__ )
+
+//**********************************************************************************
+
+namespace CSCI441_INTERNAL {
+    /// size of the encoded arguments of one message
+    constexpr size_t LOG_PAYLOAD_SIZE = 216;
+
+    /// how an argument is stored in a record: as printf receives it after default promotions
+    template<typename T, typename = void> struct LogArgument { using Stored = T; static constexpr bool IS_STRING = false; };
+    template<typename T> struct LogArgument<T, std::enable_if_t<std::is_floating_point<T>::value>> { using Stored = double; static constexpr bool IS_STRING = false; };
+    template<typename T> struct LogArgument<T, std::enable_if_t<std::is_integral<T>::value>> { using Stored = std::conditional_t<(sizeof(T) < sizeof(int)), int, T>; static constexpr bool IS_STRING = false; };
+    template<typename T> struct LogArgument<T, std::enable_if_t<std::is_enum<T>::value>> { using Stored = typename LogArgument< std::underlying_type_t<T> >::Stored; static constexpr bool IS_STRING = false; };
+    template<> struct LogArgument<const char*> { using Stored = const char*; static constexpr bool IS_STRING = true; };
+    template<> struct LogArgument<char*> { using Stored = const char*; static constexpr bool IS_STRING = true; };
+    template<> struct LogArgument<const unsigned char*> { using Stored = const char*; static constexpr bool IS_STRING = true; };
+    template<> struct LogArgument<unsigned char*> { using Stored = const char*; static constexpr bool IS_STRING = true; };
+
+    /// stored type of an argument as passed to the logging macro
+    template<typename T>
+    using LogStored = typename LogArgument< std::decay_t<T> >::Stored;
+
+    /// copies arguments into a record's payload
+    class LogPayloadWriter {
+    public:
+        explicit LogPayloadWriter( unsigned char* payload ) : _payload( payload ), _offset( 0 ) {}
+
+        template<typename T>
+        void put( const T& value ) {
+            using Argument = LogArgument< std::decay_t<T> >;
+            if constexpr( Argument::IS_STRING ) {
+                _putString( value != nullptr ? reinterpret_cast<const char*>(value) : "(null)" );
+            } else {
+                const typename Argument::Stored stored = static_cast<typename Argument::Stored>( value );
+                if( _offset + sizeof(stored) <= LOG_PAYLOAD_SIZE ) {
+                    memcpy( _payload + _offset, &stored, sizeof(stored) );
+                }
+                _offset += sizeof(stored);
+            }
+        }
+
+    private:
+        void _putString( const char* str ) {
+            if( _offset >= LOG_PAYLOAD_SIZE ) return;
+            const size_t length = std::min( strlen( str ), LOG_PAYLOAD_SIZE - _offset - 1 );
+            memcpy( _payload + _offset, str, length );
+            _payload[_offset + length] = '\0';
+            _offset += length + 1;
+        }
+
+        unsigned char* _payload;
+        size_t _offset;
+    };
+
+    /// reads arguments back in the order they were written
+    class LogPayloadReader {
+    public:
+        explicit LogPayloadReader( const unsigned char* payload ) : _payload( payload ), _offset( 0 ) {}
+
+        template<typename Stored>
+        Stored get() {
+            if constexpr( std::is_same<Stored, const char*>::value ) {
+                if( _offset >= LOG_PAYLOAD_SIZE ) return "";
+                const auto str = reinterpret_cast<const char*>( _payload + _offset );
+                _offset += strlen( str ) + 1;
+                return str;
+            } else {
+                Stored stored{};
+                if( _offset + sizeof(stored) <= LOG_PAYLOAD_SIZE ) {
+                    memcpy( &stored, _payload + _offset, sizeof(stored) );
+                }
+                _offset += sizeof(stored);
+                return stored;
+            }
+        }
+
+    private:
+        const unsigned char* _payload;
+        size_t _offset;
+    };
+
+    /// formats a record with the argument types it was written with
+    template<typename... Stored>
+    int formatLogRecord( const char* format, const unsigned char* payload, char* out, const size_t size ) {
+        LogPayloadReader reader( payload );
+        // braced initialization reads the arguments left to right
+        const std::tuple<Stored...> values{ reader.template get<Stored>()... };
+        return std::apply( [format, out, size]( const Stored&... args ) {
+#if defined(__GNUC__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wformat-nonliteral"
+    #pragma GCC diagnostic ignored "-Wformat-security"
+#endif
+            // the macros check the literal format against the arguments at the call site
+            return snprintf( out, size, format, args... );
+#if defined(__GNUC__)
+    #pragma GCC diagnostic pop
+#endif
+        }, values );
+    }
+}
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class LogRateLimiter
+     * @brief limits how many messages one call site logs per second, one static instance per CSCI441_LOG_* call
+     */
+    class [[maybe_unused]] LogRateLimiter final {
+    public:
+        /**
+         * @brief messages a call site may log within one second
+         */
+        static constexpr unsigned int MAX_MESSAGES_PER_SECOND = 10;
+
+        /**
+         * @brief returns true if the message may be logged
+         * @param suppressed set to the number of messages suppressed since the last one logged
+         */
+        [[maybe_unused]] bool allow( unsigned int& suppressed ) noexcept;
+
+    private:
+        std::atomic<int64_t> _windowStart{ 0 };
+        std::atomic<unsigned int> _numInWindow{ 0 };
+        std::atomic<unsigned int> _numSuppressed{ 0 };
+    };
+
+    /**
+     * @class Logger
+     * @brief multiple producer ring buffer of log messages drained and formatted by a background thread
+     */
+    class [[maybe_unused]] Logger final {
+    public:
+        /**
+         * @brief message severities, in increasing order
+         */
+        enum Severity {
+            SEVERITY_DEBUG,
+            SEVERITY_INFO,
+            SEVERITY_WARNING,
+            SEVERITY_ERROR
+        };
+
+        /**
+         * @brief number of messages the ring buffer holds before dropping new ones
+         */
+        static constexpr size_t CAPACITY = 1024;
+
+        /**
+         * @brief returns the logger, starting its writer thread on first use
+         */
+        [[maybe_unused]] static Logger& instance();
+
+        /**
+         * @brief do not allow the logger to be copied
+         */
+        Logger(const Logger&) = delete;
+        /**
+         * @brief do not allow the logger to be copied
+         */
+        Logger& operator=(const Logger&) = delete;
+
+        /**
+         * @brief messages below this severity are discarded at the call site
+         * @note defaults to SEVERITY_INFO
+         */
+        [[maybe_unused]] void setMinimumSeverity( Severity severity ) { _minimumSeverity.store( severity, std::memory_order_relaxed ); }
+        /**
+         * @brief returns true if messages of this severity are logged
+         */
+        [[maybe_unused]] [[nodiscard]] bool isEnabled( Severity severity ) const { return severity >= _minimumSeverity.load( std::memory_order_relaxed ); }
+
+        /**
+         * @brief copies the arguments into the ring buffer to be formatted and written later
+         * @param suppressed number of messages the call site suppressed before this one
+         * @param format printf format string, must be a string literal
+         * @returns false if the ring buffer was full and the message was dropped
+         * @note use the CSCI441_LOG_* macros, which check the format and rate limit the call site
+         */
+        template<typename... Args>
+        [[maybe_unused]] bool log( Severity severity, unsigned int suppressed, const char* format, const Args&... args );
+
+        /**
+         * @brief blocks until every message logged so far has been written
+         */
+        [[maybe_unused]] void flush();
+
+        /**
+         * @brief returns the number of messages dropped because the ring buffer was full
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getNumberOfDroppedMessages() const { return _numDropped.load( std::memory_order_relaxed ); }
+
+    private:
+        Logger();
+        ~Logger();
+
+        using FormatFunction = int(*)( const char* format, const unsigned char* payload, char* out, size_t size );
+
+        struct Record {
+            Severity severity;
+            unsigned int suppressed;
+            const char* format;
+            FormatFunction formatFunction;
+            unsigned char payload[CSCI441_INTERNAL::LOG_PAYLOAD_SIZE];
+        };
+
+        // a slot is free for the producer claiming position p when sequence == p and
+        // holds a message for the writer when sequence == p + 1
+        struct Slot {
+            std::atomic<size_t> sequence;
+            Record record;
+        };
+
+        Slot* _slots;
+        std::atomic<size_t> _enqueuePosition;
+        std::atomic<size_t> _dequeuePosition;     // written by the writer thread only
+        std::atomic<size_t> _numDropped;
+        size_t _numDroppedReported;
+        std::atomic<int> _minimumSeverity;
+
+        std::thread _writerThread;
+        std::mutex _wakeMutex;
+        std::condition_variable _wake;
+        std::atomic<bool> _stop;
+
+        Slot* _claim();
+        void _publish( Slot* slot );
+        bool _writePending();
+        void _run();
+    };
+}
+
+//**********************************************************************************
+//**********************************************************************************
+// Outward facing function implementations
+
+[[maybe_unused]]
+inline bool CSCI441::LogRateLimiter::allow( unsigned int& suppressed ) noexcept {
+    const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    int64_t windowStart = _windowStart.load( std::memory_order_relaxed );
+    if( now - windowStart >= 1000 && _windowStart.compare_exchange_strong( windowStart, now, std::memory_order_relaxed ) ) {
+        _numInWindow.store( 0, std::memory_order_relaxed );
+    }
+    if( _numInWindow.fetch_add( 1, std::memory_order_relaxed ) < MAX_MESSAGES_PER_SECOND ) {
+        suppressed = _numSuppressed.exchange( 0, std::memory_order_relaxed );
+        return true;
+    }
+    _numSuppressed.fetch_add( 1, std::memory_order_relaxed );
+    return false;
+}
+
+[[maybe_unused]]
+inline CSCI441::Logger& CSCI441::Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+template<typename... Args>
+[[maybe_unused]]
+inline bool CSCI441::Logger::log( const Severity severity, const unsigned int suppressed, const char* format, const Args&... args ) {
+    Slot* slot = _claim();
+    if( slot == nullptr ) {
+        _numDropped.fetch_add( 1, std::memory_order_relaxed );
+        return false;
+    }
+
+    Record& record = slot->record;
+    record.severity = severity;
+    record.suppressed = suppressed;
+    record.format = format;
+    record.formatFunction = &CSCI441_INTERNAL::formatLogRecord< CSCI441_INTERNAL::LogStored<Args>... >;
+    CSCI441_INTERNAL::LogPayloadWriter writer( record.payload );
+    ( writer.put( args ), ... );
+
+    _publish( slot );
+    return true;
+}
+
+[[maybe_unused]]
+inline void CSCI441::Logger::flush() {
+    const size_t target = _enqueuePosition.load( std::memory_order_acquire );
+    while( _dequeuePosition.load( std::memory_order_acquire ) < target ) {
+        _wake.notify_one();
+        std::this_thread::yield();
+    }
+}
+
+//**********************************************************************************
+//**********************************************************************************
+// Internal implementations
+
+inline CSCI441::Logger::Logger() :
+    _slots( new Slot[CAPACITY] ),
+    _enqueuePosition( 0 ),
+    _dequeuePosition( 0 ),
+    _numDropped( 0 ),
+    _numDroppedReported( 0 ),
+    _minimumSeverity( SEVERITY_INFO ),
+    _stop( false ) {
+
+    for( size_t i = 0; i < CAPACITY; i++ ) {
+        _slots[i].sequence.store( i, std::memory_order_relaxed );
+    }
+    _writerThread = std::thread( &Logger::_run, this );
+}
+
+inline CSCI441::Logger::~Logger() {
+    _stop.store( true );
+    {
+        std::lock_guard<std::mutex> lock( _wakeMutex );
+    }
+    _wake.notify_one();
+    _writerThread.join();
+    delete[] _slots;
+}
+
+inline CSCI441::Logger::Slot* CSCI441::Logger::_claim() {
+    size_t position = _enqueuePosition.load( std::memory_order_relaxed );
+    while( true ) {
+        Slot* slot = &_slots[position % CAPACITY];
+        const size_t sequence = slot->sequence.load( std::memory_order_acquire );
+        const auto difference = static_cast<std::ptrdiff_t>( sequence ) - static_cast<std::ptrdiff_t>( position );
+        if( difference == 0 ) {
+            if( _enqueuePosition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ) {
+                return slot;
+            }
+        } else if( difference < 0 ) {
+            return nullptr;         // the writer has not freed this slot yet, the buffer is full
+        } else {
+            position = _enqueuePosition.load( std::memory_order_relaxed );
+        }
+    }
+}
+
+inline void CSCI441::Logger::_publish( Slot* slot ) {
+    // the position this slot was claimed at is one ring behind the sequence it waits for
+    slot->sequence.store( slot->sequence.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+    _wake.notify_one();
+}
+
+inline bool CSCI441::Logger::_writePending() {
+    static const char* const PREFIXES[] = { "[DEBUG]: ", "[INFO]: ", "[WARN]: ", "[ERROR]: " };
+    char line[1024];
+    bool wroteStdout = false, wroteStderr = false;
+
+    size_t position = _dequeuePosition.load( std::memory_order_relaxed );
+    while( true ) {
+        Slot& slot = _slots[position % CAPACITY];
+        if( slot.sequence.load( std::memory_order_acquire ) != position + 1 ) break;
+
+        const Record& record = slot.record;
+        FILE* stream = record.severity >= SEVERITY_WARNING ? stderr : stdout;
+        int length = snprintf( line, sizeof(line), "%s", PREFIXES[record.severity] );
+        length += std::max( record.formatFunction( record.format, record.payload, line + length, sizeof(line) - length ), 0 );
+        length = std::min( length, static_cast<int>(sizeof(line)) - 1 );
+        if( record.suppressed > 0 ) {
+            length += snprintf( line + length, sizeof(line) - length, " (%u similar messages suppressed)", record.suppressed );
+            length = std::min( length, static_cast<int>(sizeof(line)) - 1 );
+        }
+        fwrite( line, 1, length, stream );
+        fputc( '\n', stream );
+        (stream == stderr ? wroteStderr : wroteStdout) = true;
+
+        slot.sequence.store( position + CAPACITY, std::memory_order_release );
+        position++;
+        _dequeuePosition.store( position, std::memory_order_release );
+    }
+
+    const size_t numDropped = _numDropped.load( std::memory_order_relaxed );
+    if( numDropped != _numDroppedReported ) {
+        fprintf( stderr, "[WARN]: CSCI441::Logger: %zu messages dropped, the log buffer was full\n", numDropped - _numDroppedReported );
+        _numDroppedReported = numDropped;
+        wroteStderr = true;
+    }
+
+    // one flush per batch instead of one per line
+    if( wroteStdout ) fflush( stdout );
+    if( wroteStderr ) fflush( stderr );
+    return wroteStdout || wroteStderr;
+}
+
+inline void CSCI441::Logger::_run() {
+    while( true ) {
+        _writePending();
+        if( _stop.load() ) {
+            _writePending();
+            break;
+        }
+        // producers notify without the mutex, so a wakeup can be missed; the timeout bounds the delay
+        std::unique_lock<std::mutex> lock( _wakeMutex );
+        _wake.wait_for( lock, std::chrono::milliseconds(10) );
+    }
+}
+
+#endif // CSCI441_LOGGER_HPP
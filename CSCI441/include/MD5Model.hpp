@@ -7,6 +7,65 @@
  *
  *	These functions, classes, and constants help minimize common
  *	code that needs to be written.
+ *
+ *	Models can be skinned on the CPU (allocVertexArrays()) or in the vertex
+ *	shader (allocSkinnedVertexArrays()).  On the CPU, vertices are skinned by a
+ *	CPUSkinner with SSE across the worker threads shared by all models after the
+ *	pose is converted to joint matrices once per draw.  When skinned on the GPU, each frame
+ *	only uploads one affine matrix per joint to a texture buffer, stored as
+ *	three RGBA32F texels holding the matrix rows.  A vertex shader applies it as:
+ *
+ *	    uniform samplerBuffer jointPalette;
+ *	    in uvec4 vJointIndices;
+ *	    in vec4 vJointWeights;
+ *
+ *	    mat4 jointMatrix(uint joint) {
+ *	        int base = int(joint) * 3;
+ *	        return transpose(mat4(texelFetch(jointPalette, base),
+ *	                              texelFetch(jointPalette, base + 1),
+ *	                              texelFetch(jointPalette, base + 2),
+ *	                              vec4(0.0, 0.0, 0.0, 1.0)));
+ *	    }
+ *
+ *	    mat4 skinMtx = vJointWeights.x * jointMatrix(vJointIndices.x)
+ *	                 + vJointWeights.y * jointMatrix(vJointIndices.y)
+ *	                 + vJointWeights.z * jointMatrix(vJointIndices.z)
+ *	                 + vJointWeights.w * jointMatrix(vJointIndices.w);
+ *	    gl_Position = mvpMatrix * skinMtx * vec4(vPos, 1.0);
+ *
+ *	loadMD5Model() prefers a cooked binary file (MESH_FILE.cooked, or
+ *	MESH_FILE.ANIM_NAME.cooked with an animation) newer than its sources and writes one after parsing the text files otherwise.  The cooked
+ *	file holds the joints, vertices, triangles, and weights in their in-memory
+ *	layout along with the quantized animation, so readCookedMD5() maps it and
+ *	points the meshes into the mapping instead of parsing.
+ *
+ *	Crowds sharing a model skip skeleton evaluation entirely.  Each loaded
+ *	animation is baked once with bakeAnimation() into a 2D RGBA32F texture holding
+ *	the same three rows per joint for every sampled frame (x = joint * 3 + row,
+ *	y = frame), and drawInstanced() draws every instance with only a model matrix,
+ *	clip ID and time offset per instance.  The clip table from getBakedClips()
+ *	holds the first row, number of rows and sample rate of each clip:
+ *
+ *	    uniform sampler2D bakedPalette;
+ *	    uniform vec3 bakedClips[MAX_CLIPS];
+ *	    uniform float time;
+ *	    in mat4 vInstanceModelMtx;
+ *	    in vec2 vInstanceAnimation;     // clip ID, time offset
+ *
+ *	    vec3 clip = bakedClips[int(vInstanceAnimation.x)];
+ *	    float frame = mod((time + vInstanceAnimation.y) * clip.z, clip.y);
+ *	    int rowA = int(clip.x) + int(frame);
+ *	    int rowB = int(clip.x) + (int(frame) + 1) % int(clip.y);
+ *
+ *	    mat4 jointMatrix(uint joint) {
+ *	        int base = int(joint) * 3;
+ *	        mat4 rows = mat4(0.0);
+ *	        for(int r = 0; r < 3; r++)
+ *	            rows[r] = mix(texelFetch(bakedPalette, ivec2(base + r, rowA), 0),
+ *	                          texelFetch(bakedPalette, ivec2(base + r, rowB), 0), fract(frame));
+ *	        rows[3] = vec4(0.0, 0.0, 0.0, 1.0);
+ *	        return transpose(rows);
+ *	    }
  */
 
 #ifndef CSCI441_MD5_MODEL_HPP
@@ -45,6 +104,9 @@
  *
  */
 
+#include "AnimationClip.hpp"
+#include "CPUSkinner.hpp"
+#include "Logger.hpp"
 #include "TextureUtils.hpp"
 
 #ifdef CSCI441_USE_GLEW
@@ -54,6 +116,8 @@
 #endif
 
 #include <glm/exponential.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_precision.hpp>
 #include <glm/ext/quaternion_common.hpp>
 #include <glm/ext/quaternion_float.hpp>
 
@@ -65,6 +129,17 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 
 namespace CSCI441 {
 
@@ -306,6 +381,38 @@ namespace CSCI441 {
         /**
          * @brief stores state of current animation frame
          */
+        /**
+         * @brief header of a cooked model file, offsets are in bytes from the start of the file
+         */
+        struct MD5CookedHeader {
+            char magic[4] = {'M', 'D', '5', 'C'};
+            GLuint version = 1;
+            GLint numJoints = 0;
+            GLint numMeshes = 0;
+            GLint numFrames = 0;        // 0 without animation
+            GLint frameRate = 0;
+            GLuint64 jointsOffset = 0;
+            GLuint64 meshesOffset = 0;
+            GLuint64 keyframesOffset = 0;
+            GLuint64 positionMinOffset = 0;
+            GLuint64 positionScaleOffset = 0;
+            GLuint64 fileSize = 0;
+        };
+
+        /**
+         * @brief a mesh record of a cooked model file
+         */
+        struct MD5CookedMesh {
+            GLint numVertices = 0;
+            GLint numTriangles = 0;
+            GLint numWeights = 0;
+            GLint padding = 0;
+            GLuint64 verticesOffset = 0;
+            GLuint64 trianglesOffset = 0;
+            GLuint64 weightsOffset = 0;
+            char shader[512] = "";
+        };
+
         struct MD5AnimationState {
             /**
              * @brief index of current frame model is in
@@ -368,6 +475,18 @@ namespace CSCI441 {
          * @returns true if file parsed successfully
          */
         [[nodiscard]] bool readMD5Model(const char* FILENAME);
+        /**
+         * @brief maps a cooked model and its animation, if any, without parsing
+         * @param FILENAME cooked file written by writeCookedMD5()
+         * @returns true if the file is a valid cooked model
+         */
+        [[nodiscard]] bool readCookedMD5(const char* FILENAME);
+        /**
+         * @brief writes the loaded model and its animation, if any, as a cooked binary file
+         * @param FILENAME cooked file to write
+         * @returns true if the file was written
+         */
+        [[maybe_unused]] bool writeCookedMD5(const char* FILENAME) const;
         /**
          * @brief binds model VBOs to attribute pointer locations
          * @param vPosAttribLoc location of vertex position attribute
@@ -377,8 +496,61 @@ namespace CSCI441 {
          * @note texCoord attribute used when drawing the mesh
          */
         [[maybe_unused]]void allocVertexArrays(GLuint vPosAttribLoc, GLuint vColorAttribLoc, GLuint vTexCoordAttribLoc);
+        /**
+         * @brief binds static model VBOs so the mesh is skinned in the vertex shader
+         * @param vPosAttribLoc location of vertex position attribute, holding the bind pose position
+         * @param vColorAttribLoc location of vertex color attribute
+         * @param vTexCoordAttribLoc location of vertex texture coordinate attribute
+         * @param vJointIndicesAttribLoc location of the uvec4 joint index attribute
+         * @param vJointWeightsAttribLoc location of the vec4 joint weight attribute
+         * @param jointPaletteTexture texture unit the joint palette texture buffer is bound to when drawing (default: GL_TEXTURE1)
+         * @note vertices influenced by more than four joints keep their four largest weights, renormalized
+         * @note the skeleton is still drawn with drawSkeleton() as with allocVertexArrays()
+         */
+        [[maybe_unused]] void allocSkinnedVertexArrays(GLuint vPosAttribLoc, GLuint vColorAttribLoc, GLuint vTexCoordAttribLoc,
+                                                       GLuint vJointIndicesAttribLoc, GLuint vJointWeightsAttribLoc,
+                                                       GLenum jointPaletteTexture = GL_TEXTURE1);
+        /**
+         * @brief returns if the model is skinned in the vertex shader
+         * @returns true if allocSkinnedVertexArrays() was used
+         */
+        [[maybe_unused]] [[nodiscard]] bool isSkinnedOnGPU() const { return _gpuSkinning; }
+        /**
+         * @brief samples the loaded animation into the baked palette texture for instanced drawing
+         * @param samplesPerFrame palette rows per animation frame, more rows keep fast rotations closer to slerp (default: 1)
+         * @returns clip ID of the baked animation, -1 if it could not be baked
+         * @note requires allocSkinnedVertexArrays().  Call again after each readMD5Anim() to bake further clips
+         */
+        [[maybe_unused]] GLint bakeAnimation(GLuint samplesPerFrame = 1);
+        /**
+         * @brief returns the clip table of the baked palette
+         * @returns per clip ID the first palette row, number of rows and rows per second
+         */
+        [[maybe_unused]] [[nodiscard]] const std::vector<glm::vec3>& getBakedClips() const { return _bakedClips; }
+        /**
+         * @brief binds per instance attributes to the skinned VAOs
+         * @param vInstanceModelMtxAttribLoc first of four consecutive locations of the mat4 instance model matrix attribute
+         * @param vInstanceAnimationAttribLoc location of the vec2 instance clip ID and time offset attribute
+         * @param bakedPaletteTexture texture unit the baked palette is bound to when drawing (default: GL_TEXTURE2)
+         * @note requires allocSkinnedVertexArrays()
+         */
+        [[maybe_unused]] void allocInstanceArrays(GLuint vInstanceModelMtxAttribLoc, GLuint vInstanceAnimationAttribLoc,
+                                                  GLenum bakedPaletteTexture = GL_TEXTURE2);
+        /**
+         * @brief uploads the instances drawn by drawInstanced()
+         * @param modelMtxs model matrix of each instance
+         * @param animations clip ID and time offset in seconds of each instance
+         * @param numInstances number of instances
+         */
+        [[maybe_unused]] void setInstances(const glm::mat4* modelMtxs, const glm::vec2* animations, GLsizei numInstances);
+        /**
+         * @brief draws every instance of every mesh, animated from the baked palette
+         * @note no skeleton is evaluated on the CPU, the vertex shader samples the pose for each instance
+         */
+        [[maybe_unused]] void drawInstanced() const;
         /**
          * @brief draws all the meshes that make up the model
+         * @note when skinned on the GPU, the current joint palette is uploaded first
          */
         [[maybe_unused]] void draw() const;
         /**
@@ -395,9 +567,21 @@ namespace CSCI441 {
         [[nodiscard]] bool readMD5Anim(const char* filename);
         /**
          * @brief advances the model forward in its animation sequence the corresponding amount of time based on frame rate
-         * @param dt delta time since last frame
+         * @param dt time since the last call, may span several animation frames when updates are throttled by an AnimationScheduler
          */
         void animate(GLfloat dt);
+        /**
+         * @brief blends another clip of the same skeleton into the current pose
+         * @param clip clip to blend in, such as getAnimationClip() of another model loaded with the same mesh
+         * @param time time within the clip in seconds
+         * @param weight amount of the clip in [0, 1]
+         * @note call after animate() each frame
+         */
+        [[maybe_unused]] void blendAnimation(const AnimationClip& clip, GLfloat time, GLfloat weight);
+        /**
+         * @brief returns the quantized keyframes of the loaded animation
+         */
+        [[maybe_unused]] [[nodiscard]] const AnimationClip& getAnimationClip() const { return _animationClip; }
 
     private:
         MD5Joint* _baseSkeleton;
@@ -420,6 +604,27 @@ namespace CSCI441 {
         GLuint _skeletonVAO;
         GLuint _skeletonVBO;
 
+        // CPU skinning, one skinner mesh per model mesh
+        CPUSkinner* _cpuSkinner;
+
+        // GPU skinning
+        bool _gpuSkinning;
+        GLuint* _skinnedVAOs;               // one per mesh
+        GLuint* _skinnedVBOs;               // vertex + index buffer per mesh
+        glm::mat4* _inverseBindPose;        // inverse base skeleton joint transform
+        glm::vec4* _jointPalette;           // three rows per joint
+        GLuint _jointPaletteBuffer;
+        GLuint _jointPaletteTextureHandle;
+        GLenum _jointPaletteTexture;
+
+        // baked animation palette for instanced crowds
+        std::vector<glm::vec4> _bakedPalette;   // three texels per joint per row
+        std::vector<glm::vec3> _bakedClips;     // first row, number of rows, rows per second
+        GLuint _bakedPaletteTextureHandle;
+        GLenum _bakedPaletteTexture;
+        GLuint _instanceVBO;                    // interleaved model matrix + clip ID and time offset
+        GLsizei _numInstances;
+
         /**
          * @brief the MD5 skeletal joint data
          */
@@ -436,8 +641,23 @@ namespace CSCI441 {
          * @brief current animation frame state
          */
         MD5AnimationState _animationInfo;
+        /**
+         * @brief quantized keyframes, replacing the skeleton frames once the animation is validated
+         */
+        AnimationClip _animationClip;
+        /**
+         * @brief current pose as structure of arrays, copied into _skeleton
+         */
+        AnimationClip::Pose _pose;
+
+        // cooked file the joints and mesh arrays point into
+        char* _cookedData;
+        size_t _cookedSize;
+        bool _cookedMapped;
 
-        void _prepareMesh(const MD5Mesh* pMESH) const;
+        void _prepareMesh(const MD5Mesh* pMESH, GLint meshIndex) const;
+        void _computeJointPalette(const MD5Joint* pSKELETON, glm::vec4* pPalette) const;
+        void _uploadJointPalette() const;
         void _drawMesh(const MD5Mesh* pMESH) const;
         [[nodiscard]] bool _checkAnimValidity() const;
         static void _buildFrameSkeleton(const MD5JointInfo* pJOINT_INFOS,
@@ -446,6 +666,9 @@ namespace CSCI441 {
                                         MD5Joint* pSkeletonFrame,
                                         GLint NUM_JOINTS);
         void _interpolateSkeletons(GLfloat interp);
+        void _applyPose();
+        void _loadMeshTextures(MD5Mesh* mesh);
+        [[nodiscard]] static bool _isCookedFileCurrent(const std::string& cookedFile, const char* MD5_MESH_FILE, const char* MD5_ANIM_FILE);
         void _freeModel();
         void _freeVertexArrays();
         void _freeAnim();
@@ -470,10 +693,26 @@ inline CSCI441::MD5Model::MD5Model()
     _vbo[1] = 0;
     _skeletonVAO = 0;
     _skeletonVBO = 0;
+    _cpuSkinner = nullptr;
+    _gpuSkinning = false;
+    _skinnedVAOs = nullptr;
+    _skinnedVBOs = nullptr;
+    _inverseBindPose = nullptr;
+    _jointPalette = nullptr;
+    _jointPaletteBuffer = 0;
+    _jointPaletteTextureHandle = 0;
+    _jointPaletteTexture = GL_TEXTURE1;
+    _bakedPaletteTextureHandle = 0;
+    _bakedPaletteTexture = GL_TEXTURE2;
+    _instanceVBO = 0;
+    _numInstances = 0;
     _animation = MD5Animation();
     _skeleton = nullptr;
     _animationInfo = MD5AnimationState();
     _isAnimated = false;
+    _cookedData = nullptr;
+    _cookedSize = 0;
+    _cookedMapped = false;
 }
 
 inline CSCI441::MD5Model::~MD5Model()
@@ -490,6 +729,32 @@ CSCI441::MD5Model::loadMD5Model(
         const char* MD5_MESH_FILE,
         const char* MD5_ANIM_FILE
 ) {
+    // Map the cooked file when it is up to date, one per mesh and animation pair.  Animations in
+    // different folders may share a name, so the name is followed by a hash of the absolute path
+    std::string cookedFile = MD5_MESH_FILE;
+    if( strcmp(MD5_ANIM_FILE, "") != 0 ) {
+        std::error_code error;
+        const std::filesystem::path ANIM_PATH = std::filesystem::absolute(MD5_ANIM_FILE, error);
+        GLuint64 pathHash = 14695981039346656037ull;                         // 64-bit FNV-1a
+        for( const char c : ANIM_PATH.string() ) {
+            pathHash ^= static_cast<unsigned char>(c);
+            pathHash *= 1099511628211ull;
+        }
+        char hashText[18];
+        snprintf( hashText, sizeof(hashText), "-%016llx", static_cast<unsigned long long>(pathHash) );
+        cookedFile += "." + std::filesystem::path(MD5_ANIM_FILE).stem().string() + hashText;
+    }
+    const std::string COOKED_FILE = cookedFile + ".cooked";
+    if( _isCookedFileCurrent(COOKED_FILE, MD5_MESH_FILE, MD5_ANIM_FILE) && readCookedMD5(COOKED_FILE.c_str()) ) {
+        return true;
+    }
+
+    // replace any previously loaded model
+    _freeVertexArrays();
+    _freeAnim();
+    _freeModel();
+    _isAnimated = false;
+
     // Load MD5 _model file
     if( readMD5Model(MD5_MESH_FILE) ) {
         // if MD5 animation file name provided
@@ -505,9 +770,335 @@ CSCI441::MD5Model::loadMD5Model(
     } else {
         return false;
     }
+
+    // cook for the next load
+    writeCookedMD5(COOKED_FILE.c_str());
+    return true;
+}
+
+// A cooked file is used only when it is newer than the files it was cooked from.
+inline bool
+CSCI441::MD5Model::_isCookedFileCurrent(
+        const std::string& cookedFile,
+        const char* MD5_MESH_FILE,
+        const char* MD5_ANIM_FILE
+) {
+    std::error_code error;
+    const auto COOKED_TIME = std::filesystem::last_write_time(cookedFile, error);
+    if( error ) return false;
+
+    if( std::filesystem::last_write_time(MD5_MESH_FILE, error) > COOKED_TIME || error ) return false;
+    if( strcmp(MD5_ANIM_FILE, "") != 0 ) {
+        if( std::filesystem::last_write_time(MD5_ANIM_FILE, error) > COOKED_TIME || error ) return false;
+    }
+    return true;
+}
+
+// Map a cooked model file.  Joints, vertices, triangles, and weights are
+// used in place, the animation keyframes are copied into the clip.
+inline bool
+CSCI441::MD5Model::readCookedMD5(
+        const char* FILENAME
+) {
+    printf("[.md5mesh]: about to map %s\n", FILENAME );
+
+    char* data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+
+#ifdef _WIN32
+    FILE *fp = fopen(FILENAME, "rb" );
+    if( !fp ) {
+        CSCI441_LOG_ERROR("[.md5mesh]: couldn't open \"%s\"!", FILENAME);
+        return false;
+    }
+    fseek( fp, 0, SEEK_END );
+    size = static_cast<size_t>( ftell(fp) );
+    fseek( fp, 0, SEEK_SET );
+    data = new char[size];
+    if( fread( data, 1, size, fp ) != size ) {
+        fclose( fp );
+        delete[] data;
+        CSCI441_LOG_ERROR("[.md5mesh]: couldn't read \"%s\"!", FILENAME);
+        return false;
+    }
+    fclose( fp );
+#else
+    const int fd = open(FILENAME, O_RDONLY );
+    if( fd < 0 ) {
+        CSCI441_LOG_ERROR("[.md5mesh]: couldn't open \"%s\"!", FILENAME);
+        return false;
+    }
+    struct stat fileInfo = {};
+    if( fstat(fd, &fileInfo) == 0 ) {
+        size = static_cast<size_t>( fileInfo.st_size );
+        // private so the base skeleton can still be modified in memory
+        void* mapping = size > 0 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 ) : MAP_FAILED;
+        if( mapping != MAP_FAILED ) {
+            data = static_cast<char*>( mapping );
+            mapped = true;
+        }
+    }
+    close( fd );
+    if( data == nullptr ) {
+        CSCI441_LOG_ERROR("[.md5mesh]: couldn't map \"%s\"!", FILENAME);
+        return false;
+    }
+#endif
+
+    auto release = [&]() {
+#ifndef _WIN32
+        if( mapped ) { munmap( data, size ); return; }
+#endif
+        delete[] data;
+    };
+
+    // validate every range before touching the model
+    const auto *pHEADER = reinterpret_cast<const MD5CookedHeader*>( data );
+    const MD5CookedHeader EXPECTED;
+    auto inFile = [size](GLuint64 offset, GLuint64 bytes) { return offset <= size && bytes <= size - offset; };
+    bool valid = size >= sizeof(MD5CookedHeader)
+                 && memcmp(pHEADER->magic, EXPECTED.magic, sizeof(EXPECTED.magic)) == 0
+                 && pHEADER->version == EXPECTED.version
+                 && pHEADER->fileSize == size
+                 && pHEADER->numJoints > 0 && pHEADER->numMeshes > 0 && pHEADER->numFrames >= 0
+                 && inFile(pHEADER->jointsOffset, sizeof(MD5Joint) * static_cast<GLuint64>(pHEADER->numJoints))
+                 && inFile(pHEADER->meshesOffset, sizeof(MD5CookedMesh) * static_cast<GLuint64>(pHEADER->numMeshes));
+    if( valid ) {
+        const auto *pMESHES = reinterpret_cast<const MD5CookedMesh*>( data + pHEADER->meshesOffset );
+        for(GLint i = 0; i < pHEADER->numMeshes && valid; ++i) {
+            valid = pMESHES[i].numVertices >= 0 && pMESHES[i].numTriangles >= 0 && pMESHES[i].numWeights >= 0
+                    && inFile(pMESHES[i].verticesOffset, sizeof(MD5Vertex) * static_cast<GLuint64>(pMESHES[i].numVertices))
+                    && inFile(pMESHES[i].trianglesOffset, sizeof(MD5Triangle) * static_cast<GLuint64>(pMESHES[i].numTriangles))
+                    && inFile(pMESHES[i].weightsOffset, sizeof(MD5Weight) * static_cast<GLuint64>(pMESHES[i].numWeights));
+        }
+    }
+    if( valid && pHEADER->numFrames > 0 ) {
+        const GLuint64 JOINT_FRAMES = static_cast<GLuint64>(pHEADER->numFrames) * static_cast<GLuint64>(pHEADER->numJoints);
+        valid = pHEADER->frameRate > 0
+                && inFile(pHEADER->keyframesOffset, sizeof(GLushort) * 6 * JOINT_FRAMES)
+                && inFile(pHEADER->positionMinOffset, sizeof(glm::vec3) * static_cast<GLuint64>(pHEADER->numJoints))
+                && inFile(pHEADER->positionScaleOffset, sizeof(glm::vec3) * static_cast<GLuint64>(pHEADER->numJoints));
+    }
+    if( !valid ) {
+        CSCI441_LOG_ERROR("[.md5mesh]: \"%s\" is not a valid cooked model", FILENAME);
+        release();
+        return false;
+    }
+
+    // replace any previously loaded model, only once the cooked file is known to be good
+    _freeVertexArrays();
+    _freeAnim();
+    _freeModel();
+    _isAnimated = false;
+
+    _cookedData = data;
+    _cookedSize = size;
+    _cookedMapped = mapped;
+
+    _numJoints = pHEADER->numJoints;
+    _numMeshes = pHEADER->numMeshes;
+    _baseSkeleton = reinterpret_cast<MD5Joint*>( data + pHEADER->jointsOffset );
+    _meshes = new MD5Mesh[_numMeshes];
+
+    GLint totalVertices = 0, totalWeights = 0, totalTriangles = 0;
+    const auto *pMESHES = reinterpret_cast<const MD5CookedMesh*>( data + pHEADER->meshesOffset );
+    for(GLint i = 0; i < _numMeshes; ++i) {
+        MD5Mesh *mesh = &_meshes[i];
+        mesh->numVertices  = pMESHES[i].numVertices;
+        mesh->numTriangles = pMESHES[i].numTriangles;
+        mesh->numWeights   = pMESHES[i].numWeights;
+        mesh->vertices  = reinterpret_cast<MD5Vertex*>( data + pMESHES[i].verticesOffset );
+        mesh->triangles = reinterpret_cast<MD5Triangle*>( data + pMESHES[i].trianglesOffset );
+        mesh->weights   = reinterpret_cast<MD5Weight*>( data + pMESHES[i].weightsOffset );
+        strncpy( mesh->shader, pMESHES[i].shader, sizeof(mesh->shader) - 1 );
+
+        if( mesh->numVertices > _maxVertices ) _maxVertices = mesh->numVertices;
+        if( mesh->numTriangles > _maxTriangles ) _maxTriangles = mesh->numTriangles;
+        totalVertices += mesh->numVertices;
+        totalWeights += mesh->numWeights;
+        totalTriangles += mesh->numTriangles;
+
+        if( mesh->shader[0] != '\0' ) {
+            _loadMeshTextures(mesh);
+        }
+    }
+    _skeleton = _baseSkeleton;
+
+    printf("[.md5mesh]: mapped %d meshes, %d joints, %d vertices, %d weights, and %d triangles\n", _numMeshes, _numJoints, totalVertices, totalWeights, totalTriangles );
+
+    if( pHEADER->numFrames > 0 ) {
+        _animation.numFrames = pHEADER->numFrames;
+        _animation.numJoints = pHEADER->numJoints;
+        _animation.frameRate = pHEADER->frameRate;
+        _animationClip.setQuantized(pHEADER->numFrames, pHEADER->numJoints, pHEADER->frameRate,
+                                    data + pHEADER->keyframesOffset,
+                                    reinterpret_cast<const glm::vec3*>( data + pHEADER->positionMinOffset ),
+                                    reinterpret_cast<const glm::vec3*>( data + pHEADER->positionScaleOffset ) );
+
+        _skeleton = new MD5Joint[_numJoints];
+        for(GLint i = 0; i < _numJoints; ++i) {
+            _skeleton[i].parent = _baseSkeleton[i].parent;
+        }
+
+        _animationInfo.currFrame = 0;
+        _animationInfo.nextFrame = _animation.numFrames > 1 ? 1 : 0;
+        _animationInfo.lastTime = 0.0f;
+        _animationInfo.maxTime = 1.0f / (GLfloat)_animation.frameRate;
+
+        _isAnimated = true;
+        animate(0.0);
+
+        printf("[.md5anim]: mapped %d frames at %d frames per second\n", _animation.numFrames, _animation.frameRate );
+    }
+
+    return true;
+}
+
+// Write the loaded model as a cooked file.  Every array is 16 byte aligned.
+[[maybe_unused]]
+inline bool
+CSCI441::MD5Model::writeCookedMD5(
+        const char* FILENAME
+) const {
+    if( _numJoints == 0 || _numMeshes == 0 ) return false;
+
+    auto align = [](GLuint64 offset) { return (offset + 15) & ~static_cast<GLuint64>(15); };
+
+    MD5CookedHeader header;
+    header.numJoints = _numJoints;
+    header.numMeshes = _numMeshes;
+
+    GLuint64 offset = align(sizeof(MD5CookedHeader));
+    header.jointsOffset = offset;
+    offset = align(offset + sizeof(MD5Joint) * _numJoints);
+    header.meshesOffset = offset;
+    offset = align(offset + sizeof(MD5CookedMesh) * _numMeshes);
+
+    auto meshes = new MD5CookedMesh[_numMeshes];
+    for(GLint i = 0; i < _numMeshes; ++i) {
+        meshes[i].numVertices  = _meshes[i].numVertices;
+        meshes[i].numTriangles = _meshes[i].numTriangles;
+        meshes[i].numWeights   = _meshes[i].numWeights;
+        strncpy( meshes[i].shader, _meshes[i].shader, sizeof(meshes[i].shader) - 1 );
+
+        meshes[i].verticesOffset = offset;
+        offset = align(offset + sizeof(MD5Vertex) * _meshes[i].numVertices);
+        meshes[i].trianglesOffset = offset;
+        offset = align(offset + sizeof(MD5Triangle) * _meshes[i].numTriangles);
+        meshes[i].weightsOffset = offset;
+        offset = align(offset + sizeof(MD5Weight) * _meshes[i].numWeights);
+    }
+
+    if( _isAnimated ) {
+        header.numFrames = _animationClip.getNumberOfFrames();
+        header.frameRate = _animationClip.getFrameRate();
+        header.keyframesOffset = offset;
+        offset = align(offset + _animationClip.getKeyframeDataSize());
+        header.positionMinOffset = offset;
+        offset = align(offset + sizeof(glm::vec3) * _numJoints);
+        header.positionScaleOffset = offset;
+        offset = align(offset + sizeof(glm::vec3) * _numJoints);
+    }
+    header.fileSize = offset;
+
+    // assemble in memory so a partial file is never left behind
+    std::vector<char> file( static_cast<size_t>(header.fileSize), 0 );
+    memcpy( &file[0], &header, sizeof(header) );
+    memcpy( &file[header.jointsOffset], _baseSkeleton, sizeof(MD5Joint) * _numJoints );
+    memcpy( &file[header.meshesOffset], meshes, sizeof(MD5CookedMesh) * _numMeshes );
+    for(GLint i = 0; i < _numMeshes; ++i) {
+        if( _meshes[i].numVertices > 0 ) memcpy( &file[meshes[i].verticesOffset], _meshes[i].vertices, sizeof(MD5Vertex) * _meshes[i].numVertices );
+        if( _meshes[i].numTriangles > 0 ) memcpy( &file[meshes[i].trianglesOffset], _meshes[i].triangles, sizeof(MD5Triangle) * _meshes[i].numTriangles );
+        if( _meshes[i].numWeights > 0 ) memcpy( &file[meshes[i].weightsOffset], _meshes[i].weights, sizeof(MD5Weight) * _meshes[i].numWeights );
+    }
+    if( _isAnimated ) {
+        memcpy( &file[header.keyframesOffset], _animationClip.getKeyframeData(), _animationClip.getKeyframeDataSize() );
+        memcpy( &file[header.positionMinOffset], _animationClip.getPositionMin(), sizeof(glm::vec3) * _numJoints );
+        memcpy( &file[header.positionScaleOffset], _animationClip.getPositionScale(), sizeof(glm::vec3) * _numJoints );
+    }
+    delete[] meshes;
+
+    FILE *fp = fopen(FILENAME, "wb" );
+    if( !fp ) {
+        CSCI441_LOG_ERROR("[.md5mesh]: couldn't write \"%s\"!", FILENAME);
+        return false;
+    }
+    const bool WRITTEN = fwrite( file.data(), 1, file.size(), fp ) == file.size();
+    fclose( fp );
+    if( !WRITTEN ) {
+        remove( FILENAME );
+        CSCI441_LOG_ERROR("[.md5mesh]: couldn't write \"%s\"!", FILENAME);
+        return false;
+    }
+
+    printf("[.md5mesh]: cooked %s (%zu bytes)\n", FILENAME, file.size() );
     return true;
 }
 
+// Load the diffuse, specular, normal, and height maps named by a mesh's shader.
+inline void
+CSCI441::MD5Model::_loadMeshTextures(
+        MD5Mesh *mesh
+) {
+    // diffuse map
+    strcpy(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, mesh->shader);
+    strcat(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, ".tga");
+    mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE);
+    if( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle == 0 ) {
+        strcpy(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, mesh->shader);
+        strcat(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, "_d.tga");
+        mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
+        if( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle == 0 ) {
+            strcpy(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, mesh->shader);
+            strcat(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, ".png");
+            mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
+            if( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle == 0 ) {
+                printf("[.md5mesh | ERROR]: Could not load diffuse map %s\n", mesh->shader);
+            }
+        }
+    }
+
+    // specular map
+    strcpy(mesh->textures[MD5Mesh::TextureMap::SPECULAR].filename, mesh->shader);
+    strcat(mesh->textures[MD5Mesh::TextureMap::SPECULAR].filename, "_s.tga");
+    mesh->textures[MD5Mesh::TextureMap::SPECULAR].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::SPECULAR].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
+    if( mesh->textures[MD5Mesh::TextureMap::SPECULAR].texHandle == 0 ) {
+        strcpy(mesh->textures[MD5Mesh::TextureMap::SPECULAR].filename, mesh->shader);
+        strcat(mesh->textures[MD5Mesh::TextureMap::SPECULAR].filename, "_s.png");
+        mesh->textures[MD5Mesh::TextureMap::SPECULAR].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::SPECULAR].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
+        if( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle == 0 ) {
+            printf("[.md5mesh | ERROR]: Could not load specular map %s\n", mesh->shader);
+        }
+    }
+
+    // normal map
+    strcpy(mesh->textures[MD5Mesh::TextureMap::NORMAL].filename, mesh->shader);
+    strcat(mesh->textures[MD5Mesh::TextureMap::NORMAL].filename, "_local.tga");
+    mesh->textures[MD5Mesh::TextureMap::NORMAL].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::NORMAL].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
+    if( mesh->textures[MD5Mesh::TextureMap::NORMAL].texHandle == 0 ) {
+        strcpy(mesh->textures[MD5Mesh::TextureMap::NORMAL].filename, mesh->shader);
+        strcat(mesh->textures[MD5Mesh::TextureMap::NORMAL].filename, "_local.png");
+        mesh->textures[MD5Mesh::TextureMap::NORMAL].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::NORMAL].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
+        if( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle == 0 ) {
+            printf("[.md5mesh | ERROR]: Could not load normal map %s\n", mesh->shader);
+        }
+    }
+
+    // height map
+    strcpy(mesh->textures[MD5Mesh::TextureMap::HEIGHT].filename, mesh->shader);
+    strcat(mesh->textures[MD5Mesh::TextureMap::HEIGHT].filename, "_h.tga");
+    mesh->textures[MD5Mesh::TextureMap::HEIGHT].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::HEIGHT].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
+    if( mesh->textures[MD5Mesh::TextureMap::HEIGHT].texHandle == 0 ) {
+        strcpy(mesh->textures[MD5Mesh::TextureMap::HEIGHT].filename, mesh->shader);
+        strcat(mesh->textures[MD5Mesh::TextureMap::HEIGHT].filename, "_h.png");
+        mesh->textures[MD5Mesh::TextureMap::HEIGHT].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::HEIGHT].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
+        if( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle == 0 ) {
+            printf("[.md5mesh | ERROR]: Could not load height map %s\n", mesh->shader);
+        }
+    }
+}
+
 // Load an MD5 model from file.
 inline bool
 CSCI441::MD5Model::readMD5Model(
@@ -531,7 +1122,7 @@ CSCI441::MD5Model::readMD5Model(
 
     fp = fopen(FILENAME, "rb" );
     if( !fp ) {
-        fprintf (stderr, "[.md5mesh]: Error: couldn't open \"%s\"!\n", FILENAME);
+        CSCI441_LOG_ERROR("[.md5mesh]: couldn't open \"%s\"!", FILENAME);
         return false;
     }
 
@@ -542,7 +1133,7 @@ CSCI441::MD5Model::readMD5Model(
         if( sscanf(buff, " MD5Version %d", &version) == 1 ) {
             if( version != 10 ) {
                 // Bad version
-                fprintf (stderr, "[.md5mesh]: Error: bad model version\n");
+                CSCI441_LOG_ERROR("[.md5mesh]: bad model version");
                 fclose (fp);
                 return false;
             }
@@ -600,62 +1191,7 @@ CSCI441::MD5Model::readMD5Model(
                     }
                     // there was a shader name
                     if( j > 0 ) {
-                        // diffuse map
-                        strcpy(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, mesh->shader);
-                        strcat(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, ".tga");
-                        mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE);
-                        if( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle == 0 ) {
-                            strcpy(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, mesh->shader);
-                            strcat(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, "_d.tga");
-                            mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
-                            if( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle == 0 ) {
-                                strcpy(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, mesh->shader);
-                                strcat(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, ".png");
-                                mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture(mesh->textures[MD5Mesh::TextureMap::DIFFUSE].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
-                                if( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle == 0 ) {
-                                    printf("[.md5mesh | ERROR]: Could not load diffuse map %s\n", mesh->shader);
-                                }
-                            }
-                        }
-
-                        // specular map
-                        strcpy(mesh->textures[MD5Mesh::TextureMap::SPECULAR].filename, mesh->shader);
-                        strcat(mesh->textures[MD5Mesh::TextureMap::SPECULAR].filename, "_s.tga");
-                        mesh->textures[MD5Mesh::TextureMap::SPECULAR].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::SPECULAR].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
-                        if( mesh->textures[MD5Mesh::TextureMap::SPECULAR].texHandle == 0 ) {
-                            strcpy(mesh->textures[MD5Mesh::TextureMap::SPECULAR].filename, mesh->shader);
-                            strcat(mesh->textures[MD5Mesh::TextureMap::SPECULAR].filename, "_s.png");
-                            mesh->textures[MD5Mesh::TextureMap::SPECULAR].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::SPECULAR].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
-                            if( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle == 0 ) {
-                                printf("[.md5mesh | ERROR]: Could not load specular map %s\n", mesh->shader);
-                            }
-                        }
-
-                        // normal map
-                        strcpy(mesh->textures[MD5Mesh::TextureMap::NORMAL].filename, mesh->shader);
-                        strcat(mesh->textures[MD5Mesh::TextureMap::NORMAL].filename, "_local.tga");
-                        mesh->textures[MD5Mesh::TextureMap::NORMAL].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::NORMAL].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
-                        if( mesh->textures[MD5Mesh::TextureMap::NORMAL].texHandle == 0 ) {
-                            strcpy(mesh->textures[MD5Mesh::TextureMap::NORMAL].filename, mesh->shader);
-                            strcat(mesh->textures[MD5Mesh::TextureMap::NORMAL].filename, "_local.png");
-                            mesh->textures[MD5Mesh::TextureMap::NORMAL].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::NORMAL].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
-                            if( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle == 0 ) {
-                                printf("[.md5mesh | ERROR]: Could not load normal map %s\n", mesh->shader);
-                            }
-                        }
-
-                        // height map
-                        strcpy(mesh->textures[MD5Mesh::TextureMap::HEIGHT].filename, mesh->shader);
-                        strcat(mesh->textures[MD5Mesh::TextureMap::HEIGHT].filename, "_h.tga");
-                        mesh->textures[MD5Mesh::TextureMap::HEIGHT].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::HEIGHT].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
-                        if( mesh->textures[MD5Mesh::TextureMap::HEIGHT].texHandle == 0 ) {
-                            strcpy(mesh->textures[MD5Mesh::TextureMap::HEIGHT].filename, mesh->shader);
-                            strcat(mesh->textures[MD5Mesh::TextureMap::HEIGHT].filename, "_h.png");
-                            mesh->textures[MD5Mesh::TextureMap::HEIGHT].texHandle = CSCI441::TextureUtils::loadAndRegisterTexture( mesh->textures[MD5Mesh::TextureMap::HEIGHT].filename, GL_LINEAR, GL_LINEAR_MIPMAP_LINEAR, GL_REPEAT, GL_REPEAT, GL_FALSE, GL_FALSE );
-                            if( mesh->textures[MD5Mesh::TextureMap::DIFFUSE].texHandle == 0 ) {
-                                printf("[.md5mesh | ERROR]: Could not load height map %s\n", mesh->shader);
-                            }
-                        }
+                        _loadMeshTextures(mesh);
                     }
                 } else if( sscanf(buff, " numverts %d", &mesh->numVertices) == 1 ) {
                     if( mesh->numVertices > 0 ) {
@@ -742,42 +1278,113 @@ CSCI441::MD5Model::readMD5Model(
 inline void
 CSCI441::MD5Model::_freeModel()
 {
-    delete _baseSkeleton;
-    _baseSkeleton = nullptr;
+    if( _skeleton == _baseSkeleton ) {
+        _skeleton = nullptr;
+    }
 
-    // Free mesh data
-    for(GLint i = 0; i < _numMeshes; ++i) {
-        delete _meshes[i].vertices;
-        _meshes[i].vertices = nullptr;
+    // a cooked model's arrays live in the cooked file
+    if( _cookedData == nullptr ) {
+        delete[] _baseSkeleton;
 
-        delete _meshes[i].triangles;
-        _meshes[i].triangles = nullptr;
+        // Free mesh data
+        for(GLint i = 0; i < _numMeshes; ++i) {
+            delete[] _meshes[i].vertices;
+            delete[] _meshes[i].triangles;
+            delete[] _meshes[i].weights;
+        }
+    }
+    _baseSkeleton = nullptr;
 
-        delete _meshes[i].weights;
-        _meshes[i].weights = nullptr;
+    if( _meshes != nullptr ) {
+        for(GLint i = 0; i < _numMeshes; ++i) {
+            _meshes[i].vertices = nullptr;
+            _meshes[i].triangles = nullptr;
+            _meshes[i].weights = nullptr;
+        }
     }
 
-    delete _meshes;
+    delete[] _meshes;
     _meshes = nullptr;
+
+#ifndef _WIN32
+    if( _cookedMapped ) {
+        munmap( _cookedData, _cookedSize );
+        _cookedData = nullptr;
+    }
+#endif
+    delete[] _cookedData;
+    _cookedData = nullptr;
+    _cookedSize = 0;
+    _cookedMapped = false;
 }
 
 [[maybe_unused]]
 inline void
 CSCI441::MD5Model::draw() const
 {
+    if( _gpuSkinning ) {
+        // only the joints change per frame, vertices are skinned in the vertex shader
+        _uploadJointPalette();
+
+        for(GLint i = 0; i < _numMeshes; ++i) {
+            glBindTexture(GL_TEXTURE_2D, _meshes[i].textures[MD5Mesh::TextureMap::DIFFUSE].texHandle );
+
+            glBindVertexArray( _skinnedVAOs[i] );
+            glDrawElements(GL_TRIANGLES, _meshes[i].numTriangles * 3, GL_UNSIGNED_INT, (void*)nullptr );
+        }
+        return;
+    }
+
+    // the pose is shared by every mesh, convert it once
+    _cpuSkinner->setPose(_skeleton, _numJoints);
+
     // Draw each mesh of the model
     for(GLint i = 0; i < _numMeshes; ++i) {
         MD5Mesh mesh = _meshes[i];                  // get the mesh
-        _prepareMesh(&mesh);                // do some preprocessing on it
+        _prepareMesh(&mesh, i);             // do some preprocessing on it
         _drawMesh(&mesh);
     }
 }
 
+// Compute a pose relative to the base pose for each joint as three
+// matrix rows per joint.
+inline void
+CSCI441::MD5Model::_computeJointPalette(
+        const MD5Joint *pSKELETON,
+        glm::vec4 *pPalette
+) const {
+    for(GLint i = 0; i < _numJoints; ++i) {
+        glm::mat4 jointMtx = glm::translate(glm::mat4(1.0f), pSKELETON[i].position) * glm::mat4_cast(pSKELETON[i].orientation);
+        glm::mat4 skinMtx = jointMtx * _inverseBindPose[i];
+
+        // store the top three rows, the last is always (0, 0, 0, 1)
+        for(GLint row = 0; row < 3; ++row) {
+            pPalette[i * 3 + row] = glm::vec4(skinMtx[0][row], skinMtx[1][row], skinMtx[2][row], skinMtx[3][row]);
+        }
+    }
+}
+
+// Compute the current pose relative to the base pose for each joint and
+// send it to the palette texture buffer.
+inline void
+CSCI441::MD5Model::_uploadJointPalette() const
+{
+    _computeJointPalette(_skeleton, _jointPalette);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, _jointPaletteBuffer );
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, static_cast<GLsizeiptr>(sizeof(glm::vec4) * 3 * _numJoints), _jointPalette );
+
+    glActiveTexture( _jointPaletteTexture );
+    glBindTexture(GL_TEXTURE_BUFFER, _jointPaletteTextureHandle );
+    glActiveTexture( GL_TEXTURE0 );
+}
+
 // Prepare a mesh for drawing.  Compute mesh's final vertex positions
 // given a skeleton.  Put the vertices in vertex arrays.
 inline void
 CSCI441::MD5Model::_prepareMesh(
-        const MD5Mesh *pMESH
+        const MD5Mesh *pMESH,
+        const GLint meshIndex
 ) const {
     GLint i, j, k;
 
@@ -787,29 +1394,10 @@ CSCI441::MD5Model::_prepareMesh(
             _vertexIndicesArray[k] = pMESH->triangles[i].index[j];
     }
 
-    // Setup vertices
-    for(i = 0; i < pMESH->numVertices; ++i) {
-        glm::vec3 finalVertex = {0.0f, 0.0f, 0.0f };
-
-        // Calculate final vertex to draw with weights
-        for(j = 0; j < pMESH->vertices[i].count; ++j) {
-            const MD5Weight *weight = &pMESH->weights[pMESH->vertices[i].start + j];
-            const MD5Joint  *joint  = &_skeleton[weight->joint];
-
-            // Calculate transformed vertex for this weight
-            glm::vec3 weightedVertex;
-            weightedVertex = glm::rotate(joint->orientation, glm::vec4(weight->position, 0.0f));
-
-            // The sum of all weight->bias should be 1.0
-            finalVertex.x += (joint->position.x + weightedVertex.x) * weight->bias;
-            finalVertex.y += (joint->position.y + weightedVertex.y) * weight->bias;
-            finalVertex.z += (joint->position.z + weightedVertex.z) * weight->bias;
-        }
-
-        _vertexArray[i].x = finalVertex.x;
-        _vertexArray[i].y = finalVertex.y;
-        _vertexArray[i].z = finalVertex.z;
+    // Setup vertices, the skinner already holds the current pose
+    _cpuSkinner->skin(static_cast<GLuint>(meshIndex), _vertexArray);
 
+    for(i = 0; i < pMESH->numVertices; ++i) {
         _texelArray[i].s = pMESH->vertices[i].texCoord.s;
         _texelArray[i].t = pMESH->vertices[i].texCoord.t;
     }
@@ -876,11 +1464,302 @@ CSCI441::MD5Model::allocVertexArrays(
     glVertexAttribPointer( vColorAttribLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * _numJoints * 3) );
 
     printf("[.md5mesh]: Skeleton VAO/VBO registered at %u/%u\n", _skeletonVAO, _skeletonVBO );
+
+    // sort the weights into skinning streams
+    _cpuSkinner = new CPUSkinner();
+    for(GLint i = 0; i < _numMeshes; ++i) {
+        _cpuSkinner->addMesh(_meshes[i].vertices, _meshes[i].numVertices, _meshes[i].weights);
+    }
+
+    printf("[.md5mesh]: CPU skinning streams built for %d meshes on %u threads\n", _numMeshes, _cpuSkinner->getNumberOfThreads() );
+}
+
+[[maybe_unused]]
+inline void
+CSCI441::MD5Model::allocSkinnedVertexArrays(
+        GLuint vPosAttribLoc,
+        GLuint vColorAttribLoc,
+        GLuint vTexCoordAttribLoc,
+        GLuint vJointIndicesAttribLoc,
+        GLuint vJointWeightsAttribLoc,
+        GLenum jointPaletteTexture
+) {
+    // the skeleton and CPU fallback arrays are shared with the CPU skinned path
+    allocVertexArrays(vPosAttribLoc, vColorAttribLoc, vTexCoordAttribLoc);
+
+    _inverseBindPose = new glm::mat4[_numJoints];
+    for(GLint i = 0; i < _numJoints; ++i) {
+        glm::mat4 bindMtx = glm::translate(glm::mat4(1.0f), _baseSkeleton[i].position) * glm::mat4_cast(_baseSkeleton[i].orientation);
+        _inverseBindPose[i] = glm::inverse(bindMtx);
+    }
+
+    _skinnedVAOs = new GLuint[_numMeshes];
+    _skinnedVBOs = new GLuint[_numMeshes * 2];
+    glGenVertexArrays(_numMeshes, _skinnedVAOs );
+    glGenBuffers(_numMeshes * 2, _skinnedVBOs );
+
+    for(GLint m = 0; m < _numMeshes; ++m) {
+        const MD5Mesh *pMESH = &_meshes[m];
+        const GLint NUM_VERTICES = pMESH->numVertices;
+
+        auto bindPositions = new glm::vec3[NUM_VERTICES];
+        auto texCoords     = new glm::vec2[NUM_VERTICES];
+        auto jointIndices  = new glm::u16vec4[NUM_VERTICES];
+        auto jointWeights  = new glm::vec4[NUM_VERTICES];
+
+        for(GLint i = 0; i < NUM_VERTICES; ++i) {
+            const MD5Vertex *vertex = &pMESH->vertices[i];
+
+            // bind pose position, computed the same way _prepareMesh() does with the base skeleton
+            glm::vec3 bindPosition = {0.0f, 0.0f, 0.0f };
+            for(GLint j = 0; j < vertex->count; ++j) {
+                const MD5Weight *weight = &pMESH->weights[vertex->start + j];
+                const MD5Joint  *joint  = &_baseSkeleton[weight->joint];
+                glm::vec3 weightedVertex = glm::rotate(joint->orientation, glm::vec4(weight->position, 0.0f));
+                bindPosition += (joint->position + weightedVertex) * weight->bias;
+            }
+
+            // keep the four most influential weights
+            std::pair<GLfloat, GLint> influences[4] = { {0.0f, 0}, {0.0f, 0}, {0.0f, 0}, {0.0f, 0} };
+            for(GLint j = 0; j < vertex->count; ++j) {
+                const MD5Weight *weight = &pMESH->weights[vertex->start + j];
+                std::pair<GLfloat, GLint> influence = { weight->bias, weight->joint };
+                for(auto& slot : influences) {
+                    if( influence.first > slot.first ) std::swap( influence, slot );
+                }
+            }
+            GLfloat totalBias = influences[0].first + influences[1].first + influences[2].first + influences[3].first;
+            if( totalBias <= 0.0f ) totalBias = 1.0f;
+
+            bindPositions[i] = bindPosition;
+            texCoords[i] = vertex->texCoord;
+            for(GLint k = 0; k < 4; ++k) {
+                jointIndices[i][k] = static_cast<glm::u16>( influences[k].second );
+                jointWeights[i][k] = influences[k].first / totalBias;
+            }
+        }
+
+        auto indices = new GLuint[pMESH->numTriangles * 3];
+        for(GLint i = 0, k = 0; i < pMESH->numTriangles; ++i) {
+            for(GLint j = 0; j < 3; ++j, ++k)
+                indices[k] = pMESH->triangles[i].index[j];
+        }
+
+        const GLsizeiptr POS_SIZE    = static_cast<GLsizeiptr>(sizeof(glm::vec3) * NUM_VERTICES);
+        const GLsizeiptr TEX_SIZE    = static_cast<GLsizeiptr>(sizeof(glm::vec2) * NUM_VERTICES);
+        const GLsizeiptr JOINT_SIZE  = static_cast<GLsizeiptr>(sizeof(glm::u16vec4) * NUM_VERTICES);
+        const GLsizeiptr WEIGHT_SIZE = static_cast<GLsizeiptr>(sizeof(glm::vec4) * NUM_VERTICES);
+
+        glBindVertexArray( _skinnedVAOs[m] );
+        glBindBuffer(GL_ARRAY_BUFFER, _skinnedVBOs[m * 2] );
+        glBufferData(GL_ARRAY_BUFFER, POS_SIZE + TEX_SIZE + JOINT_SIZE + WEIGHT_SIZE, nullptr, GL_STATIC_DRAW );
+        glBufferSubData(GL_ARRAY_BUFFER, 0, POS_SIZE, bindPositions );
+        glBufferSubData(GL_ARRAY_BUFFER, POS_SIZE, TEX_SIZE, texCoords );
+        glBufferSubData(GL_ARRAY_BUFFER, POS_SIZE + TEX_SIZE, JOINT_SIZE, jointIndices );
+        glBufferSubData(GL_ARRAY_BUFFER, POS_SIZE + TEX_SIZE + JOINT_SIZE, WEIGHT_SIZE, jointWeights );
+
+        glEnableVertexAttribArray( vPosAttribLoc );
+        glVertexAttribPointer( vPosAttribLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)nullptr );
+
+        glEnableVertexAttribArray( vTexCoordAttribLoc );
+        glVertexAttribPointer( vTexCoordAttribLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)(POS_SIZE) );
+
+        glEnableVertexAttribArray( vJointIndicesAttribLoc );
+        glVertexAttribIPointer( vJointIndicesAttribLoc, 4, GL_UNSIGNED_SHORT, 0, (void*)(POS_SIZE + TEX_SIZE) );
+
+        glEnableVertexAttribArray( vJointWeightsAttribLoc );
+        glVertexAttribPointer( vJointWeightsAttribLoc, 4, GL_FLOAT, GL_FALSE, 0, (void*)(POS_SIZE + TEX_SIZE + JOINT_SIZE) );
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _skinnedVBOs[m * 2 + 1] );
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(GLuint) * pMESH->numTriangles * 3), indices, GL_STATIC_DRAW );
+
+        delete[] bindPositions;
+        delete[] texCoords;
+        delete[] jointIndices;
+        delete[] jointWeights;
+        delete[] indices;
+    }
+
+    // joint palette, three texels per joint
+    _jointPalette = new glm::vec4[_numJoints * 3];
+    _jointPaletteTexture = jointPaletteTexture;
+
+    glGenBuffers( 1, &_jointPaletteBuffer );
+    glBindBuffer(GL_TEXTURE_BUFFER, _jointPaletteBuffer );
+    glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(sizeof(glm::vec4) * 3 * _numJoints), nullptr, GL_DYNAMIC_DRAW );
+
+    glGenTextures( 1, &_jointPaletteTextureHandle );
+    glBindTexture(GL_TEXTURE_BUFFER, _jointPaletteTextureHandle );
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, _jointPaletteBuffer );
+
+    _gpuSkinning = true;
+
+    printf("[.md5mesh]: Skinned VAOs registered for %d meshes, joint palette texture buffer at %u\n", _numMeshes, _jointPaletteTextureHandle );
+}
+
+[[maybe_unused]]
+inline GLint
+CSCI441::MD5Model::bakeAnimation(
+        const GLuint samplesPerFrame
+) {
+    if( !_gpuSkinning || !_isAnimated || samplesPerFrame == 0 ) {
+        CSCI441_LOG_ERROR("CSCI441::MD5Model::bakeAnimation(): model must be animated and allocated with allocSkinnedVertexArrays()");
+        return -1;
+    }
+
+    const GLint ROW_WIDTH = _numJoints * 3;
+    const GLint NUM_ROWS = _animation.numFrames * static_cast<GLint>(samplesPerFrame);
+    const GLint FIRST_ROW = static_cast<GLint>(_bakedPalette.size()) / ROW_WIDTH;
+    _bakedPalette.resize( _bakedPalette.size() + static_cast<size_t>(NUM_ROWS) * ROW_WIDTH );
+
+    // sample between each frame and the next, wrapping around as animate() does
+    auto pose = new MD5Joint[_numJoints];
+    AnimationClip::Pose clipPose;
+    for(GLint frame = 0; frame < _animation.numFrames; ++frame) {
+        for(GLuint sample = 0; sample < samplesPerFrame; ++sample) {
+            const GLfloat interp = static_cast<GLfloat>(sample) / static_cast<GLfloat>(samplesPerFrame);
+            _animationClip.sampleFrames(frame, (frame + 1) % _animation.numFrames, interp, clipPose);
+            for(GLint i = 0; i < _numJoints; ++i) {
+                pose[i].position = clipPose.position(i);
+                pose[i].orientation = clipPose.orientation(i);
+            }
+
+            const GLint ROW = FIRST_ROW + frame * static_cast<GLint>(samplesPerFrame) + static_cast<GLint>(sample);
+            _computeJointPalette(pose, &_bakedPalette[static_cast<size_t>(ROW) * ROW_WIDTH]);
+        }
+    }
+    delete[] pose;
+
+    _bakedClips.emplace_back( static_cast<GLfloat>(FIRST_ROW), static_cast<GLfloat>(NUM_ROWS),
+                              static_cast<GLfloat>(_animation.frameRate) * static_cast<GLfloat>(samplesPerFrame) );
+
+    // rows are fetched exactly and blended in the shader, so no filtering across joints or clips
+    if( _bakedPaletteTextureHandle == 0 ) {
+        glGenTextures( 1, &_bakedPaletteTextureHandle );
+    }
+    glBindTexture(GL_TEXTURE_2D, _bakedPaletteTextureHandle );
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, ROW_WIDTH, FIRST_ROW + NUM_ROWS, 0, GL_RGBA, GL_FLOAT, _bakedPalette.data() );
+
+    const auto CLIP_ID = static_cast<GLint>(_bakedClips.size()) - 1;
+    printf("[.md5anim]: baked clip %d into palette rows %d-%d at %u samples per frame\n", CLIP_ID, FIRST_ROW, FIRST_ROW + NUM_ROWS - 1, samplesPerFrame );
+    return CLIP_ID;
+}
+
+[[maybe_unused]]
+inline void
+CSCI441::MD5Model::allocInstanceArrays(
+        GLuint vInstanceModelMtxAttribLoc,
+        GLuint vInstanceAnimationAttribLoc,
+        GLenum bakedPaletteTexture
+) {
+    if( !_gpuSkinning ) {
+        CSCI441_LOG_ERROR("CSCI441::MD5Model::allocInstanceArrays(): model must be allocated with allocSkinnedVertexArrays()");
+        return;
+    }
+
+    _bakedPaletteTexture = bakedPaletteTexture;
+
+    const GLsizei STRIDE = sizeof(glm::mat4) + sizeof(glm::vec2);
+    glGenBuffers( 1, &_instanceVBO );
+
+    // every mesh shares the same instances
+    for(GLint m = 0; m < _numMeshes; ++m) {
+        glBindVertexArray( _skinnedVAOs[m] );
+        glBindBuffer(GL_ARRAY_BUFFER, _instanceVBO );
+
+        for(GLuint column = 0; column < 4; ++column) {
+            glEnableVertexAttribArray( vInstanceModelMtxAttribLoc + column );
+            glVertexAttribPointer( vInstanceModelMtxAttribLoc + column, 4, GL_FLOAT, GL_FALSE, STRIDE, (void*)(sizeof(glm::vec4) * column) );
+            glVertexAttribDivisor( vInstanceModelMtxAttribLoc + column, 1 );
+        }
+
+        glEnableVertexAttribArray( vInstanceAnimationAttribLoc );
+        glVertexAttribPointer( vInstanceAnimationAttribLoc, 2, GL_FLOAT, GL_FALSE, STRIDE, (void*)(sizeof(glm::mat4)) );
+        glVertexAttribDivisor( vInstanceAnimationAttribLoc, 1 );
+    }
+
+    printf("[.md5mesh]: Instance VBO registered at %u\n", _instanceVBO );
+}
+
+[[maybe_unused]]
+inline void
+CSCI441::MD5Model::setInstances(
+        const glm::mat4* modelMtxs,
+        const glm::vec2* animations,
+        const GLsizei numInstances
+) {
+    if( _instanceVBO == 0 ) return;
+
+    // interleave so each instance is read from one place
+    std::vector<GLfloat> instanceData( static_cast<size_t>(numInstances) * 18 );
+    for(GLsizei i = 0; i < numInstances; ++i) {
+        memcpy( &instanceData[i * 18], &modelMtxs[i][0][0], sizeof(glm::mat4) );
+        instanceData[i * 18 + 16] = animations[i].x;
+        instanceData[i * 18 + 17] = animations[i].y;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _instanceVBO );
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(GLfloat) * instanceData.size()), instanceData.data(), GL_STREAM_DRAW );
+    _numInstances = numInstances;
+}
+
+[[maybe_unused]]
+inline void
+CSCI441::MD5Model::drawInstanced() const
+{
+    if( _numInstances == 0 || _bakedPaletteTextureHandle == 0 ) return;
+
+    glActiveTexture( _bakedPaletteTexture );
+    glBindTexture(GL_TEXTURE_2D, _bakedPaletteTextureHandle );
+    glActiveTexture( GL_TEXTURE0 );
+
+    for(GLint i = 0; i < _numMeshes; ++i) {
+        glBindTexture(GL_TEXTURE_2D, _meshes[i].textures[MD5Mesh::TextureMap::DIFFUSE].texHandle );
+
+        glBindVertexArray( _skinnedVAOs[i] );
+        glDrawElementsInstanced(GL_TRIANGLES, _meshes[i].numTriangles * 3, GL_UNSIGNED_INT, (void*)nullptr, _numInstances );
+    }
 }
 
 inline void
 CSCI441::MD5Model::_freeVertexArrays()
 {
+    if( _skinnedVAOs != nullptr ) {
+        glDeleteVertexArrays( _numMeshes, _skinnedVAOs );
+        glDeleteBuffers( _numMeshes * 2, _skinnedVBOs );
+    }
+    delete[] _skinnedVAOs;
+    _skinnedVAOs = nullptr;
+
+    delete[] _skinnedVBOs;
+    _skinnedVBOs = nullptr;
+
+    delete[] _inverseBindPose;
+    _inverseBindPose = nullptr;
+
+    delete[] _jointPalette;
+    _jointPalette = nullptr;
+
+    glDeleteBuffers( 1, &_jointPaletteBuffer );
+    glDeleteTextures( 1, &_jointPaletteTextureHandle );
+    _gpuSkinning = false;
+
+    // the baked palette is relative to the inverse bind pose freed above
+    glDeleteTextures( 1, &_bakedPaletteTextureHandle );
+    _bakedPaletteTextureHandle = 0;
+    glDeleteBuffers( 1, &_instanceVBO );
+    _instanceVBO = 0;
+    _numInstances = 0;
+    _bakedPalette.clear();
+    _bakedClips.clear();
+
+    delete _cpuSkinner;
+    _cpuSkinner = nullptr;
+
     delete[] _vertexArray;
     _vertexArray = nullptr;
 
@@ -1065,11 +1944,15 @@ CSCI441::MD5Model::readMD5Anim(
     GLint frameIndex;
     GLint i;
 
+    // replace any previously loaded animation
+    _freeAnim();
+    _isAnimated = false;
+
     printf( "[.md5anim]: about to read %s\n", filename );
 
     FILE *fp = fopen( filename, "rb" );
     if( !fp ) {
-        fprintf (stderr, "[.md5anim]: Error: couldn't open \"%s\"!\n", filename);
+        CSCI441_LOG_ERROR("[.md5anim]: couldn't open \"%s\"!", filename);
         return false;
     }
 
@@ -1080,7 +1963,7 @@ CSCI441::MD5Model::readMD5Anim(
         if( sscanf(buff, " MD5Version %d", &version) == 1 ) {
             if( version != 10 ) {
                 // Bad version
-                fprintf (stderr, "[.md5anim]: Error: bad animation version\n");
+                CSCI441_LOG_ERROR("[.md5anim]: bad animation version");
                 fclose (fp);
                 return false;
             }
@@ -1181,9 +2064,27 @@ CSCI441::MD5Model::readMD5Anim(
     _skeleton = new MD5Joint[_animation.numJoints];
 
     if( _checkAnimValidity() ) {
+        // keep only the quantized keyframes, the joint names and parents match the base skeleton
+        _animationClip.quantize(_animation.skeletonFrames, _animation.numFrames, _animation.numJoints, _animation.frameRate);
+        printf( "[.md5anim]: quantized %d frames into %zu bytes (from %zu)\n", _animation.numFrames, _animationClip.getMemorySize(),
+                sizeof(MD5Joint) * _animation.numFrames * _animation.numJoints );
+
+        for(i = 0; i < _animation.numFrames; ++i) {
+            delete[] _animation.skeletonFrames[i];
+        }
+        delete[] _animation.skeletonFrames;
+        _animation.skeletonFrames = nullptr;
+
+        for(i = 0; i < _animation.numJoints; ++i) {
+            _skeleton[i].parent = _baseSkeleton[i].parent;
+        }
+
         _isAnimated = true;
         // compute initial pose
         animate(0.0);
+    } else {
+        // keep drawing the base pose
+        _freeAnim();
     }
 
     return true;
@@ -1195,42 +2096,58 @@ CSCI441::MD5Model::_freeAnim()
 {
     GLint i;
 
-    for(i = 0; i < _animation.numFrames; ++i) {
-        delete _animation.skeletonFrames[i];
-        _animation.skeletonFrames[i] = nullptr;
+    if( _animation.skeletonFrames != nullptr ) {
+        for(i = 0; i < _animation.numFrames; ++i) {
+            delete[] _animation.skeletonFrames[i];
+            _animation.skeletonFrames[i] = nullptr;
+        }
     }
 
     delete[] _animation.skeletonFrames;
     _animation.skeletonFrames = nullptr;
 
-    delete _animation.boundingBoxes;
+    delete[] _animation.boundingBoxes;
     _animation.boundingBoxes = nullptr;
 
-    delete _skeleton;
-    _skeleton = nullptr;
+    // without an animation the skeleton is the base skeleton, freed with the model
+    if( _skeleton != _baseSkeleton ) {
+        delete[] _skeleton;
+    }
+    _skeleton = _baseSkeleton;
 }
 
 // Smoothly interpolate two skeletons
 inline void
 CSCI441::MD5Model::_interpolateSkeletons(GLfloat interp)
 {
-    const MD5Joint *skeletonA = _animation.skeletonFrames[_animationInfo.currFrame];
-    const MD5Joint *skeletonB = _animation.skeletonFrames[_animationInfo.nextFrame];
-
-    GLint i;
+    // decoded keyframes are cached and every joint is interpolated in one batched pass
+    _animationClip.sampleFrames(_animationInfo.currFrame, _animationInfo.nextFrame, interp, _pose);
+    _applyPose();
+}
 
-    for(i = 0; i < _animation.numJoints; ++i) {
-        // Copy parent index
-        _skeleton[i].parent = skeletonA[i].parent;
+// Copy the current pose into the skeleton used for skinning and drawing.
+inline void
+CSCI441::MD5Model::_applyPose()
+{
+    for(GLint i = 0; i < _pose.numJoints; ++i) {
+        _skeleton[i].position = _pose.position(i);
+        _skeleton[i].orientation = _pose.orientation(i);
+    }
+}
 
-        // Linear interpolation for position
-        _skeleton[i].position[0] = skeletonA[i].position[0] + interp * (skeletonB[i].position[0] - skeletonA[i].position[0]);
-        _skeleton[i].position[1] = skeletonA[i].position[1] + interp * (skeletonB[i].position[1] - skeletonA[i].position[1]);
-        _skeleton[i].position[2] = skeletonA[i].position[2] + interp * (skeletonB[i].position[2] - skeletonA[i].position[2]);
+[[maybe_unused]]
+inline void
+CSCI441::MD5Model::blendAnimation(
+        const AnimationClip& clip,
+        const GLfloat time,
+        const GLfloat weight
+) {
+    if( !_isAnimated || clip.getNumberOfJoints() != _numJoints ) return;
 
-        // Spherical linear interpolation for orientation
-        _skeleton[i].orientation = glm::slerp(skeletonA[i].orientation, skeletonB[i].orientation, interp);
-    }
+    AnimationClip::Pose clipPose;
+    clip.sample(time, clipPose);
+    AnimationClip::blend(_pose, clipPose, weight, _pose);
+    _applyPose();
 }
 
 // Perform animation related computations.  Calculate the current and
@@ -1242,11 +2159,11 @@ CSCI441::MD5Model::animate(GLfloat dt)
 
     _animationInfo.lastTime += dt;
 
-    // move to next frame
-    if( _animationInfo.lastTime >= _animationInfo.maxTime ) {
+    // move to next frame, possibly several when updates are throttled and dt spans frames
+    while( _animationInfo.maxTime > 0.0f && _animationInfo.lastTime >= _animationInfo.maxTime ) {
         _animationInfo.currFrame++;
         _animationInfo.nextFrame++;
-        _animationInfo.lastTime = 0.0;
+        _animationInfo.lastTime -= _animationInfo.maxTime;
 
         if( _animationInfo.currFrame > maxFrames )
             _animationInfo.currFrame = 0;
@@ -0,0 +1,421 @@
+/** @file MeshSimplifier.hpp
+ * @brief Reduces indexed triangle meshes with quadric error metrics to build levels of detail
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Implements Garland and Heckbert's quadric error metric with half-edge collapses.  Every
+ *	collapse moves one vertex onto a neighbor that already exists, so the simplified mesh is
+ *	only a new index list into the original vertex arrays and each level of detail can share
+ *	the same vertex buffer.  Vertices split along normal or texture seams are welded by position
+ *	while simplifying and the corner whose attributes match best is kept for each triangle.
+ *	Boundary edges are weighted so open borders keep their silhouette.
+ *
+ *	@warning This header file depends upon glm
+ */
+
+#ifndef CSCI441_MESH_SIMPLIFIER_HPP
+#define CSCI441_MESH_SIMPLIFIER_HPP
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <queue>
+#include <tuple>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @namespace MeshSimplifier
+     * @brief quadric error mesh simplification functions
+     */
+    namespace MeshSimplifier {
+
+        /**
+         * @brief the vertex data a mesh is simplified against
+         * @note only positions and indices are required, normals and texture coordinates
+         * may be null and are then ignored when matching corners across seams
+         */
+        struct MeshData {
+            /// vertex positions
+            const glm::vec3* positions = nullptr;
+            /// vertex normals, may be null
+            const glm::vec3* normals = nullptr;
+            /// vertex texture coordinates, may be null
+            const glm::vec2* texCoords = nullptr;
+            /// number of vertices in each array
+            GLuint numVertices = 0;
+            /// triangle list indices
+            const GLuint* indices = nullptr;
+            /// number of indices, a multiple of three
+            GLuint numIndices = 0;
+        };
+
+        /**
+         * @brief a simplified mesh expressed as indices into the original vertex arrays
+         */
+        struct SimplifiedMesh {
+            /// triangle list indices into the original vertex arrays
+            std::vector<GLuint> indices;
+            /// for each output triangle, the input triangle it was derived from
+            std::vector<GLuint> sourceTriangles;
+            /// largest collapse error accepted, relative to the mesh bounding box diagonal
+            float error = 0.0f;
+        };
+
+        /**
+         * @brief simplifies a mesh until it has at most the requested number of indices
+         * @param mesh mesh to simplify
+         * @param targetNumIndices stop once the mesh has this many indices or fewer
+         * @param maxError stop before a collapse whose error, relative to the bounding box diagonal,
+         * exceeds this value (default: 1.0 which effectively disables the limit)
+         * @param attributeWeight how strongly collapses across normal or texture seams are penalized (default: 1.0)
+         * @returns the simplified mesh
+         */
+        [[maybe_unused]] SimplifiedMesh simplify( const MeshData& mesh, GLuint targetNumIndices,
+                                                  float maxError = 1.0f, float attributeWeight = 1.0f );
+
+        /**
+         * @brief builds a chain of progressively simpler levels of detail
+         * @param mesh full resolution mesh, level 0
+         * @param numLevels number of reduced levels to build (default: 3)
+         * @param reductionPerLevel fraction of triangles kept from one level to the next (default: 0.5)
+         * @returns the reduced levels, most detailed first, each simplified from the previous one.
+         * Source triangles always refer to the full resolution mesh.
+         * @note stops early if a level cannot be reduced further
+         */
+        [[maybe_unused]] std::vector<SimplifiedMesh> generateLODs( const MeshData& mesh, GLuint numLevels = 3,
+                                                                    float reductionPerLevel = 0.5f );
+    }
+}
+
+//**********************************************************************************
+// Internal helper structures
+
+namespace CSCI441_INTERNAL {
+    // symmetric 4x4 quadric stored as its upper triangle
+    struct Quadric {
+        double a[10] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+        void addPlane( const glm::dvec3& n, double d, double weight ) {
+            a[0] += weight * n.x * n.x; a[1] += weight * n.x * n.y; a[2] += weight * n.x * n.z; a[3] += weight * n.x * d;
+            a[4] += weight * n.y * n.y; a[5] += weight * n.y * n.z; a[6] += weight * n.y * d;
+            a[7] += weight * n.z * n.z; a[8] += weight * n.z * d;
+            a[9] += weight * d * d;
+        }
+        Quadric& operator+=( const Quadric& other ) {
+            for( int i = 0; i < 10; i++ ) a[i] += other.a[i];
+            return *this;
+        }
+        [[nodiscard]] double evaluate( const glm::dvec3& p ) const {
+            return a[0]*p.x*p.x + 2*a[1]*p.x*p.y + 2*a[2]*p.x*p.z + 2*a[3]*p.x
+                 + a[4]*p.y*p.y + 2*a[5]*p.y*p.z + 2*a[6]*p.y
+                 + a[7]*p.z*p.z + 2*a[8]*p.z
+                 + a[9];
+        }
+    };
+
+    // a candidate half-edge collapse, moving group "from" onto group "to"
+    struct Collapse {
+        double cost;
+        GLuint from, to;
+        GLuint fromVersion, toVersion;
+        bool operator>( const Collapse& other ) const { return cost > other.cost; }
+    };
+
+    class QuadricSimplifier {
+    public:
+        explicit QuadricSimplifier( const CSCI441::MeshSimplifier::MeshData& mesh, float attributeWeight );
+        CSCI441::MeshSimplifier::SimplifiedMesh run( GLuint targetNumIndices, float maxError );
+
+    private:
+        void _pushCollapses( GLuint group );
+        bool _evaluate( GLuint from, GLuint to, double& cost ) const;
+        bool _isValid( GLuint from, GLuint to ) const;
+        void _apply( GLuint from, GLuint to );
+        GLuint _matchCorner( GLuint vertex, GLuint group ) const;
+        double _attributeDistance( GLuint a, GLuint b ) const;
+        [[nodiscard]] glm::dvec3 _position( GLuint group ) const { return glm::dvec3( _mesh.positions[ _groupVertices[group].front() ] ); }
+
+        const CSCI441::MeshSimplifier::MeshData& _mesh;
+        double _attributeWeight;
+        double _scale;                                          // bounding box diagonal
+
+        std::vector<GLuint> _vertexGroup;                       // welded position group of each vertex
+        std::vector< std::vector<GLuint> > _groupVertices;      // vertices sharing each position
+        std::vector< std::vector<GLuint> > _groupTriangles;     // triangles touching each group
+        std::vector<Quadric> _quadrics;
+        std::vector<GLuint> _versions;
+        std::vector<bool> _groupAlive;
+
+        std::vector<GLuint> _corners;                           // current vertex of each triangle corner
+        std::vector<bool> _triangleAlive;
+        GLuint _numLiveTriangles;
+
+        std::priority_queue< Collapse, std::vector<Collapse>, std::greater<> > _heap;
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+[[maybe_unused]]
+inline CSCI441::MeshSimplifier::SimplifiedMesh CSCI441::MeshSimplifier::simplify( const MeshData& mesh, const GLuint targetNumIndices, const float maxError, const float attributeWeight ) {
+    CSCI441_INTERNAL::QuadricSimplifier simplifier( mesh, attributeWeight );
+    return simplifier.run( targetNumIndices, maxError );
+}
+
+[[maybe_unused]]
+inline std::vector<CSCI441::MeshSimplifier::SimplifiedMesh> CSCI441::MeshSimplifier::generateLODs( const MeshData& mesh, const GLuint numLevels, const float reductionPerLevel ) {
+    std::vector<SimplifiedMesh> levels;
+
+    MeshData previous = mesh;
+    for( GLuint level = 0; level < numLevels; level++ ) {
+        const auto target = static_cast<GLuint>( static_cast<float>(previous.numIndices / 3) * reductionPerLevel ) * 3;
+        if( target < 3 ) break;
+
+        SimplifiedMesh reduced = simplify( previous, target );
+        if( reduced.indices.empty() || reduced.indices.size() >= previous.numIndices ) break;
+
+        // map source triangles of this pass back to the full resolution mesh
+        if( !levels.empty() ) {
+            for( auto& sourceTriangle : reduced.sourceTriangles ) {
+                sourceTriangle = levels.back().sourceTriangles[ sourceTriangle ];
+            }
+        }
+        levels.push_back( std::move(reduced) );
+
+        previous.indices = levels.back().indices.data();
+        previous.numIndices = static_cast<GLuint>( levels.back().indices.size() );
+    }
+    return levels;
+}
+
+//**********************************************************************************
+// Internal implementations
+
+inline CSCI441_INTERNAL::QuadricSimplifier::QuadricSimplifier( const CSCI441::MeshSimplifier::MeshData& mesh, const float attributeWeight )
+        : _mesh(mesh), _attributeWeight(attributeWeight), _scale(1.0), _numLiveTriangles(0) {
+    // weld vertices that share a position
+    glm::vec3 boxMin( 0.0f ), boxMax( 0.0f );
+    std::map< std::tuple<float, float, float>, GLuint > positionGroups;
+    _vertexGroup.resize( mesh.numVertices );
+    for( GLuint v = 0; v < mesh.numVertices; v++ ) {
+        const glm::vec3& p = mesh.positions[v];
+        boxMin = v == 0 ? p : glm::min( boxMin, p );
+        boxMax = v == 0 ? p : glm::max( boxMax, p );
+        auto inserted = positionGroups.emplace( std::make_tuple( p.x, p.y, p.z ), static_cast<GLuint>( _groupVertices.size() ) );
+        if( inserted.second ) _groupVertices.emplace_back();
+        _vertexGroup[v] = inserted.first->second;
+        _groupVertices[ inserted.first->second ].push_back( v );
+    }
+    _scale = std::max( 1e-6, static_cast<double>( glm::length( boxMax - boxMin ) ) );
+
+    const size_t NUM_GROUPS = _groupVertices.size();
+    _groupTriangles.resize( NUM_GROUPS );
+    _quadrics.resize( NUM_GROUPS );
+    _versions.assign( NUM_GROUPS, 0 );
+    _groupAlive.assign( NUM_GROUPS, true );
+
+    const GLuint NUM_TRIANGLES = mesh.numIndices / 3;
+    _corners.assign( mesh.indices, mesh.indices + NUM_TRIANGLES * 3 );
+    _triangleAlive.assign( NUM_TRIANGLES, true );
+    _numLiveTriangles = NUM_TRIANGLES;
+
+    // one plane quadric per triangle so costs are squared distances, and count how many triangles share each edge
+    std::map< std::pair<GLuint, GLuint>, int > edgeUse;
+    for( GLuint t = 0; t < NUM_TRIANGLES; t++ ) {
+        const GLuint g[3] = { _vertexGroup[ _corners[t*3] ], _vertexGroup[ _corners[t*3+1] ], _vertexGroup[ _corners[t*3+2] ] };
+        if( g[0] == g[1] || g[1] == g[2] || g[0] == g[2] ) {
+            _triangleAlive[t] = false;
+            _numLiveTriangles--;
+            continue;
+        }
+
+        const glm::dvec3 p0 = _position( g[0] ), p1 = _position( g[1] ), p2 = _position( g[2] );
+        const glm::dvec3 cross = glm::cross( p1 - p0, p2 - p0 );
+        const double area = glm::length( cross ) * 0.5;
+        if( area > 0.0 ) {
+            const glm::dvec3 n = cross / (area * 2.0);
+            for( GLuint corner : g ) _quadrics[corner].addPlane( n, -glm::dot( n, p0 ), 1.0 );
+        }
+
+        for( int i = 0; i < 3; i++ ) {
+            _groupTriangles[ g[i] ].push_back( t );
+            edgeUse[ std::minmax( g[i], g[(i+1)%3] ) ]++;
+        }
+    }
+
+    // constrain open borders with planes perpendicular to their triangle
+    for( GLuint t = 0; t < NUM_TRIANGLES; t++ ) {
+        if( !_triangleAlive[t] ) continue;
+        const GLuint g[3] = { _vertexGroup[ _corners[t*3] ], _vertexGroup[ _corners[t*3+1] ], _vertexGroup[ _corners[t*3+2] ] };
+        const glm::dvec3 faceNormal = glm::cross( _position(g[1]) - _position(g[0]), _position(g[2]) - _position(g[0]) );
+        for( int i = 0; i < 3; i++ ) {
+            if( edgeUse[ std::minmax( g[i], g[(i+1)%3] ) ] != 1 ) continue;
+            const glm::dvec3 edge = _position( g[(i+1)%3] ) - _position( g[i] );
+            const glm::dvec3 borderNormal = glm::cross( edge, faceNormal );
+            const double length = glm::length( borderNormal );
+            if( length <= 0.0 ) continue;
+            const glm::dvec3 n = borderNormal / length;
+            const double weight = 10.0;
+            _quadrics[ g[i] ].addPlane( n, -glm::dot( n, _position( g[i] ) ), weight );
+            _quadrics[ g[(i+1)%3] ].addPlane( n, -glm::dot( n, _position( g[i] ) ), weight );
+        }
+    }
+
+    for( GLuint g = 0; g < NUM_GROUPS; g++ ) _pushCollapses( g );
+}
+
+inline CSCI441::MeshSimplifier::SimplifiedMesh CSCI441_INTERNAL::QuadricSimplifier::run( const GLuint targetNumIndices, const float maxError ) {
+    CSCI441::MeshSimplifier::SimplifiedMesh result;
+    const double MAX_COST = static_cast<double>(maxError) * maxError * _scale * _scale;
+    double acceptedCost = 0.0;
+
+    while( _numLiveTriangles * 3 > targetNumIndices && !_heap.empty() ) {
+        const Collapse collapse = _heap.top();
+        _heap.pop();
+
+        if( !_groupAlive[collapse.from] || !_groupAlive[collapse.to]
+            || _versions[collapse.from] != collapse.fromVersion || _versions[collapse.to] != collapse.toVersion ) continue;
+        if( collapse.cost > MAX_COST ) break;
+        if( !_isValid( collapse.from, collapse.to ) ) continue;
+
+        _apply( collapse.from, collapse.to );
+        acceptedCost = std::max( acceptedCost, collapse.cost );
+    }
+
+    for( GLuint t = 0; t < _triangleAlive.size(); t++ ) {
+        if( !_triangleAlive[t] ) continue;
+        result.indices.insert( result.indices.end(), _corners.begin() + t*3, _corners.begin() + t*3 + 3 );
+        result.sourceTriangles.push_back( t );
+    }
+    result.error = static_cast<float>( std::sqrt( std::max( 0.0, acceptedCost ) ) / _scale );
+    return result;
+}
+
+inline void CSCI441_INTERNAL::QuadricSimplifier::_pushCollapses( const GLuint group ) {
+    for( GLuint t : _groupTriangles[group] ) {
+        if( !_triangleAlive[t] ) continue;
+        for( int i = 0; i < 3; i++ ) {
+            const GLuint neighbor = _vertexGroup[ _corners[t*3+i] ];
+            if( neighbor == group ) continue;
+            double cost;
+            if( _evaluate( group, neighbor, cost ) ) _heap.push( { cost, group, neighbor, _versions[group], _versions[neighbor] } );
+            if( _evaluate( neighbor, group, cost ) ) _heap.push( { cost, neighbor, group, _versions[neighbor], _versions[group] } );
+        }
+    }
+}
+
+inline bool CSCI441_INTERNAL::QuadricSimplifier::_evaluate( const GLuint from, const GLuint to, double& cost ) const {
+    Quadric combined = _quadrics[from];
+    combined += _quadrics[to];
+    cost = std::max( 0.0, combined.evaluate( _position(to) ) );
+
+    // penalize corners that have no close match in the target group
+    if( _attributeWeight > 0.0 && (_mesh.normals != nullptr || _mesh.texCoords != nullptr) ) {
+        double attributeCost = 0.0;
+        for( GLuint v : _groupVertices[from] ) {
+            attributeCost += _attributeDistance( v, _matchCorner( v, to ) );
+        }
+        cost += attributeCost * _attributeWeight * _scale * _scale * 1e-3;
+    }
+    return true;
+}
+
+inline bool CSCI441_INTERNAL::QuadricSimplifier::_isValid( const GLuint from, const GLuint to ) const {
+    const glm::dvec3 target = _position( to );
+    for( GLuint t : _groupTriangles[from] ) {
+        if( !_triangleAlive[t] ) continue;
+        glm::dvec3 p[3];
+        bool touchesTarget = false;
+        for( int i = 0; i < 3; i++ ) {
+            const GLuint g = _vertexGroup[ _corners[t*3+i] ];
+            touchesTarget = touchesTarget || g == to;
+            p[i] = _position( g );
+        }
+        if( touchesTarget ) continue;               // this triangle collapses away
+
+        // reject collapses that would flip or degenerate a surviving triangle
+        const glm::dvec3 before = glm::cross( p[1] - p[0], p[2] - p[0] );
+        for( int i = 0; i < 3; i++ ) {
+            if( _vertexGroup[ _corners[t*3+i] ] == from ) p[i] = target;
+        }
+        const glm::dvec3 after = glm::cross( p[1] - p[0], p[2] - p[0] );
+        const double beforeLength = glm::length( before ), afterLength = glm::length( after );
+        if( afterLength <= 1e-12 * _scale * _scale ) return false;
+        if( beforeLength > 0.0 && glm::dot( before, after ) < 0.2 * beforeLength * afterLength ) return false;
+    }
+    return true;
+}
+
+inline void CSCI441_INTERNAL::QuadricSimplifier::_apply( const GLuint from, const GLuint to ) {
+    for( GLuint t : _groupTriangles[from] ) {
+        if( !_triangleAlive[t] ) continue;
+
+        bool touchesTarget = false;
+        for( int i = 0; i < 3; i++ ) touchesTarget = touchesTarget || _vertexGroup[ _corners[t*3+i] ] == to;
+
+        if( touchesTarget ) {
+            _triangleAlive[t] = false;
+            _numLiveTriangles--;
+        } else {
+            for( int i = 0; i < 3; i++ ) {
+                GLuint& corner = _corners[t*3+i];
+                if( _vertexGroup[corner] == from ) corner = _matchCorner( corner, to );
+            }
+            _groupTriangles[to].push_back( t );
+        }
+    }
+
+    _quadrics[to] += _quadrics[from];
+    _groupAlive[from] = false;
+    _groupTriangles[from].clear();
+    _versions[to]++;
+
+    // drop dead triangles from the target so its list does not grow without bound
+    auto& triangles = _groupTriangles[to];
+    triangles.erase( std::remove_if( triangles.begin(), triangles.end(), [this](GLuint t) { return !_triangleAlive[t]; } ), triangles.end() );
+
+    // only edges touching the target changed cost, older entries are skipped by their version
+    _pushCollapses( to );
+}
+
+inline GLuint CSCI441_INTERNAL::QuadricSimplifier::_matchCorner( const GLuint vertex, const GLuint group ) const {
+    const auto& candidates = _groupVertices[group];
+    GLuint best = candidates.front();
+    double bestDistance = _attributeDistance( vertex, best );
+    for( size_t i = 1; i < candidates.size(); i++ ) {
+        const double distance = _attributeDistance( vertex, candidates[i] );
+        if( distance < bestDistance ) {
+            bestDistance = distance;
+            best = candidates[i];
+        }
+    }
+    return best;
+}
+
+inline double CSCI441_INTERNAL::QuadricSimplifier::_attributeDistance( const GLuint a, const GLuint b ) const {
+    double distance = 0.0;
+    if( _mesh.normals != nullptr ) {
+        distance += 1.0 - glm::dot( glm::dvec3( _mesh.normals[a] ), glm::dvec3( _mesh.normals[b] ) );
+    }
+    if( _mesh.texCoords != nullptr ) {
+        const glm::dvec2 d = glm::dvec2( _mesh.texCoords[a] ) - glm::dvec2( _mesh.texCoords[b] );
+        distance += glm::dot( d, d );
+    }
+    return distance;
+}
+
+#endif // CSCI441_MESH_SIMPLIFIER_HPP
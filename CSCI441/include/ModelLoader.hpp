@@ -10,6 +10,10 @@
   *     .ply
   *		.stl
   *
+  *	Vertices are uploaded interleaved with packed normals and half float texture
+  *	coordinates.  Positions can also be quantized to 16 bits, in which case the
+  *	matrix from getPositionDequantizationMatrix() must be applied to the model matrix.
+  *
   *	@warning NOTE: This header file will only work with OpenGL 3.0+
   *	@warning NOTE: This header file depends upon GLAD (or GLEW), glm, stb_image
 */
@@ -17,7 +21,12 @@
 #ifndef CSCI441_MODEL_LOADER_HPP
 #define CSCI441_MODEL_LOADER_HPP
 
+#include "AssetManager.hpp"
+#include "IndexOptimizer.hpp"
+#include "Logger.hpp"
+#include "MeshSimplifier.hpp"
 #include "modelMaterial.hpp"
+#include "VertexFormat.hpp"
 
 #ifdef CSCI441_USE_GLEW
     #include <GL/glew.h>
@@ -28,6 +37,7 @@
 #include <glm/glm.hpp>
 #include <stb_image.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -97,11 +107,28 @@ namespace CSCI441 {
          * @param matShinLocation uniform location of material shininess component
          * @param matAmbLocation uniform location of material ambient component
          * @param diffuseTexture texture number to bind diffuse texture map to
+         * @param levelOfDetail level of detail to render, 0 being the full resolution model (default: 0)
          * @return true if draw succeeded, false otherwise
+         * @note levels beyond those generated are clamped to the coarsest level available
          */
         [[maybe_unused]] bool draw( GLuint shaderProgramHandle,
                    GLint matDiffLocation = -1, GLint matSpecLocation = -1, GLint matShinLocation = -1, GLint matAmbLocation = -1,
-                   GLenum diffuseTexture = GL_TEXTURE0 ) const;
+                   GLenum diffuseTexture = GL_TEXTURE0, GLuint levelOfDetail = 0 ) const;
+
+        /**
+         * @brief Generates reduced levels of detail with quadric error simplification
+         * @param numLevels number of reduced levels to build in addition to the full resolution model (default: 3)
+         * @param reductionPerLevel fraction of triangles kept from one level to the next (default: 0.5)
+         * @return number of reduced levels built
+         * @note the levels reuse the model's vertex buffer and only add indices to its element buffer
+         * @warning Must be called after a model has been loaded from file
+         */
+        [[maybe_unused]] GLuint generateLODs( GLuint numLevels = 3, GLfloat reductionPerLevel = 0.5f );
+        /**
+         * @brief Return the number of levels of detail available, including the full resolution model
+         * @return the number of levels of detail
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint getNumberOfLODs() const;
 
         /**
          * @brief Return the number of vertices the model is made up of.  This value corresponds to the size of the Vertices, TexCoords, and Normals arrays.
@@ -137,6 +164,16 @@ namespace CSCI441 {
 		 * @note For use with IBOs
 		 */
         [[maybe_unused]] [[nodiscard]] GLuint* getIndices() const;
+        /**
+         * @brief Return the post-transform cache efficiency of the index array as loaded from file
+         * @return ACMR and ATVR before the index array was optimized
+         */
+        [[maybe_unused]] [[nodiscard]] CSCI441::IndexOptimizer::Statistics getUnoptimizedVertexCacheStatistics() const;
+        /**
+         * @brief Return the post-transform cache efficiency of the index array that is drawn
+         * @return ACMR and ATVR after the index array was optimized
+         */
+        [[maybe_unused]] [[nodiscard]] CSCI441::IndexOptimizer::Statistics getVertexCacheStatistics() const;
 
 		/**
 		 * @brief Enable auto-generation of vertex normals
@@ -154,6 +191,28 @@ namespace CSCI441 {
          */
 		[[maybe_unused]] static void disableAutoGenerateNormals();
 
+        /**
+         * @brief Enable 16 bit vertex positions, 16 bytes per vertex instead of 20
+         * @warning Must be called prior to loading in a model from file
+         * @note The model matrix must be multiplied by getPositionDequantizationMatrix() when drawing
+         * @note Positions are stored as floats by default
+         * @note To disable, call disablePositionQuantization
+         */
+        [[maybe_unused]] static void enablePositionQuantization();
+        /**
+         * @brief Disable 16 bit vertex positions
+         * @warning Must be called prior to loading in a model from file
+         * @note Positions are stored as floats by default
+         * @note To enable, call enablePositionQuantization
+         */
+        [[maybe_unused]] static void disablePositionQuantization();
+        /**
+         * @brief Return the matrix that maps the stored vertex positions back to model space
+         * @return dequantization matrix, identity unless position quantization was enabled when the model was loaded
+         * @note apply as modelMtx * getPositionDequantizationMatrix(), it only translates and scales uniformly so the normal matrix is unaffected
+         */
+        [[maybe_unused]] [[nodiscard]] const glm::mat4& getPositionDequantizationMatrix() const;
+
 	private:
 		void _init();
 		bool _loadMTLFile( const char *mtlFilename, bool INFO, bool ERRORS );
@@ -162,7 +221,9 @@ namespace CSCI441 {
 		bool _loadPLYFile( bool INFO, bool ERRORS );
 		bool _loadSTLFile( bool INFO, bool ERRORS );
 		static std::vector<std::string> _tokenizeString( std::string input, const std::string& delimiters );
+		static std::string _resolveMTLTextureFilename( const std::string& filename, const std::string& path );
         void _allocateAttributeArrays(GLuint numVertices, GLuint numIndices);
+        void _optimizeIndices();
         void _bufferData();
 
 		std::string _filename;
@@ -170,6 +231,7 @@ namespace CSCI441 {
 
 		GLuint _vaod;
 		GLuint _vbods[2];
+		CSCI441::VertexFormat _vertexFormat;
 
 		glm::vec3* _vertices;
         glm::vec3* _normals;
@@ -180,11 +242,17 @@ namespace CSCI441 {
 
 		std::map< std::string, CSCI441_INTERNAL::ModelMaterial* > _materials;
 		std::map< std::string, std::vector< std::pair< GLuint, GLuint > > > _materialIndexStartStop;
+		std::vector< std::map< std::string, std::vector< std::pair< GLuint, GLuint > > > > _lodIndexStartStop;  // one entry per reduced level
+		std::vector< GLuint > _textureHandles;  // references held on textures shared through the AssetManager
+
+		CSCI441::IndexOptimizer::Statistics _unoptimizedCacheStatistics;
+		CSCI441::IndexOptimizer::Statistics _cacheStatistics;
 
 		bool _hasVertexTexCoords;
 		bool _hasVertexNormals;
 
         static bool sAUTO_GEN_NORMALS;
+        static bool sQUANTIZE_POSITIONS;
 	};
 }
 
@@ -197,6 +265,7 @@ namespace CSCI441_INTERNAL {
 }
 
 inline bool CSCI441::ModelLoader::sAUTO_GEN_NORMALS = false;
+inline bool CSCI441::ModelLoader::sQUANTIZE_POSITIONS = false;
 
 inline CSCI441::ModelLoader::ModelLoader() {
 	_init();
@@ -216,6 +285,10 @@ inline CSCI441::ModelLoader::~ModelLoader() {
 
 	glDeleteBuffers( 2, _vbods );
     glDeleteVertexArrays( 1, &_vaod );
+
+	for( const auto& textureHandle : _textureHandles ) {
+		CSCI441::AssetManager::instance().releaseTexture( textureHandle );
+	}
 }
 
 inline void CSCI441::ModelLoader::_init() {
@@ -237,25 +310,26 @@ inline void CSCI441::ModelLoader::_init() {
 inline bool CSCI441::ModelLoader::loadModelFile( std::string filename, bool INFO, bool ERRORS ) {
 	bool result = true;
 	_filename = std::move(filename);
+	_lodIndexStartStop.clear();
 	if( _filename.find(".obj") != std::string::npos ) {
-		result = _loadOBJFile( INFO, ERRORS );
 		_modelType = CSCI441_INTERNAL::MODEL_TYPE::OBJ;
+		result = _loadOBJFile( INFO, ERRORS );
 	}
 	else if( _filename.find(".off") != std::string::npos ) {
-		result = _loadOFFFile( INFO, ERRORS );
 		_modelType = CSCI441_INTERNAL::MODEL_TYPE::OFF;
+		result = _loadOFFFile( INFO, ERRORS );
 	}
 	else if( _filename.find(".ply") != std::string::npos ) {
-		result = _loadPLYFile( INFO, ERRORS );
 		_modelType = CSCI441_INTERNAL::MODEL_TYPE::PLY;
+		result = _loadPLYFile( INFO, ERRORS );
 	}
 	else if( _filename.find(".stl") != std::string::npos ) {
-		result = _loadSTLFile( INFO, ERRORS );
 		_modelType = CSCI441_INTERNAL::MODEL_TYPE::STL;
+		result = _loadSTLFile( INFO, ERRORS );
 	}
 	else {
 		result = false;
-		if (ERRORS) fprintf( stderr, "[ERROR]:  Unsupported file format for file: %s\n", _filename.c_str() );
+		if (ERRORS) CSCI441_LOG_ERROR( "Unsupported file format for file: %s", _filename.c_str() );
 	}
 
 	return result;
@@ -266,27 +340,23 @@ inline void CSCI441::ModelLoader::setAttributeLocations(GLint positionLocation,
     glBindVertexArray( _vaod );
     glBindBuffer( GL_ARRAY_BUFFER, _vbods[0] );
 
-    glEnableVertexAttribArray( positionLocation );
-    glVertexAttribPointer( positionLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)nullptr );
-
-    glEnableVertexAttribArray( normalLocation );
-    glVertexAttribPointer( normalLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * _uniqueIndex) );
-
-    glEnableVertexAttribArray( texCoordLocation );
-    glVertexAttribPointer( texCoordLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * _uniqueIndex * 2) );
+    _vertexFormat.setAttributePointers( positionLocation, normalLocation, texCoordLocation );
 }
 
 [[maybe_unused]]
 inline bool CSCI441::ModelLoader::draw( GLuint shaderProgramHandle,
                                         GLint matDiffLocation, GLint matSpecLocation, GLint matShinLocation, GLint matAmbLocation,
-                                        GLenum diffuseTexture ) const {
+                                        GLenum diffuseTexture, GLuint levelOfDetail ) const {
     glBindVertexArray( _vaod );
 
+    levelOfDetail = std::min( levelOfDetail, static_cast<GLuint>( _lodIndexStartStop.size() ) );
+    const auto& levelIndexStartStop = levelOfDetail == 0 ? _materialIndexStartStop : _lodIndexStartStop[levelOfDetail - 1];
+
     bool result = true;
-	if( _modelType == CSCI441_INTERNAL::MODEL_TYPE::OBJ ) {
-		for(const auto & materialIter : _materialIndexStartStop) {
-			auto materialName = materialIter.first;
-			auto indexStartStop = materialIter.second;
+	if( _modelType == CSCI441_INTERNAL::MODEL_TYPE::OBJ || levelOfDetail > 0 ) {
+		for(const auto & materialIter : levelIndexStartStop) {
+			const auto& materialName = materialIter.first;
+			const auto& indexStartStop = materialIter.second;
 
 			CSCI441_INTERNAL::ModelMaterial* material = nullptr;
 			if( _materials.find( materialName ) != _materials.end() )
@@ -321,12 +391,73 @@ inline bool CSCI441::ModelLoader::draw( GLuint shaderProgramHandle,
 	return result;
 }
 
+[[maybe_unused]]
+inline GLuint CSCI441::ModelLoader::generateLODs( const GLuint numLevels, const GLfloat reductionPerLevel ) {
+	if( _indices == nullptr || _numIndices < 3 ) {
+		CSCI441_LOG_ERROR( "CSCI441::ModelLoader::generateLODs(): no model loaded" );
+		return 0;
+	}
+
+	CSCI441::MeshSimplifier::MeshData mesh;
+	mesh.positions = _vertices;
+	mesh.normals = _hasVertexNormals || sAUTO_GEN_NORMALS ? _normals : nullptr;
+	mesh.texCoords = _hasVertexTexCoords ? _texCoords : nullptr;
+	mesh.numVertices = _uniqueIndex;
+	mesh.indices = _indices;
+	mesh.numIndices = _numIndices;
+
+	const auto levels = CSCI441::MeshSimplifier::generateLODs( mesh, numLevels, reductionPerLevel );
+
+	// material of each full resolution triangle so reduced triangles keep their material
+	const GLuint numTriangles = _numIndices / 3;
+	std::vector< std::string > triangleMaterials( numTriangles );
+	for( const auto& materialIter : _materialIndexStartStop ) {
+		for( const auto& idxIter : materialIter.second ) {
+			for( GLuint triangle = idxIter.first / 3; triangle < (idxIter.second + 1) / 3 && triangle < numTriangles; triangle++ ) {
+				triangleMaterials[triangle] = materialIter.first;
+			}
+		}
+	}
+
+	// lay each level out after the full resolution indices, grouped by material
+	std::vector< GLuint > lodIndices;
+	_lodIndexStartStop.clear();
+	for( const auto& level : levels ) {
+		std::map< std::string, std::vector< GLuint > > materialTriangles;
+		for( GLuint triangle = 0; triangle < level.sourceTriangles.size(); triangle++ ) {
+			materialTriangles[ triangleMaterials[ level.sourceTriangles[triangle] ] ].push_back( triangle );
+		}
+
+		std::map< std::string, std::vector< std::pair< GLuint, GLuint > > > levelIndexStartStop;
+		for( const auto& materialIter : materialTriangles ) {
+			const auto start = static_cast<GLuint>( _numIndices + lodIndices.size() );
+			for( const auto& triangle : materialIter.second ) {
+				lodIndices.insert( lodIndices.end(), level.indices.begin() + triangle * 3, level.indices.begin() + triangle * 3 + 3 );
+			}
+			const auto end = static_cast<GLuint>( _numIndices + lodIndices.size() ) - 1;
+			levelIndexStartStop[ materialIter.first ].emplace_back( start, end );
+		}
+		_lodIndexStartStop.push_back( std::move(levelIndexStartStop) );
+	}
+
+	glBindVertexArray( _vaod );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _vbods[1] );
+	glBufferData( GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(GLuint) * (_numIndices + lodIndices.size())), nullptr, GL_STATIC_DRAW );
+	glBufferSubData( GL_ELEMENT_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(sizeof(GLuint) * _numIndices), _indices );
+	glBufferSubData( GL_ELEMENT_ARRAY_BUFFER, static_cast<GLintptr>(sizeof(GLuint) * _numIndices), static_cast<GLsizeiptr>(sizeof(GLuint) * lodIndices.size()), lodIndices.data() );
+
+	return static_cast<GLuint>( _lodIndexStartStop.size() );
+}
+
+[[maybe_unused]] inline GLuint CSCI441::ModelLoader::getNumberOfLODs() const { return static_cast<GLuint>( _lodIndexStartStop.size() ) + 1; }
 [[maybe_unused]] inline GLuint CSCI441::ModelLoader::getNumberOfVertices() const { return _uniqueIndex; }
 [[maybe_unused]] inline GLfloat* CSCI441::ModelLoader::getVertices() const { return (_vertices != nullptr ? (GLfloat*)&_vertices[0] : nullptr); }
 [[maybe_unused]] inline GLfloat* CSCI441::ModelLoader::getNormals() const { return (_normals != nullptr ? (GLfloat*)&_normals[0] : nullptr); }
 [[maybe_unused]] inline GLfloat* CSCI441::ModelLoader::getTexCoords() const { return (_texCoords != nullptr ? (GLfloat*)&_texCoords[0] : nullptr); }
 [[maybe_unused]] inline GLuint CSCI441::ModelLoader::getNumberOfIndices() const { return _numIndices; }
 [[maybe_unused]] inline GLuint* CSCI441::ModelLoader::getIndices() const { return _indices; }
+[[maybe_unused]] inline CSCI441::IndexOptimizer::Statistics CSCI441::ModelLoader::getUnoptimizedVertexCacheStatistics() const { return _unoptimizedCacheStatistics; }
+[[maybe_unused]] inline CSCI441::IndexOptimizer::Statistics CSCI441::ModelLoader::getVertexCacheStatistics() const { return _cacheStatistics; }
 
 // Read in a WaveFront *.obj File
 inline bool CSCI441::ModelLoader::_loadOBJFile( bool INFO, bool ERRORS ) {
@@ -339,7 +470,7 @@ inline bool CSCI441::ModelLoader::_loadOBJFile( bool INFO, bool ERRORS ) {
 
 	std::ifstream in( _filename );
 	if( !in.is_open() ) {
-		if (ERRORS) fprintf( stderr, "[.obj]: [ERROR]: Could not open \"%s\"\n", _filename.c_str() );
+		if (ERRORS) CSCI441_LOG_ERROR( "[.obj]: Could not open \"%s\"", _filename.c_str() );
 		if ( INFO ) fprintf( stdout, "[.obj]: -=-=-=-=-=-=-=-  END %s Info  -=-=-=-=-=-=-=- \n", _filename.c_str() );
 		return false;
 	}
@@ -442,7 +573,7 @@ inline bool CSCI441::ModelLoader::_loadOBJFile( bool INFO, bool ERRORS ) {
 
                     currentFaceTokenStream << "/" << texCoordIndex << "/" << normalIndex;
                 } else if (groupTokens.size() != 1) {
-                    if (ERRORS) fprintf(stderr, "[.obj]: [ERROR]: Malformed OBJ file, %s.\n", _filename.c_str());
+                    if (ERRORS) CSCI441_LOG_ERROR("[.obj]: Malformed OBJ file, %s.", _filename.c_str());
                     return false;
                 }
 
@@ -617,7 +748,7 @@ inline bool CSCI441::ModelLoader::_loadOBJFile( bool INFO, bool ERRORS ) {
 
                     currentFaceTokenStream << "/" << texCoordIndex << "/" << normalIndex;
                 } else if(vertexAttributeTokens.size() != 1) {
-                    if (ERRORS) fprintf(stderr, "[.obj]: [ERROR]: Malformed OBJ file, %s.\n", _filename.c_str());
+                    if (ERRORS) CSCI441_LOG_ERROR("[.obj]: Malformed OBJ file, %s.", _filename.c_str());
                     return false;
                 }
 
@@ -641,7 +772,7 @@ inline bool CSCI441::ModelLoader::_loadOBJFile( bool INFO, bool ERRORS ) {
 						if( (vertexAttributeTokens.size() == 2 && numAttributeSlashes == 2)
                             || (vertexAttributeTokens.size() == 3) ) {
 							// should not occur if no normals
-							if (ERRORS) fprintf( stderr, "[.obj]: [ERROR]: no vertex normals were specified, should not be trying to access values\n" );
+							if (ERRORS) CSCI441_LOG_ERROR( "[.obj]: no vertex normals were specified, should not be trying to access values" );
 						}
 					}
 					uniqueNumVertices++;
@@ -729,6 +860,7 @@ inline bool CSCI441::ModelLoader::_loadOBJFile( bool INFO, bool ERRORS ) {
 	double seconds = difftime( end, start );
 
 	if (INFO) {
+		printf( "[.obj]: Vertex cache ACMR: %.3f -> %.3f  ATVR: %.3f -> %.3f\n", _unoptimizedCacheStatistics.acmr, _cacheStatistics.acmr, _unoptimizedCacheStatistics.atvr, _cacheStatistics.atvr );
 		printf( "[.obj]: Completed in %.3fs\n", seconds );
 		printf( "[.obj]: -=-=-=-=-=-=-=-  END %s Info  -=-=-=-=-=-=-=- \n\n", _filename.c_str() );
 	}
@@ -755,7 +887,7 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
 		std::string folderMtlFile = path + mtlFilename;
 		in.open( folderMtlFile.c_str() );
 		if( !in.is_open() ) {
-			if (ERRORS) fprintf( stderr, "[.mtl]: [ERROR]: could not open material file: %s\n", mtlFilename );
+			if (ERRORS) CSCI441_LOG_ERROR( "[.mtl]: could not open material file: %s", mtlFilename );
 			if ( INFO ) printf( "[.mtl]: -*-*-*-*-*-*-*-  END %s Info  -*-*-*-*-*-*-*-\n", mtlFilename );
 			return false;
 		}
@@ -764,13 +896,9 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
 	CSCI441_INTERNAL::ModelMaterial* currentMaterial = nullptr;
 	std::string materialName;
 
-	unsigned char *textureData = nullptr;
-	unsigned char *maskData = nullptr;
-	unsigned char *fullData;
 	int texWidth, texHeight, textureChannels = 1, maskChannels = 1;
 	GLuint textureHandle = 0;
-
-	std::map< std::string, GLuint > imageHandles;
+	std::string diffuseFilename;
 
 	int numMaterials = 0;
 
@@ -792,8 +920,7 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
 			_materials.insert( std::pair<std::string, CSCI441_INTERNAL::ModelMaterial*>( materialName, currentMaterial ) );
 
 			textureHandle = 0;
-			textureData = nullptr;
-			maskData = nullptr;
+			diffuseFilename.clear();
 			textureChannels = 1;
 			maskChannels = 1;
 
@@ -824,90 +951,76 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
 		} else if( tokens[0] == "illum" ) {				    // illumination type component
 			// TODO illumination type?
 		} else if( tokens[0] == "map_Kd" ) {				// diffuse color texture map
-			if( imageHandles.find( tokens[1] ) != imageHandles.end() ) {
-				// _textureHandles->insert( pair< string, GLuint >( materialName, imageHandles.find( tokens[1] )->second ) );
-				currentMaterial->map_Kd = imageHandles.find( tokens[1] )->second;
-			} else {
-                stbi_set_flip_vertically_on_load(true);
-				textureData = stbi_load( tokens[1].c_str(), &texWidth, &texHeight, &textureChannels, 0 );
-				if( !textureData ) {
-					std::string folderName = path + tokens[1];
-					textureData = stbi_load( folderName.c_str(), &texWidth, &texHeight, &textureChannels, 0 );
+			diffuseFilename = _resolveMTLTextureFilename( tokens[1], path );
+
+			textureHandle = CSCI441::AssetManager::instance().acquireTexture( { diffuseFilename }, "mtl:map_Kd", [&](size_t& bytes) {
+				CSCI441::AsyncTextureLoader* pAsyncLoader = CSCI441::AssetManager::instance().getAsyncTextureLoader();
+				if( pAsyncLoader != nullptr ) {
+					if (INFO) printf( "[.mtl]: TextureMap:\t%s\tqueued for background load\n", tokens[1].c_str() );
+					bytes = CSCI441::AsyncTextureLoader::estimateBytes( diffuseFilename.c_str() );
+					return pAsyncLoader->load2DTexture( diffuseFilename.c_str(), GL_LINEAR, GL_LINEAR, GL_REPEAT, GL_REPEAT, GL_TRUE );
 				}
 
-				if( !textureData ) {
-					if (ERRORS) fprintf( stderr, "[.mtl]: [ERROR]: File Not Found: %s\n", tokens[1].c_str() );
-				} else {
+				GLuint texHandle = 0;
+				// flipped by hand, the stb_image setting is shared with the background loader's threads
+				unsigned char *textureData = stbi_load( diffuseFilename.c_str(), &texWidth, &texHeight, &textureChannels, 0 );
+				if( textureData ) {
+					CSCI441::TextureUtils::flipImageRows( textureData, texWidth, texHeight, textureChannels );
 					if (INFO) printf( "[.mtl]: TextureMap:\t%s\tSize: %dx%d\tColors: %d\n", tokens[1].c_str(), texWidth, texHeight, textureChannels );
 
-					if( maskData == nullptr ) {
-						if( textureHandle == 0 ) {
-							glGenTextures( 1, &textureHandle );
-							imageHandles.insert( std::pair<std::string, GLuint>( tokens[1], textureHandle ) );
-						}
-
-						glBindTexture( GL_TEXTURE_2D, textureHandle );
-
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-						GLint colorSpace = GL_RGB;
-						if( textureChannels == 4 )
-							colorSpace = GL_RGBA;
-						glTexImage2D( GL_TEXTURE_2D, 0, colorSpace, texWidth, texHeight, 0, colorSpace, GL_UNSIGNED_BYTE, textureData );
-
-						currentMaterial->map_Kd = textureHandle;
-					} else {
-						fullData = CSCI441_INTERNAL::createTransparentTexture( textureData, maskData, texWidth, texHeight, textureChannels, maskChannels );
-
-						if( textureHandle == 0 ) {
-							glGenTextures( 1, &textureHandle );
-							imageHandles.insert( std::pair<std::string, GLuint>( tokens[1], textureHandle ) );
-						}
+					glGenTextures( 1, &texHandle );
+					glBindTexture( GL_TEXTURE_2D, texHandle );
 
-						glBindTexture( GL_TEXTURE_2D, textureHandle );
+					glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+					glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+					glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+					glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+					GLint colorSpace = GL_RGB;
+					if( textureChannels == 4 )
+						colorSpace = GL_RGBA;
+					glTexImage2D( GL_TEXTURE_2D, 0, colorSpace, texWidth, texHeight, 0, colorSpace, GL_UNSIGNED_BYTE, textureData );
 
-						glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, texWidth, texHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, fullData );
-
-						delete[] fullData;
-
-						currentMaterial->map_Kd = textureHandle;
-					}
+					bytes = static_cast<size_t>(texWidth) * texHeight * 4;
+					stbi_image_free( textureData );
 				}
+				return texHandle;
+			} );
+
+			if( textureHandle == 0 ) {
+				if (ERRORS) CSCI441_LOG_ERROR( "[.mtl]: File Not Found: %s", tokens[1].c_str() );
+				diffuseFilename.clear();
+			} else {
+				_textureHandles.push_back( textureHandle );
+				currentMaterial->map_Kd = textureHandle;
 			}
 		} else if( tokens[0] == "map_d" ) {				// alpha texture map
-			if( imageHandles.find( tokens[1] ) != imageHandles.end() ) {
-				// _textureHandles->insert( pair< string, GLuint >( materialName, imageHandles.find( tokens[1] )->second ) );
-				currentMaterial->map_d = imageHandles.find( tokens[1] )->second;
-			} else {
-			    stbi_set_flip_vertically_on_load(true);
-				maskData = stbi_load( tokens[1].c_str(), &texWidth, &texHeight, &textureChannels, 0 );
-				if( !textureData ) {
-					std::string folderName = path + tokens[1];
-					maskData = stbi_load( folderName.c_str(), &texWidth, &texHeight, &textureChannels, 0 );
-				}
+			const std::string maskFilename = _resolveMTLTextureFilename( tokens[1], path );
 
-				if( !maskData ) {
-					if (ERRORS) fprintf( stderr, "[.mtl]: [ERROR]: File Not Found: %s\n", tokens[1].c_str() );
-				} else {
-					if (INFO) printf( "[.mtl]: AlphaMap:  \t%s\tSize: %dx%d\tColors: %d\n", tokens[1].c_str(), texWidth, texHeight, maskChannels );
-
-					if( textureData != nullptr ) {
-						fullData = CSCI441_INTERNAL::createTransparentTexture( textureData, maskData, texWidth, texHeight, textureChannels, maskChannels );
-
-						if( textureHandle == 0 ) {
-							glGenTextures( 1, &textureHandle );
-                            imageHandles.insert( std::pair<std::string, GLuint>( tokens[1], textureHandle ) );
-                        }
+			if( diffuseFilename.empty() ) {
+				// nothing to apply the mask to
+				if (INFO) printf( "[.mtl]: AlphaMap:  \t%s\tignored, no diffuse map set\n", tokens[1].c_str() );
+			} else {
+				// the masked texture is shared by every material combining the same image and mask
+				GLuint maskedHandle = CSCI441::AssetManager::instance().acquireTexture( { diffuseFilename, maskFilename }, "mtl:map_Kd+map_d", [&](size_t& bytes) {
+					GLuint texHandle = 0;
+					unsigned char *textureData = stbi_load( diffuseFilename.c_str(), &texWidth, &texHeight, &textureChannels, 0 );
+					int maskWidth, maskHeight;
+					unsigned char *maskData = stbi_load( maskFilename.c_str(), &maskWidth, &maskHeight, &maskChannels, 0 );
+					if( textureData ) CSCI441::TextureUtils::flipImageRows( textureData, texWidth, texHeight, textureChannels );
+					if( maskData )    CSCI441::TextureUtils::flipImageRows( maskData, maskWidth, maskHeight, maskChannels );
+
+					if( textureData && maskData && (maskWidth != texWidth || maskHeight != texHeight) ) {
+						// the mask is read texel for texel alongside the diffuse image
+						if (ERRORS) CSCI441_LOG_ERROR( "[.mtl]: AlphaMap %s is %dx%d but the diffuse map is %dx%d", tokens[1].c_str(), maskWidth, maskHeight, texWidth, texHeight );
+					} else if( textureData && maskData ) {
+						if (INFO) printf( "[.mtl]: AlphaMap:  \t%s\tSize: %dx%d\tColors: %d\n", tokens[1].c_str(), maskWidth, maskHeight, maskChannels );
+
+						unsigned char *fullData = CSCI441_INTERNAL::createTransparentTexture( textureData, maskData, texWidth, texHeight, textureChannels, maskChannels );
+
+						glGenTextures( 1, &texHandle );
+						glBindTexture( GL_TEXTURE_2D, texHandle );
 
 						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 						glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -917,10 +1030,22 @@ inline bool CSCI441::ModelLoader::_loadMTLFile( const char* mtlFilename, bool IN
 
 						glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, texWidth, texHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, fullData );
 
+						bytes = static_cast<size_t>(texWidth) * texHeight * 4;
 						delete[] fullData;
-
-                        currentMaterial->map_Kd = textureHandle;
 					}
+					stbi_image_free( textureData );
+					stbi_image_free( maskData );
+					return texHandle;
+				} );
+
+				if( maskedHandle == 0 ) {
+					if (ERRORS) CSCI441_LOG_ERROR( "[.mtl]: Could not apply AlphaMap %s, keeping the opaque diffuse map", tokens[1].c_str() );
+				} else {
+					// swap the opaque diffuse map for the masked version
+					CSCI441::AssetManager::instance().releaseTexture( currentMaterial->map_Kd );
+					_textureHandles.erase( std::find( _textureHandles.begin(), _textureHandles.end(), currentMaterial->map_Kd ) );
+					_textureHandles.push_back( maskedHandle );
+					currentMaterial->map_Kd = maskedHandle;
 				}
 			}
 		} else if( tokens[0] == "map_Ka" ) {				    // ambient color texture map
@@ -961,7 +1086,7 @@ inline bool CSCI441::ModelLoader::_loadOFFFile( bool INFO, bool ERRORS ) {
 
 	std::ifstream in( _filename );
 	if( !in.is_open() ) {
-		if (ERRORS) fprintf( stderr, "[.off]: [ERROR]: Could not open \"%s\"\n", _filename.c_str() );
+		if (ERRORS) CSCI441_LOG_ERROR( "[.off]: Could not open \"%s\"", _filename.c_str() );
 		if ( INFO ) printf( "[.off]: -=-=-=-=-=-=-=-  END %s Info  -=-=-=-=-=-=-=-\n\n", _filename.c_str() );
 		return false;
 	}
@@ -990,7 +1115,7 @@ inline bool CSCI441::ModelLoader::_loadOFFFile( bool INFO, bool ERRORS ) {
 			if( tokens[0] == "OFF" ) {					// denotes OFF File type
 			} else {
 				if( tokens.size() != 3 ) {
-					if (ERRORS) fprintf( stderr, "[.off]: [ERROR]: Malformed OFF file.  # vertices, faces, edges not properly specified\n" );
+					if (ERRORS) CSCI441_LOG_ERROR( "[.off]: Malformed OFF file.  # vertices, faces, edges not properly specified" );
 					if ( INFO ) printf( "[.off]: -=-=-=-=-=-=-=-  END %s Info  -=-=-=-=-=-=-=-\n\n", _filename.c_str() );
 					in.close();
 					return false;
@@ -1208,6 +1333,7 @@ inline bool CSCI441::ModelLoader::_loadOFFFile( bool INFO, bool ERRORS ) {
 	if (INFO) {
 		printf( "\33[2K\r" );
 		printf( "[.off]: parsing %s...done!  (Time: %.1fs)\n", _filename.c_str(), seconds );
+		printf( "[.off]: Vertex cache ACMR: %.3f -> %.3f  ATVR: %.3f -> %.3f\n", _unoptimizedCacheStatistics.acmr, _cacheStatistics.acmr, _unoptimizedCacheStatistics.atvr, _cacheStatistics.atvr );
 		printf( "[.off]: -=-=-=-=-=-=-=-  END %s Info  -=-=-=-=-=-=-=-\n\n", _filename.c_str() );
 	}
 
@@ -1225,7 +1351,7 @@ inline bool CSCI441::ModelLoader::_loadPLYFile( bool INFO, bool ERRORS ) {
 
 	std::ifstream in( _filename );
 	if( !in.is_open() ) {
-		if (ERRORS) fprintf( stderr, "[.ply]: [ERROR]: Could not open \"%s\"\n", _filename.c_str() );
+		if (ERRORS) CSCI441_LOG_ERROR( "[.ply]: Could not open \"%s\"", _filename.c_str() );
 		if ( INFO ) printf( "[.ply]: -=-=-=-=-=-=-=-  END %s Info  -=-=-=-=-=-=-=-\n\n", _filename.c_str() );
 		return false;
 	}
@@ -1258,7 +1384,7 @@ inline bool CSCI441::ModelLoader::_loadPLYFile( bool INFO, bool ERRORS ) {
 			if( tokens[0] == "ply" ) {					// denotes ply File type
 			} else if( tokens[0] == "format" ) {
 				if( tokens[1] != "ascii" ) {
-					if (ERRORS) fprintf( stderr, "[.ply]: [ERROR]: File \"%s\" not ASCII format\n", _filename.c_str() );
+					if (ERRORS) CSCI441_LOG_ERROR( "[.ply]: File \"%s\" not ASCII format", _filename.c_str() );
 					if ( INFO ) printf( "[.ply]: -=-=-=-=-=-=-=-  END %s Info  -=-=-=-=-=-=-=-\n\n", _filename.c_str() );
 					in.close();
 					return false;
@@ -1381,7 +1507,7 @@ inline bool CSCI441::ModelLoader::_loadPLYFile( bool INFO, bool ERRORS ) {
 			if( tokens[0] == "ply" ) {					// denotes ply File type
 			} else if( tokens[0] == "format" ) {
 				if( tokens[1] != "ascii" ) {
-					if (ERRORS) fprintf( stderr, "[.ply]: [ERROR]: File \"%s\" not ASCII format\n", _filename.c_str() );
+					if (ERRORS) CSCI441_LOG_ERROR( "[.ply]: File \"%s\" not ASCII format", _filename.c_str() );
 					if ( INFO ) printf( "[.ply]: -=-=-=-=-=-=-=-  END %s Info  -=-=-=-=-=-=-=-\n\n", _filename.c_str() );
 					in.close();
 					return false;
@@ -1497,6 +1623,7 @@ inline bool CSCI441::ModelLoader::_loadPLYFile( bool INFO, bool ERRORS ) {
 	if (INFO) {
 		printf( "\33[2K\r" );
 		printf( "[.ply]: parsing %s...done!\n[.ply]: Time to complete: %.3fs\n", _filename.c_str(), seconds );
+		printf( "[.ply]: Vertex cache ACMR: %.3f -> %.3f  ATVR: %.3f -> %.3f\n", _unoptimizedCacheStatistics.acmr, _cacheStatistics.acmr, _unoptimizedCacheStatistics.atvr, _cacheStatistics.atvr );
 		printf( "[.ply]: -=-=-=-=-=-=-=-  END %s Info  -=-=-=-=-=-=-=-\n\n", _filename.c_str() );
 	}
 
@@ -1513,7 +1640,7 @@ inline bool CSCI441::ModelLoader::_loadSTLFile( bool INFO, bool ERRORS ) {
 
 	std::ifstream in( _filename );
 	if( !in.is_open() ) {
-		if (ERRORS) fprintf(stderr, "[.stl]: [ERROR]: Could not open \"%s\"\n", _filename.c_str() );
+		if (ERRORS) CSCI441_LOG_ERROR("[.stl]: Could not open \"%s\"", _filename.c_str() );
 		if ( INFO ) printf( "[.stl]: -=-=-=-=-=-=-=-  END %s Info  -=-=-=-=-=-=-=-\n\n", _filename.c_str() );
 		return false;
 	}
@@ -1566,7 +1693,7 @@ inline bool CSCI441::ModelLoader::_loadSTLFile( bool INFO, bool ERRORS ) {
 		}
 		else {
 			if( memchr( line.c_str(), '\0', line.length() ) != nullptr ) {
-				if (ERRORS) fprintf( stderr, "[.stl]: [ERROR]: Cannot read binary STL file \"%s\"\n", _filename.c_str() );
+				if (ERRORS) CSCI441_LOG_ERROR( "[.stl]: Cannot read binary STL file \"%s\"", _filename.c_str() );
 				if ( INFO ) printf( "[.stl]: -=-=-=-=-=-=-=-  END %s Info  -=-=-=-=-=-=-=-\n\n", _filename.c_str() );
 				in.close();
 				return false;
@@ -1673,6 +1800,7 @@ inline bool CSCI441::ModelLoader::_loadSTLFile( bool INFO, bool ERRORS ) {
 	if (INFO) {
 		printf("\33[2K\r");
 		printf("[.stl]: parsing %s...done!\n[.stl]: Time to complete: %.3fs\n", _filename.c_str(), seconds);
+		printf("[.stl]: Vertex cache ACMR: %.3f -> %.3f  ATVR: %.3f -> %.3f\n", _unoptimizedCacheStatistics.acmr, _cacheStatistics.acmr, _unoptimizedCacheStatistics.atvr, _cacheStatistics.atvr);
 		printf( "[.stl]: -=-=-=-=-=-=-=-  END %s Info  -=-=-=-=-=-=-=-\n\n", _filename.c_str() );
 	}
 
@@ -1689,6 +1817,21 @@ inline void CSCI441::ModelLoader::disableAutoGenerateNormals() {
     sAUTO_GEN_NORMALS = false;
 }
 
+[[maybe_unused]]
+inline void CSCI441::ModelLoader::enablePositionQuantization() {
+    sQUANTIZE_POSITIONS = true;
+}
+
+[[maybe_unused]]
+inline void CSCI441::ModelLoader::disablePositionQuantization() {
+    sQUANTIZE_POSITIONS = false;
+}
+
+[[maybe_unused]]
+inline const glm::mat4& CSCI441::ModelLoader::getPositionDequantizationMatrix() const {
+    return _vertexFormat.getDequantizationMatrix();
+}
+
 inline void CSCI441::ModelLoader::_allocateAttributeArrays(const GLuint numVertices, const GLuint numIndices) {
     _vertices  = new glm::vec3[numVertices];
     _normals   = new glm::vec3[numVertices];
@@ -1696,14 +1839,37 @@ inline void CSCI441::ModelLoader::_allocateAttributeArrays(const GLuint numVerti
     _indices   = new GLuint[numIndices];
 }
 
+inline void CSCI441::ModelLoader::_optimizeIndices() {
+    _unoptimizedCacheStatistics = CSCI441::IndexOptimizer::analyzeVertexCache( _indices, _numIndices, _uniqueIndex );
+
+    // reorder triangles within each material range so draw() can still issue one call per range
+    if( _modelType == CSCI441_INTERNAL::MODEL_TYPE::OBJ ) {
+        for( const auto& materialIter : _materialIndexStartStop ) {
+            for( const auto& idxIter : materialIter.second ) {
+                if( idxIter.second < idxIter.first || idxIter.second >= _numIndices ) continue;
+                CSCI441::IndexOptimizer::optimizeVertexCache( _indices + idxIter.first, idxIter.second - idxIter.first + 1, _uniqueIndex );
+            }
+        }
+    } else {
+        CSCI441::IndexOptimizer::optimizeVertexCache( _indices, _numIndices, _uniqueIndex );
+    }
+
+    const auto remap = CSCI441::IndexOptimizer::optimizeVertexFetch( _indices, _numIndices, _uniqueIndex );
+    CSCI441::IndexOptimizer::remapVertices( _vertices, remap );
+    CSCI441::IndexOptimizer::remapVertices( _normals, remap );
+    CSCI441::IndexOptimizer::remapVertices( _texCoords, remap );
+
+    _cacheStatistics = CSCI441::IndexOptimizer::analyzeVertexCache( _indices, _numIndices, _uniqueIndex );
+}
+
 inline void CSCI441::ModelLoader::_bufferData() {
+    _optimizeIndices();
+
     glBindVertexArray( _vaod );
 
     glBindBuffer( GL_ARRAY_BUFFER, _vbods[0] );
-    glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>((sizeof(glm::vec3)*2 + sizeof(glm::vec2)) * _uniqueIndex), nullptr, GL_STATIC_DRAW );
-    glBufferSubData( GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(sizeof(glm::vec3) * _uniqueIndex), _vertices );
-    glBufferSubData( GL_ARRAY_BUFFER, static_cast<GLintptr>(sizeof(glm::vec3) * _uniqueIndex), static_cast<GLsizeiptr>(sizeof(glm::vec3) * _uniqueIndex), _normals );
-    glBufferSubData( GL_ARRAY_BUFFER, static_cast<GLintptr>(sizeof(glm::vec3) * _uniqueIndex * 2), static_cast<GLsizeiptr>(sizeof(glm::vec2) * _uniqueIndex), _texCoords );
+    _vertexFormat = CSCI441::VertexFormat( sQUANTIZE_POSITIONS ? CSCI441::VertexFormat::SHORT_POSITIONS : CSCI441::VertexFormat::FLOAT_POSITIONS );
+    _vertexFormat.bufferData( _vertices, _normals, _texCoords, _uniqueIndex );
 
     glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _vbods[1] );
     glBufferData( GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(GLuint) * _numIndices), _indices, GL_STATIC_DRAW );
@@ -1715,6 +1881,13 @@ inline void CSCI441::ModelLoader::_bufferData() {
 //      This is a helper function to break a single string into std::vector
 //  of strings, based on a given set of delimiter characters.
 //
+inline std::string CSCI441::ModelLoader::_resolveMTLTextureFilename( const std::string& filename, const std::string& path ) {
+	// texture maps are listed relative to either the working directory or the model's folder
+	std::error_code errorCode;
+	if( std::filesystem::exists( filename, errorCode ) ) return filename;
+	return path + filename;
+}
+
 inline std::vector<std::string> CSCI441::ModelLoader::_tokenizeString(std::string input, const std::string& delimiters) {
 	if(input.empty())
 		return {};
@@ -12,6 +12,7 @@
 #ifndef CSCI441_OPENGL_ENGINE_HPP
 #define CSCI441_OPENGL_ENGINE_HPP
 
+#include "Logger.hpp"
 #include "OpenGLUtils.hpp"
 
 #ifdef CSCI441_USE_GLEW
@@ -23,6 +24,7 @@
 #include <GLFW/glfw3.h>
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <set>
 #include <string>
@@ -112,6 +114,19 @@ namespace CSCI441 {
          */
         [[maybe_unused]] [[nodiscard]] virtual GLFWwindow* getWindow() const noexcept final { return mpWindow; }
 
+        /**
+         * @brief Request a hidden window so the engine can render offscreen
+         * @param HEADLESS true to hide the window and disable vsync
+         * @note must be called before initialize().  On Linux without DISPLAY or WAYLAND_DISPLAY,
+         * GLFW 3.4+ uses its null platform and an OSMesa context (for example Mesa llvmpipe).
+         * Rendering should target a framebuffer object since the default framebuffer is never shown.
+         */
+        [[maybe_unused]] virtual void setHeadless(const bool HEADLESS) noexcept final { mHeadless = HEADLESS; }
+        /**
+         * @brief Returns if the window is hidden for offscreen rendering
+         */
+        [[maybe_unused]] [[nodiscard]] virtual bool isHeadless() const noexcept final { return mHeadless; }
+
         /**
          * @brief Tell our engine's window to close
          */
@@ -217,6 +232,11 @@ namespace CSCI441 {
          * @note by default false
          */
         bool mWindowResizable;
+        /**
+         * @brief if the GLFW window is hidden for offscreen rendering
+         * @note by default false
+         */
+        bool mHeadless;
         /**
          * @brief the title of the GLFW window
          */
@@ -232,7 +252,7 @@ namespace CSCI441 {
          *	this function.  We can then print this info to the terminal to
          *	alert the user.
          */
-        static void mErrorCallback(int error, const char* DESCRIPTION) { fprintf(stderr, "[ERROR]: %d\n\t%s\n", error, DESCRIPTION ); }
+        static void mErrorCallback(int error, const char* DESCRIPTION) { CSCI441_LOG_ERROR("%d\n\t%s", error, DESCRIPTION ); }
 
         /**
          * callback called when GLFW pWindow is resized.  internally updated mWindowWidth and
@@ -253,9 +273,10 @@ namespace CSCI441 {
          *  - requests Core Profile<br>
          *  - requests double buffering<br>
          *  - marks window as resizable or not based on constructor creation<br>
+         *  - hides the window if headless<br>
          *  - creates a window<br>
          *  - makes the window the current context<br>
-         *  - sets the swap interval to 1
+         *  - sets the swap interval to 1, or 0 if headless
          * @note This method should be overridden if any additional callbacks need to be registered.
          * When registering additional callbacks, the parent implementation must be called first and
          * then the additional callbacks may be registered as desired.
@@ -341,9 +362,9 @@ namespace CSCI441 {
 }
 
 inline CSCI441::OpenGLEngine::OpenGLEngine(const int OPENGL_MAJOR_VERSION, const int OPENGL_MINOR_VERSION, const int WINDOW_WIDTH, const int WINDOW_HEIGHT, const char* WINDOW_TITLE, const bool WINDOW_RESIZABLE)
-        : mOpenGLMajorVersion(OPENGL_MAJOR_VERSION), mOpenGLMinorVersion(OPENGL_MINOR_VERSION), mWindowWidth(WINDOW_WIDTH), mWindowHeight(WINDOW_HEIGHT), mWindowResizable(WINDOW_RESIZABLE) {
+        : mOpenGLMajorVersion(OPENGL_MAJOR_VERSION), mOpenGLMinorVersion(OPENGL_MINOR_VERSION), mWindowWidth(WINDOW_WIDTH), mWindowHeight(WINDOW_HEIGHT), mWindowResizable(WINDOW_RESIZABLE), mHeadless(false) {
 
-    mWindowTitle = (char*)malloc(sizeof(char) * strlen(WINDOW_TITLE));
+    mWindowTitle = (char*)malloc(sizeof(char) * (strlen(WINDOW_TITLE) + 1));
     strcpy(mWindowTitle, WINDOW_TITLE);
 
     mpWindow = nullptr;
@@ -384,9 +405,18 @@ inline void CSCI441::OpenGLEngine::mSetupGLFW()  {
     // all other GLFW calls must be performed after GLFW has been initialized
     glfwSetErrorCallback(mErrorCallback);
 
+    // with no display to connect to, a headless engine renders through OSMesa on GLFW's null platform
+    bool useOSMesa = false;
+#if defined(__linux__) && (GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4))
+    if( mHeadless && getenv("DISPLAY") == nullptr && getenv("WAYLAND_DISPLAY") == nullptr ) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        useOSMesa = true;
+    }
+#endif
+
     // initialize GLFW
     if( !glfwInit() ) {
-        fprintf( stderr, "[ERROR]: Could not initialize GLFW\n" );
+        CSCI441_LOG_ERROR( "Could not initialize GLFW" );
         mErrorCode = OPENGL_ENGINE_ERROR_GLFW_INIT;
     } else {
         if(DEBUG) fprintf( stdout, "[INFO]: GLFW %d.%d.%d initialized\n", GLFW_VERSION_MAJOR, GLFW_VERSION_MINOR, GLFW_VERSION_REVISION );
@@ -397,17 +427,22 @@ inline void CSCI441::OpenGLEngine::mSetupGLFW()  {
         glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE );             // request OpenGL Core Profile context
         glfwWindowHint( GLFW_DOUBLEBUFFER, GLFW_TRUE );                              // request double buffering
         glfwWindowHint(GLFW_RESIZABLE, mWindowResizable );		                    // set if our window should be able to be resized
+        glfwWindowHint(GLFW_VISIBLE, mHeadless ? GLFW_FALSE : GLFW_TRUE );          // headless windows are never shown
+        if( useOSMesa ) {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API );    // software context without a display
+            if(DEBUG) fprintf( stdout, "[INFO]: No display found, using OSMesa on the GLFW null platform\n" );
+        }
 
         // create a window for a given size, with a given title
         mpWindow = glfwCreateWindow(mWindowWidth, mWindowHeight, mWindowTitle, nullptr, nullptr );
         if( !mpWindow ) {						                                                // if the window could not be created, NULL is returned
-            fprintf( stderr, "[ERROR]: GLFW Window could not be created\n" );
+            CSCI441_LOG_ERROR( "GLFW Window could not be created" );
             glfwTerminate();
             mErrorCode = OPENGL_ENGINE_ERROR_GLFW_WINDOW;
         } else {
             if(DEBUG) fprintf( stdout, "[INFO]: GLFW Window created\n" );
             glfwMakeContextCurrent(mpWindow);		                                    // make the created window the current window
-            glfwSwapInterval(1);				                                        // update our screen after at least 1 screen refresh
+            glfwSwapInterval(mHeadless ? 0 : 1);                                        // update our screen after at least 1 screen refresh, never wait when headless
             glfwSetInputMode(mpWindow, GLFW_LOCK_KEY_MODS, GLFW_TRUE);      // track state of Caps Lock and Num Lock keys
             glfwSetWindowUserPointer(mpWindow, (void*)this);
             glfwSetWindowSizeCallback(mpWindow, mWindowResizeCallback);
@@ -423,8 +458,8 @@ inline void CSCI441::OpenGLEngine::_setupGLFunctions() {
 
     // check for an error
     if( glewResult != GLEW_OK ) {
-        fprintf( stderr, "[ERROR]: Error initializing GLEW\n");
-        fprintf( stderr, "[ERROR]: %s\n", glewGetErrorString(glewResult) );
+        CSCI441_LOG_ERROR( "Error initializing GLEW");
+        CSCI441_LOG_ERROR( "%s", glewGetErrorString(glewResult) );
         mErrorCode = OPENGL_ENGINE_ERROR_GLEW_INIT;
     } else {
         if(DEBUG) {
@@ -435,7 +470,7 @@ inline void CSCI441::OpenGLEngine::_setupGLFunctions() {
 #else
     int version = gladLoadGL(glfwGetProcAddress);
     if(version == 0) {
-        fprintf(stderr, "Failed to initialize GLAD\n" );
+        CSCI441_LOG_ERROR("Failed to initialize GLAD" );
         mErrorCode = OPENGL_ENGINE_ERROR_GLAD_INIT;
     } else {
         if(DEBUG) {
@@ -0,0 +1,490 @@
+/** @file PerformanceOverlay.hpp
+ * @brief On screen frame-time graph, percentiles and engine counters
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Draws a panel with a graph of the last NUM_FRAMES frame times, split into
+ *	simulation, render and remaining time, followed by frame-time percentiles
+ *	and named counters.  Text uses a built in 5x7 glyph atlas covering ASCII 32
+ *	to 95, lower case letters are drawn in upper case.
+ *
+ *	The whole panel is one indexed draw from one buffer upload, built in the calling
+ *	thread's FrameArena, which must be reset once per frame.  The text is only
+ *	rebuilt every REFRESH_INTERVAL_MS of frame time so it stays readable; the graph
+ *	is rebuilt every frame.
+ *
+ *	The overlay does not own a shader.  Before draw(), bind a program that
+ *	multiplies the vertex color by the texture bound to the active texture unit and
+ *	that transforms pixel coordinates, with the origin at the lower left.  Enable
+ *	alpha blending for the translucent background.
+ *
+ *	@warning This header file depends upon glm
+ */
+
+#ifndef CSCI441_PERFORMANCE_OVERLAY_HPP
+#define CSCI441_PERFORMANCE_OVERLAY_HPP
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include "FrameArena.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class PerformanceOverlay
+     * @brief draws frame times and counters over the scene
+     */
+    class [[maybe_unused]] PerformanceOverlay final {
+    public:
+        /**
+         * @brief number of frames shown in the graph and used for percentiles
+         */
+        static constexpr GLuint NUM_FRAMES = 240;
+        /**
+         * @brief frame time at the top of the graph, longer frames are clipped
+         */
+        static constexpr GLfloat GRAPH_MAX_MS = 33.3f;
+        /**
+         * @brief frame time between text updates
+         */
+        static constexpr GLfloat REFRESH_INTERVAL_MS = 250.0f;
+        /**
+         * @brief quads the vertex buffer holds, anything past it is not drawn
+         */
+        static constexpr GLuint MAX_QUADS = 2048;
+
+        /**
+         * @brief creates an overlay with no frames or counters
+         */
+        PerformanceOverlay();
+        /**
+         * @brief deletes the atlas, buffers and VAO
+         */
+        ~PerformanceOverlay();
+
+        /**
+         * @brief do not allow overlays to be copied
+         */
+        PerformanceOverlay(const PerformanceOverlay&) = delete;
+        /**
+         * @brief do not allow overlays to be copied
+         */
+        PerformanceOverlay& operator=(const PerformanceOverlay&) = delete;
+
+        /**
+         * @brief creates the glyph atlas, vertex buffer and VAO
+         * @param positionLocation location of the vec2 pixel position attribute
+         * @param texCoordLocation location of the vec2 texture coordinate attribute
+         * @param colorLocation location of the vec4 color attribute
+         * @note negative locations are skipped
+         */
+        [[maybe_unused]] void setup( GLint positionLocation, GLint texCoordLocation, GLint colorLocation );
+
+        /**
+         * @brief records one frame
+         * @param frameTimeMs total frame time in milliseconds
+         * @param simulationTimeMs time spent updating the simulation
+         * @param renderTimeMs time spent issuing rendering commands
+         */
+        [[maybe_unused]] void addFrame( GLfloat frameTimeMs, GLfloat simulationTimeMs, GLfloat renderTimeMs );
+        /**
+         * @brief sets the value shown for a counter, adding the counter the first time
+         * @param label counter label, must outlive the overlay
+         * @param value value to show
+         * @note counters are listed in the order they were first set
+         */
+        [[maybe_unused]] void setCounter( const char* label, GLuint64 value );
+
+        /**
+         * @brief draws the panel
+         * @param left pixel position of the left edge of the panel
+         * @param top pixel position of the top edge of the panel
+         * @param scale pixels per glyph atlas texel
+         */
+        [[maybe_unused]] void draw( GLfloat left, GLfloat top, GLfloat scale = 2.0f );
+
+        /**
+         * @brief returns the CPU time the last draw() took in milliseconds
+         */
+        [[maybe_unused]] [[nodiscard]] GLfloat getDrawTimeMs() const { return _drawTimeMs; }
+
+    private:
+        struct Vertex {
+            GLfloat x, y;
+            GLfloat s, t;
+            GLubyte r, g, b, a;
+        };
+        struct Frame {
+            GLfloat frameTimeMs;
+            GLfloat simulationTimeMs;
+            GLfloat renderTimeMs;
+        };
+        struct Counter {
+            const char* label;
+            GLuint64 value;
+        };
+
+        // glyph cells are 6x8 texels: a 5x7 glyph plus one texel of spacing
+        static constexpr GLint CELL_WIDTH = 6, CELL_HEIGHT = 8;
+        static constexpr GLint ATLAS_COLUMNS = 16, ATLAS_ROWS = 5;
+        static constexpr GLint FIRST_GLYPH = 32, NUM_GLYPHS = 64;
+        // cell after the glyphs is solid, for bars and the background
+        static constexpr GLint SOLID_CELL = NUM_GLYPHS;
+        static constexpr GLuint MAX_TEXT = 1024;
+
+        GLuint _atlasTexture;
+        GLuint _vao;
+        GLuint _vbo;
+        GLuint _ibo;
+
+        std::array<Frame, NUM_FRAMES> _frames;
+        GLuint _numFrames;
+        GLuint _nextFrame;
+        std::vector<Counter> _counters;
+
+        char _text[MAX_TEXT];
+        GLfloat _timeSinceRefreshMs;
+        GLfloat _drawTimeMs;
+
+        void _refreshText();
+        static void _addQuad( FrameVector<Vertex>& vertices, GLfloat x0, GLfloat y0, GLfloat x1, GLfloat y1, GLint cell, const glm::u8vec4& color );
+        void _addText( FrameVector<Vertex>& vertices, GLfloat left, GLfloat top, GLfloat scale ) const;
+        [[nodiscard]] GLfloat _percentile( GLfloat percentile ) const;
+    };
+}
+
+//**********************************************************************************
+
+namespace CSCI441_INTERNAL::PerformanceOverlayFont {
+    // one byte per glyph row from top to bottom, bit 4 is the leftmost column
+    inline constexpr GLubyte GLYPHS[64][7] = {
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // space
+        { 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04 }, // !
+        { 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00 }, // "
+        { 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A }, // #
+        { 0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04 }, // $
+        { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 }, // %
+        { 0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D }, // &
+        { 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 }, // '
+        { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 }, // (
+        { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 }, // )
+        { 0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00 }, // *
+        { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 }, // +
+        { 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 }, // ,
+        { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 }, // -
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C }, // .
+        { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 }, // /
+        { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, // 0
+        { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E }, // 1
+        { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, // 2
+        { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E }, // 3
+        { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, // 4
+        { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E }, // 5
+        { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, // 6
+        { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, // 7
+        { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, // 8
+        { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }, // 9
+        { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 }, // :
+        { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08 }, // ;
+        { 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 }, // <
+        { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 }, // =
+        { 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 }, // >
+        { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 }, // ?
+        { 0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E }, // @
+        { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, // A
+        { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E }, // B
+        { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E }, // C
+        { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C }, // D
+        { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F }, // E
+        { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 }, // F
+        { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F }, // G
+        { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, // H
+        { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E }, // I
+        { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C }, // J
+        { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, // K
+        { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F }, // L
+        { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 }, // M
+        { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, // N
+        { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // O
+        { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 }, // P
+        { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D }, // Q
+        { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 }, // R
+        { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E }, // S
+        { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, // T
+        { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // U
+        { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 }, // V
+        { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A }, // W
+        { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 }, // X
+        { 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04 }, // Y
+        { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F }, // Z
+        { 0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E }, // [
+        { 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00 }, // backslash
+        { 0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E }, // ]
+        { 0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00 }, // ^
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F }, // _
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+inline CSCI441::PerformanceOverlay::PerformanceOverlay()
+    : _atlasTexture(0), _vao(0), _vbo(0), _ibo(0),
+      _frames(), _numFrames(0), _nextFrame(0),
+      _text(), _timeSinceRefreshMs(REFRESH_INTERVAL_MS), _drawTimeMs(0.0f) {
+}
+
+inline CSCI441::PerformanceOverlay::~PerformanceOverlay() {
+    glDeleteTextures( 1, &_atlasTexture );
+    glDeleteBuffers( 1, &_vbo );
+    glDeleteBuffers( 1, &_ibo );
+    glDeleteVertexArrays( 1, &_vao );
+}
+
+[[maybe_unused]]
+inline void CSCI441::PerformanceOverlay::setup( const GLint positionLocation, const GLint texCoordLocation, const GLint colorLocation ) {
+    // white texels, the glyph is in the alpha channel
+    constexpr GLint ATLAS_WIDTH = ATLAS_COLUMNS * CELL_WIDTH, ATLAS_HEIGHT = ATLAS_ROWS * CELL_HEIGHT;
+    std::vector<GLubyte> atlas( ATLAS_WIDTH * ATLAS_HEIGHT * 4, 255 );
+    for( GLint cell = 0; cell < ATLAS_COLUMNS * ATLAS_ROWS; cell++ ) {
+        for( GLint y = 0; y < CELL_HEIGHT; y++ ) {
+            for( GLint x = 0; x < CELL_WIDTH; x++ ) {
+                bool set = cell == SOLID_CELL;
+                if( cell < NUM_GLYPHS && x < 5 && y < 7 ) {
+                    set = (CSCI441_INTERNAL::PerformanceOverlayFont::GLYPHS[cell][y] >> (4 - x)) & 1;
+                }
+                // the atlas is stored bottom row first
+                const GLint texelX = (cell % ATLAS_COLUMNS) * CELL_WIDTH + x;
+                const GLint texelY = ATLAS_HEIGHT - 1 - ((cell / ATLAS_COLUMNS) * CELL_HEIGHT + y);
+                atlas[(texelY * ATLAS_WIDTH + texelX) * 4 + 3] = set ? 255 : 0;
+            }
+        }
+    }
+
+    glGenTextures( 1, &_atlasTexture );
+    glBindTexture( GL_TEXTURE_2D, _atlasTexture );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, atlas.data() );
+
+    // every quad uses the same two triangles
+    std::vector<GLushort> indices( MAX_QUADS * 6 );
+    for( GLuint quad = 0; quad < MAX_QUADS; quad++ ) {
+        const auto first = static_cast<GLushort>( quad * 4 );
+        const GLushort QUAD[6] = { first, static_cast<GLushort>(first + 1), static_cast<GLushort>(first + 2),
+                                   first, static_cast<GLushort>(first + 2), static_cast<GLushort>(first + 3) };
+        std::copy( QUAD, QUAD + 6, indices.begin() + quad * 6 );
+    }
+
+    glGenVertexArrays( 1, &_vao );
+    glBindVertexArray( _vao );
+
+    glGenBuffers( 1, &_vbo );
+    glBindBuffer( GL_ARRAY_BUFFER, _vbo );
+    glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(Vertex) * MAX_QUADS * 4), nullptr, GL_STREAM_DRAW );
+
+    glGenBuffers( 1, &_ibo );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _ibo );
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(GLushort) * indices.size()), indices.data(), GL_STATIC_DRAW );
+
+    if( positionLocation >= 0 ) {
+        glEnableVertexAttribArray( positionLocation );
+        glVertexAttribPointer( positionLocation, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, x)) );
+    }
+    if( texCoordLocation >= 0 ) {
+        glEnableVertexAttribArray( texCoordLocation );
+        glVertexAttribPointer( texCoordLocation, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, s)) );
+    }
+    if( colorLocation >= 0 ) {
+        glEnableVertexAttribArray( colorLocation );
+        glVertexAttribPointer( colorLocation, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, r)) );
+    }
+
+    glBindVertexArray( 0 );
+}
+
+[[maybe_unused]]
+inline void CSCI441::PerformanceOverlay::addFrame( const GLfloat frameTimeMs, const GLfloat simulationTimeMs, const GLfloat renderTimeMs ) {
+    _frames[_nextFrame] = { frameTimeMs, simulationTimeMs, renderTimeMs };
+    _nextFrame = (_nextFrame + 1) % NUM_FRAMES;
+    _numFrames = std::min( _numFrames + 1, NUM_FRAMES );
+    _timeSinceRefreshMs += frameTimeMs;
+}
+
+[[maybe_unused]]
+inline void CSCI441::PerformanceOverlay::setCounter( const char* label, const GLuint64 value ) {
+    for( auto& counter : _counters ) {
+        if( counter.label == label || strcmp( counter.label, label ) == 0 ) {
+            counter.value = value;
+            return;
+        }
+    }
+    _counters.push_back( { label, value } );
+}
+
+[[maybe_unused]]
+inline void CSCI441::PerformanceOverlay::draw( const GLfloat left, const GLfloat top, const GLfloat scale ) {
+    const auto drawStart = std::chrono::steady_clock::now();
+
+    if( _timeSinceRefreshMs >= REFRESH_INTERVAL_MS ) {
+        _refreshText();
+        _timeSinceRefreshMs = 0.0f;
+    }
+
+    // measure the text to size the background
+    GLint numLines = 1, lineLength = 0, longestLine = 0;
+    for( const char* c = _text; *c != '\0'; c++ ) {
+        if( *c == '\n' ) { numLines++; lineLength = 0; }
+        else longestLine = std::max( longestLine, ++lineLength );
+    }
+
+    const GLfloat PADDING = 4.0f * scale;
+    const GLfloat LINE_HEIGHT = static_cast<GLfloat>(CELL_HEIGHT) * scale;
+    const GLfloat GRAPH_WIDTH = static_cast<GLfloat>(NUM_FRAMES) * scale * 0.5f;
+    const GLfloat GRAPH_HEIGHT = 40.0f * scale;
+    const GLfloat WIDTH = std::max( GRAPH_WIDTH, static_cast<GLfloat>(longestLine * CELL_WIDTH) * scale ) + 2.0f * PADDING;
+    const GLfloat HEIGHT = GRAPH_HEIGHT + static_cast<GLfloat>(numLines) * LINE_HEIGHT + 3.0f * PADDING;
+
+    // the panel's quads only live until the upload below
+    FrameVector<Vertex> vertices( FrameArena::forThisThread() );
+    vertices.reserve( MAX_QUADS * 4 );
+    _addQuad( vertices, left, top - HEIGHT, left + WIDTH, top, SOLID_CELL, glm::u8vec4(0, 0, 0, 160) );
+
+    // graph, oldest frame on the left: simulation, render, then the rest of the frame
+    const GLfloat graphLeft = left + PADDING;
+    const GLfloat graphBottom = top - PADDING - GRAPH_HEIGHT;
+    const GLfloat msToPixels = GRAPH_HEIGHT / GRAPH_MAX_MS;
+    const GLfloat barWidth = GRAPH_WIDTH / static_cast<GLfloat>(NUM_FRAMES);
+    for( GLuint i = 0; i < _numFrames; i++ ) {
+        const Frame& frame = _frames[(_nextFrame + NUM_FRAMES - _numFrames + i) % NUM_FRAMES];
+        const GLfloat x0 = graphLeft + static_cast<GLfloat>(NUM_FRAMES - _numFrames + i) * barWidth;
+        const GLfloat x1 = x0 + barWidth;
+        const GLfloat simulationTop = graphBottom + std::min( frame.simulationTimeMs, GRAPH_MAX_MS ) * msToPixels;
+        const GLfloat renderTop = std::min( simulationTop + frame.renderTimeMs * msToPixels, graphBottom + GRAPH_HEIGHT );
+        const GLfloat frameTop = std::max( renderTop, graphBottom + std::min( frame.frameTimeMs, GRAPH_MAX_MS ) * msToPixels );
+        const glm::u8vec4 restColor = frame.frameTimeMs > GRAPH_MAX_MS ? glm::u8vec4(230, 60, 60, 255) : glm::u8vec4(150, 150, 150, 255);
+
+        if( simulationTop > graphBottom ) _addQuad( vertices, x0, graphBottom, x1, simulationTop, SOLID_CELL, glm::u8vec4(80, 200, 80, 255) );
+        if( renderTop > simulationTop )   _addQuad( vertices, x0, simulationTop, x1, renderTop, SOLID_CELL, glm::u8vec4(80, 140, 240, 255) );
+        if( frameTop > renderTop )        _addQuad( vertices, x0, renderTop, x1, frameTop, SOLID_CELL, restColor );
+    }
+    // 60 and 30 frames per second
+    for( const GLfloat targetMs : { 1000.0f / 60.0f, GRAPH_MAX_MS } ) {
+        const GLfloat y = graphBottom + targetMs * msToPixels;
+        _addQuad( vertices, graphLeft, y - 0.5f, graphLeft + GRAPH_WIDTH, y + 0.5f, SOLID_CELL, glm::u8vec4(240, 220, 60, 200) );
+    }
+
+    _addText( vertices, left + PADDING, graphBottom - PADDING, scale );
+
+    glBindTexture( GL_TEXTURE_2D, _atlasTexture );
+    glBindVertexArray( _vao );
+    glBindBuffer( GL_ARRAY_BUFFER, _vbo );
+    glBufferSubData( GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(sizeof(Vertex) * vertices.size()), vertices.data() );
+    glDrawElements( GL_TRIANGLES, static_cast<GLsizei>(vertices.size() / 4 * 6), GL_UNSIGNED_SHORT, nullptr );
+    glBindVertexArray( 0 );
+
+    _drawTimeMs = std::chrono::duration<GLfloat, std::milli>( std::chrono::steady_clock::now() - drawStart ).count();
+}
+
+//**********************************************************************************
+// Internal implementations
+
+inline void CSCI441::PerformanceOverlay::_refreshText() {
+    const GLuint refreshFrames = std::max( 1u, std::min( _numFrames, 15u ) );
+    GLfloat frameTimeMs = 0.0f, simulationTimeMs = 0.0f, renderTimeMs = 0.0f;
+    for( GLuint i = 1; i <= refreshFrames; i++ ) {
+        const Frame& frame = _frames[(_nextFrame + NUM_FRAMES - i) % NUM_FRAMES];
+        frameTimeMs += frame.frameTimeMs;
+        simulationTimeMs += frame.simulationTimeMs;
+        renderTimeMs += frame.renderTimeMs;
+    }
+    frameTimeMs /= static_cast<GLfloat>(refreshFrames);
+    simulationTimeMs /= static_cast<GLfloat>(refreshFrames);
+    renderTimeMs /= static_cast<GLfloat>(refreshFrames);
+
+    int length = snprintf( _text, MAX_TEXT,
+                           "FRAME %6.2f MS %5.0f FPS\n"
+                           "P50 %.1f P95 %.1f P99 %.1f MAX %.1f\n"
+                           "SIM %5.2f MS  RENDER %5.2f MS\n"
+                           "OVERLAY %4.2f MS",
+                           frameTimeMs, frameTimeMs > 0.0f ? 1000.0f / frameTimeMs : 0.0f,
+                           _percentile(50.0f), _percentile(95.0f), _percentile(99.0f), _percentile(100.0f),
+                           simulationTimeMs, renderTimeMs, _drawTimeMs );
+    for( const auto& counter : _counters ) {
+        if( length < 0 || static_cast<GLuint>(length) >= MAX_TEXT ) break;
+        length += snprintf( _text + length, MAX_TEXT - length, "\n%-18s %8llu", counter.label, static_cast<unsigned long long>(counter.value) );
+    }
+}
+
+inline void CSCI441::PerformanceOverlay::_addQuad( FrameVector<Vertex>& vertices, const GLfloat x0, const GLfloat y0, const GLfloat x1, const GLfloat y1,
+                                                   const GLint cell, const glm::u8vec4& color ) {
+    if( vertices.size() >= MAX_QUADS * 4 ) return;
+
+    constexpr GLfloat TEXEL_WIDTH = 1.0f / static_cast<GLfloat>(ATLAS_COLUMNS * CELL_WIDTH);
+    constexpr GLfloat TEXEL_HEIGHT = 1.0f / static_cast<GLfloat>(ATLAS_ROWS * CELL_HEIGHT);
+    GLfloat s0, t0, s1, t1;
+    if( cell == SOLID_CELL ) {
+        // a single texel in the middle of the solid cell
+        s0 = s1 = (static_cast<GLfloat>((cell % ATLAS_COLUMNS) * CELL_WIDTH) + 3.0f) * TEXEL_WIDTH;
+        t0 = t1 = 1.0f - (static_cast<GLfloat>((cell / ATLAS_COLUMNS) * CELL_HEIGHT) + 4.0f) * TEXEL_HEIGHT;
+    } else {
+        s0 = static_cast<GLfloat>((cell % ATLAS_COLUMNS) * CELL_WIDTH) * TEXEL_WIDTH;
+        s1 = s0 + static_cast<GLfloat>(CELL_WIDTH) * TEXEL_WIDTH;
+        t1 = 1.0f - static_cast<GLfloat>((cell / ATLAS_COLUMNS) * CELL_HEIGHT) * TEXEL_HEIGHT;
+        t0 = t1 - static_cast<GLfloat>(CELL_HEIGHT) * TEXEL_HEIGHT;
+    }
+
+    vertices.push_back( { x0, y0, s0, t0, color.r, color.g, color.b, color.a } );
+    vertices.push_back( { x1, y0, s1, t0, color.r, color.g, color.b, color.a } );
+    vertices.push_back( { x1, y1, s1, t1, color.r, color.g, color.b, color.a } );
+    vertices.push_back( { x0, y1, s0, t1, color.r, color.g, color.b, color.a } );
+}
+
+inline void CSCI441::PerformanceOverlay::_addText( FrameVector<Vertex>& vertices, const GLfloat left, const GLfloat top, const GLfloat scale ) const {
+    const GLfloat GLYPH_WIDTH = static_cast<GLfloat>(CELL_WIDTH) * scale;
+    const GLfloat GLYPH_HEIGHT = static_cast<GLfloat>(CELL_HEIGHT) * scale;
+    GLfloat x = left, y = top;
+    for( const char* c = _text; *c != '\0'; c++ ) {
+        if( *c == '\n' ) {
+            x = left;
+            y -= GLYPH_HEIGHT;
+            continue;
+        }
+        GLint glyph = (*c >= 'a' && *c <= 'z') ? *c - 'a' + 'A' : *c;
+        if( glyph < FIRST_GLYPH || glyph >= FIRST_GLYPH + NUM_GLYPHS ) glyph = '?';
+        if( glyph != ' ' ) _addQuad( vertices, x, y - GLYPH_HEIGHT, x + GLYPH_WIDTH, y, glyph - FIRST_GLYPH, glm::u8vec4(255, 255, 255, 255) );
+        x += GLYPH_WIDTH;
+    }
+}
+
+inline GLfloat CSCI441::PerformanceOverlay::_percentile( const GLfloat percentile ) const {
+    if( _numFrames == 0 ) return 0.0f;
+
+    // nearest rank on a copy, the history is small enough to not need anything smarter
+    std::array<GLfloat, NUM_FRAMES> frameTimes;
+    for( GLuint i = 0; i < _numFrames; i++ ) frameTimes[i] = _frames[(_nextFrame + NUM_FRAMES - _numFrames + i) % NUM_FRAMES].frameTimeMs;
+    const auto rank = static_cast<GLuint>( std::clamp( percentile, 0.0f, 100.0f ) / 100.0f * static_cast<GLfloat>(_numFrames - 1) + 0.5f );
+    std::nth_element( frameTimes.begin(), frameTimes.begin() + rank, frameTimes.begin() + _numFrames );
+    return frameTimes[rank];
+}
+
+#endif // CSCI441_PERFORMANCE_OVERLAY_HPP
@@ -0,0 +1,484 @@
+/** @file Profiler.hpp
+ * @brief Scoped CPU and GPU zone profiler with Chrome trace export
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Instrument code with the macros below.  They expand to nothing unless
+ *	CSCI441_ENABLE_PROFILER is defined, so instrumentation can stay in release code.
+ *
+ *		CSCI441_PROFILE_ZONE("name")          times the enclosing scope on the CPU
+ *		CSCI441_PROFILE_GPU_ZONE("name")      times the enclosing scope on the CPU and the GPU
+ *		CSCI441_PROFILE_FRAME()               marks the start of a frame, call once per frame on the GL thread
+ *		CSCI441_PROFILE_THREAD_NAME("name")   names the calling thread in the trace
+ *		CSCI441_PROFILE_WRITE_TRACE("file")   writes a Chrome trace (chrome://tracing, ui.perfetto.dev)
+ *
+ *	Zone names must be string literals or otherwise outlive the profiler.
+ *
+ *	CPU zones are recorded with nanosecond steady_clock timestamps into a buffer
+ *	owned by the recording thread.  The buffer grows in fixed blocks that are
+ *	published with atomics, so recording never takes a lock and the trace can be
+ *	written while other threads keep recording.  A thread stops recording once it
+ *	has filled MAX_BLOCKS_PER_THREAD blocks.
+ *
+ *	GPU zones write a GL_TIMESTAMP query at each end of the scope.  Timestamps are
+ *	used rather than GL_TIME_ELAPSED because elapsed-time queries cannot nest.  Each
+ *	frame's queries are read FRAMES_IN_FLIGHT - 1 frames later, once they are
+ *	available, so reading them never stalls the pipeline.  GPU zones are placed on a
+ *	separate "GPU" track, aligned to the CPU time the frame started.
+ *
+ *	@warning GPU zones and CSCI441_PROFILE_FRAME() need a current OpenGL context;
+ *	write the trace before the context is destroyed
+ */
+
+#ifndef CSCI441_PROFILER_HPP
+#define CSCI441_PROFILER_HPP
+
+#include "Logger.hpp"
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//**********************************************************************************
+
+#ifdef CSCI441_ENABLE_PROFILER
+    #define CSCI441_PROFILE_CONCAT_INNER(A, B) A##B
+    #define CSCI441_PROFILE_CONCAT(A, B) CSCI441_PROFILE_CONCAT_INNER(A, B)
+    #define CSCI441_PROFILE_ZONE(NAME) const CSCI441::ProfileZone CSCI441_PROFILE_CONCAT(csci441ProfileZone, __LINE__)(NAME)
+    #define CSCI441_PROFILE_GPU_ZONE(NAME) const CSCI441::GPUProfileZone CSCI441_PROFILE_CONCAT(csci441GPUProfileZone, __LINE__)(NAME)
+    #define CSCI441_PROFILE_FRAME() CSCI441::Profiler::instance().beginFrame()
+    #define CSCI441_PROFILE_THREAD_NAME(NAME) CSCI441::Profiler::instance().setThreadName(NAME)
+    #define CSCI441_PROFILE_WRITE_TRACE(FILENAME) CSCI441::Profiler::instance().writeChromeTrace(FILENAME)
+#else
+    #define CSCI441_PROFILE_ZONE(NAME) ((void)0)
+    #define CSCI441_PROFILE_GPU_ZONE(NAME) ((void)0)
+    #define CSCI441_PROFILE_FRAME() ((void)0)
+    #define CSCI441_PROFILE_THREAD_NAME(NAME) ((void)0)
+    #define CSCI441_PROFILE_WRITE_TRACE(FILENAME) ((void)0)
+#endif
+
+namespace CSCI441 {
+
+    /**
+     * @class Profiler
+     * @brief records CPU and GPU zones and exports them as a Chrome trace
+     * @note use the CSCI441_PROFILE_* macros rather than calling the profiler directly
+     */
+    class [[maybe_unused]] Profiler final {
+    public:
+        /**
+         * @brief number of frames whose GPU queries can be in flight at once
+         */
+        static constexpr GLuint FRAMES_IN_FLIGHT = 4;
+        /**
+         * @brief number of GPU zones recorded per frame, further zones are ignored
+         */
+        static constexpr GLuint MAX_GPU_ZONES_PER_FRAME = 64;
+        /**
+         * @brief number of CPU zones in one block of a thread's buffer
+         */
+        static constexpr GLuint EVENTS_PER_BLOCK = 4096;
+        /**
+         * @brief number of blocks a thread can fill before it stops recording
+         */
+        static constexpr GLuint MAX_BLOCKS_PER_THREAD = 256;
+
+        /**
+         * @brief returns the profiler shared by all threads
+         */
+        static Profiler& instance();
+
+        /**
+         * @brief do not allow the profiler to be copied
+         */
+        Profiler(const Profiler&) = delete;
+        /**
+         * @brief do not allow the profiler to be copied
+         */
+        Profiler& operator=(const Profiler&) = delete;
+
+        /**
+         * @brief returns nanoseconds since the profiler was created
+         */
+        [[nodiscard]] GLuint64 now() const;
+
+        /**
+         * @brief records a finished CPU zone for the calling thread
+         * @param name zone name, must outlive the profiler
+         * @param startNs start time from now()
+         * @param endNs end time from now()
+         */
+        void recordZone( const char* name, GLuint64 startNs, GLuint64 endNs );
+        /**
+         * @brief names the calling thread in the trace
+         * @param name thread name
+         */
+        void setThreadName( const char* name );
+
+        /**
+         * @brief starts a GPU frame: reads the queries of finished frames and writes the frame's start timestamp
+         * @note call once per frame on the thread that owns the OpenGL context
+         */
+        void beginFrame();
+        /**
+         * @brief writes the start timestamp of a GPU zone
+         * @param name zone name, must outlive the profiler
+         * @returns zone index to pass to endGPUZone(), or -1 if the zone is not recorded
+         */
+        GLint beginGPUZone( const char* name );
+        /**
+         * @brief writes the end timestamp of a GPU zone
+         * @param zone index returned by beginGPUZone()
+         */
+        void endGPUZone( GLint zone );
+
+        /**
+         * @brief writes every recorded zone as Chrome trace JSON
+         * @param filename file to create or overwrite
+         * @returns true if the file was written
+         * @note waits for outstanding GPU queries and then deletes them
+         */
+        bool writeChromeTrace( const char* filename );
+
+    private:
+        Profiler();
+        ~Profiler();
+
+        struct Event {
+            const char* name;
+            GLuint64 startNs;
+            GLuint64 endNs;
+        };
+
+        // written only by its thread; count is published with release so readers see complete events
+        struct Block {
+            Event events[EVENTS_PER_BLOCK];
+            std::atomic<GLuint> count{0};
+            std::atomic<Block*> next{nullptr};
+        };
+
+        struct ThreadBuffer {
+            GLuint threadId;
+            std::string name;
+            Block* head;
+            Block* tail;
+            GLuint numBlocks;
+        };
+
+        struct GPUFrame {
+            GLuint queries[1 + 2 * MAX_GPU_ZONES_PER_FRAME];
+            const char* names[MAX_GPU_ZONES_PER_FRAME];
+            GLuint numZones;
+            GLuint lastQuery;                   // most recently issued, nested zones end out of index order
+            GLuint64 cpuStartNs;
+            bool pending;
+        };
+
+        ThreadBuffer* _threadBuffer();
+        void _resolveGPUFrame( GPUFrame& frame, bool wait );
+        static void _writeEvent( FILE* file, const Event& event, GLuint threadId );
+        static void _writeThreadName( FILE* file, const char* name, GLuint threadId );
+        static void _writeJSONString( FILE* file, const char* text );
+
+        const std::chrono::steady_clock::time_point _epoch;
+
+        std::mutex _threadsMutex;                   // taken once per thread, when its buffer is created
+        std::vector<ThreadBuffer*> _threads;
+
+        // GPU state, only touched on the thread that owns the OpenGL context
+        GPUFrame _gpuFrames[FRAMES_IN_FLIGHT];
+        GLuint _gpuFrameIndex;
+        GPUFrame* _currentGPUFrame;
+        bool _gpuQueriesCreated;
+        std::vector<Event> _gpuEvents;
+        GLuint _droppedGPUFrames;
+    };
+
+    /**
+     * @class ProfileZone
+     * @brief times its own lifetime as a CPU zone
+     */
+    class [[maybe_unused]] ProfileZone final {
+    public:
+        /**
+         * @brief starts the zone
+         * @param name zone name, must outlive the profiler
+         */
+        explicit ProfileZone( const char* name ) : _name(name), _startNs(Profiler::instance().now()) {}
+        /**
+         * @brief ends and records the zone
+         */
+        ~ProfileZone() { Profiler::instance().recordZone(_name, _startNs, Profiler::instance().now()); }
+
+        /**
+         * @brief do not allow zones to be copied
+         */
+        ProfileZone(const ProfileZone&) = delete;
+        /**
+         * @brief do not allow zones to be copied
+         */
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+    private:
+        const char* _name;
+        GLuint64 _startNs;
+    };
+
+    /**
+     * @class GPUProfileZone
+     * @brief times its own lifetime as a CPU zone and as a GPU zone
+     */
+    class [[maybe_unused]] GPUProfileZone final {
+    public:
+        /**
+         * @brief starts the zone
+         * @param name zone name, must outlive the profiler
+         */
+        explicit GPUProfileZone( const char* name ) : _cpuZone(name), _gpuZone(Profiler::instance().beginGPUZone(name)) {}
+        /**
+         * @brief ends the zone
+         */
+        ~GPUProfileZone() { Profiler::instance().endGPUZone(_gpuZone); }
+
+        /**
+         * @brief do not allow zones to be copied
+         */
+        GPUProfileZone(const GPUProfileZone&) = delete;
+        /**
+         * @brief do not allow zones to be copied
+         */
+        GPUProfileZone& operator=(const GPUProfileZone&) = delete;
+
+    private:
+        ProfileZone _cpuZone;
+        GLint _gpuZone;
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+inline CSCI441::Profiler& CSCI441::Profiler::instance() {
+    static Profiler sInstance;
+    return sInstance;
+}
+
+inline GLuint64 CSCI441::Profiler::now() const {
+    return static_cast<GLuint64>( std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _epoch).count() );
+}
+
+inline void CSCI441::Profiler::recordZone( const char* name, const GLuint64 startNs, const GLuint64 endNs ) {
+    ThreadBuffer* buffer = _threadBuffer();
+
+    Block* block = buffer->tail;
+    GLuint count = block->count.load( std::memory_order_relaxed );
+    if( count == EVENTS_PER_BLOCK ) {
+        if( buffer->numBlocks == MAX_BLOCKS_PER_THREAD ) return;
+        auto newBlock = new Block();
+        block->next.store( newBlock, std::memory_order_release );
+        buffer->tail = block = newBlock;
+        buffer->numBlocks++;
+        count = 0;
+    }
+
+    block->events[count] = { name, startNs, endNs };
+    block->count.store( count + 1, std::memory_order_release );
+}
+
+inline void CSCI441::Profiler::setThreadName( const char* name ) {
+    ThreadBuffer* buffer = _threadBuffer();
+    std::lock_guard<std::mutex> lock( _threadsMutex );
+    buffer->name = name;
+}
+
+inline void CSCI441::Profiler::beginFrame() {
+    if( !_gpuQueriesCreated ) {
+        for( auto& frame : _gpuFrames ) {
+            glGenQueries( 1 + 2 * MAX_GPU_ZONES_PER_FRAME, frame.queries );
+            frame.numZones = 0;
+            frame.lastQuery = frame.queries[0];
+            frame.pending = false;
+        }
+        _gpuQueriesCreated = true;
+    }
+
+    // read every earlier frame whose queries are done, oldest first
+    for( GLuint i = 1; i < FRAMES_IN_FLIGHT; i++ ) {
+        GPUFrame& frame = _gpuFrames[(_gpuFrameIndex + i) % FRAMES_IN_FLIGHT];
+        if( frame.pending ) _resolveGPUFrame( frame, false );
+    }
+
+    GPUFrame& frame = _gpuFrames[_gpuFrameIndex];
+    _gpuFrameIndex = (_gpuFrameIndex + 1) % FRAMES_IN_FLIGHT;
+    if( frame.pending ) {
+        // still not finished after FRAMES_IN_FLIGHT frames; drop it rather than wait
+        _droppedGPUFrames++;
+    }
+
+    frame.numZones = 0;
+    frame.pending = true;
+    frame.cpuStartNs = now();
+    glQueryCounter( frame.queries[0], GL_TIMESTAMP );
+    frame.lastQuery = frame.queries[0];
+    _currentGPUFrame = &frame;
+}
+
+inline GLint CSCI441::Profiler::beginGPUZone( const char* name ) {
+    if( _currentGPUFrame == nullptr || _currentGPUFrame->numZones == MAX_GPU_ZONES_PER_FRAME ) return -1;
+
+    const GLuint zone = _currentGPUFrame->numZones++;
+    _currentGPUFrame->names[zone] = name;
+    glQueryCounter( _currentGPUFrame->queries[1 + 2 * zone], GL_TIMESTAMP );
+    _currentGPUFrame->lastQuery = _currentGPUFrame->queries[1 + 2 * zone];
+    return static_cast<GLint>(zone);
+}
+
+inline void CSCI441::Profiler::endGPUZone( const GLint zone ) {
+    if( zone < 0 || _currentGPUFrame == nullptr ) return;
+
+    glQueryCounter( _currentGPUFrame->queries[2 + 2 * zone], GL_TIMESTAMP );
+    _currentGPUFrame->lastQuery = _currentGPUFrame->queries[2 + 2 * zone];
+}
+
+inline bool CSCI441::Profiler::writeChromeTrace( const char* filename ) {
+    if( _gpuQueriesCreated ) {
+        for( auto& frame : _gpuFrames ) {
+            if( frame.pending ) _resolveGPUFrame( frame, true );
+            glDeleteQueries( 1 + 2 * MAX_GPU_ZONES_PER_FRAME, frame.queries );
+        }
+        _gpuQueriesCreated = false;
+        _currentGPUFrame = nullptr;
+    }
+
+    FILE* file = fopen( filename, "w" );
+    if( file == nullptr ) {
+        CSCI441_LOG_ERROR( "CSCI441::Profiler::writeChromeTrace(): Could not open \"%s\" for writing", filename );
+        return false;
+    }
+
+    // timestamps are in microseconds, tid 0 is the GPU track
+    fprintf( file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" );
+    _writeThreadName( file, "GPU", 0 );
+    for( const Event& event : _gpuEvents ) {
+        _writeEvent( file, event, 0 );
+    }
+
+    GLuint64 numCPUEvents = 0;
+    {
+        std::lock_guard<std::mutex> lock( _threadsMutex );
+        for( const ThreadBuffer* buffer : _threads ) {
+            _writeThreadName( file, buffer->name.c_str(), buffer->threadId );
+            for( const Block* block = buffer->head; block != nullptr; block = block->next.load(std::memory_order_acquire) ) {
+                const GLuint count = block->count.load( std::memory_order_acquire );
+                for( GLuint i = 0; i < count; i++ ) {
+                    _writeEvent( file, block->events[i], buffer->threadId );
+                }
+                numCPUEvents += count;
+            }
+        }
+    }
+    fprintf( file, "\n]}\n" );
+    fclose( file );
+
+    fprintf( stdout, "[INFO]: Wrote %llu CPU and %zu GPU zones to %s", static_cast<unsigned long long>(numCPUEvents), _gpuEvents.size(), filename );
+    if( _droppedGPUFrames > 0 ) fprintf( stdout, " (%u GPU frames dropped)", _droppedGPUFrames );
+    fprintf( stdout, "\n" );
+    return true;
+}
+
+//**********************************************************************************
+// Internal implementations
+
+inline CSCI441::Profiler::Profiler()
+    : _epoch(std::chrono::steady_clock::now()),
+      _gpuFrames(),
+      _gpuFrameIndex(0),
+      _currentGPUFrame(nullptr),
+      _gpuQueriesCreated(false),
+      _droppedGPUFrames(0) {
+}
+
+inline CSCI441::Profiler::~Profiler() {
+    // the OpenGL context is gone by now, so GPU queries are only deleted by writeChromeTrace()
+    for( ThreadBuffer* buffer : _threads ) {
+        for( Block* block = buffer->head; block != nullptr; ) {
+            Block* next = block->next.load( std::memory_order_relaxed );
+            delete block;
+            block = next;
+        }
+        delete buffer;
+    }
+}
+
+inline CSCI441::Profiler::ThreadBuffer* CSCI441::Profiler::_threadBuffer() {
+    thread_local ThreadBuffer* tBuffer = nullptr;
+    if( tBuffer == nullptr ) {
+        auto buffer = new ThreadBuffer();
+        buffer->head = buffer->tail = new Block();
+        buffer->numBlocks = 1;
+
+        std::lock_guard<std::mutex> lock( _threadsMutex );
+        buffer->threadId = static_cast<GLuint>(_threads.size()) + 1;
+        buffer->name = buffer->threadId == 1 ? "Main" : "Thread " + std::to_string(buffer->threadId);
+        _threads.push_back( buffer );
+        tBuffer = buffer;
+    }
+    return tBuffer;
+}
+
+inline void CSCI441::Profiler::_resolveGPUFrame( GPUFrame& frame, const bool wait ) {
+    // queries finish in order, so the last one written tells if the whole frame is done
+    if( !wait ) {
+        GLuint available = GL_FALSE;
+        glGetQueryObjectuiv( frame.lastQuery, GL_QUERY_RESULT_AVAILABLE, &available );
+        if( available == GL_FALSE ) return;
+    }
+
+    GLuint64 frameStartTimestamp = 0;
+    glGetQueryObjectui64v( frame.queries[0], GL_QUERY_RESULT, &frameStartTimestamp );
+    for( GLuint zone = 0; zone < frame.numZones; zone++ ) {
+        GLuint64 startTimestamp = 0, endTimestamp = 0;
+        glGetQueryObjectui64v( frame.queries[1 + 2 * zone], GL_QUERY_RESULT, &startTimestamp );
+        glGetQueryObjectui64v( frame.queries[2 + 2 * zone], GL_QUERY_RESULT, &endTimestamp );
+        _gpuEvents.push_back( { frame.names[zone],
+                                frame.cpuStartNs + (startTimestamp - frameStartTimestamp),
+                                frame.cpuStartNs + (endTimestamp - frameStartTimestamp) } );
+    }
+    frame.pending = false;
+}
+
+inline void CSCI441::Profiler::_writeEvent( FILE* file, const Event& event, const GLuint threadId ) {
+    fprintf( file, ",\n{\"name\":" );
+    _writeJSONString( file, event.name );
+    fprintf( file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+             threadId, static_cast<double>(event.startNs) / 1000.0, static_cast<double>(event.endNs - event.startNs) / 1000.0 );
+}
+
+inline void CSCI441::Profiler::_writeThreadName( FILE* file, const char* name, const GLuint threadId ) {
+    // the GPU track is written first, so only it goes without a leading comma
+    fprintf( file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", threadId == 0 ? "" : ",", threadId );
+    _writeJSONString( file, name );
+    fprintf( file, "}}" );
+}
+
+inline void CSCI441::Profiler::_writeJSONString( FILE* file, const char* text ) {
+    fputc( '"', file );
+    for( const char* c = text; *c != '\0'; c++ ) {
+        if( *c == '"' || *c == '\\' ) fprintf( file, "\\%c", *c );
+        else if( static_cast<unsigned char>(*c) < 0x20 ) fprintf( file, "\\u%04x", static_cast<unsigned int>(*c) );
+        else fputc( *c, file );
+    }
+    fputc( '"', file );
+}
+
+#endif // CSCI441_PROFILER_HPP
@@ -0,0 +1,186 @@
+/** @file ShaderPermutations.hpp
+ * @brief Variants of one shader program specialised by preprocessor defines
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	A permutation set owns one vertex and fragment shader source and compiles a
+ *	separate ShaderProgram for every set of #define lines it is asked for.  The
+ *	defines are inserted after the #version line of both stages, so the GLSL can
+ *	use #if / #ifdef to remove features a variant does not need.  An optional
+ *	library source is inserted after the defines in both stages, which lets code
+ *	shared by the vertex and fragment stage live in one file.
+ *
+ *	Variants are compiled the first time they are requested and cached by their
+ *	defines.  Look the variant up once when the features are known and keep the
+ *	returned pointer; the lookup builds a string key and is not meant for every draw.
+ *
+ *	@warning This header file depends upon glm
+ */
+
+#ifndef CSCI441_SHADER_PERMUTATIONS_HPP
+#define CSCI441_SHADER_PERMUTATIONS_HPP
+
+#include "Logger.hpp"
+#include "ShaderProgram.hpp"
+
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class ShaderPermutations
+     * @brief compiles and caches variants of a shader program for different sets of #define lines
+     */
+    class [[maybe_unused]] ShaderPermutations final {
+    public:
+        /**
+         * @brief macro names mapped to their values, an empty value defines the macro without one
+         */
+        using Defines = std::map<std::string, std::string>;
+
+        /**
+         * @brief creates a permutation set, no shader is compiled until a variant is requested
+         * @param vertexShaderFilename vertex shader filename to load from text file
+         * @param fragmentShaderFilename fragment shader filename to load from text file
+         * @param librarySourceFilename source inserted after the defines in both stages, nullptr for none
+         */
+        ShaderPermutations( const char* vertexShaderFilename, const char* fragmentShaderFilename, const char* librarySourceFilename = nullptr );
+        /**
+         * @brief deletes every compiled variant
+         */
+        ~ShaderPermutations();
+
+        /**
+         * @brief do not allow permutation sets to be copied
+         */
+        ShaderPermutations(const ShaderPermutations&) = delete;
+        /**
+         * @brief do not allow permutation sets to be copied
+         */
+        ShaderPermutations& operator=(const ShaderPermutations&) = delete;
+
+        /**
+         * @brief sets defines used by every variant unless the request overrides them
+         * @param defines default macro names and values
+         * @note only affects variants compiled afterwards
+         */
+        [[maybe_unused]] void setDefaultDefines( const Defines& defines ) { _defaultDefines = defines; }
+        /**
+         * @brief sets a function called once for every newly compiled variant
+         * @param callback receives the new variant, typically to set uniforms that never change
+         */
+        [[maybe_unused]] void setVariantCreatedCallback( std::function<void(ShaderProgram&)> callback ) { _variantCreatedCallback = std::move(callback); }
+
+        /**
+         * @brief returns the variant compiled with the default defines plus the given ones, compiling it if needed
+         * @param defines macro names and values for this variant
+         * @returns variant owned by the permutation set
+         */
+        [[maybe_unused]] ShaderProgram* getVariant( const Defines& defines = Defines() );
+
+        /**
+         * @brief returns the number of variants compiled so far
+         */
+        [[maybe_unused]] [[nodiscard]] size_t getNumberOfVariants() const { return _variants.size(); }
+
+        /**
+         * @brief returns the #define lines for a set of defines
+         * @param defines macro names and values
+         */
+        [[maybe_unused]] [[nodiscard]] static std::string makePreamble( const Defines& defines );
+
+    private:
+        // ShaderProgram only exposes the preamble to derived classes
+        class Variant final : public ShaderProgram {
+        public:
+            Variant( const char* vertexShaderFilename, const char* fragmentShaderFilename, const std::string& preamble );
+        };
+
+        std::string _vertexShaderFilename;
+        std::string _fragmentShaderFilename;
+        std::string _librarySource;
+
+        Defines _defaultDefines;
+        std::function<void(ShaderProgram&)> _variantCreatedCallback;
+
+        // keyed by the preamble, which lists the merged defines in sorted order
+        std::map<std::string, ShaderProgram*> _variants;
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+inline CSCI441::ShaderPermutations::ShaderPermutations( const char* vertexShaderFilename, const char* fragmentShaderFilename, const char* librarySourceFilename )
+    : _vertexShaderFilename(vertexShaderFilename), _fragmentShaderFilename(fragmentShaderFilename) {
+    if( librarySourceFilename != nullptr ) {
+        char* librarySource = nullptr;
+        if( CSCI441_INTERNAL::ShaderUtils::readTextFromFile( librarySourceFilename, librarySource ) ) {
+            _librarySource = librarySource;
+            delete[] librarySource;
+        } else {
+            CSCI441_LOG_ERROR( "CSCI441::ShaderPermutations::ShaderPermutations(): Could not read library source \"%s\"", librarySourceFilename );
+        }
+    }
+}
+
+inline CSCI441::ShaderPermutations::~ShaderPermutations() {
+    for( auto& [key, variant] : _variants ) {
+        delete variant;
+    }
+}
+
+[[maybe_unused]]
+inline CSCI441::ShaderProgram* CSCI441::ShaderPermutations::getVariant( const Defines& defines ) {
+    Defines mergedDefines = _defaultDefines;
+    for( const auto& [name, value] : defines ) {
+        mergedDefines[name] = value;
+    }
+    const std::string definesPreamble = makePreamble( mergedDefines );
+
+    const auto variantIter = _variants.find( definesPreamble );
+    if( variantIter != _variants.end() ) {
+        return variantIter->second;
+    }
+
+    fprintf( stdout, "[INFO]: Compiling shader variant %zu of %s with\n%s", _variants.size() + 1, _vertexShaderFilename.c_str(), definesPreamble.c_str() );
+    // restart line numbering so compile errors in the shader body point at its own lines
+    const std::string preamble = definesPreamble + _librarySource + "#line 2\n";
+    ShaderProgram* variant = new Variant( _vertexShaderFilename.c_str(), _fragmentShaderFilename.c_str(), preamble );
+    _variants.emplace( definesPreamble, variant );
+
+    if( _variantCreatedCallback ) {
+        _variantCreatedCallback( *variant );
+    }
+    return variant;
+}
+
+[[maybe_unused]]
+inline std::string CSCI441::ShaderPermutations::makePreamble( const Defines& defines ) {
+    std::string preamble;
+    for( const auto& [name, value] : defines ) {
+        preamble += "#define " + name;
+        if( !value.empty() ) {
+            preamble += " " + value;
+        }
+        preamble += "\n";
+    }
+    return preamble;
+}
+
+//**********************************************************************************
+// Internal implementations
+
+inline CSCI441::ShaderPermutations::Variant::Variant( const char* vertexShaderFilename, const char* fragmentShaderFilename, const std::string& preamble ) {
+    mSourcePreamble = preamble;
+    mRegisterShaderProgram( vertexShaderFilename, "", "", "", fragmentShaderFilename, false );
+}
+
+#endif // CSCI441_SHADER_PERMUTATIONS_HPP
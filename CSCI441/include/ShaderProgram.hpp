@@ -13,6 +13,7 @@
 #ifndef CSCI441_SHADER_PROGRAM_HPP
 #define CSCI441_SHADER_PROGRAM_HPP
 
+#include "Logger.hpp"
 #include "ShaderUtils.hpp"
 
 #include <glm/glm.hpp>
@@ -852,6 +853,12 @@ namespace CSCI441 {
          */
         std::map<std::string, GLint> *mpAttributeLocationsMap;
 
+        /**
+         * @brief source text inserted after the #version line of every stage, such as #define lines
+         * @note set before calling mRegisterShaderProgram()
+         */
+        std::string mSourcePreamble;
+
         /**
          * @brief registers a shader program with the GPU
          * @param vertexShaderFilename vertex shader filename to load from text file
@@ -946,19 +953,19 @@ inline CSCI441::ShaderProgram::ShaderProgram( const char **shaderFilenames,
     _initialize();
     if( vertexPresent && !tessellationPresent && !geometryPresent && !fragmentPresent ) {
         if( !isSeparable ) {
-            fprintf(stderr, "[ERROR]: Fragment Shader not present.  Program must be separable.\n");
+            CSCI441_LOG_ERROR("Fragment Shader not present.  Program must be separable.");
         } else {
             mRegisterShaderProgram(shaderFilenames[0], "", "", "", "", isSeparable);
         }
     } else if( vertexPresent && tessellationPresent && !geometryPresent && !fragmentPresent ) {
         if( !isSeparable ) {
-            fprintf(stderr, "[ERROR]: Fragment Shader not present.  Program must be separable.\n");
+            CSCI441_LOG_ERROR("Fragment Shader not present.  Program must be separable.");
         } else {
             mRegisterShaderProgram(shaderFilenames[0], shaderFilenames[1], shaderFilenames[2], "", "", isSeparable);
         }
     } else if( vertexPresent && tessellationPresent && geometryPresent && !fragmentPresent ) {
         if( !isSeparable ) {
-            fprintf(stderr, "[ERROR]: Fragment Shader not present.  Program must be separable.\n");
+            CSCI441_LOG_ERROR("Fragment Shader not present.  Program must be separable.");
         } else {
             mRegisterShaderProgram(shaderFilenames[0], shaderFilenames[1], shaderFilenames[2], shaderFilenames[3], "",
                                    isSeparable);
@@ -971,7 +978,7 @@ inline CSCI441::ShaderProgram::ShaderProgram( const char **shaderFilenames,
                                isSeparable);
     } else if( vertexPresent && !tessellationPresent && geometryPresent && !fragmentPresent ) {
         if( !isSeparable ) {
-            fprintf(stderr, "[ERROR]: Fragment Shader not present.  Program must be separable.\n");
+            CSCI441_LOG_ERROR("Fragment Shader not present.  Program must be separable.");
         } else {
             mRegisterShaderProgram(shaderFilenames[0], "", "", shaderFilenames[1], "", isSeparable);
         }
@@ -981,51 +988,51 @@ inline CSCI441::ShaderProgram::ShaderProgram( const char **shaderFilenames,
         mRegisterShaderProgram(shaderFilenames[0], "", "", "", shaderFilenames[1], isSeparable);
     } else if( !vertexPresent && tessellationPresent && !geometryPresent && !fragmentPresent ) {
         if( !isSeparable ) {
-            fprintf(stderr, "[ERROR]: Vertex & Fragment Shaders not present.  Program must be separable.\n");
+            CSCI441_LOG_ERROR("Vertex & Fragment Shaders not present.  Program must be separable.");
         } else {
             mRegisterShaderProgram("", shaderFilenames[0], shaderFilenames[1], "", "", isSeparable);
         }
     } else if( !vertexPresent && tessellationPresent && geometryPresent && !fragmentPresent ) {
         if( !isSeparable ) {
-            fprintf(stderr, "[ERROR]: Vertex & Fragment Shaders not present.  Program must be separable.\n");
+            CSCI441_LOG_ERROR("Vertex & Fragment Shaders not present.  Program must be separable.");
         } else {
             mRegisterShaderProgram("", shaderFilenames[0], shaderFilenames[1], shaderFilenames[2], "", isSeparable);
         }
     } else if( !vertexPresent && tessellationPresent && geometryPresent && fragmentPresent ) {
         if( !isSeparable ) {
-            fprintf(stderr, "[ERROR]: Vertex Shader not present.  Program must be separable.\n");
+            CSCI441_LOG_ERROR("Vertex Shader not present.  Program must be separable.");
         } else {
             mRegisterShaderProgram("", shaderFilenames[0], shaderFilenames[1], shaderFilenames[2], shaderFilenames[3],
                                    isSeparable);
         }
     } else if( !vertexPresent && tessellationPresent && !geometryPresent && fragmentPresent ) {
         if( !isSeparable ) {
-            fprintf(stderr, "[ERROR]: Vertex Shader not present.  Program must be separable.\n");
+            CSCI441_LOG_ERROR("Vertex Shader not present.  Program must be separable.");
         } else {
             mRegisterShaderProgram("", shaderFilenames[0], shaderFilenames[1], "", shaderFilenames[2], isSeparable);
         }
     } else if( !vertexPresent && !tessellationPresent && geometryPresent && !fragmentPresent ) {
         if( !isSeparable ) {
-            fprintf(stderr, "[ERROR]: Vertex & Fragment Shaders not present.  Program must be separable.\n");
+            CSCI441_LOG_ERROR("Vertex & Fragment Shaders not present.  Program must be separable.");
         } else {
             mRegisterShaderProgram("", "", "", shaderFilenames[0], "", isSeparable);
         }
     } else if( !vertexPresent && !tessellationPresent && geometryPresent && fragmentPresent ) {
         if( !isSeparable ) {
-            fprintf(stderr, "[ERROR]: Vertex Shader not present.  Program must be separable.\n");
+            CSCI441_LOG_ERROR("Vertex Shader not present.  Program must be separable.");
         } else {
             mRegisterShaderProgram("", "", "", shaderFilenames[0], shaderFilenames[1], isSeparable);
         }
     } else if( !vertexPresent && !tessellationPresent && !geometryPresent && fragmentPresent ) {
         if( !isSeparable ) {
-            fprintf(stderr, "[ERROR]: Vertex Shader not present.  Program must be separable.\n");
+            CSCI441_LOG_ERROR("Vertex Shader not present.  Program must be separable.");
         } else {
             mRegisterShaderProgram("", "", "", "", shaderFilenames[0], isSeparable);
         }
     } else if( !vertexPresent && !tessellationPresent && !geometryPresent && !fragmentPresent ) {
-        fprintf(stderr, "[ERROR]: At least one shader must be present.\n");
+        CSCI441_LOG_ERROR("At least one shader must be present.");
     } else {
-        fprintf(stderr, "[ERROR]: Unknown state.\n");
+        CSCI441_LOG_ERROR("Unknown state.");
     }
 }
 
@@ -1039,7 +1046,7 @@ inline bool CSCI441::ShaderProgram::mRegisterShaderProgram(const char *vertexSha
     /* compile each one of our shaders */
     if( strcmp( vertexShaderFilename, "" ) != 0 ) {
         if( sDEBUG ) printf( "[INFO]: | Vertex Shader: %39s |\n", vertexShaderFilename );
-        mVertexShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(vertexShaderFilename, GL_VERTEX_SHADER );
+        mVertexShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(vertexShaderFilename, GL_VERTEX_SHADER, mSourcePreamble );
     } else {
         mVertexShaderHandle = 0;
     }
@@ -1050,7 +1057,7 @@ inline bool CSCI441::ShaderProgram::mRegisterShaderProgram(const char *vertexSha
             printf( "[ERROR]:|   TESSELLATION SHADER NOT SUPPORTED!! UPGRADE TO v4.0+ |\n" );
             mTessellationControlShaderHandle = 0;
         } else {
-            mTessellationControlShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(tessellationControlShaderFilename, GL_TESS_CONTROL_SHADER );
+            mTessellationControlShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(tessellationControlShaderFilename, GL_TESS_CONTROL_SHADER, mSourcePreamble );
         }
     } else {
         mTessellationControlShaderHandle = 0;
@@ -1062,7 +1069,7 @@ inline bool CSCI441::ShaderProgram::mRegisterShaderProgram(const char *vertexSha
             printf( "[ERROR]:|   TESSELLATION SHADER NOT SUPPORTED!! UPGRADE TO v4.0+ |\n" );
             mTessellationEvaluationShaderHandle = 0;
         } else {
-            mTessellationEvaluationShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(tessellationEvaluationShaderFilename, GL_TESS_EVALUATION_SHADER );
+            mTessellationEvaluationShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(tessellationEvaluationShaderFilename, GL_TESS_EVALUATION_SHADER, mSourcePreamble );
         }
     } else {
         mTessellationEvaluationShaderHandle = 0;
@@ -1074,7 +1081,7 @@ inline bool CSCI441::ShaderProgram::mRegisterShaderProgram(const char *vertexSha
             printf( "[ERROR]:|   GEOMETRY SHADER NOT SUPPORTED!!!    UPGRADE TO v3.2+ |\n" );
             mGeometryShaderHandle = 0;
         } else {
-            mGeometryShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(geometryShaderFilename, GL_GEOMETRY_SHADER );
+            mGeometryShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(geometryShaderFilename, GL_GEOMETRY_SHADER, mSourcePreamble );
         }
     } else {
         mGeometryShaderHandle = 0;
@@ -1082,7 +1089,7 @@ inline bool CSCI441::ShaderProgram::mRegisterShaderProgram(const char *vertexSha
 
     if( strcmp( fragmentShaderFilename, "" ) != 0 ) {
         if( sDEBUG ) printf( "[INFO]: | Fragment Shader: %37s |\n", fragmentShaderFilename );
-        mFragmentShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(fragmentShaderFilename, GL_FRAGMENT_SHADER );
+        mFragmentShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(fragmentShaderFilename, GL_FRAGMENT_SHADER, mSourcePreamble );
     } else {
         mFragmentShaderHandle = 0;
     }
@@ -1153,17 +1160,20 @@ inline bool CSCI441::ShaderProgram::mRegisterShaderProgram(const char *vertexSha
             int size = 0;
             GLenum type;
             glGetActiveUniform(mShaderProgramHandle, i, max_length, &actual_length, &size, &type, name );
-            GLint location = -1;
-            if(size > 1) {
+            // arrays are reported as "name[0]", even with one element; register the plain name
+            // for the first element as glGetUniformLocation() accepts it, then every element
+            const std::string uniformName = name;
+            const size_t arraySuffix = uniformName.rfind("[0]");
+            if( arraySuffix != std::string::npos && arraySuffix + 3 == uniformName.size() ) {
+                const std::string baseName = uniformName.substr(0, arraySuffix);
+                mpUniformLocationsMap->emplace(baseName, glGetUniformLocation(mShaderProgramHandle, baseName.c_str()) );
                 for(int j = 0; j < size; j++) {
-                    char long_name[64];
-                    sprintf(long_name, "%s[%i]", name, j);
-                    location = glGetUniformLocation(mShaderProgramHandle, long_name);
+                    const std::string elementName = baseName + "[" + std::to_string(j) + "]";
+                    mpUniformLocationsMap->emplace(elementName, glGetUniformLocation(mShaderProgramHandle, elementName.c_str()) );
                 }
             } else {
-                location = glGetUniformLocation(mShaderProgramHandle, name);
+                mpUniformLocationsMap->emplace(uniformName, glGetUniformLocation(mShaderProgramHandle, name) );
             }
-            mpUniformLocationsMap->emplace(name, location );
         }
     }
 
@@ -1216,14 +1226,14 @@ inline bool CSCI441::ShaderProgram::mRegisterShaderProgram(const char *vertexSha
 inline GLint CSCI441::ShaderProgram::getUniformLocation( const char *uniformName ) const {
     GLint uniformLoc = glGetUniformLocation(mShaderProgramHandle, uniformName );
     if( uniformLoc == -1 )
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle );
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle );
     return uniformLoc;
 }
 
 inline GLint CSCI441::ShaderProgram::getUniformBlockIndex( const char *uniformBlockName ) const {
     GLint uniformBlockLoc = glGetUniformBlockIndex(mShaderProgramHandle, uniformBlockName );
     if( uniformBlockLoc == -1 )
-        fprintf(stderr, "[ERROR]: Could not find uniform block \"%s\" for Shader Program %u\n", uniformBlockName, mShaderProgramHandle );
+        CSCI441_LOG_ERROR("Could not find uniform block \"%s\" for Shader Program %u", uniformBlockName, mShaderProgramHandle );
     return uniformBlockLoc;
 }
 
@@ -1286,7 +1296,7 @@ inline void CSCI441::ShaderProgram::setUniformBlockBinding( const char *uniformB
 inline GLint CSCI441::ShaderProgram::getAttributeLocation( const char *attributeName ) const {
     auto attribIter = mpAttributeLocationsMap->find(attributeName);
     if(attribIter == mpAttributeLocationsMap->end() ) {
-        fprintf(stderr, "[ERROR]: Could not find attribute \"%s\" for Shader Program %u\n", attributeName, mShaderProgramHandle );
+        CSCI441_LOG_ERROR("Could not find attribute \"%s\" for Shader Program %u", attributeName, mShaderProgramHandle );
         return -1;
     }
     return attribIter->second;
@@ -1296,7 +1306,7 @@ inline GLint CSCI441::ShaderProgram::getAttributeLocation( const char *attribute
 inline GLuint CSCI441::ShaderProgram::getSubroutineIndex( GLenum shaderStage, const char *subroutineName ) const {
     GLuint subroutineIndex = glGetSubroutineIndex(mShaderProgramHandle, shaderStage, subroutineName );
     if( subroutineIndex == GL_INVALID_INDEX )
-        fprintf(stderr, "[ERROR]: Could not find subroutine \"%s\" in %s for Shader Program %u\n", subroutineName, CSCI441_INTERNAL::ShaderUtils::GL_shader_type_to_string(shaderStage), mShaderProgramHandle );
+        CSCI441_LOG_ERROR("Could not find subroutine \"%s\" in %s for Shader Program %u", subroutineName, CSCI441_INTERNAL::ShaderUtils::GL_shader_type_to_string(shaderStage), mShaderProgramHandle );
     return subroutineIndex;
 }
 
@@ -1306,7 +1316,7 @@ inline GLint CSCI441::ShaderProgram::getImageBinding(const char* imageName) cons
     GLint imageLoc = getUniformLocation(imageName);
 
     if(imageLoc == -1) {
-        fprintf(stderr, "[ERROR]: Could not find image \"%s\" for Shader Program %u\n", imageName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find image \"%s\" for Shader Program %u", imageName, mShaderProgramHandle);
         return -1;
     }
 
@@ -1321,7 +1331,7 @@ inline GLint CSCI441::ShaderProgram::getShaderStorageBlockBinding(const char* ss
     GLuint ssboIndex = glGetProgramResourceIndex(mShaderProgramHandle, GL_SHADER_STORAGE_BLOCK, ssboName);
 
     if(ssboIndex == GL_INVALID_INDEX) {
-        fprintf(stderr, "[ERROR]: Could not find shader storage block \"%s\" for Shader Program %u\n", ssboName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find shader storage block \"%s\" for Shader Program %u", ssboName, mShaderProgramHandle);
         return -1;
     }
 
@@ -1338,7 +1348,7 @@ inline GLint CSCI441::ShaderProgram::getAtomicCounterBufferBinding(const char* a
     GLuint uniformIndex = glGetProgramResourceIndex(mShaderProgramHandle, GL_UNIFORM, atomicName);
 
     if(uniformIndex == GL_INVALID_INDEX) {
-        fprintf(stderr, "[ERROR]: Could not find atomic counter \"%s\" for Shader Program %u\n", atomicName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find atomic counter \"%s\" for Shader Program %u", atomicName, mShaderProgramHandle);
         return -1;
     }
 
@@ -1355,7 +1365,7 @@ inline GLint CSCI441::ShaderProgram::getAtomicCounterBufferOffset(const char* at
     GLuint uniformIndex = glGetProgramResourceIndex(mShaderProgramHandle, GL_UNIFORM, atomicName);
 
     if(uniformIndex == GL_INVALID_INDEX) {
-        fprintf(stderr, "[ERROR]: Could not find atomic counter \"%s\" for Shader Program %u\n", atomicName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find atomic counter \"%s\" for Shader Program %u", atomicName, mShaderProgramHandle);
         return -1;
     }
 
@@ -1369,7 +1379,7 @@ inline GLint CSCI441::ShaderProgram::getAtomicCounterBufferSize(const char* atom
     GLuint uniformIndex = glGetProgramResourceIndex(mShaderProgramHandle, GL_UNIFORM, atomicName);
 
     if(uniformIndex == GL_INVALID_INDEX) {
-        fprintf(stderr, "[ERROR]: Could not find atomic counter \"%s\" for Shader Program %u\n", atomicName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find atomic counter \"%s\" for Shader Program %u", atomicName, mShaderProgramHandle);
         return -1;
     }
 
@@ -1417,7 +1427,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform1f(mShaderProgramHandle, uniformIter->second, v0 );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1427,7 +1437,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform2f(mShaderProgramHandle, uniformIter->second, v0, v1 );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1442,7 +1452,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform3f(mShaderProgramHandle, uniformIter->second, v0, v1, v2 );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1457,7 +1467,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform4f(mShaderProgramHandle, uniformIter->second, v0, v1, v2, v3 );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1483,11 +1493,11 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, G
                 glProgramUniform4fv(mShaderProgramHandle, uniformIter->second, count, value );
                 break;
             default:
-                fprintf(stderr, "[ERROR]: invalid dimension %u for uniform %s in Shader Program %u.  Dimension must be [1,4]\n", dim, uniformName, mShaderProgramHandle);
+                CSCI441_LOG_ERROR("invalid dimension %u for uniform %s in Shader Program %u.  Dimension must be [1,4]", dim, uniformName, mShaderProgramHandle);
                 break;
         }
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1497,7 +1507,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform1i(mShaderProgramHandle, uniformIter->second, v0 );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1507,7 +1517,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform2i(mShaderProgramHandle, uniformIter->second, v0, v1 );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1517,7 +1527,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, g
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform2iv(mShaderProgramHandle, uniformIter->second, 1, &value[0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1527,7 +1537,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform3i(mShaderProgramHandle, uniformIter->second, v0, v1, v2 );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1537,7 +1547,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, g
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform3iv(mShaderProgramHandle, uniformIter->second, 1, &value[0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1547,7 +1557,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform4i(mShaderProgramHandle, uniformIter->second, v0, v1, v2, v3 );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1557,7 +1567,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, g
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform4iv(mShaderProgramHandle, uniformIter->second, 1, &value[0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1579,11 +1589,11 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, G
                 glProgramUniform4iv(mShaderProgramHandle, uniformIter->second, count, value );
                 break;
             default:
-                fprintf(stderr, "[ERROR]: invalid dimension %u for uniform %s in Shader Program %u.  Dimension must be [1,4]\n", dim, uniformName, mShaderProgramHandle);
+                CSCI441_LOG_ERROR("invalid dimension %u for uniform %s in Shader Program %u.  Dimension must be [1,4]", dim, uniformName, mShaderProgramHandle);
                 break;
         }
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1593,7 +1603,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform1ui(mShaderProgramHandle, uniformIter->second, v0 );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1603,7 +1613,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform2ui(mShaderProgramHandle, uniformIter->second, v0, v1 );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1613,7 +1623,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, g
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform2uiv(mShaderProgramHandle, uniformIter->second, 1, &value[0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1623,7 +1633,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform3ui(mShaderProgramHandle, uniformIter->second, v0, v1, v2 );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1633,7 +1643,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, g
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform3uiv(mShaderProgramHandle, uniformIter->second, 1, &value[0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1643,7 +1653,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform4ui(mShaderProgramHandle, uniformIter->second, v0, v1, v2, v3 );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1653,7 +1663,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, g
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform4uiv(mShaderProgramHandle, uniformIter->second, 1, &value[0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1675,11 +1685,11 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, G
                 glProgramUniform4uiv(mShaderProgramHandle, uniformIter->second, count, value );
                 break;
             default:
-                fprintf(stderr, "[ERROR]: invalid dimension %u for uniform %s in Shader Program %u.  Dimension must be [1,4]\n", dim, uniformName, mShaderProgramHandle);
+                CSCI441_LOG_ERROR("invalid dimension %u for uniform %s in Shader Program %u.  Dimension must be [1,4]", dim, uniformName, mShaderProgramHandle);
                 break;
         }
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1689,7 +1699,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix2fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1699,7 +1709,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix3fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1709,7 +1719,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix4fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1719,7 +1729,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix2x3fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1729,7 +1739,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix3x2fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1739,7 +1749,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix2x4fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1749,7 +1759,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix4x2fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1759,7 +1769,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix3x4fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1769,7 +1779,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix4x3fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
     } else {
-        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
+        CSCI441_LOG_ERROR("Could not find uniform \"%s\" for Shader Program %u", uniformName, mShaderProgramHandle);
     }
 }
 
@@ -1823,7 +1833,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(GLint uniformLocation, GLu
             glProgramUniform4fv(mShaderProgramHandle, uniformLocation, count, value );
             break;
         default:
-            fprintf(stderr, "[ERROR]: invalid dimension %u for uniform %i in Shader Program %u.  Dimension must be [1,4]\n", dim, uniformLocation, mShaderProgramHandle);
+            CSCI441_LOG_ERROR("invalid dimension %u for uniform %i in Shader Program %u.  Dimension must be [1,4]", dim, uniformLocation, mShaderProgramHandle);
             break;
     }
 }
@@ -1878,7 +1888,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(GLint uniformLocation, GLu
             glProgramUniform4iv(mShaderProgramHandle, uniformLocation, count, value );
             break;
         default:
-            fprintf(stderr, "[ERROR]: invalid dimension %u for uniform %i in Shader Program %u.  Dimension must be [1,4]\n", dim, uniformLocation, mShaderProgramHandle);
+            CSCI441_LOG_ERROR("invalid dimension %u for uniform %i in Shader Program %u.  Dimension must be [1,4]", dim, uniformLocation, mShaderProgramHandle);
             break;
     }
 }
@@ -1933,7 +1943,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(GLint uniformLocation, GLu
             glProgramUniform4uiv(mShaderProgramHandle, uniformLocation, count, value );
             break;
         default:
-            fprintf(stderr, "[ERROR]: invalid dimension %u for uniform %i in Shader Program %u.  Dimension must be [1,4]\n", dim, uniformLocation, mShaderProgramHandle);
+            CSCI441_LOG_ERROR("invalid dimension %u for uniform %i in Shader Program %u.  Dimension must be [1,4]", dim, uniformLocation, mShaderProgramHandle);
             break;
     }
 }
@@ -2038,7 +2048,7 @@ inline bool CSCI441::ShaderProgram::writeShaderProgramBinaryToFile(const char* B
     GLint formats = 0;
     glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
     if( formats < 1 ) {
-        fprintf(stderr, "[ERROR]: Driver does not support any binary formats.\n");
+        CSCI441_LOG_ERROR("Driver does not support any binary formats.");
         return false;
     }
 
@@ -2064,7 +2074,7 @@ inline CSCI441::ShaderProgram* CSCI441::ShaderProgram::loadShaderProgramFromBina
     GLint formats = 0;
     glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
     if( formats < 1 ) {
-        fprintf(stderr, "[ERROR]: Driver does not support any binary formats.\n");
+        CSCI441_LOG_ERROR("Driver does not support any binary formats.");
         return nullptr;
     }
 
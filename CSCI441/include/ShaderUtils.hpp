@@ -14,6 +14,8 @@
 #ifndef CSCI441_SHADER_UTILS_HPP
 #define CSCI441_SHADER_UTILS_HPP
 
+#include "Logger.hpp"
+
 #ifdef CSCI441_USE_GLEW
     #include <GL/glew.h>
 #else
@@ -63,6 +65,13 @@ namespace CSCI441_INTERNAL::ShaderUtils {
     // GLuint shader handle if compilation successful.  -1 otherwise
     GLuint compileShader( const char *filename, GLenum shaderType );
 
+    // Reads the contents of a text file, inserts source text after its #version line, and compiles the associated shader type
+    // const char* filename of shader file to read in
+    // GLenum type of shader file corresponds to
+    // const std::string& source text to insert, such as #define lines
+    // GLuint shader handle if compilation successful.  -1 otherwise
+    GLuint compileShader( const char *filename, GLenum shaderType, const std::string& preamble );
+
     // Prints the shader log for the associated Shader handle
     void printShaderLog( GLuint shaderHandle );
 
@@ -119,7 +128,7 @@ inline bool CSCI441_INTERNAL::ShaderUtils::readTextFromFile(
 
     std::ifstream in(filename);
     if( !in.is_open() ) {
-    	fprintf( stderr, "[ERROR]: Could not open file %s\n", filename );
+    	CSCI441_LOG_ERROR( "Could not open file %s", filename );
     	return false;
     }
     while( std::getline(in, line) ) {
@@ -799,17 +808,36 @@ inline void CSCI441_INTERNAL::ShaderUtils::printShaderProgramInfo(
 inline GLuint CSCI441_INTERNAL::ShaderUtils::compileShader(
         const char *filename,
         const GLenum shaderType
+) {
+    return compileShader( filename, shaderType, std::string() );
+}
+
+inline GLuint CSCI441_INTERNAL::ShaderUtils::compileShader(
+        const char *filename,
+        const GLenum shaderType,
+        const std::string& preamble
 ) {
 	GLuint shaderHandle = glCreateShader( shaderType );	char *shaderString;
 
     // read in each text file and store the contents in a string
     if( readTextFromFile( filename, shaderString ) ) {
 
-		// send the contents of each program to the GPU
-		glShaderSource( shaderHandle, 1, (const char**)&shaderString, nullptr );
+        // #version must stay the first statement, so the preamble goes on the line after it
+        std::string source( shaderString );
+        delete [] shaderString;
+        if( !preamble.empty() ) {
+            size_t insertAt = 0;
+            const size_t versionPos = source.find( "#version" );
+            if( versionPos != std::string::npos ) {
+                const size_t lineEnd = source.find( '\n', versionPos );
+                insertAt = lineEnd == std::string::npos ? source.length() : lineEnd + 1;
+            }
+            source.insert( insertAt, preamble );
+        }
+        const char* sourceString = source.c_str();
 
-		// we are good programmers so free up the memory used by each buffer
-		delete [] shaderString;
+		// send the contents of each program to the GPU
+		glShaderSource( shaderHandle, 1, &sourceString, nullptr );
 
 		// compile each shader on the GPU
 		glCompileShader( shaderHandle );
@@ -9,6 +9,9 @@
  *
  *	@warning This header file depends upon GLAD (or alternatively GLEW)
  *	@warning This header file depends upon stb_image
+ *	@warning This header file depends upon KTXUtils
+ *	@warning stb_image v2.23 stores the vertical flip setting globally.  Images are decoded
+ *	unflipped and flipped with flipImageRows() so loads on other threads are not affected.
  */
 
 #ifndef CSCI441_TEXTURE_UTILS_HPP
@@ -20,8 +23,12 @@
     #include <glad/gl.h>
 #endif
 
+#include "KTXUtils.hpp"
+#include "Logger.hpp"
+
 #include <stb_image.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <string>
@@ -56,6 +63,16 @@ namespace CSCI441 {
          */
 		bool loadPPM( const char *filename, int &imageWidth, int &imageHeight, unsigned char* &imageData );
 
+        /**
+         * @brief reverses the order of the rows of an image in place
+         * @note use instead of stbi_set_flip_vertically_on_load(), which changes the setting for every thread
+         * @param imageData tightly packed pixels
+         * @param imageWidth width of the image in pixels
+         * @param imageHeight height of the image in pixels
+         * @param imageChannels bytes per pixel
+         */
+        [[maybe_unused]] void flipImageRows( unsigned char* imageData, int imageWidth, int imageHeight, int imageChannels );
+
         /**
 		 * @brief loads and registers a texture into memory returning a texture handle
          * @note Calls through to loadAndRegister2DTexture()
@@ -105,6 +122,37 @@ namespace CSCI441 {
 		 * @warning Cube Map must be bound as active texture before calling
          */
         [[maybe_unused]] void loadCubeMapFaceTexture(GLint cubeMapFace, const char* filename);
+
+        /**
+		 * @brief loads a KTX file created by the texture cooker and registers it with OpenGL
+		 * @brief Every face and mip level stored in the file is uploaded as is, using
+		 * glCompressedTexImage2D() for block compressed formats.  Files containing six
+		 * faces are registered as cube maps, all others as 2D textures.
+		 * @param filename name of KTX file to load
+		 * @param minFilter minification filter to apply (default: GL_LINEAR_MIPMAP_LINEAR)
+		 * @param magFilter magnification filter to apply (default: GL_LINEAR)
+		 * @param wrapS wrapping to apply to S coordinate (default: GL_REPEAT)
+		 * @param wrapT wrapping to apply to T coordinate (default: GL_REPEAT)
+         * @param printAllMessages prints debug/error messages to terminal
+		 * @param[out] pBytes if not null, will contain the number of bytes uploaded
+		 * @returns texture handle corresponding to the texture, or 0 if the file could not be read
+		 * or the driver does not support its compression format
+         */
+        [[maybe_unused]] GLuint loadAndRegisterKTXTexture( const char *filename,
+                                                           GLint minFilter = GL_LINEAR_MIPMAP_LINEAR,
+                                                           GLint magFilter = GL_LINEAR,
+                                                           GLint wrapS = GL_REPEAT,
+                                                           GLint wrapT = GL_REPEAT,
+                                                           GLboolean printAllMessages = GL_TRUE,
+                                                           size_t *pBytes = nullptr );
+
+        /**
+         * @brief returns true if the current OpenGL context can sample the given KTX format
+         * @param format encoding to query
+         * @note BC1 and BC3 require EXT_texture_compression_s3tc, BC7 requires OpenGL 4.2 or
+         * ARB_texture_compression_bptc
+         */
+        [[maybe_unused]] bool isKTXFormatSupported( KTXUtils::Format format );
 	}
 }
 
@@ -116,7 +164,7 @@ inline bool CSCI441::TextureUtils::loadPPM( const char *filename, int &imageWidt
     int temp, maxValue;
     fscanf(fp, "P%d", &temp);
     if(temp != 3) {
-        fprintf(stderr, "[ERROR]: CSCI441::TextureUtils::loadPPM(): PPM file is not of correct format! (Must be P3, is P%d.)\n", temp);
+        CSCI441_LOG_ERROR("CSCI441::TextureUtils::loadPPM(): PPM file is not of correct format! (Must be P3, is P%d.)", temp);
         fclose(fp);
         return false;
     }
@@ -129,7 +177,7 @@ inline bool CSCI441::TextureUtils::loadPPM( const char *filename, int &imageWidt
     //now that we know how big it is, allocate the buffer...
     imageData = new unsigned char[imageWidth*imageHeight*3];
     if(!imageData) {
-        fprintf(stderr, "[ERROR]: CSCI441::TextureUtils::loadPPM(): couldn't allocate image memory. Dimensions: %d x %d.\n", imageWidth, imageHeight);
+        CSCI441_LOG_ERROR("CSCI441::TextureUtils::loadPPM(): couldn't allocate image memory. Dimensions: %d x %d.", imageWidth, imageHeight);
         fclose(fp);
         return false;
     }
@@ -152,6 +200,14 @@ inline bool CSCI441::TextureUtils::loadPPM( const char *filename, int &imageWidt
     return true;
 }
 
+[[maybe_unused]]
+inline void CSCI441::TextureUtils::flipImageRows( unsigned char* imageData, const int imageWidth, const int imageHeight, const int imageChannels ) {
+    const size_t ROW_BYTES = static_cast<size_t>(imageWidth) * imageChannels;
+    for( int top = 0, bottom = imageHeight - 1; top < bottom; top++, bottom-- ) {
+        std::swap_ranges( imageData + top * ROW_BYTES, imageData + (top + 1) * ROW_BYTES, imageData + bottom * ROW_BYTES );
+    }
+}
+
 [[maybe_unused]]
 inline GLuint CSCI441::TextureUtils::loadAndRegisterTexture( const char *filename, const GLint minFilter, const GLint magFilter, const GLint wrapS, const GLint wrapT, const GLboolean flipOnY, const GLboolean printAllMessages ) {
 	return loadAndRegister2DTexture( filename, minFilter, magFilter, wrapS, wrapT, flipOnY, printAllMessages );
@@ -160,8 +216,8 @@ inline GLuint CSCI441::TextureUtils::loadAndRegisterTexture( const char *filenam
 inline GLuint CSCI441::TextureUtils::loadAndRegister2DTexture( const char *filename, const GLint minFilter, const GLint magFilter, const GLint wrapS, const GLint wrapT, const GLboolean flipOnY, const GLboolean printAllMessages ) {
     int imageWidth, imageHeight, imageChannels;
     GLuint texHandle = 0;
-    stbi_set_flip_vertically_on_load(flipOnY);
     unsigned char *data = stbi_load( filename, &imageWidth, &imageHeight, &imageChannels, 0);
+    if( data && flipOnY ) flipImageRows( data, imageWidth, imageHeight, imageChannels );
 
 	if( !data ) {
         if( strstr(filename, ".ppm") != NULL ) {
@@ -198,8 +254,79 @@ inline void CSCI441::TextureUtils::loadCubeMapFaceTexture(const GLint cubeMapFac
         glTexImage2D(cubeMapFace, 0, STORAGE_TYPE, imageWidth, imageHeight, 0, STORAGE_TYPE, GL_UNSIGNED_BYTE, data);
         stbi_image_free(data);
     } else {
-        fprintf( stderr, "[ERROR]: CSCI441::TextureUtils::loadCubeMapFaceTexture(): Could not load texture map \"%s\"\n", FILENAME );
+        CSCI441_LOG_ERROR( "CSCI441::TextureUtils::loadCubeMapFaceTexture(): Could not load texture map \"%s\"", FILENAME );
+    }
+}
+
+[[maybe_unused]]
+inline bool CSCI441::TextureUtils::isKTXFormatSupported( const KTXUtils::Format format ) {
+    if( format == KTXUtils::Format::RGBA8 ) return true;
+
+    GLint majorVersion = 0, minorVersion = 0;
+    glGetIntegerv( GL_MAJOR_VERSION, &majorVersion );
+    glGetIntegerv( GL_MINOR_VERSION, &minorVersion );
+    if( format == KTXUtils::Format::BC7 && (majorVersion > 4 || (majorVersion == 4 && minorVersion >= 2)) ) return true;
+
+    const char* EXTENSION = (format == KTXUtils::Format::BC7 ? "GL_ARB_texture_compression_bptc" : "GL_EXT_texture_compression_s3tc");
+    GLint numExtensions = 0;
+    glGetIntegerv( GL_NUM_EXTENSIONS, &numExtensions );
+    for( GLint i = 0; i < numExtensions; i++ ) {
+        if( strcmp( (const char*)glGetStringi( GL_EXTENSIONS, i ), EXTENSION ) == 0 ) return true;
+    }
+    return false;
+}
+
+[[maybe_unused]]
+inline GLuint CSCI441::TextureUtils::loadAndRegisterKTXTexture( const char *filename, const GLint minFilter, const GLint magFilter, const GLint wrapS, const GLint wrapT, const GLboolean printAllMessages, size_t *pBytes ) {
+    KTXUtils::Texture texture;
+    if( !KTXUtils::readKTX( filename, texture ) ) {
+        if( printAllMessages ) CSCI441_LOG_ERROR( "CSCI441::TextureUtils::loadAndRegisterKTXTexture(): Could not load texture \"%s\"", filename );
+        return 0;
+    }
+    if( !isKTXFormatSupported( texture.format ) ) {
+        if( printAllMessages ) CSCI441_LOG_ERROR( "CSCI441::TextureUtils::loadAndRegisterKTXTexture(): Compression format of \"%s\" is not supported by this driver", filename );
+        return 0;
+    }
+
+    const bool IS_CUBE_MAP = (texture.numFaces == 6);
+    const GLenum TARGET = IS_CUBE_MAP ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+    const auto INTERNAL_FORMAT = static_cast<GLenum>( texture.format );
+
+    GLuint texHandle = 0;
+    glGenTextures(1, &texHandle );
+    glBindTexture(   TARGET, texHandle );
+    glTexParameteri( TARGET, GL_TEXTURE_MIN_FILTER, minFilter );
+    glTexParameteri( TARGET, GL_TEXTURE_MAG_FILTER, magFilter );
+    glTexParameteri( TARGET, GL_TEXTURE_WRAP_S,     wrapS );
+    glTexParameteri( TARGET, GL_TEXTURE_WRAP_T,     wrapT );
+    if( IS_CUBE_MAP ) glTexParameteri( TARGET, GL_TEXTURE_WRAP_R, wrapT );
+    glTexParameteri( TARGET, GL_TEXTURE_MAX_LEVEL,  static_cast<GLint>( texture.levels.size() ) - 1 );
+
+    GLint unpackAlignment;
+    glGetIntegerv( GL_UNPACK_ALIGNMENT, &unpackAlignment );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+    size_t bytes = 0;
+    for( GLint level = 0; level < static_cast<GLint>( texture.levels.size() ); level++ ) {
+        const GLsizei WIDTH  = std::max( 1, static_cast<GLsizei>( texture.width ) >> level );
+        const GLsizei HEIGHT = std::max( 1, static_cast<GLsizei>( texture.height ) >> level );
+        for( GLuint face = 0; face < texture.numFaces; face++ ) {
+            const GLenum FACE_TARGET = IS_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : GL_TEXTURE_2D;
+            const auto& data = texture.levels[level][face];
+            if( texture.format == KTXUtils::Format::RGBA8 ) {
+                glTexImage2D( FACE_TARGET, level, GL_RGBA8, WIDTH, HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.data() );
+            } else {
+                glCompressedTexImage2D( FACE_TARGET, level, INTERNAL_FORMAT, WIDTH, HEIGHT, 0, static_cast<GLsizei>( data.size() ), data.data() );
+            }
+            bytes += data.size();
+        }
     }
+    glPixelStorei( GL_UNPACK_ALIGNMENT, unpackAlignment );
+
+    if( pBytes != nullptr ) *pBytes = bytes;
+    if( printAllMessages ) printf( "[INFO]: Successfully loaded texture \"%s\" with handle %d\n", filename, texHandle );
+
+	return texHandle;
 }
 
 #endif // CSCI441_TEXTURE_UTILS_HPP
@@ -0,0 +1,193 @@
+/** @file TransformHierarchy.hpp
+ * @brief Parent/child transforms with cached world and normal matrices
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Nodes store a local matrix relative to their parent.  Setting a local matrix
+ *	marks the node dirty only when it actually changed, and update() recomputes the
+ *	world and normal matrices of dirty nodes and their descendants in a single pass.
+ *	Parents are always created before their children, so the pass walks the
+ *	contiguous arrays in order.
+ *
+ *	Normal matrices are the inverse transpose of the upper 3x3 of the world matrix.
+ *	When every transform from the root down only rotates, translates and scales
+ *	uniformly, that equals the world matrix divided by the squared scale and no
+ *	inverse is computed.
+ *
+ *	Draw code multiplies the view-projection matrix of each view with the cached
+ *	world matrices, so world and normal matrices are computed once per frame no
+ *	matter how many views the scene is drawn in.
+ *
+ *	@warning This header file depends upon glm
+ */
+
+#ifndef CSCI441_TRANSFORM_HIERARCHY_HPP
+#define CSCI441_TRANSFORM_HIERARCHY_HPP
+
+#include "Logger.hpp"
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class TransformHierarchy
+     * @brief tree of transforms whose world and normal matrices are only recomputed when they change
+     */
+    class [[maybe_unused]] TransformHierarchy final {
+    public:
+        /**
+         * @brief parent of root nodes
+         */
+        static constexpr GLint NO_PARENT = -1;
+
+        /**
+         * @brief adds a node with an identity local matrix
+         * @param parent node the new node is relative to, must already exist, or NO_PARENT
+         * @returns node ID
+         */
+        [[maybe_unused]] GLuint addNode( GLint parent = NO_PARENT );
+
+        /**
+         * @brief sets a node's matrix relative to its parent
+         * @param node node ID
+         * @param localMtx local matrix
+         * @note the node is only marked dirty if the matrix differs from the current one
+         */
+        [[maybe_unused]] void setLocalMatrix( GLuint node, const glm::mat4& localMtx );
+
+        /**
+         * @brief recomputes the world and normal matrices of every dirty node and its descendants
+         */
+        [[maybe_unused]] void update();
+
+        /**
+         * @brief returns the node's matrix relative to its parent
+         */
+        [[maybe_unused]] [[nodiscard]] const glm::mat4& getLocalMatrix( GLuint node ) const { return _localMatrices[node]; }
+        /**
+         * @brief returns the node's model matrix as of the last update()
+         */
+        [[maybe_unused]] [[nodiscard]] const glm::mat4& getWorldMatrix( GLuint node ) const { return _worldMatrices[node]; }
+        /**
+         * @brief returns the node's normal matrix as of the last update()
+         */
+        [[maybe_unused]] [[nodiscard]] const glm::mat3& getNormalMatrix( GLuint node ) const { return _normalMatrices[node]; }
+        /**
+         * @brief returns if the node's world matrix only scales uniformly
+         */
+        [[maybe_unused]] [[nodiscard]] bool hasUniformScale( GLuint node ) const { return _worldUniformScale[node] != 0; }
+        /**
+         * @brief returns the number of nodes
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint getNumberOfNodes() const { return static_cast<GLuint>( _parents.size() ); }
+        /**
+         * @brief returns the number of nodes recomputed by the last update()
+         */
+        [[maybe_unused]] [[nodiscard]] GLuint getNumberOfUpdatedNodes() const { return _numUpdatedNodes; }
+
+    private:
+        // structure of arrays indexed by node ID
+        std::vector<GLint> _parents;
+        std::vector<glm::mat4> _localMatrices;
+        std::vector<glm::mat4> _worldMatrices;
+        std::vector<glm::mat3> _normalMatrices;
+        std::vector<GLubyte> _dirty;                // local matrix changed since the last update
+        std::vector<GLubyte> _updated;              // world matrix recomputed in the current update
+        std::vector<GLubyte> _localUniformScale;
+        std::vector<GLubyte> _worldUniformScale;
+        GLuint _numUpdatedNodes = 0;
+
+        static bool _isUniformScale( const glm::mat3& mtx );
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+[[maybe_unused]]
+inline GLuint CSCI441::TransformHierarchy::addNode( const GLint parent ) {
+    if( parent >= static_cast<GLint>( _parents.size() ) ) {
+        CSCI441_LOG_ERROR( "CSCI441::TransformHierarchy::addNode(): parent %d does not exist, adding a root node", parent );
+    }
+    _parents.push_back( parent < static_cast<GLint>( _parents.size() ) ? parent : NO_PARENT );
+    _localMatrices.emplace_back( 1.0f );
+    _worldMatrices.emplace_back( 1.0f );
+    _normalMatrices.emplace_back( 1.0f );
+    _dirty.push_back( 1 );
+    _updated.push_back( 0 );
+    _localUniformScale.push_back( 1 );
+    _worldUniformScale.push_back( 1 );
+    return static_cast<GLuint>( _parents.size() - 1 );
+}
+
+[[maybe_unused]]
+inline void CSCI441::TransformHierarchy::setLocalMatrix( const GLuint node, const glm::mat4& localMtx ) {
+    if( _localMatrices[node] == localMtx ) return;
+    _localMatrices[node] = localMtx;
+    _localUniformScale[node] = _isUniformScale( glm::mat3( localMtx ) ) ? 1 : 0;
+    _dirty[node] = 1;
+}
+
+[[maybe_unused]]
+inline void CSCI441::TransformHierarchy::update() {
+    _numUpdatedNodes = 0;
+    const size_t numNodes = _parents.size();
+    for( size_t i = 0; i < numNodes; i++ ) {
+        const GLint parent = _parents[i];
+        if( !_dirty[i] && (parent == NO_PARENT || !_updated[parent]) ) {
+            _updated[i] = 0;
+            continue;
+        }
+
+        if( parent == NO_PARENT ) {
+            _worldMatrices[i] = _localMatrices[i];
+            _worldUniformScale[i] = _localUniformScale[i];
+        } else {
+            _worldMatrices[i] = _worldMatrices[parent] * _localMatrices[i];
+            _worldUniformScale[i] = _worldUniformScale[parent] & _localUniformScale[i];
+        }
+
+        const glm::mat3 worldMtx( _worldMatrices[i] );
+        if( _worldUniformScale[i] ) {
+            // M = sR, so (M^-1)^T = R / s = M / s^2
+            const GLfloat scaleSquared = glm::dot( worldMtx[0], worldMtx[0] );
+            _normalMatrices[i] = scaleSquared > 0.0f ? worldMtx / scaleSquared : worldMtx;
+        } else {
+            _normalMatrices[i] = glm::transpose( glm::inverse( worldMtx ) );
+        }
+
+        _dirty[i] = 0;
+        _updated[i] = 1;
+        _numUpdatedNodes++;
+    }
+}
+
+//**********************************************************************************
+// Internal implementations
+
+inline bool CSCI441::TransformHierarchy::_isUniformScale( const glm::mat3& mtx ) {
+    // columns of a uniformly scaled rotation are orthogonal and of equal length
+    const GLfloat lengthSquared = glm::dot( mtx[0], mtx[0] );
+    const GLfloat tolerance = 1e-5f * lengthSquared;
+    return std::fabs( glm::dot( mtx[1], mtx[1] ) - lengthSquared ) <= tolerance
+        && std::fabs( glm::dot( mtx[2], mtx[2] ) - lengthSquared ) <= tolerance
+        && std::fabs( glm::dot( mtx[0], mtx[1] ) ) <= tolerance
+        && std::fabs( glm::dot( mtx[0], mtx[2] ) ) <= tolerance
+        && std::fabs( glm::dot( mtx[1], mtx[2] ) ) <= tolerance;
+}
+
+#endif // CSCI441_TRANSFORM_HIERARCHY_HPP
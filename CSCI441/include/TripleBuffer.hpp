@@ -0,0 +1,145 @@
+/** @file TripleBuffer.hpp
+ * @brief Hands the latest value from one producer thread to one consumer thread
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Three copies of T rotate between the producer, the consumer and a middle slot
+ *	holding the latest published value.  publish() and acquire() swap the middle
+ *	slot with a single atomic exchange, so neither side ever waits on the other or
+ *	sees a partially written value.  When the producer is faster, values the
+ *	consumer never acquired are overwritten.
+ *
+ *	waitUntilConsumed() bounds how far the producer can run ahead: it blocks while
+ *	the last published value is still unread, so the consumer is never more than
+ *	one value behind.  Call it before sampling inputs for the next value to keep
+ *	input-to-consumer latency within one value.
+ *
+ *	@warning exactly one producer thread and one consumer thread
+ */
+
+#ifndef CSCI441_TRIPLE_BUFFER_HPP
+#define CSCI441_TRIPLE_BUFFER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class TripleBuffer
+     * @brief lock free latest value handoff between a producer and a consumer thread
+     * @tparam T value type, copied into the buffer by the producer
+     */
+    template<typename T>
+    class [[maybe_unused]] TripleBuffer final {
+    public:
+        /**
+         * @brief creates a buffer with nothing published
+         */
+        TripleBuffer() : _buffers(), _writeIndex(0), _readIndex(2), _middle(1), _cancelled(false) {}
+
+        /**
+         * @brief do not allow buffers to be copied
+         */
+        TripleBuffer(const TripleBuffer&) = delete;
+        /**
+         * @brief do not allow buffers to be copied
+         */
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        /**
+         * @brief returns the value the producer writes next
+         * @note producer only, the contents are whatever was written three publishes ago
+         */
+        [[maybe_unused]] [[nodiscard]] T& getWriteBuffer() { return _buffers[_writeIndex]; }
+        /**
+         * @brief makes the write buffer the latest value and moves on to another buffer
+         * @note producer only
+         */
+        [[maybe_unused]] void publish();
+        /**
+         * @brief blocks while the last published value has not been acquired
+         * @returns false if the buffer was cancelled
+         * @note producer only
+         */
+        [[maybe_unused]] bool waitUntilConsumed();
+
+        /**
+         * @brief takes the latest published value if there is a newer one
+         * @returns true if the read buffer changed
+         * @note consumer only
+         */
+        [[maybe_unused]] bool acquire();
+        /**
+         * @brief returns the value the consumer acquired last
+         * @note consumer only
+         */
+        [[maybe_unused]] [[nodiscard]] const T& getReadBuffer() const { return _buffers[_readIndex]; }
+
+        /**
+         * @brief wakes the producer and makes every later waitUntilConsumed() return false
+         */
+        [[maybe_unused]] void cancel();
+
+    private:
+        // the middle slot index plus a flag set when it holds a value the consumer has not taken
+        static constexpr unsigned int INDEX_MASK = 0x3;
+        static constexpr unsigned int FRESH = 0x4;
+
+        T _buffers[3];
+        unsigned int _writeIndex;           // producer only
+        unsigned int _readIndex;            // consumer only
+        std::atomic<unsigned int> _middle;
+
+        std::mutex _mutex;                  // only for the producer to sleep on
+        std::condition_variable _consumed;
+        std::atomic<bool> _cancelled;
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+template<typename T>
+[[maybe_unused]]
+inline void CSCI441::TripleBuffer<T>::publish() {
+    _writeIndex = _middle.exchange( _writeIndex | FRESH, std::memory_order_acq_rel ) & INDEX_MASK;
+}
+
+template<typename T>
+[[maybe_unused]]
+inline bool CSCI441::TripleBuffer<T>::waitUntilConsumed() {
+    std::unique_lock<std::mutex> lock( _mutex );
+    _consumed.wait( lock, [this]() {
+        return (_middle.load(std::memory_order_acquire) & FRESH) == 0 || _cancelled.load();
+    } );
+    return !_cancelled.load();
+}
+
+template<typename T>
+[[maybe_unused]]
+inline bool CSCI441::TripleBuffer<T>::acquire() {
+    if( (_middle.load(std::memory_order_acquire) & FRESH) == 0 ) return false;
+
+    _readIndex = _middle.exchange( _readIndex, std::memory_order_acq_rel ) & INDEX_MASK;
+    // taking the lock orders this notify after a producer that already checked the flag starts waiting
+    { std::lock_guard<std::mutex> lock( _mutex ); }
+    _consumed.notify_one();
+    return true;
+}
+
+template<typename T>
+[[maybe_unused]]
+inline void CSCI441::TripleBuffer<T>::cancel() {
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _cancelled.store( true );
+    }
+    _consumed.notify_all();
+}
+
+#endif // CSCI441_TRIPLE_BUFFER_HPP
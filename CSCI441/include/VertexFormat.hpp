@@ -0,0 +1,218 @@
+/** @file VertexFormat.hpp
+ * @brief Interleaved vertex layout with packed normals and texture coordinates
+ * @author Dr. Jeffrey Paone
+ *
+ * @copyright MIT License Copyright (c) 2017 Dr. Jeffrey Paone
+ *
+ *	Packs position, normal, and texture coordinate arrays into one interleaved
+ *	vertex buffer.  Normals are stored as GL_INT_2_10_10_10_REV and texture
+ *	coordinates as two half floats, 4 bytes each instead of 12 and 8.  Positions
+ *	are either kept as floats (20 bytes per vertex instead of 32) or quantized to
+ *	16 bit integers over the mesh bounds (16 bytes per vertex).
+ *
+ *	Quantized positions are not normalized by OpenGL.  The vertex shader receives
+ *	the raw integers and the matrix returned by getDequantizationMatrix() maps them
+ *	back to model space; multiply it into the model matrix before drawing.  The
+ *	quantization uses the same scale on every axis so the matrix does not change
+ *	the direction of normals.
+ *
+ *	Normals are decoded with the OpenGL 4.2 signed normalized rule.  OpenGL 4.1
+ *	decodes them with an error below 0.002, which disappears once the shader
+ *	normalizes the normal.
+ *
+ *	@warning This header file depends upon glm
+ */
+
+#ifndef CSCI441_VERTEX_FORMAT_HPP
+#define CSCI441_VERTEX_FORMAT_HPP
+
+#ifdef CSCI441_USE_GLEW
+    #include <GL/glew.h>
+#else
+    #include <glad/gl.h>
+#endif
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+//**********************************************************************************
+
+namespace CSCI441 {
+
+    /**
+     * @class VertexFormat
+     * @brief packs vertex attributes into a compact interleaved buffer and describes it to OpenGL
+     */
+    class [[maybe_unused]] VertexFormat final {
+    public:
+        /**
+         * @brief how vertex positions are stored
+         */
+        enum PositionType : GLubyte {
+            /// three 32 bit floats
+            FLOAT_POSITIONS,
+            /// three 16 bit integers and padding, dequantized by the model matrix
+            SHORT_POSITIONS
+        };
+
+        /**
+         * @brief creates a vertex format
+         * @param positionType how positions are stored (default: floats)
+         */
+        explicit VertexFormat( PositionType positionType = FLOAT_POSITIONS );
+
+        /**
+         * @brief packs vertex attributes into interleaved vertices
+         * @param positions array of vertex positions
+         * @param normals array of vertex normals, may be nullptr
+         * @param texCoords array of vertex texture coordinates, may be nullptr
+         * @param numVertices number of vertices in each array
+         * @returns getStride() bytes per vertex
+         * @note with SHORT_POSITIONS this also sets the dequantization matrix for these positions
+         */
+        [[maybe_unused]] std::vector<GLubyte> pack( const glm::vec3* positions, const glm::vec3* normals, const glm::vec2* texCoords, size_t numVertices );
+        /**
+         * @brief packs vertex attributes and uploads them to the buffer bound to GL_ARRAY_BUFFER
+         * @param positions array of vertex positions
+         * @param normals array of vertex normals, may be nullptr
+         * @param texCoords array of vertex texture coordinates, may be nullptr
+         * @param numVertices number of vertices in each array
+         * @param usage buffer usage hint (default: GL_STATIC_DRAW)
+         */
+        [[maybe_unused]] void bufferData( const glm::vec3* positions, const glm::vec3* normals, const glm::vec2* texCoords, size_t numVertices,
+                                          GLenum usage = GL_STATIC_DRAW );
+
+        /**
+         * @brief points and enables the attributes of the buffer bound to GL_ARRAY_BUFFER in the bound vertex array
+         * @param positionLocation attribute location of vertex position, -1 to skip
+         * @param normalLocation attribute location of vertex normal, -1 to skip
+         * @param texCoordLocation attribute location of vertex texture coordinate, -1 to skip
+         */
+        [[maybe_unused]] void setAttributePointers( GLint positionLocation, GLint normalLocation = -1, GLint texCoordLocation = -1 ) const;
+
+        /**
+         * @brief returns how positions are stored
+         */
+        [[maybe_unused]] [[nodiscard]] PositionType getPositionType() const { return _positionType; }
+        /**
+         * @brief returns the number of bytes per vertex
+         */
+        [[maybe_unused]] [[nodiscard]] GLsizei getStride() const { return _positionType == SHORT_POSITIONS ? 16 : 20; }
+        /**
+         * @brief returns the matrix mapping stored positions to model space
+         * @note identity for FLOAT_POSITIONS
+         */
+        [[maybe_unused]] [[nodiscard]] const glm::mat4& getDequantizationMatrix() const { return _dequantizationMtx; }
+
+        /**
+         * @brief packs a unit normal as GL_INT_2_10_10_10_REV
+         */
+        [[maybe_unused]] [[nodiscard]] static GLuint packNormal( const glm::vec3& normal );
+        /**
+         * @brief packs a texture coordinate as two half floats
+         */
+        [[maybe_unused]] [[nodiscard]] static GLuint packTexCoord( const glm::vec2& texCoord );
+
+    private:
+        PositionType _positionType;
+        glm::mat4 _dequantizationMtx;
+
+        [[nodiscard]] GLsizei _positionSize() const { return _positionType == SHORT_POSITIONS ? 8 : 12; }
+    };
+}
+
+//**********************************************************************************
+// Outward facing function implementations
+
+inline CSCI441::VertexFormat::VertexFormat( const PositionType positionType )
+    : _positionType(positionType), _dequantizationMtx(1.0f) {
+}
+
+[[maybe_unused]]
+inline std::vector<GLubyte> CSCI441::VertexFormat::pack( const glm::vec3* positions, const glm::vec3* normals, const glm::vec2* texCoords, const size_t numVertices ) {
+    const GLsizei stride = getStride();
+    const GLsizei positionSize = _positionSize();
+    std::vector<GLubyte> packed( numVertices * stride );
+
+    // one scale for every axis keeps the dequantization from skewing normals
+    glm::vec3 center(0.0f);
+    GLfloat scale = 1.0f;
+    if( _positionType == SHORT_POSITIONS && numVertices > 0 ) {
+        glm::vec3 minimum = positions[0], maximum = positions[0];
+        for( size_t i = 1; i < numVertices; i++ ) {
+            minimum = glm::min( minimum, positions[i] );
+            maximum = glm::max( maximum, positions[i] );
+        }
+        center = (minimum + maximum) * 0.5f;
+        const glm::vec3 halfExtent = (maximum - minimum) * 0.5f;
+        const GLfloat largest = glm::max( halfExtent.x, glm::max( halfExtent.y, halfExtent.z ) );
+        scale = largest > 0.0f ? largest / 32767.0f : 1.0f;
+    }
+    _dequantizationMtx = glm::scale( glm::translate( glm::mat4(1.0f), center ), glm::vec3(scale) );
+
+    for( size_t i = 0; i < numVertices; i++ ) {
+        GLubyte* vertex = packed.data() + i * stride;
+
+        if( _positionType == SHORT_POSITIONS ) {
+            const glm::vec3 quantized = glm::clamp( glm::round( (positions[i] - center) / scale ), glm::vec3(-32767.0f), glm::vec3(32767.0f) );
+            const GLshort position[4] = { static_cast<GLshort>(quantized.x), static_cast<GLshort>(quantized.y), static_cast<GLshort>(quantized.z), 0 };
+            memcpy( vertex, position, sizeof(position) );
+        } else {
+            memcpy( vertex, &positions[i], sizeof(glm::vec3) );
+        }
+
+        const GLuint normal = packNormal( normals != nullptr ? normals[i] : glm::vec3(0.0f) );
+        memcpy( vertex + positionSize, &normal, sizeof(GLuint) );
+
+        const GLuint texCoord = packTexCoord( texCoords != nullptr ? texCoords[i] : glm::vec2(0.0f) );
+        memcpy( vertex + positionSize + sizeof(GLuint), &texCoord, sizeof(GLuint) );
+    }
+
+    return packed;
+}
+
+[[maybe_unused]]
+inline void CSCI441::VertexFormat::bufferData( const glm::vec3* positions, const glm::vec3* normals, const glm::vec2* texCoords, const size_t numVertices,
+                                               const GLenum usage ) {
+    const std::vector<GLubyte> packed = pack( positions, normals, texCoords, numVertices );
+    glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(packed.size()), packed.data(), usage );
+}
+
+[[maybe_unused]]
+inline void CSCI441::VertexFormat::setAttributePointers( const GLint positionLocation, const GLint normalLocation, const GLint texCoordLocation ) const {
+    const GLsizei stride = getStride();
+    const GLsizei positionSize = _positionSize();
+    if( positionLocation != -1 ) {
+        glEnableVertexAttribArray( positionLocation );
+        if( _positionType == SHORT_POSITIONS ) {
+            glVertexAttribPointer( positionLocation, 3, GL_SHORT, GL_FALSE, stride, (void*)nullptr );
+        } else {
+            glVertexAttribPointer( positionLocation, 3, GL_FLOAT, GL_FALSE, stride, (void*)nullptr );
+        }
+    }
+    if( normalLocation != -1 ) {
+        glEnableVertexAttribArray( normalLocation );
+        glVertexAttribPointer( normalLocation, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)(static_cast<GLintptr>(positionSize)) );
+    }
+    if( texCoordLocation != -1 ) {
+        glEnableVertexAttribArray( texCoordLocation );
+        glVertexAttribPointer( texCoordLocation, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)(static_cast<GLintptr>(positionSize + sizeof(GLuint))) );
+    }
+}
+
+[[maybe_unused]]
+inline GLuint CSCI441::VertexFormat::packNormal( const glm::vec3& normal ) {
+    return glm::packSnorm3x10_1x2( glm::vec4( normal, 0.0f ) );
+}
+
+[[maybe_unused]]
+inline GLuint CSCI441::VertexFormat::packTexCoord( const glm::vec2& texCoord ) {
+    return glm::packHalf2x16( texCoord );
+}
+
+#endif // CSCI441_VERTEX_FORMAT_HPP
@@ -8,6 +8,17 @@
  *	objects.  All objects are constructed using triangles that
  *	have normals and texture coordinates properly set.
  *
+ *	Cubes, cylinders, spheres, and tori are welded into indexed
+ *	triangle lists when first generated, with triangles ordered for
+ *	the post-transform vertex cache and vertices ordered for fetch.
+ *	They are all appended to one shared vertex and element buffer,
+ *	so the get*Mesh() functions can hand their ranges to a
+ *	DrawBatcher and many shapes can be drawn with one call.
+ *
+ *	Vertices are interleaved in 20 bytes: float positions,
+ *	GL_INT_2_10_10_10_REV normals, and half float texture
+ *	coordinates (see VertexFormat.hpp).
+ *
  *	@warning NOTE: This header file will only work with OpenGL 3.0+
  *	@warning NOTE: This header file depends upon GLAD (or alternatively GLEW)
  */
@@ -15,7 +26,10 @@
 #ifndef CSCI441_OBJECTS_HPP
 #define CSCI441_OBJECTS_HPP
 
+#include "DrawBatcher.hpp"              // for DrawBatcher::Mesh
+#include "IndexOptimizer.hpp"           // for optimizeVertexCache(), optimizeVertexFetch()
 #include "teapot.hpp"                   // for teapot()
+#include "VertexFormat.hpp"             // for VertexFormat
 
 #ifdef CSCI441_USE_GLEW
     #include <GL/glew.h>
@@ -25,8 +39,10 @@
 
 #include <glm/gtc/constants.hpp>
 
+#include <array>                        // for array
 #include <cassert>   					// for assert()
 #include <map>							// for map
+#include <vector>                       // for vector
 
 ////////////////////////////////////////////////////////////////////////////////////
 
@@ -46,14 +62,90 @@ namespace CSCI441 {
 
     /**
      * @brief deletes the VAOs stored for all object types
+     * @note either call also deletes the vertex array and buffers shared by the indexed shapes, which are rebuilt when next drawn
      */
     [[maybe_unused]] void deleteObjectVAOs();
 
     /**
      * @brief deletes the VBOs stored for all object types
+     * @note either call also deletes the vertex array and buffers shared by the indexed shapes, which are rebuilt when next drawn
      */
     [[maybe_unused]] void deleteObjectVBOs();
 
+    /**
+     * @brief Returns the vertex buffer shared by all indexed shapes
+     * @note The buffer is created if it does not exist yet, its name does not change as shapes are added
+     */
+    [[maybe_unused]] [[nodiscard]] GLuint getShapeVertexBuffer();
+    /**
+     * @brief Returns the GL_UNSIGNED_INT element buffer shared by all indexed shapes
+     * @note The buffer is created if it does not exist yet, its name does not change as shapes are added
+     */
+    [[maybe_unused]] [[nodiscard]] GLuint getShapeIndexBuffer();
+    /**
+     * @brief Returns the layout of the shared shape vertex buffer
+     */
+    [[maybe_unused]] [[nodiscard]] const VertexFormat& getShapeVertexFormat();
+
+    /**
+     * @brief Returns the range of the shared shape buffers holding a solid cube
+     * @param sideLength length of the edge of the cube
+     * @pre sideLength must be greater than zero
+     * @note Generates the shape if it has not been drawn before
+     */
+    [[maybe_unused]] [[nodiscard]] DrawBatcher::Mesh getSolidCubeMesh( GLfloat sideLength );
+    /**
+     * @brief Returns the range of the shared shape buffers holding a solid cone
+     * @param base radius of the base of the cone
+     * @param height height of the cone from the base to the tip
+     * @param stacks resolution of the number of steps rotated around the central axis of the cone
+     * @param slices resolution of the number of steps to take along the height
+     * @pre base must be greater than zero
+     * @pre height must be greater than zero
+     * @pre stacks must be greater than zero
+     * @pre slices must be greater than two
+     * @note Generates the shape if it has not been drawn before
+     */
+    [[maybe_unused]] [[nodiscard]] DrawBatcher::Mesh getSolidConeMesh( GLfloat base, GLfloat height, GLint stacks, GLint slices );
+    /**
+     * @brief Returns the range of the shared shape buffers holding a solid cylinder
+     * @param base radius of the base of the cylinder
+     * @param top radius of the top of the cylinder
+     * @param height height of the cylinder from the base to the top
+     * @param stacks resolution of the number of steps rotated around the central axis of the cylinder
+     * @param slices resolution of the number of steps to take along the height
+     * @pre either base or top must be greater than zero
+     * @pre height must be greater than zero
+     * @pre stacks must be greater than zero
+     * @pre slices must be greater than two
+     * @note Generates the shape if it has not been drawn before
+     */
+    [[maybe_unused]] [[nodiscard]] DrawBatcher::Mesh getSolidCylinderMesh( GLfloat base, GLfloat top, GLfloat height, GLint stacks, GLint slices );
+    /**
+     * @brief Returns the range of the shared shape buffers holding a solid sphere
+     * @param radius radius of the sphere
+     * @param stacks resolution of the number of steps to take along theta (rotate around Y-axis)
+     * @param slices resolution of the number of steps to take along phi (rotate around X- or Z-axis)
+     * @pre radius must be greater than zero
+     * @pre stacks must be greater than one
+     * @pre slices must be greater than two
+     * @note Generates the shape if it has not been drawn before
+     */
+    [[maybe_unused]] [[nodiscard]] DrawBatcher::Mesh getSolidSphereMesh( GLfloat radius, GLint stacks, GLint slices );
+    /**
+     * @brief Returns the range of the shared shape buffers holding a solid torus
+     * @param innerRadius minor radius
+     * @param outerRadius major radius
+     * @param sides number of faces around the minor radius
+     * @param rings number of rings around the major radius
+     * @pre innerRadius must be greater than zero
+     * @pre outerRadius must be greater than zero
+     * @pre sides must be greater than two
+     * @pre rings must be greater than two
+     * @note Generates the shape if it has not been drawn before
+     */
+    [[maybe_unused]] [[nodiscard]] DrawBatcher::Mesh getSolidTorusMesh( GLfloat innerRadius, GLfloat outerRadius, GLint sides, GLint rings );
+
     /**
      * @brief Draws a solid cone
      * @param base radius of the base of the cone
@@ -353,16 +445,50 @@ namespace CSCI441_INTERNAL {
     void drawTorus( GLfloat innerRadius, GLfloat outerRadius, GLuint sides, GLuint rings, GLenum renderMode );
     void drawTeapot( GLenum renderMode );
 
+    // an indexed triangle list built from the triangles, strips and fans a shape is generated as
+    struct IndexedShape {
+        // first vertex of the shape in the shared vertex buffer
+        GLint baseVertex;
+        // number of welded vertices in the vertex buffer
+        GLuint numVertices;
+        // first index in the shared element buffer and number of indices of each section
+        std::vector< std::pair< GLuint, GLuint > > sections;
+    };
+    // a glDrawArrays() call over the generated vertex arrays
+    struct ArrayRange {
+        GLenum mode;
+        GLuint first;
+        GLuint count;
+    };
+    IndexedShape bufferIndexedShape( const glm::vec3* vertices, const glm::vec3* normals, const glm::vec2* texCoords, GLuint64 numVertices,
+                                     const std::vector< std::vector< ArrayRange > >& sections );
+    void drawIndexedShape( const IndexedShape& shape, size_t section );
+    CSCI441::DrawBatcher::Mesh getIndexedShapeMesh( const IndexedShape& shape, size_t section );
+
+    // every indexed shape is appended to one vertex and one element buffer, the CPU copies
+    // are kept so the buffers can be respecified under the same names as shapes are added
+    void generateShapeBuffers();
+    // deletes the shared VAO and buffers and forgets every indexed shape stored in them
+    void deleteShapeBuffers();
+    inline GLuint _shapeVAO = 0;
+    inline GLuint _shapeVBO = 0;
+    inline GLuint _shapeIBO = 0;
+    inline std::vector< GLubyte > _shapeVertexData;
+    inline std::vector< GLuint > _shapeIndexData;
+
     inline GLint _positionAttributeLocation = -1;
     inline GLint _normalAttributeLocation = -1;
     inline GLint _texCoordAttributeLocation = -1;
 
+    // interleaved float positions, packed normals and half float texture coordinates, 20 bytes per vertex
+    inline CSCI441::VertexFormat _objectVertexFormat;
+    void setObjectAttributePointers();
+
     void generateCubeVAOFlat( GLfloat sideLength );
-    void generateCubeVAOIndexed( GLfloat sideLength );
+    void generateCubeShape( GLfloat sideLength );
     inline std::map< GLfloat, GLuint > _cubeVAO;
     inline std::map< GLfloat, GLuint > _cubeVBO;
-    inline std::map< GLfloat, GLuint > _cubeVAOIndexed;
-    inline std::map< GLfloat, GLuint > _cubeVBOIndexed;
+    inline std::map< GLfloat, IndexedShape > _cubeShape;
 
     // stores data necessary to specify a unique cylinder
     struct CylinderData {
@@ -401,9 +527,8 @@ namespace CSCI441_INTERNAL {
             return false;
         }
     };
-    void generateCylinderVAO( CylinderData cylData );
-    inline std::map< CylinderData, GLuint > _cylinderVAO;
-    inline std::map< CylinderData, GLuint > _cylinderVBO;
+    void generateCylinderShape( CylinderData cylData );
+    inline std::map< CylinderData, IndexedShape > _cylinderShape;
 
     struct DiskData {
         GLfloat innerRadius, outerRadius, startAngle, sweepAngle;
@@ -459,9 +584,10 @@ namespace CSCI441_INTERNAL {
             return false;
         }
     };
-    void generateSphereVAO( SphereData sphereData );
-    inline std::map< SphereData, GLuint > _sphereVAO;
-    inline std::map< SphereData, GLuint > _sphereVBO;
+    void generateSphereShape( SphereData sphereData );
+    inline std::map< SphereData, IndexedShape > _sphereShape;
+    // sections of the sphere element buffer
+    enum SphereSection : size_t { SPHERE_FULL = 0, SPHERE_HALF = 1, SPHERE_DOME = 2 };
 
     struct TorusData {
         GLfloat innerRadius, outerRadius;
@@ -486,9 +612,8 @@ namespace CSCI441_INTERNAL {
             return false;
         }
     };
-    void generateTorusVAO( TorusData torusData );
-    inline std::map< TorusData, GLuint > _torusVAO;
-    inline std::map< TorusData, GLuint > _torusVBO;
+    void generateTorusShape( TorusData torusData );
+    inline std::map< TorusData, IndexedShape > _torusShape;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -512,6 +637,84 @@ inline void CSCI441::deleteObjectVBOs() {
     CSCI441_INTERNAL::deleteObjectVBOs();
 }
 
+[[maybe_unused]]
+inline GLuint CSCI441::getShapeVertexBuffer() {
+    CSCI441_INTERNAL::generateShapeBuffers();
+    return CSCI441_INTERNAL::_shapeVBO;
+}
+
+[[maybe_unused]]
+inline GLuint CSCI441::getShapeIndexBuffer() {
+    CSCI441_INTERNAL::generateShapeBuffers();
+    return CSCI441_INTERNAL::_shapeIBO;
+}
+
+[[maybe_unused]]
+inline const CSCI441::VertexFormat& CSCI441::getShapeVertexFormat() {
+    return CSCI441_INTERNAL::_objectVertexFormat;
+}
+
+[[maybe_unused]]
+inline CSCI441::DrawBatcher::Mesh CSCI441::getSolidCubeMesh( GLfloat sideLength ) {
+    assert( sideLength > 0.0f );
+
+    if( CSCI441_INTERNAL::_cubeShape.count( sideLength ) == 0 ) {
+        CSCI441_INTERNAL::generateCubeShape( sideLength );
+    }
+    return CSCI441_INTERNAL::getIndexedShapeMesh( CSCI441_INTERNAL::_cubeShape.find( sideLength )->second, 0 );
+}
+
+[[maybe_unused]]
+inline CSCI441::DrawBatcher::Mesh CSCI441::getSolidConeMesh( GLfloat base, GLfloat height, GLint stacks, GLint slices ) {
+    assert( base > 0.0f );
+    assert( height > 0.0f );
+    assert( stacks > 0 );
+    assert( slices > 2 );
+
+    return getSolidCylinderMesh( base, 0.0f, height, stacks, slices );
+}
+
+[[maybe_unused]]
+inline CSCI441::DrawBatcher::Mesh CSCI441::getSolidCylinderMesh( GLfloat base, GLfloat top, GLfloat height, GLint stacks, GLint slices ) {
+    assert( (base >= 0.0f && top > 0.0f) || (base > 0.0f && top >= 0.0f) );
+    assert( height > 0.0f );
+    assert( stacks > 0 );
+    assert( slices > 2 );
+
+    CSCI441_INTERNAL::CylinderData cylData = { base, top, height, static_cast<GLuint>(stacks), static_cast<GLuint>(slices) };
+    if( CSCI441_INTERNAL::_cylinderShape.count( cylData ) == 0 ) {
+        CSCI441_INTERNAL::generateCylinderShape( cylData );
+    }
+    return CSCI441_INTERNAL::getIndexedShapeMesh( CSCI441_INTERNAL::_cylinderShape.find( cylData )->second, 0 );
+}
+
+[[maybe_unused]]
+inline CSCI441::DrawBatcher::Mesh CSCI441::getSolidSphereMesh( GLfloat radius, GLint stacks, GLint slices ) {
+    assert( radius > 0.0f );
+    assert( stacks > 1 );
+    assert( slices > 2 );
+
+    CSCI441_INTERNAL::SphereData sphereData = { radius, static_cast<GLuint>(stacks), static_cast<GLuint>(slices) };
+    if( CSCI441_INTERNAL::_sphereShape.count( sphereData ) == 0 ) {
+        CSCI441_INTERNAL::generateSphereShape( sphereData );
+    }
+    return CSCI441_INTERNAL::getIndexedShapeMesh( CSCI441_INTERNAL::_sphereShape.find( sphereData )->second, CSCI441_INTERNAL::SPHERE_FULL );
+}
+
+[[maybe_unused]]
+inline CSCI441::DrawBatcher::Mesh CSCI441::getSolidTorusMesh( GLfloat innerRadius, GLfloat outerRadius, GLint sides, GLint rings ) {
+    assert( innerRadius > 0.0f );
+    assert( outerRadius > 0.0f );
+    assert( sides > 2 );
+    assert( rings > 2 );
+
+    CSCI441_INTERNAL::TorusData torusData = { innerRadius, outerRadius, static_cast<GLuint>(sides), static_cast<GLuint>(rings) };
+    if( CSCI441_INTERNAL::_torusShape.count( torusData ) == 0 ) {
+        CSCI441_INTERNAL::generateTorusShape( torusData );
+    }
+    return CSCI441_INTERNAL::getIndexedShapeMesh( CSCI441_INTERNAL::_torusShape.find( torusData )->second, 0 );
+}
+
 [[maybe_unused]]
 inline void CSCI441::drawSolidCone( GLfloat base, GLfloat height, GLint stacks, GLint slices ) {
     assert( base > 0.0f );
@@ -728,42 +931,41 @@ inline void CSCI441_INTERNAL::deleteObjectVAOs() {
     for(auto & iter : _cubeVAO) {
         glDeleteVertexArrays(1, &(iter.second));
     }
-    for(auto & iter : _cubeVAOIndexed) {
-        glDeleteVertexArrays(1, &(iter.second));
-    }
-    for(auto & iter : _cylinderVAO) {
-        glDeleteVertexArrays(1, &(iter.second));
-    }
     for(auto & iter : _diskVAO) {
         glDeleteVertexArrays(1, &(iter.second));
     }
-    for(auto & iter : _sphereVAO) {
-        glDeleteVertexArrays(1, &(iter.second));
-    }
-    for(auto & iter : _torusVAO) {
-        glDeleteVertexArrays(1, &(iter.second));
-    }
+    deleteShapeBuffers();
 }
 
 inline void CSCI441_INTERNAL::deleteObjectVBOs() {
     for(auto & iter : _cubeVBO) {
         glDeleteBuffers(1, &(iter.second));
     }
-    for(auto & iter : _cubeVBOIndexed) {
-        glDeleteBuffers(1, &(iter.second));
-    }
-    for(auto & iter : _cylinderVBO) {
-        glDeleteBuffers(1, &(iter.second));
-    }
     for(auto & iter : _diskVBO) {
         glDeleteBuffers(1, &(iter.second));
     }
-    for(auto & iter : _sphereVBO) {
-        glDeleteBuffers(1, &(iter.second));
-    }
-    for(auto & iter : _torusVBO) {
-        glDeleteBuffers(1, &(iter.second));
-    }
+    deleteShapeBuffers();
+}
+
+inline void CSCI441_INTERNAL::deleteShapeBuffers() {
+    // the VAO only reads the shared buffers, so all three go together and
+    // generateShapeBuffers() recreates them on the next shape
+    glDeleteVertexArrays(1, &_shapeVAO);
+    glDeleteBuffers(1, &_shapeVBO);
+    glDeleteBuffers(1, &_shapeIBO);
+    _shapeVAO = _shapeVBO = _shapeIBO = 0;
+
+    // the shapes referred to the deleted shared buffers
+    _shapeVertexData.clear();
+    _shapeIndexData.clear();
+    _cubeShape.clear();
+    _cylinderShape.clear();
+    _sphereShape.clear();
+    _torusShape.clear();
+}
+
+inline void CSCI441_INTERNAL::setObjectAttributePointers() {
+    _objectVertexFormat.setAttributePointers( _positionAttributeLocation, _normalAttributeLocation, _texCoordAttributeLocation );
 }
 
 inline void CSCI441_INTERNAL::drawCube( GLfloat sideLength, GLenum renderMode ) {
@@ -775,26 +977,13 @@ inline void CSCI441_INTERNAL::drawCubeFlat( GLfloat sideLength, GLenum renderMod
         CSCI441_INTERNAL::generateCubeVAOFlat( sideLength );
     }
 
-    const GLuint64 NUM_VERTICES = 36;
-
     GLint currentPolygonMode[2];
     glGetIntegerv(GL_POLYGON_MODE, currentPolygonMode);
 
     glPolygonMode( GL_FRONT_AND_BACK, renderMode );
     glBindVertexArray( CSCI441_INTERNAL::_cubeVAO.find( sideLength )->second );
     glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_cubeVBO.find( sideLength )->second );
-    if(CSCI441_INTERNAL::_positionAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_positionAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_positionAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)nullptr );
-    }
-    if(CSCI441_INTERNAL::_normalAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_normalAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_normalAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES) );
-    }
-    if(CSCI441_INTERNAL::_texCoordAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_texCoordAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_texCoordAttributeLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES * 2) );
-    }
+    CSCI441_INTERNAL::setObjectAttributePointers();
 
     glDrawArrays( GL_TRIANGLES, 0, 36 );
 
@@ -803,32 +992,15 @@ inline void CSCI441_INTERNAL::drawCubeFlat( GLfloat sideLength, GLenum renderMod
 }
 
 inline void CSCI441_INTERNAL::drawCubeIndexed( GLfloat sideLength, GLenum renderMode ) {
-    if( CSCI441_INTERNAL::_cubeVAOIndexed.count( sideLength ) == 0 ) {
-        CSCI441_INTERNAL::generateCubeVAOIndexed( sideLength );
+    if( CSCI441_INTERNAL::_cubeShape.count( sideLength ) == 0 ) {
+        CSCI441_INTERNAL::generateCubeShape( sideLength );
     }
 
-    const GLuint64 NUM_VERTICES = 8;
-
     GLint currentPolygonMode[2];
     glGetIntegerv(GL_POLYGON_MODE, currentPolygonMode);
 
     glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-    glBindVertexArray( CSCI441_INTERNAL::_cubeVAOIndexed.find( sideLength )->second );
-    glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_cubeVBOIndexed.find( sideLength )->second );
-    if(CSCI441_INTERNAL::_positionAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_positionAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_positionAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)nullptr );
-    }
-    if(CSCI441_INTERNAL::_normalAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_normalAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_normalAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES) );
-    }
-    if(CSCI441_INTERNAL::_texCoordAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_texCoordAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_texCoordAttributeLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES * 2) );
-    }
-
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_SHORT, (void*)nullptr);
+    CSCI441_INTERNAL::drawIndexedShape( CSCI441_INTERNAL::_cubeShape.find( sideLength )->second, 0 );
 
     glPolygonMode( GL_FRONT, currentPolygonMode[0] );
     glPolygonMode( GL_BACK, currentPolygonMode[1] );
@@ -836,34 +1008,15 @@ inline void CSCI441_INTERNAL::drawCubeIndexed( GLfloat sideLength, GLenum render
 
 inline void CSCI441_INTERNAL::drawCylinder( GLfloat base, GLfloat top, GLfloat height, GLuint stacks, GLuint slices, GLenum renderMode ) {
     CylinderData cylData = { base, top, height, stacks, slices };
-    if( CSCI441_INTERNAL::_cylinderVAO.count( cylData ) == 0 ) {
-        CSCI441_INTERNAL::generateCylinderVAO( cylData );
+    if( CSCI441_INTERNAL::_cylinderShape.count( cylData ) == 0 ) {
+        CSCI441_INTERNAL::generateCylinderShape( cylData );
     }
 
-    const GLuint64 NUM_VERTICES = cylData.numVertices();
-
     GLint currentPolygonMode[2];
     glGetIntegerv(GL_POLYGON_MODE, currentPolygonMode);
 
     glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-    glBindVertexArray( CSCI441_INTERNAL::_cylinderVAO.find( cylData )->second );
-    glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_cylinderVBO.find( cylData )->second );
-    if(CSCI441_INTERNAL::_positionAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_positionAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_positionAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)nullptr );
-    }
-    if(CSCI441_INTERNAL::_normalAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_normalAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_normalAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES) );
-    }
-    if(CSCI441_INTERNAL::_texCoordAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_texCoordAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_texCoordAttributeLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES * 2) );
-    }
-
-    for(GLuint stackNum = 0; stackNum < stacks; stackNum++) {
-        glDrawArrays( GL_TRIANGLE_STRIP, static_cast<GLint>((slices+1)*2*stackNum), static_cast<GLint>((slices+1)*2) );
-    }
+    CSCI441_INTERNAL::drawIndexedShape( CSCI441_INTERNAL::_cylinderShape.find( cylData )->second, 0 );
 
     glPolygonMode( GL_FRONT, currentPolygonMode[0] );
     glPolygonMode( GL_BACK, currentPolygonMode[1] );
@@ -875,26 +1028,13 @@ inline void CSCI441_INTERNAL::drawPartialDisk(GLfloat innerRadius, GLfloat outer
         CSCI441_INTERNAL::generateDiskVAO( diskData );
     }
 
-    const GLuint64 NUM_VERTICES = diskData.numVertices();
-
     GLint currentPolygonMode[2];
     glGetIntegerv(GL_POLYGON_MODE, currentPolygonMode);
 
     glPolygonMode( GL_FRONT_AND_BACK, renderMode );
     glBindVertexArray( CSCI441_INTERNAL::_diskVAO.find( diskData )->second );
     glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_diskVBO.find( diskData )->second );
-    if(CSCI441_INTERNAL::_positionAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_positionAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_positionAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)nullptr );
-    }
-    if(CSCI441_INTERNAL::_normalAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_normalAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_normalAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES) );
-    }
-    if(CSCI441_INTERNAL::_texCoordAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_texCoordAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_texCoordAttributeLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES * 2) );
-    }
+    CSCI441_INTERNAL::setObjectAttributePointers();
 
     for(GLuint ringNum = 0; ringNum < rings; ringNum++) {
         glDrawArrays( GL_TRIANGLE_STRIP, static_cast<GLint>((slices+1)*2*ringNum), static_cast<GLint>((slices+1)*2) );
@@ -906,38 +1046,15 @@ inline void CSCI441_INTERNAL::drawPartialDisk(GLfloat innerRadius, GLfloat outer
 
 inline void CSCI441_INTERNAL::drawSphere( GLfloat radius, GLuint stacks, GLuint slices, GLenum renderMode ) {
     SphereData sphereData = { radius, stacks, slices };
-    if( CSCI441_INTERNAL::_sphereVAO.count( sphereData ) == 0 ) {
-        CSCI441_INTERNAL::generateSphereVAO( sphereData );
+    if( CSCI441_INTERNAL::_sphereShape.count( sphereData ) == 0 ) {
+        CSCI441_INTERNAL::generateSphereShape( sphereData );
     }
 
-    const GLuint64 NUM_VERTICES = sphereData.numVertices();
-
     GLint currentPolygonMode[2];
     glGetIntegerv(GL_POLYGON_MODE, currentPolygonMode);
 
     glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-    glBindVertexArray( CSCI441_INTERNAL::_sphereVAO.find( sphereData )->second );
-    glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_sphereVBO.find( sphereData )->second );
-    if(CSCI441_INTERNAL::_positionAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_positionAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_positionAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)nullptr );
-    }
-    if(CSCI441_INTERNAL::_normalAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_normalAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_normalAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES) );
-    }
-    if(CSCI441_INTERNAL::_texCoordAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_texCoordAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_texCoordAttributeLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES * 2) );
-    }
-
-    glDrawArrays( GL_TRIANGLE_FAN, 0, static_cast<GLint>(slices+2) );
-
-    for(GLuint stackNum = 1; stackNum < stacks-1; stackNum++) {
-        glDrawArrays( GL_TRIANGLE_STRIP, static_cast<GLint>((slices+2) + (stackNum-1)*((slices+1)*2)), static_cast<GLint>((slices+1)*2) );
-    }
-
-    glDrawArrays( GL_TRIANGLE_FAN, static_cast<GLint>((slices+2) + (stacks-2)*(slices+1)*2), static_cast<GLint>(slices+2) );
+    CSCI441_INTERNAL::drawIndexedShape( CSCI441_INTERNAL::_sphereShape.find( sphereData )->second, SPHERE_FULL );
 
     glPolygonMode( GL_FRONT, currentPolygonMode[0] );
     glPolygonMode( GL_BACK, currentPolygonMode[1] );
@@ -945,38 +1062,15 @@ inline void CSCI441_INTERNAL::drawSphere( GLfloat radius, GLuint stacks, GLuint
 
 inline void CSCI441_INTERNAL::drawHalfSphere( GLfloat radius, GLuint stacks, GLuint slices, GLenum renderMode ) {
     SphereData sphereData = { radius, stacks, slices };
-    if( CSCI441_INTERNAL::_sphereVAO.count( sphereData ) == 0 ) {
-        CSCI441_INTERNAL::generateSphereVAO( sphereData );
+    if( CSCI441_INTERNAL::_sphereShape.count( sphereData ) == 0 ) {
+        CSCI441_INTERNAL::generateSphereShape( sphereData );
     }
 
-    const GLuint64 NUM_VERTICES = sphereData.numVertices();
-
     GLint currentPolygonMode[2];
     glGetIntegerv(GL_POLYGON_MODE, currentPolygonMode);
 
     glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-    glBindVertexArray( CSCI441_INTERNAL::_sphereVAO.find( sphereData )->second );
-    glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_sphereVBO.find( sphereData )->second );
-    if(CSCI441_INTERNAL::_positionAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_positionAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_positionAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)nullptr );
-    }
-    if(CSCI441_INTERNAL::_normalAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_normalAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_normalAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES) );
-    }
-    if(CSCI441_INTERNAL::_texCoordAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_texCoordAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_texCoordAttributeLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES * 2) );
-    }
-
-    glDrawArrays( GL_TRIANGLE_FAN, static_cast<GLint>((slices+2)/2), static_cast<GLint>((slices+2)/2) );
-
-    for(GLuint stackNum = 1; stackNum < stacks-1; stackNum++) {
-        glDrawArrays( GL_TRIANGLE_STRIP, static_cast<GLint>((slices+2) + (stackNum-1)*((slices+1)*2)), static_cast<GLint>(slices+2) );
-    }
-
-    glDrawArrays( GL_TRIANGLE_FAN, static_cast<GLint>((slices+2) + (stacks-2)*(slices+1)*2), static_cast<GLint>((slices+2)/2) );
+    CSCI441_INTERNAL::drawIndexedShape( CSCI441_INTERNAL::_sphereShape.find( sphereData )->second, SPHERE_HALF );
 
     glPolygonMode( GL_FRONT, currentPolygonMode[0] );
     glPolygonMode( GL_BACK, currentPolygonMode[1] );
@@ -986,36 +1080,15 @@ inline void CSCI441_INTERNAL::drawHalfSphere( GLfloat radius, GLuint stacks, GLu
 
 inline void CSCI441_INTERNAL::drawDome( GLfloat radius, GLuint stacks, GLuint slices, GLenum renderMode ) {
     SphereData sphereData = { radius, stacks, slices };
-    if( CSCI441_INTERNAL::_sphereVAO.count( sphereData ) == 0 ) {
-        CSCI441_INTERNAL::generateSphereVAO( sphereData );
+    if( CSCI441_INTERNAL::_sphereShape.count( sphereData ) == 0 ) {
+        CSCI441_INTERNAL::generateSphereShape( sphereData );
     }
 
-    const GLuint64 NUM_VERTICES = sphereData.numVertices();
-
     GLint currentPolygonMode[2];
     glGetIntegerv(GL_POLYGON_MODE, currentPolygonMode);
 
     glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-    glBindVertexArray( CSCI441_INTERNAL::_sphereVAO.find( sphereData )->second );
-    glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_sphereVBO.find( sphereData )->second );
-    if(CSCI441_INTERNAL::_positionAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_positionAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_positionAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)nullptr );
-    }
-    if(CSCI441_INTERNAL::_normalAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_normalAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_normalAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES) );
-    }
-    if(CSCI441_INTERNAL::_texCoordAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_texCoordAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_texCoordAttributeLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES * 2) );
-    }
-
-    glDrawArrays( GL_TRIANGLE_FAN, 0, static_cast<GLint>(slices+2) );
-
-    for(GLuint stackNum = (stacks-1)/2; stackNum < stacks-1; stackNum++) {
-        glDrawArrays( GL_TRIANGLE_STRIP, static_cast<GLint>((slices+2) + (stackNum-1)*((slices+1)*2)), static_cast<GLint>((slices+1)*2) );
-    }
+    CSCI441_INTERNAL::drawIndexedShape( CSCI441_INTERNAL::_sphereShape.find( sphereData )->second, SPHERE_DOME );
 
     glPolygonMode( GL_FRONT, currentPolygonMode[0] );
     glPolygonMode( GL_BACK, currentPolygonMode[1] );
@@ -1023,34 +1096,15 @@ inline void CSCI441_INTERNAL::drawDome( GLfloat radius, GLuint stacks, GLuint sl
 
 inline void CSCI441_INTERNAL::drawTorus( GLfloat innerRadius, GLfloat outerRadius, GLuint sides, GLuint rings, GLenum renderMode ) {
     TorusData torusData = { innerRadius, outerRadius, sides, rings };
-    if( CSCI441_INTERNAL::_torusVAO.count( torusData ) == 0 ) {
-        CSCI441_INTERNAL::generateTorusVAO( torusData );
+    if( CSCI441_INTERNAL::_torusShape.count( torusData ) == 0 ) {
+        CSCI441_INTERNAL::generateTorusShape( torusData );
     }
 
-    const GLuint64 NUM_VERTICES = torusData.numVertices();
-
     GLint currentPolygonMode[2];
     glGetIntegerv(GL_POLYGON_MODE, currentPolygonMode);
 
     glPolygonMode( GL_FRONT_AND_BACK, renderMode );
-    glBindVertexArray( CSCI441_INTERNAL::_torusVAO.find( torusData )->second );
-    glBindBuffer( GL_ARRAY_BUFFER, CSCI441_INTERNAL::_torusVBO.find( torusData )->second );
-    if(CSCI441_INTERNAL::_positionAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_positionAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_positionAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)nullptr );
-    }
-    if(CSCI441_INTERNAL::_normalAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_normalAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_normalAttributeLocation, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES) );
-    }
-    if(CSCI441_INTERNAL::_texCoordAttributeLocation != -1) {
-        glEnableVertexAttribArray( CSCI441_INTERNAL::_texCoordAttributeLocation );
-        glVertexAttribPointer( CSCI441_INTERNAL::_texCoordAttributeLocation, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(glm::vec3) * NUM_VERTICES * 2) );
-    }
-
-    for(GLuint ringNum = 0; ringNum < rings; ringNum++) {
-        glDrawArrays( GL_TRIANGLE_STRIP, static_cast<GLint>(ringNum*sides*4), static_cast<GLint>(sides*4) );
-    }
+    CSCI441_INTERNAL::drawIndexedShape( CSCI441_INTERNAL::_torusShape.find( torusData )->second, 0 );
 
     glPolygonMode( GL_FRONT, currentPolygonMode[0] );
     glPolygonMode( GL_BACK, currentPolygonMode[1] );
@@ -1066,6 +1120,107 @@ inline void CSCI441_INTERNAL::drawTeapot( GLenum renderMode ) {
     glPolygonMode( GL_BACK, currentPolygonMode[1] );
 }
 
+inline CSCI441_INTERNAL::IndexedShape CSCI441_INTERNAL::bufferIndexedShape( const glm::vec3* vertices, const glm::vec3* normals, const glm::vec2* texCoords, const GLuint64 numVertices,
+                                                                              const std::vector< std::vector< ArrayRange > >& sections ) {
+    // weld the vertices strips and fans share
+    std::map< std::array< GLfloat, 8 >, GLuint > uniqueVertices;
+    std::vector< GLuint > welded( numVertices );
+    std::vector< glm::vec3 > weldedVertices, weldedNormals;
+    std::vector< glm::vec2 > weldedTexCoords;
+    for(GLuint64 i = 0; i < numVertices; i++) {
+        const std::array< GLfloat, 8 > key = { vertices[i].x, vertices[i].y, vertices[i].z,
+                                               normals[i].x, normals[i].y, normals[i].z,
+                                               texCoords[i].s, texCoords[i].t };
+        auto iter = uniqueVertices.find( key );
+        if( iter == uniqueVertices.end() ) {
+            iter = uniqueVertices.insert( std::pair< std::array< GLfloat, 8 >, GLuint >( key, static_cast<GLuint>(weldedVertices.size()) ) ).first;
+            weldedVertices.push_back( vertices[i] );
+            weldedNormals.push_back( normals[i] );
+            weldedTexCoords.push_back( texCoords[i] );
+        }
+        welded[i] = iter->second;
+    }
+    const auto NUM_WELDED = static_cast<GLuint>( weldedVertices.size() );
+
+    // triangulate each section, keeping the winding the strips and fans had, and order it for the vertex cache
+    generateShapeBuffers();
+    const auto FIRST_INDEX = static_cast<GLuint>( _shapeIndexData.size() );
+    const auto BASE_VERTEX = static_cast<GLint>( _shapeVertexData.size() / _objectVertexFormat.getStride() );
+    IndexedShape shape = { BASE_VERTEX, NUM_WELDED, {} };
+    std::vector< GLuint > indices;
+    for(const auto& section : sections) {
+        const auto sectionStart = static_cast<GLuint>( indices.size() );
+        for(const auto& range : section) {
+            for(GLuint i = 0; i + 2 < range.count; i += (range.mode == GL_TRIANGLES ? 3 : 1)) {
+                GLuint a, b, c;
+                if( range.mode == GL_TRIANGLES ) {
+                    a = welded[range.first + i]; b = welded[range.first + i + 1]; c = welded[range.first + i + 2];
+                } else if( range.mode == GL_TRIANGLE_FAN ) {
+                    a = welded[range.first]; b = welded[range.first + i + 1]; c = welded[range.first + i + 2];
+                } else if( i % 2 == 0 ) {
+                    a = welded[range.first + i]; b = welded[range.first + i + 1]; c = welded[range.first + i + 2];
+                } else {
+                    a = welded[range.first + i + 1]; b = welded[range.first + i]; c = welded[range.first + i + 2];
+                }
+                if( a == b || b == c || a == c ) continue;
+                indices.push_back( a ); indices.push_back( b ); indices.push_back( c );
+            }
+        }
+        const auto sectionLength = static_cast<GLuint>( indices.size() ) - sectionStart;
+        CSCI441::IndexOptimizer::optimizeVertexCache( indices.data() + sectionStart, sectionLength, NUM_WELDED );
+        shape.sections.emplace_back( FIRST_INDEX + sectionStart, sectionLength );
+    }
+
+    // order vertices by first use, the first section being the one drawn most often
+    const auto remap = CSCI441::IndexOptimizer::optimizeVertexFetch( indices.data(), static_cast<GLuint>( indices.size() ), NUM_WELDED );
+    CSCI441::IndexOptimizer::remapVertices( weldedVertices.data(), remap );
+    CSCI441::IndexOptimizer::remapVertices( weldedNormals.data(), remap );
+    CSCI441::IndexOptimizer::remapVertices( weldedTexCoords.data(), remap );
+
+    // append to the shared buffers, indices stay relative to the shape's base vertex
+    const std::vector< GLubyte > packed = _objectVertexFormat.pack( weldedVertices.data(), weldedNormals.data(), weldedTexCoords.data(), NUM_WELDED );
+    _shapeVertexData.insert( _shapeVertexData.end(), packed.begin(), packed.end() );
+    _shapeIndexData.insert( _shapeIndexData.end(), indices.begin(), indices.end() );
+
+    glBindVertexArray( _shapeVAO );
+    glBindBuffer( GL_ARRAY_BUFFER, _shapeVBO );
+    glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(_shapeVertexData.size()), _shapeVertexData.data(), GL_STATIC_DRAW );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _shapeIBO );
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(GLuint) * _shapeIndexData.size()), _shapeIndexData.data(), GL_STATIC_DRAW );
+
+    return shape;
+}
+
+inline void CSCI441_INTERNAL::drawIndexedShape( const IndexedShape& shape, const size_t section ) {
+    glBindVertexArray( _shapeVAO );
+    glBindBuffer( GL_ARRAY_BUFFER, _shapeVBO );
+    CSCI441_INTERNAL::setObjectAttributePointers();
+
+    const auto& range = shape.sections[section];
+    glDrawElementsBaseVertex( GL_TRIANGLES, static_cast<GLsizei>(range.second), GL_UNSIGNED_INT, (void*)(sizeof(GLuint) * range.first), shape.baseVertex );
+}
+
+inline CSCI441::DrawBatcher::Mesh CSCI441_INTERNAL::getIndexedShapeMesh( const IndexedShape& shape, const size_t section ) {
+    const auto& range = shape.sections[section];
+    CSCI441::DrawBatcher::Mesh mesh;
+    mesh.numIndices = range.second;
+    mesh.firstIndex = range.first;
+    mesh.baseVertex = shape.baseVertex;
+    return mesh;
+}
+
+inline void CSCI441_INTERNAL::generateShapeBuffers() {
+    if( _shapeVAO != 0 ) return;
+
+    glGenVertexArrays( 1, &_shapeVAO );
+    glBindVertexArray( _shapeVAO );
+
+    glGenBuffers( 1, &_shapeVBO );
+    glGenBuffers( 1, &_shapeIBO );
+    glBindBuffer( GL_ARRAY_BUFFER, _shapeVBO );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, _shapeIBO );
+}
+
 inline void CSCI441_INTERNAL::generateCubeVAOFlat( GLfloat sideLength ) {
     GLuint vaod;
     glGenVertexArrays( 1, &vaod );
@@ -1140,16 +1295,13 @@ inline void CSCI441_INTERNAL::generateCubeVAOFlat( GLfloat sideLength ) {
             {0.0f, 1.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}
     };
 
-    glBufferData(GL_ARRAY_BUFFER, (sizeof(glm::vec3)*2 + sizeof(glm::vec2)) * NUM_VERTICES, nullptr, GL_STATIC_DRAW );
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec3) * NUM_VERTICES, vertices );
-    glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * NUM_VERTICES, sizeof(glm::vec3) * NUM_VERTICES, normals );
-    glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * NUM_VERTICES * 2, sizeof(glm::vec2) * NUM_VERTICES, texCoords );
+    _objectVertexFormat.bufferData( vertices, normals, texCoords, NUM_VERTICES );
 
     CSCI441_INTERNAL::_cubeVAO.insert( std::pair<GLfloat, GLuint>( sideLength, vaod ) );
     CSCI441_INTERNAL::_cubeVBO.insert( std::pair<GLfloat, GLuint>( sideLength, vbod ) );
 }
 
-inline void CSCI441_INTERNAL::generateCubeVAOIndexed( GLfloat sideLength ) {
+inline void CSCI441_INTERNAL::generateCubeShape( GLfloat sideLength ) {
     const GLfloat CORNER_POINT = sideLength / 2.0f;
 
     const GLuint64 NUM_VERTICES = 8;
@@ -1174,15 +1326,15 @@ inline void CSCI441_INTERNAL::generateCubeVAOIndexed( GLfloat sideLength ) {
             { 1.0f,  1.0f,  1.0f}, // 6 trf
             {-1.0f,  1.0f,  1.0f}  // 7 tlf
     };
-    glm::vec3 texCoords[NUM_VERTICES] = {
-            {-1.0f, -1.0f, -1.0f}, // 0 bln
-            { 1.0f, -1.0f, -1.0f}, // 1.0f brn
-            { 1.0f,  1.0f, -1.0f}, // 2 trn
-            {-1.0f,  1.0f, -1.0f}, // 3 tln
-            {-1.0f, -1.0f,  1.0f}, // 4 blf
-            { 1.0f, -1.0f,  1.0f}, // 5 brf
-            { 1.0f,  1.0f,  1.0f}, // 6 trf
-            {-1.0f,  1.0f,  1.0f}  // 7 tlf
+    glm::vec2 texCoords[NUM_VERTICES] = {
+            {-1.0f, -1.0f}, // 0 bln
+            { 1.0f, -1.0f}, // 1 brn
+            { 1.0f,  1.0f}, // 2 trn
+            {-1.0f,  1.0f}, // 3 tln
+            {-1.0f, -1.0f}, // 4 blf
+            { 1.0f, -1.0f}, // 5 brf
+            { 1.0f,  1.0f}, // 6 trf
+            {-1.0f,  1.0f}  // 7 tlf
     };
     GLushort indices[36] = {
             0, 2, 1,   0, 3, 2, // near
@@ -1193,35 +1345,22 @@ inline void CSCI441_INTERNAL::generateCubeVAOIndexed( GLfloat sideLength ) {
             0, 4, 3,   4, 7, 3  // left
     };
 
-    GLuint vaod;
-    glGenVertexArrays( 1, &vaod );
-    glBindVertexArray( vaod );
-
-    GLuint vbods[2];
-    glGenBuffers( 2, vbods );
-
-    glBindBuffer( GL_ARRAY_BUFFER, vbods[0] );
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * NUM_VERTICES * 3, nullptr, GL_STATIC_DRAW );
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec3) * NUM_VERTICES, vertices  );
-    glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * NUM_VERTICES, sizeof(glm::vec3) * NUM_VERTICES, normals   );
-    glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * NUM_VERTICES * 2, sizeof(glm::vec3) * NUM_VERTICES, texCoords );
+    // expanded to a triangle list so it is welded and ordered like the other indexed shapes
+    glm::vec3 triangleVertices[36], triangleNormals[36];
+    glm::vec2 triangleTexCoords[36];
+    for(GLuint i = 0; i < 36; i++) {
+        triangleVertices[i]  = vertices[ indices[i] ];
+        triangleNormals[i]   = normals[ indices[i] ];
+        triangleTexCoords[i] = texCoords[ indices[i] ];
+    }
 
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, vbods[1] );
-    glBufferData( GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW) ;
+    std::vector< ArrayRange > triangles;
+    triangles.push_back( { GL_TRIANGLES, 0, 36 } );
 
-    CSCI441_INTERNAL::_cubeVAOIndexed.insert( std::pair<GLfloat, GLuint>( sideLength, vaod ) );
-    CSCI441_INTERNAL::_cubeVBOIndexed.insert( std::pair<GLfloat, GLuint>( sideLength, vbods[0] ) );
+    CSCI441_INTERNAL::_cubeShape.insert( std::pair<GLfloat, IndexedShape>( sideLength, bufferIndexedShape( triangleVertices, triangleNormals, triangleTexCoords, 36, { triangles } ) ) );
 }
 
-inline void CSCI441_INTERNAL::generateCylinderVAO( CylinderData cylData ) {
-    GLuint vaod;
-    glGenVertexArrays( 1, &vaod );
-    glBindVertexArray( vaod );
-
-    GLuint vbod;
-    glGenBuffers( 1, &vbod );
-    glBindBuffer( GL_ARRAY_BUFFER, vbod );
-
+inline void CSCI441_INTERNAL::generateCylinderShape( CylinderData cylData ) {
     const GLuint64 NUM_VERTICES = cylData.numVertices();
 
     GLfloat sliceStep = glm::two_pi<float>() / (GLfloat)cylData.slices;
@@ -1266,13 +1405,12 @@ inline void CSCI441_INTERNAL::generateCylinderVAO( CylinderData cylData ) {
         }
     }
 
-    glBufferData(GL_ARRAY_BUFFER, (sizeof(glm::vec3)*2 + sizeof(glm::vec2)) * NUM_VERTICES, nullptr, GL_STATIC_DRAW );
-    glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(sizeof(glm::vec3) * NUM_VERTICES), vertices );
-    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(sizeof(glm::vec3) * NUM_VERTICES), static_cast<GLsizeiptr>(sizeof(glm::vec3) * NUM_VERTICES), normals );
-    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(sizeof(glm::vec3) * NUM_VERTICES * 2), static_cast<GLsizeiptr>(sizeof(glm::vec2) * NUM_VERTICES), texCoords );
+    std::vector< ArrayRange > strips;
+    for(GLuint stackNum = 0; stackNum < cylData.stacks; stackNum++) {
+        strips.push_back( { GL_TRIANGLE_STRIP, (cylData.slices+1)*2*stackNum, (cylData.slices+1)*2 } );
+    }
 
-    CSCI441_INTERNAL::_cylinderVAO.insert( std::pair<CylinderData, GLuint>( cylData, vaod ) );
-    CSCI441_INTERNAL::_cylinderVBO.insert( std::pair<CylinderData, GLuint>( cylData, vbod ) );
+    CSCI441_INTERNAL::_cylinderShape.insert( std::pair<CylinderData, IndexedShape>( cylData, bufferIndexedShape( vertices, normals, texCoords, NUM_VERTICES, { strips } ) ) );
 
     delete[] vertices;
     delete[] texCoords;
@@ -1334,10 +1472,7 @@ inline void CSCI441_INTERNAL::generateDiskVAO( DiskData diskData ) {
         }
     }
 
-    glBufferData(GL_ARRAY_BUFFER, (sizeof(glm::vec3)*2 + sizeof(glm::vec2)) * NUM_VERTICES, nullptr, GL_STATIC_DRAW );
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec3) * NUM_VERTICES, vertices );
-    glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * NUM_VERTICES, sizeof(glm::vec3) * NUM_VERTICES, normals );
-    glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * NUM_VERTICES * 2, sizeof(glm::vec2) * NUM_VERTICES, texCoords );
+    _objectVertexFormat.bufferData( vertices, normals, texCoords, NUM_VERTICES );
 
     CSCI441_INTERNAL::_diskVAO.insert( std::pair<DiskData, GLuint>( diskData, vaod ) );
     CSCI441_INTERNAL::_diskVBO.insert( std::pair<DiskData, GLuint>( diskData, vbod ) );
@@ -1347,15 +1482,7 @@ inline void CSCI441_INTERNAL::generateDiskVAO( DiskData diskData ) {
     delete[] normals;
 }
 
-inline void CSCI441_INTERNAL::generateSphereVAO( SphereData sphereData ) {
-    GLuint vaod;
-    glGenVertexArrays( 1, &vaod );
-    glBindVertexArray( vaod );
-
-    GLuint vbod;
-    glGenBuffers( 1, &vbod );
-    glBindBuffer( GL_ARRAY_BUFFER, vbod );
-
+inline void CSCI441_INTERNAL::generateSphereShape( SphereData sphereData ) {
     const GLuint64 NUM_VERTICES = sphereData.numVertices();
 
     GLfloat sliceStep = glm::two_pi<float>() / (GLfloat)sphereData.slices;
@@ -1508,28 +1635,30 @@ inline void CSCI441_INTERNAL::generateSphereVAO( SphereData sphereData ) {
     texCoords[ idx ].s = 0.0f;
     texCoords[ idx ].t = 0.0f;
 
-    glBufferData(GL_ARRAY_BUFFER, (sizeof(glm::vec3)*2 + sizeof(glm::vec2)) * NUM_VERTICES, nullptr, GL_STATIC_DRAW );
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec3) * NUM_VERTICES, vertices );
-    glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * NUM_VERTICES, sizeof(glm::vec3) * NUM_VERTICES, normals );
-    glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * NUM_VERTICES * 2, sizeof(glm::vec2) * NUM_VERTICES, texCoords );
+    // the same ranges the sphere, half sphere, and dome were drawn with as arrays
+    const GLuint stacks = sphereData.stacks, slices = sphereData.slices;
+    const GLuint bottomFan = (slices+2) + (stacks-2)*(slices+1)*2;
+    std::vector< ArrayRange > full, half, dome;
+    full.push_back( { GL_TRIANGLE_FAN, 0, slices+2 } );
+    half.push_back( { GL_TRIANGLE_FAN, (slices+2)/2, (slices+2)/2 } );
+    dome.push_back( { GL_TRIANGLE_FAN, 0, slices+2 } );
+    for(GLuint stackNum = 1; stackNum < stacks-1; stackNum++) {
+        const GLuint first = (slices+2) + (stackNum-1)*((slices+1)*2);
+        full.push_back( { GL_TRIANGLE_STRIP, first, (slices+1)*2 } );
+        half.push_back( { GL_TRIANGLE_STRIP, first, slices+2 } );
+        if( stackNum >= (stacks-1)/2 ) dome.push_back( { GL_TRIANGLE_STRIP, first, (slices+1)*2 } );
+    }
+    full.push_back( { GL_TRIANGLE_FAN, bottomFan, slices+2 } );
+    half.push_back( { GL_TRIANGLE_FAN, bottomFan, (slices+2)/2 } );
 
-    CSCI441_INTERNAL::_sphereVAO.insert( std::pair<SphereData, GLuint>( sphereData, vaod ) );
-    CSCI441_INTERNAL::_sphereVBO.insert( std::pair<SphereData, GLuint>( sphereData, vbod ) );
+    CSCI441_INTERNAL::_sphereShape.insert( std::pair<SphereData, IndexedShape>( sphereData, bufferIndexedShape( vertices, normals, texCoords, NUM_VERTICES, { full, half, dome } ) ) );
 
     delete[] vertices;
     delete[] texCoords;
     delete[] normals;
 }
 
-inline void CSCI441_INTERNAL::generateTorusVAO( TorusData torusData ) {
-    GLuint vaod;
-    glGenVertexArrays( 1, &vaod );
-    glBindVertexArray( vaod );
-
-    GLuint vbod;
-    glGenBuffers( 1, &vbod );
-    glBindBuffer( GL_ARRAY_BUFFER, vbod );
-
+inline void CSCI441_INTERNAL::generateTorusShape( TorusData torusData ) {
     const GLuint64 NUM_VERTICES = torusData.numVertices();
 
     auto vertices  = new glm::vec3[NUM_VERTICES];
@@ -1603,13 +1732,12 @@ inline void CSCI441_INTERNAL::generateTorusVAO( TorusData torusData ) {
         }
     }
 
-    glBufferData(GL_ARRAY_BUFFER, (sizeof(glm::vec3)*2 + sizeof(glm::vec2)) * NUM_VERTICES, nullptr, GL_STATIC_DRAW );
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec3) * NUM_VERTICES, vertices );
-    glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * NUM_VERTICES, sizeof(glm::vec3) * NUM_VERTICES, normals );
-    glBufferSubData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * NUM_VERTICES * 2, sizeof(glm::vec2) * NUM_VERTICES, texCoords );
+    std::vector< ArrayRange > strips;
+    for(GLuint ringNum = 0; ringNum < torusData.rings; ringNum++) {
+        strips.push_back( { GL_TRIANGLE_STRIP, ringNum*torusData.sides*4, torusData.sides*4 } );
+    }
 
-    CSCI441_INTERNAL::_torusVAO.insert( std::pair<TorusData, GLuint>( torusData, vaod ) );
-    CSCI441_INTERNAL::_torusVBO.insert( std::pair<TorusData, GLuint>( torusData, vbod ) );
+    CSCI441_INTERNAL::_torusShape.insert( std::pair<TorusData, IndexedShape>( torusData, bufferIndexedShape( vertices, normals, texCoords, NUM_VERTICES, { strips } ) ) );
 
     delete[] vertices;
     delete[] texCoords;
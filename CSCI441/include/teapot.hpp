@@ -23,9 +23,12 @@
     #include <glad/gl.h>
 #endif
 
+#include "VertexFormat.hpp"
+
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <vector>
 
 namespace CSCI441_INTERNAL {
 
@@ -57,6 +60,8 @@ namespace CSCI441_INTERNAL {
 
     inline GLuint teapot_vao;
     inline GLuint teapot_vbo, teapot_ibo;
+    // uploaded interleaved with packed normals and half float texture coordinates
+    inline CSCI441::VertexFormat teapot_vertex_format;
 
     inline glm::vec3 teapot_cp_vertices[] = {
             // 1
@@ -549,9 +554,16 @@ namespace CSCI441_INTERNAL {
         glGenVertexArrays(1, &teapot_vao);
         glBindVertexArray(teapot_vao);
 
+        // positions, normals, and texture coordinates are built one after the other
+        const GLuint NUM_VERTICES = TEAPOT_NUMBER_PATCHES * TEAPOT_RES_U * TEAPOT_RES_V;
+        std::vector<glm::vec2> texCoords(NUM_VERTICES);
+        for(GLuint i = 0; i < NUM_VERTICES; i++) {
+            texCoords[i] = glm::vec2( teapot_vertices[NUM_VERTICES * 2 + i] );
+        }
+
         glGenBuffers(1, &teapot_vbo);
         glBindBuffer(GL_ARRAY_BUFFER, teapot_vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(teapot_vertices), teapot_vertices, GL_STATIC_DRAW);
+        teapot_vertex_format.bufferData(teapot_vertices, teapot_vertices + NUM_VERTICES, texCoords.data(), NUM_VERTICES);
 
         glGenBuffers(1, &teapot_ibo);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, teapot_ibo);
@@ -590,39 +602,7 @@ namespace CSCI441_INTERNAL {
         teapot_tex_attr_loc = texCoordLocation;
 
         // Describe our vertices array to OpenGL (it can't guess its format automatically)
-        if(teapot_pos_attr_loc != -1) {
-            glEnableVertexAttribArray(teapot_pos_attr_loc);
-            glVertexAttribPointer(
-                    teapot_pos_attr_loc,  // attribute
-                    3,                 // number of elements per vertex, here (x,y,z)
-                    GL_FLOAT,          // the type of each element
-                    GL_FALSE,          // take our values as-is
-                    0,                 // no extra data between each position
-                    nullptr            // offset of first element
-            );
-        }
-        if(teapot_norm_attr_loc != -1) {
-            glEnableVertexAttribArray(teapot_norm_attr_loc);
-            glVertexAttribPointer(
-                    teapot_norm_attr_loc,  // attribute
-                    3,                 // number of elements per vertex, here (x,y,z)
-                    GL_FLOAT,          // the type of each element
-                    GL_FALSE,          // take our values as-is
-                    0,                 // no extra data between each position
-                    (void*)(TEAPOT_NUMBER_PATCHES * TEAPOT_RES_U * TEAPOT_RES_V * sizeof(glm::vec3))                  // offset of first element
-            );
-        }
-        if(teapot_tex_attr_loc != -1) {
-            glEnableVertexAttribArray(teapot_tex_attr_loc);
-            glVertexAttribPointer(
-                    teapot_tex_attr_loc,  // attribute
-                    2,                 // number of elements per vertex, here (s,t)
-                    GL_FLOAT,          // the type of each element
-                    GL_FALSE,          // take our values as-is
-                    sizeof(glm::vec3),                 // no extra data between each position
-                    (void*)(TEAPOT_NUMBER_PATCHES * TEAPOT_RES_U * TEAPOT_RES_V * 2 * sizeof(glm::vec3))                  // offset of first element
-            );
-        }
+        teapot_vertex_format.setAttributePointers(teapot_pos_attr_loc, teapot_norm_attr_loc, teapot_tex_attr_loc);
     }
 
     inline void teapot() {
@@ -1,54 +1,47 @@
 #include "Coin.h"
 
 #include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
 
 #include <objects.hpp>
 #include <OpenGLUtils.hpp>
 
-Coin::Coin(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation)
-    : _shaderProgramHandle(shaderProgramHandle),
-    _isActive(true){
+// Teselación de la esfera para cada nivel de detalle
+static const GLint SPHERE_RESOLUTION[] = { 20, 12, 8, 6 };
 
-    _shaderProgramUniformLocations.mvpMtx = mvpMtxUniformLocation;
-    _shaderProgramUniformLocations.normalMtx = normalMtxUniformLocation;
-
-    _shaderProgramUniformLocations.materialAmbientColor  = glGetUniformLocation(_shaderProgramHandle, "materialAmbientColor");
-    _shaderProgramUniformLocations.materialDiffuseColor  = glGetUniformLocation(_shaderProgramHandle, "materialDiffuseColor");
-    _shaderProgramUniformLocations.materialSpecularColor = glGetUniformLocation(_shaderProgramHandle, "materialSpecularColor");
-    _shaderProgramUniformLocations.materialShininess     = glGetUniformLocation(_shaderProgramHandle, "materialShininess");
+Coin::Coin(CSCI441::TransformHierarchy* transforms)
+    : _isActive(true),
+    _transforms(transforms) {
 
     _colorBody = glm::vec3(1.0f, 0.84f, 0.0f); // Color dorado
     _scaleBody = glm::vec3(1.0f);  // Ajusta el tamaño según tus necesidades
-}
-
-void Coin::drawCoin(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) {
-    glm::mat4 coinMtx = modelMtx;
-    coinMtx = glm::scale(coinMtx, _scaleBody);
-
-    _computeAndSendMatrixUniforms(coinMtx, viewMtx, projMtx);
 
-    _setMaterialColors(_colorBody, 32.0f);
-
-    // Dibujar una esfera para representar la moneda
-    CSCI441::drawSolidSphere(1.0f, 20, 20);
+    _bodyNode = _transforms->addNode();
 }
 
-void Coin::_computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 mvpMtx = projMtx * viewMtx * modelMtx;
-    glProgramUniformMatrix4fv(_shaderProgramHandle, _shaderProgramUniformLocations.mvpMtx, 1, GL_FALSE, glm::value_ptr(mvpMtx));
-
-    glm::mat3 normalMtx = glm::mat3(glm::transpose(glm::inverse(modelMtx)));
-    glProgramUniformMatrix3fv(_shaderProgramHandle, _shaderProgramUniformLocations.normalMtx, 1, GL_FALSE, glm::value_ptr(normalMtx));
+void Coin::setModelMatrix(const glm::mat4& modelMtx) {
+    _transforms->setLocalMatrix(_bodyNode, glm::scale(modelMtx, _scaleBody));
 }
 
-void Coin::_setMaterialColors(glm::vec3 color, float shininess) const {
-    glm::vec3 ambientColor  = color * 0.2f;
-    glm::vec3 diffuseColor  = color;
-    glm::vec3 specularColor = glm::vec3(0.5f);
+void Coin::drawCoin(CSCI441::DrawBatcher& batcher, const glm::mat4& viewMtx, const glm::mat4& projMtx, const glm::mat4& viewProjMtx) {
+    CSCI441::DrawBatcher::DrawData drawData;
+    drawData.mvpMtx    = viewProjMtx * _transforms->getWorldMatrix(_bodyNode);
+    drawData.normalMtx = _transforms->getNormalMatrix(_bodyNode);
+
+    drawData.materialAmbientColor  = _colorBody * 0.2f;
+    drawData.materialDiffuseColor  = _colorBody;
+    drawData.materialSpecularColor = glm::vec3(0.5f);
+    drawData.materialShininess     = 32.0f;
+
+    // Dibujar una esfera para representar la moneda, con menos caras cuanto más lejos esté
+    glm::vec3 center;
+    float radius;
+    getBoundingSphere(center, radius);
+    GLuint levelOfDetail = _lodSelector.select(center, radius, viewMtx, projMtx);
+    batcher.add(CSCI441::getSolidSphereMesh(1.0f, SPHERE_RESOLUTION[levelOfDetail], SPHERE_RESOLUTION[levelOfDetail]), drawData);
+}
 
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialAmbientColor, 1, glm::value_ptr(ambientColor));
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialDiffuseColor, 1, glm::value_ptr(diffuseColor));
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialSpecularColor, 1, glm::value_ptr(specularColor));
-    glProgramUniform1f(_shaderProgramHandle, _shaderProgramUniformLocations.materialShininess, shininess);
+void Coin::getBoundingSphere(glm::vec3& center, float& radius) const {
+    const glm::mat4& coinMtx = _transforms->getWorldMatrix(_bodyNode);
+    center = glm::vec3(coinMtx[3]);
+    radius = glm::length(glm::vec3(coinMtx[0]));
 }
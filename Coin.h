@@ -5,34 +5,40 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 
+#include <DrawBatcher.hpp>
+#include <LODSelector.hpp>
+#include <TransformHierarchy.hpp>
+
 class Coin {
 public:
- Coin(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation);
+ explicit Coin(CSCI441::TransformHierarchy* transforms);
+
+ // Coloca la moneda, solo se recalcula si la matriz cambió
+ void setModelMatrix(const glm::mat4& modelMtx);
 
- void drawCoin(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx);
+ // Añade la moneda al lote con las matrices ya calculadas en la jerarquía
+ void drawCoin(CSCI441::DrawBatcher& batcher, const glm::mat4& viewMtx, const glm::mat4& projMtx, const glm::mat4& viewProjMtx);
+
+ // Esfera envolvente en coordenadas de mundo, para descartar la moneda en las vistas que no la ven
+ void getBoundingSphere(glm::vec3& center, float& radius) const;
 
 
  void deactivate() { _isActive = false; }
+ void reactivate() { _isActive = true; }
 
  bool isActive() const { return _isActive; }
 
 private:
  bool _isActive;
- GLuint _shaderProgramHandle;
- struct ShaderProgramUniformLocations {
-  GLint mvpMtx;
-  GLint normalMtx;
-  GLint materialAmbientColor;
-  GLint materialDiffuseColor;
-  GLint materialSpecularColor;
-  GLint materialShininess;
- } _shaderProgramUniformLocations;
 
  glm::vec3 _colorBody;
  glm::vec3 _scaleBody;
 
- void _computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
- void _setMaterialColors(glm::vec3 color, float shininess) const;
+ // Nivel de detalle elegido según el tamaño de la moneda en pantalla
+ CSCI441::LODSelector _lodSelector;
+
+ CSCI441::TransformHierarchy* _transforms;
+ GLuint _bodyNode;
 };
 
 #endif // COIN_H
@@ -1,23 +1,37 @@
 #include "Zombie.h"
 #include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
 #include <objects.hpp>
 #include <OpenGLUtils.hpp>
+#include <cmath>
+
+// Teselación de las esferas y conos para cada nivel de detalle
+static const GLint SPHERE_RESOLUTION[] = { 20, 12, 8, 6 };
+static const GLint CONE_RESOLUTION[]   = { 20, 12, 8, 6 };
+
+// Paso de un movimiento manual, un frame a 60 Hz
+static const float MOVE_STEP_TIME = 1.0f / 60.0f;
+
+// Avanza un ángulo en onda triangular entre -limit y limit
+static void swingArm(float& angle, bool& swingForward, float step, float limit) {
+    step = fmodf(step, 4.0f * limit); // un ciclo completo deja el brazo igual
+    while (step > 0.0f) {
+        float remaining = swingForward ? limit - angle : angle + limit;
+        if (step < remaining) {
+            angle += swingForward ? step : -step;
+            return;
+        }
+        angle = swingForward ? limit : -limit;
+        swingForward = !swingForward;
+        step -= remaining;
+    }
+}
 
-Zombie::Zombie(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation)
-    : _shaderProgramHandle(shaderProgramHandle),
-    rotationAngle(0.0f),
+Zombie::Zombie(CSCI441::TransformHierarchy* transforms, CSCI441::AnimationScheduler* animationScheduler)
+    : rotationAngle(0.0f),
     radius(1.0f),
-    speedMultiplier(1.0f){
-
-    _shaderProgramUniformLocations.mvpMtx    = mvpMtxUniformLocation;
-    _shaderProgramUniformLocations.normalMtx = normalMtxUniformLocation;
-
-    _shaderProgramUniformLocations.materialAmbientColor  = glGetUniformLocation(_shaderProgramHandle, "materialAmbientColor");
-    _shaderProgramUniformLocations.materialDiffuseColor  = glGetUniformLocation(_shaderProgramHandle, "materialDiffuseColor");
-    _shaderProgramUniformLocations.materialSpecularColor = glGetUniformLocation(_shaderProgramHandle, "materialSpecularColor");
-    _shaderProgramUniformLocations.materialShininess     = glGetUniformLocation(_shaderProgramHandle, "materialShininess");
-
+    speedMultiplier(1.0f),
+    _transforms(transforms),
+    _animationScheduler(animationScheduler) {
 
     _colorBody = glm::vec3(0.0f, 0.0f, 1.0f); // Cuerpo azul
     _colorHead = glm::vec3(0.0f, 1.0f, 0.0f); // Cabeza verde
@@ -26,81 +40,120 @@ Zombie::Zombie(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint no
     _colorArm  = glm::vec3(0.0f, 1.0f, 0.0f); // Brazos verdes
 
     position = glm::vec3(0.0f);
+
+    if (_animationScheduler != nullptr) {
+        _animationEntity = _animationScheduler->addEntity();
+    }
+
+    // Las partes fijas se colocan una sola vez respecto a la raíz
+    _rootNode = _transforms->addNode();
+
+    _bodyNode = _transforms->addNode(_rootNode);
+    _transforms->setLocalMatrix(_bodyNode, glm::scale(glm::mat4(1.0f), glm::vec3(0.8f, 2.0f, 0.5f)));
+
+    _leftArmNode  = _transforms->addNode(_rootNode);
+    _rightArmNode = _transforms->addNode(_rootNode);
+
+    _headNode = _transforms->addNode(_rootNode);
+    glm::mat4 headMtx = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 1.1f, 0.0f));
+    _transforms->setLocalMatrix(_headNode, glm::scale(headMtx, glm::vec3(0.8f)));
+
+    _faceNode = _transforms->addNode(_rootNode);
+    glm::mat4 faceMtx = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 1.1f, -0.18f));
+    _transforms->setLocalMatrix(_faceNode, glm::scale(faceMtx, glm::vec3(0.7f)));
+
+    _coneRightNode = _transforms->addNode(_rootNode);
+    glm::mat4 coneRightMtx = glm::translate(glm::mat4(1.0f), glm::vec3(0.7f, 1.0f, 0.0f));
+    coneRightMtx = glm::rotate(coneRightMtx, glm::radians(-90.0f), CSCI441::Z_AXIS);
+    _transforms->setLocalMatrix(_coneRightNode, glm::scale(coneRightMtx, glm::vec3(0.25f, 0.6f, 0.25f)));
+
+    _coneLeftNode = _transforms->addNode(_rootNode);
+    glm::mat4 coneLeftMtx = glm::translate(glm::mat4(1.0f), glm::vec3(-0.7f, 1.0f, 0.0f));
+    coneLeftMtx = glm::rotate(coneLeftMtx, glm::radians(90.0f), CSCI441::Z_AXIS);
+    _transforms->setLocalMatrix(_coneLeftNode, glm::scale(coneLeftMtx, glm::vec3(0.25f, 0.6f, 0.25f)));
+
+    _bagNode = _transforms->addNode(_rootNode);
+    glm::mat4 bagMtx = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.35f));
+    _transforms->setLocalMatrix(_bagNode, glm::scale(bagMtx, glm::vec3(0.4f, 0.6f, 0.3f)));
 }
 
-void Zombie::drawVehicle(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) {
+Zombie::State Zombie::getState() const {
+    State state;
+    state.position = position;
+    state.rotationAngle = rotationAngle;
+    state.isFalling = isFalling;
+    state.fallRotation = fallRotation;
+    state.isActive = isActive;
+    state.leftArmAngle = _leftArmAngle;
+    state.leftArmSwingForward = _leftArmSwingForward;
+    state.armsSwinging = _armsSwinging;
+    state.timeSinceUpdate = _animationScheduler != nullptr ? _animationScheduler->getTimeSinceUpdate(_animationEntity) : 0.0f;
+    return state;
+}
 
-    modelMtx = glm::translate(modelMtx, position);
-    if (isFalling) {
-        modelMtx = glm::rotate(modelMtx, fallRotation, CSCI441::X_AXIS);
+void Zombie::updateTransforms(const State& state) {
+    glm::mat4 modelMtx = glm::translate(glm::mat4(1.0f), state.position);
+    if (state.isFalling) {
+        modelMtx = glm::rotate(modelMtx, state.fallRotation, CSCI441::X_AXIS);
     } else {
-        modelMtx = glm::rotate(modelMtx, rotationAngle, CSCI441::Y_AXIS);
+        modelMtx = glm::rotate(modelMtx, state.rotationAngle, CSCI441::Y_AXIS);
     }
+    _transforms->setLocalMatrix(_rootNode, modelMtx);
 
-    _drawBody(modelMtx, viewMtx, projMtx);
-    _drawArmRight(modelMtx, viewMtx, projMtx);
-    _drawArmLeft(modelMtx, viewMtx, projMtx);
-    _drawHead(modelMtx, viewMtx, projMtx);
-    _drawFace(modelMtx, viewMtx, projMtx);
-    _drawCones(modelMtx, viewMtx, projMtx);
-    _drawBag(modelMtx, viewMtx, projMtx);
+    // Entre actualizaciones se extrapola el balanceo con el tiempo acumulado
+    float leftArmAngle = state.leftArmAngle;
+    if (state.armsSwinging && state.timeSinceUpdate > 0.0f) {
+        bool swingForward = state.leftArmSwingForward;
+        swingArm(leftArmAngle, swingForward, _armSwingSpeed * state.timeSinceUpdate, _armSwingLimit);
+    }
+    _transforms->setLocalMatrix(_leftArmNode, _armMatrix(-0.55f, leftArmAngle));
+    _transforms->setLocalMatrix(_rightArmNode, _armMatrix(0.55f, -leftArmAngle));
 }
 
-void Zombie::moveForward() {
+void Zombie::drawVehicle(CSCI441::DrawBatcher& batcher, const glm::mat4& viewMtx, const glm::mat4& projMtx, const glm::mat4& viewProjMtx) {
 
-    if (_leftArmSwingForward) {
-        _leftArmAngle += _armSwingSpeed;
-        if (_leftArmAngle >= _armSwingLimit) {
-            _leftArmSwingForward = false;
-        }
-    } else {
-        _leftArmAngle -= _armSwingSpeed;
-        if (_leftArmAngle <= -_armSwingLimit) {
-            _leftArmSwingForward = true;
-        }
-    }
+    glm::vec3 center;
+    float radius;
+    getBoundingSphere(center, radius);
+    _levelOfDetail = _lodSelector.select(center, radius, viewMtx, projMtx);
 
-    if (_rightArmSwingForward) {
-        _rightArmAngle += _armSwingSpeed;
-        if (_rightArmAngle >= _armSwingLimit) {
-            _rightArmSwingForward = false;
-        }
-    } else {
-        _rightArmAngle -= _armSwingSpeed;
-        if (_rightArmAngle <= -_armSwingLimit) {
-            _rightArmSwingForward = true;
-        }
+    if (_animationScheduler != nullptr) {
+        _animationScheduler->observe(_animationEntity, center, radius, viewMtx, projMtx);
     }
+
+    _drawBody(batcher, viewProjMtx);
+    _drawArms(batcher, viewProjMtx);
+    _drawHead(batcher, viewProjMtx);
+    _drawFace(batcher, viewProjMtx);
+    _drawCones(batcher, viewProjMtx);
+    _drawBag(batcher, viewProjMtx);
+}
+
+void Zombie::getBoundingSphere(glm::vec3& center, float& radius) const {
+    center = glm::vec3(_transforms->getWorldMatrix(_rootNode) * glm::vec4(0.0f, 0.4f, 0.0f, 1.0f));
+    radius = 1.6f;
+}
+
+void Zombie::moveForward() {
+    _swingArms(MOVE_STEP_TIME);
 }
 
 void Zombie::moveBackward() {
-    if (_leftArmSwingForward) {
-        _leftArmAngle += _armSwingSpeed;
-        if (_leftArmAngle >= _armSwingLimit) {
-            _leftArmSwingForward = false;
-        }
-    } else {
-        _leftArmAngle -= _armSwingSpeed;
-        if (_leftArmAngle <= -_armSwingLimit) {
-            _leftArmSwingForward = true;
-        }
-    }
+    _swingArms(MOVE_STEP_TIME);
+}
 
-    if (_rightArmSwingForward) {
-        _rightArmAngle += _armSwingSpeed;
-        if (_rightArmAngle >= _armSwingLimit) {
-            _rightArmSwingForward = false;
-        }
-    } else {
-        _rightArmAngle -= _armSwingSpeed;
-        if (_rightArmAngle <= -_armSwingLimit) {
-            _rightArmSwingForward = true;
-        }
-    }
+void Zombie::_swingArms(float deltaTime) {
+    swingArm(_leftArmAngle, _leftArmSwingForward, _armSwingSpeed * deltaTime, _armSwingLimit);
 }
 
 void Zombie::update(float deltaTime, glm::vec3 heroPosition) {
 
+    // El planificador acumula el tiempo y decide si los brazos se actualizan este frame
+    float animationTime = _animationScheduler != nullptr
+                        ? _animationScheduler->update(_animationEntity, deltaTime)
+                        : deltaTime;
+    _armsSwinging = false;
+
     if (isFalling) {
         int ROTATION_SPEED = 8.0f;
         int FALL_SPEED = 8.0f;
@@ -168,136 +221,117 @@ void Zombie::update(float deltaTime, glm::vec3 heroPosition) {
         position += velocity * deltaTime;
 
         // Actualizar movimiento de los brazos
-        moveForward();
+        _armsSwinging = true;
+        _swingArms(animationTime);
     }
 }
 
+bool Zombie::collideWith(Zombie& other) {
+    // Calcular la distancia entre los zombies
+    glm::vec3 delta = position - other.position;
+    float distance = glm::length(delta);
 
+    // Calcular la suma de los radios
+    float sumRadius = radius + other.radius;
 
-void Zombie::_drawBody(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 bodyMtx = modelMtx;
-    bodyMtx = glm::scale(bodyMtx, glm::vec3(0.8f, 2.0f, 0.5f));
-
-    _computeAndSendMatrixUniforms(bodyMtx, viewMtx, projMtx);
+    // Si no hay colisión
+    if(distance >= sumRadius)
+        return false;
 
-    _setMaterialColors(_colorBody, 64.0f);
+    // Normalizar el vector de colisión
+    glm::vec3 collisionNormal = glm::normalize(delta);
 
-    CSCI441::drawSolidCube(1.0f);
-}
-
-void Zombie::_drawArmLeft(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 armMtx = modelMtx;
+    // Calcular la velocidad relativa en la dirección normal
+    glm::vec3 relativeVelocity = velocity - other.velocity;
+    float velocityAlongNormal = glm::dot(relativeVelocity, collisionNormal);
 
-    armMtx = glm::translate(armMtx, glm::vec3(-0.55f, 0.7f, 0.0f));
+    // Evitar calcular si las velocidades se están separando
+    if(velocityAlongNormal > 0)
+        return true;
 
-    armMtx = glm::rotate(armMtx, _leftArmAngle, CSCI441::X_AXIS);
+    // Coeficiente de restitución (elasticidad del rebote)
+    float e = 0.5f; // Ajusta este valor entre 0 (inelástico) y 1 (elástico)
 
-    armMtx = glm::translate(armMtx, glm::vec3(0.0f, -0.7f, 0.0f));
+    // Calcular el impulso escalar
+    float j = -(1 + e) * velocityAlongNormal;
+    j /= 2; // Suponiendo masas iguales
 
-    armMtx = glm::scale(armMtx, glm::vec3(0.30f, 0.9f, 0.3f));
+    // Calcular el impulso vectorial
+    glm::vec3 impulse = j * 80*collisionNormal;
 
-    _computeAndSendMatrixUniforms(armMtx, viewMtx, projMtx);
+    // Actualizar las velocidades de los zombies
+    velocity += impulse;
+    other.velocity -= impulse;
 
-    _setMaterialColors(_colorArm, 64.0f); // Usar color de brazos
+    // Separar los zombies para evitar superposición
+    float penetrationDepth = sumRadius - distance;
+    glm::vec3 correction = (penetrationDepth / 2.0f) * collisionNormal;
+    position += correction;
+    other.position -= correction;
 
-    CSCI441::drawSolidCube(1.0f);
+    // Ajustar la rotación para que sigan mirando al héroe
+    rotationAngle = atan2f(-velocity.x, -velocity.z);
+    other.rotationAngle = atan2f(-other.velocity.x, -other.velocity.z);
+    return true;
 }
 
-void Zombie::_drawArmRight(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 armMtx = modelMtx;
 
-    armMtx = glm::translate(armMtx, glm::vec3(0.55f, 0.7f, 0.0f));
 
-    armMtx = glm::rotate(armMtx, _rightArmAngle, CSCI441::X_AXIS);
-
-    armMtx = glm::translate(armMtx, glm::vec3(0.0f, -0.7f, 0.0f));
+glm::mat4 Zombie::_armMatrix(float shoulderX, float armAngle) {
+    glm::mat4 armMtx = glm::translate(glm::mat4(1.0f), glm::vec3(shoulderX, 0.7f, 0.0f));
 
-    armMtx = glm::scale(armMtx, glm::vec3(0.30f, 0.9f, 0.3f));
+    armMtx = glm::rotate(armMtx, armAngle, CSCI441::X_AXIS);
 
-    _computeAndSendMatrixUniforms(armMtx, viewMtx, projMtx);
-
-    _setMaterialColors(_colorArm, 64.0f); // Usar color de brazos
+    armMtx = glm::translate(armMtx, glm::vec3(0.0f, -0.7f, 0.0f));
 
-    CSCI441::drawSolidCube(1.0f);
+    return glm::scale(armMtx, glm::vec3(0.30f, 0.9f, 0.3f));
 }
 
-void Zombie::_drawHead(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 headMtx = modelMtx;
-    headMtx = glm::translate(headMtx, glm::vec3(0.0f, 1.1f, 0.0f));
-    headMtx = glm::scale(headMtx, glm::vec3(0.8f));
-
-    _computeAndSendMatrixUniforms(headMtx, viewMtx, projMtx);
-
-    _setMaterialColors(_colorHead, 16.0f);
-
-    CSCI441::drawSolidSphere(1.0f, 20, 20);
+void Zombie::_drawBody(CSCI441::DrawBatcher& batcher, const glm::mat4& viewProjMtx) const {
+    _addPart(batcher, _bodyNode, CSCI441::getSolidCubeMesh(1.0f), _colorBody, 64.0f, viewProjMtx);
 }
 
-void Zombie::_drawFace(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 faceMtx = modelMtx;
-    faceMtx = glm::translate(faceMtx, glm::vec3(0.0f, 1.1f, -0.18f));
-    faceMtx = glm::scale(faceMtx, glm::vec3(0.7f));
-
-    _computeAndSendMatrixUniforms(faceMtx, viewMtx, projMtx);
-
-    _setMaterialColors(_colorFace, 16.0f);
+void Zombie::_drawArms(CSCI441::DrawBatcher& batcher, const glm::mat4& viewProjMtx) const {
+    const CSCI441::DrawBatcher::Mesh armMesh = CSCI441::getSolidCubeMesh(1.0f);
 
-    CSCI441::drawSolidSphere(1.0f, 20, 20);
+    _addPart(batcher, _rightArmNode, armMesh, _colorArm, 64.0f, viewProjMtx); // Usar color de brazos
+    _addPart(batcher, _leftArmNode, armMesh, _colorArm, 64.0f, viewProjMtx);
 }
 
-void Zombie::_drawCones(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-
-    glm::mat4 coneRightMtx = modelMtx;
-    coneRightMtx = glm::translate(coneRightMtx, glm::vec3(0.7f, 1.0f, 0.0f));
-    coneRightMtx = glm::rotate(coneRightMtx, glm::radians(-90.0f), CSCI441::Z_AXIS);
-    coneRightMtx = glm::scale(coneRightMtx, glm::vec3(0.25f, 0.6f, 0.25f));
-
-    _computeAndSendMatrixUniforms(coneRightMtx, viewMtx, projMtx);
-
-    _setMaterialColors(_colorFace, 16.0f);
-
-    CSCI441::drawSolidCone(1.0f, 1.0f, 20, 20);
-
-
-    glm::mat4 coneLeftMtx = modelMtx;
-    coneLeftMtx = glm::translate(coneLeftMtx, glm::vec3(-0.7f, 1.0f, 0.0f));
-    coneLeftMtx = glm::rotate(coneLeftMtx, glm::radians(90.0f), CSCI441::Z_AXIS);
-    coneLeftMtx = glm::scale(coneLeftMtx, glm::vec3(0.25f, 0.6f, 0.25f));
-
-    _computeAndSendMatrixUniforms(coneLeftMtx, viewMtx, projMtx);
-
-    _setMaterialColors(_colorFace, 32.0f);
-
-    CSCI441::drawSolidCone(1.0f, 1.0f, 20, 20);
+void Zombie::_drawHead(CSCI441::DrawBatcher& batcher, const glm::mat4& viewProjMtx) const {
+    _addPart(batcher, _headNode,
+             CSCI441::getSolidSphereMesh(1.0f, SPHERE_RESOLUTION[_levelOfDetail], SPHERE_RESOLUTION[_levelOfDetail]),
+             _colorHead, 16.0f, viewProjMtx);
 }
 
-void Zombie::_drawBag(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 bagMtx = modelMtx;
-    bagMtx = glm::translate(bagMtx, glm::vec3(0.0f, 0.0f, 0.35f));
-    bagMtx = glm::scale(bagMtx, glm::vec3(0.4f, 0.6f, 0.3f));
-
-    _computeAndSendMatrixUniforms(bagMtx, viewMtx, projMtx);
+void Zombie::_drawFace(CSCI441::DrawBatcher& batcher, const glm::mat4& viewProjMtx) const {
+    _addPart(batcher, _faceNode,
+             CSCI441::getSolidSphereMesh(1.0f, SPHERE_RESOLUTION[_levelOfDetail], SPHERE_RESOLUTION[_levelOfDetail]),
+             _colorFace, 16.0f, viewProjMtx);
+}
 
-    _setMaterialColors(_colorBag, 64.0f);
+void Zombie::_drawCones(CSCI441::DrawBatcher& batcher, const glm::mat4& viewProjMtx) const {
+    const CSCI441::DrawBatcher::Mesh coneMesh =
+        CSCI441::getSolidConeMesh(1.0f, 1.0f, CONE_RESOLUTION[_levelOfDetail], CONE_RESOLUTION[_levelOfDetail]);
 
-    CSCI441::drawSolidCube(1.0f);
+    _addPart(batcher, _coneRightNode, coneMesh, _colorFace, 16.0f, viewProjMtx);
+    _addPart(batcher, _coneLeftNode, coneMesh, _colorFace, 32.0f, viewProjMtx);
 }
 
-void Zombie::_computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 mvpMtx = projMtx * viewMtx * modelMtx;
-    glProgramUniformMatrix4fv(_shaderProgramHandle, _shaderProgramUniformLocations.mvpMtx, 1, GL_FALSE, glm::value_ptr(mvpMtx));
-
-    glm::mat3 normalMtx = glm::transpose(glm::inverse(glm::mat3(modelMtx)));
-    glProgramUniformMatrix3fv(_shaderProgramHandle, _shaderProgramUniformLocations.normalMtx, 1, GL_FALSE, glm::value_ptr(normalMtx));
+void Zombie::_drawBag(CSCI441::DrawBatcher& batcher, const glm::mat4& viewProjMtx) const {
+    _addPart(batcher, _bagNode, CSCI441::getSolidCubeMesh(1.0f), _colorBag, 64.0f, viewProjMtx);
 }
 
-void Zombie::_setMaterialColors(glm::vec3 color, float shininess) const {
-    glm::vec3 ambientColor  = color * 0.2f;
-    glm::vec3 diffuseColor  = color;
-    glm::vec3 specularColor = glm::vec3(0.5f);
+void Zombie::_addPart(CSCI441::DrawBatcher& batcher, GLuint node, const CSCI441::DrawBatcher::Mesh& mesh,
+                      glm::vec3 color, float shininess, const glm::mat4& viewProjMtx) const {
+    CSCI441::DrawBatcher::DrawData drawData;
+    drawData.mvpMtx    = viewProjMtx * _transforms->getWorldMatrix(node);
+    drawData.normalMtx = _transforms->getNormalMatrix(node);
+
+    drawData.materialAmbientColor  = color * 0.2f;
+    drawData.materialDiffuseColor  = color;
+    drawData.materialSpecularColor = glm::vec3(0.5f);
+    drawData.materialShininess     = shininess;
 
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialAmbientColor, 1, glm::value_ptr(ambientColor));
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialDiffuseColor, 1, glm::value_ptr(diffuseColor));
-    glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialSpecularColor, 1, glm::value_ptr(specularColor));
-    glProgramUniform1f(_shaderProgramHandle, _shaderProgramUniformLocations.materialShininess, shininess);
+    batcher.add(mesh, drawData);
 }
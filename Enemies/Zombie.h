@@ -6,11 +6,58 @@
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <AnimationScheduler.hpp>
+#include <DrawBatcher.hpp>
+#include <LODSelector.hpp>
+#include <TransformHierarchy.hpp>
+
 class Zombie {
 public:
-    Zombie(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation);
+    /**
+     * @param transforms jerarquía donde se guardan las matrices de cada parte
+     * @param animationScheduler planificador que decide cuándo se actualizan los brazos,
+     *                           nullptr para actualizarlos en cada frame
+     */
+    Zombie(CSCI441::TransformHierarchy* transforms, CSCI441::AnimationScheduler* animationScheduler = nullptr);
+
+    /**
+     * @brief Todo lo que se necesita para dibujar el zombie, copiado al terminar cada paso de simulación.
+     */
+    struct State {
+        glm::vec3 position;
+        float rotationAngle;
+        bool isFalling;
+        float fallRotation;
+        bool isActive;
+        float leftArmAngle;
+        bool leftArmSwingForward;
+        bool armsSwinging;
+        float timeSinceUpdate;      // tiempo acumulado desde la última actualización de los brazos
+    };
+
+    /**
+     * @brief Copia el estado actual de la simulación.
+     * @note Se llama desde el hilo que actualiza el zombie.
+     */
+    State getState() const;
 
-    void drawVehicle(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx);
+    /**
+     * @brief Copia la posición, orientación y brazos de un estado a la jerarquía, una vez por frame antes de dibujar.
+     */
+    void updateTransforms(const State& state);
+
+    /**
+     * @brief Añade las partes del zombie al lote con las matrices ya calculadas en la jerarquía.
+     * @param batcher lote que dibuja todos los zombies y monedas juntos
+     * @param viewProjMtx proyección por vista, calculada una vez por vista
+     */
+    void drawVehicle(CSCI441::DrawBatcher& batcher, const glm::mat4& viewMtx, const glm::mat4& projMtx, const glm::mat4& viewProjMtx);
+
+    /**
+     * @brief Esfera envolvente (unas 3 unidades de alto) centrada en el torso, en coordenadas de mundo.
+     * @note Usa las matrices ya calculadas en la jerarquía.
+     */
+    void getBoundingSphere(glm::vec3& center, float& radius) const;
 
     void moveForward();
     void moveBackward();
@@ -23,6 +70,13 @@ public:
      * @param deltaTime Tiempo transcurrido desde la última actualización.
      */
     void update(float deltaTime, glm::vec3 heroPosition); // Declaración del método update
+
+    /**
+     * @brief Si los dos zombies se tocan, los separa y les aplica un impulso de rebote.
+     * @return true si se tocaban
+     */
+    bool collideWith(Zombie& other);
+
     glm::vec3 position;
     glm::vec3 velocity;
     float rotationAngle;
@@ -33,16 +87,6 @@ public:
     bool isActive = true;
 
 private:
-    GLuint _shaderProgramHandle;
-    struct ShaderProgramUniformLocations {
-        GLint mvpMtx;
-        GLint normalMtx;
-        GLint materialAmbientColor;
-        GLint materialDiffuseColor;
-        GLint materialSpecularColor;
-        GLint materialShininess;
-    } _shaderProgramUniformLocations;
-
     glm::vec3 _colorBody;
     glm::vec3 _colorHead;
     glm::vec3 _colorFace;
@@ -51,23 +95,47 @@ private:
 
 
 
-    void _drawBody(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
-    void _drawArmRight(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
-    void _drawArmLeft(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
-    void _drawHead(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
-    void _drawFace(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
-    void _drawCones(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
-    void _drawBag(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
+    void _drawBody(CSCI441::DrawBatcher& batcher, const glm::mat4& viewProjMtx) const;
+    void _drawArms(CSCI441::DrawBatcher& batcher, const glm::mat4& viewProjMtx) const;
+    void _drawHead(CSCI441::DrawBatcher& batcher, const glm::mat4& viewProjMtx) const;
+    void _drawFace(CSCI441::DrawBatcher& batcher, const glm::mat4& viewProjMtx) const;
+    void _drawCones(CSCI441::DrawBatcher& batcher, const glm::mat4& viewProjMtx) const;
+    void _drawBag(CSCI441::DrawBatcher& batcher, const glm::mat4& viewProjMtx) const;
+
+    static glm::mat4 _armMatrix(float shoulderX, float armAngle);
 
-    void _computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
-    void _setMaterialColors(glm::vec3 color, float shininess) const;
+    // Añade una parte al lote con su matriz y material en vez de enviarlos como uniformes
+    void _addPart(CSCI441::DrawBatcher& batcher, GLuint node, const CSCI441::DrawBatcher::Mesh& mesh,
+                  glm::vec3 color, float shininess, const glm::mat4& viewProjMtx) const;
 
+    // El brazo derecho siempre es el reflejo del izquierdo
     float _leftArmAngle = 0.0f;
-    float _rightArmAngle = 0.0f;
     bool _leftArmSwingForward = true;
-    bool _rightArmSwingForward = false;
-    float _armSwingSpeed = glm::radians(1.0f);
+    bool _armsSwinging = false;
+    float _armSwingSpeed = glm::radians(60.0f); // por segundo, 1 grado por frame a 60 Hz
     float _armSwingLimit = glm::radians(30.0f);
+
+    void _swingArms(float deltaTime);
+
+    // Nodos de cada parte en la jerarquía, todos hijos de la raíz
+    CSCI441::TransformHierarchy* _transforms;
+    GLuint _rootNode;
+    GLuint _bodyNode;
+    GLuint _leftArmNode;
+    GLuint _rightArmNode;
+    GLuint _headNode;
+    GLuint _faceNode;
+    GLuint _coneRightNode;
+    GLuint _coneLeftNode;
+    GLuint _bagNode;
+
+    // Frecuencia de actualización de la animación según tamaño en pantalla
+    CSCI441::AnimationScheduler* _animationScheduler;
+    GLuint _animationEntity = 0;
+
+    // Nivel de detalle elegido según el tamaño del zombie en pantalla
+    CSCI441::LODSelector _lodSelector;
+    GLuint _levelOfDetail = 0;
 };
 
 #endif //ZOMBIE_H
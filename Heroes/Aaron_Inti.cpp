@@ -6,18 +6,17 @@
 #include <objects.hpp>
 #include <OpenGLUtils.hpp>
 
-Aaron_Inti::Aaron_Inti(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation)
-    : _shaderProgramHandle(shaderProgramHandle), _isDamaged(false) {
+// Teselación de las ruedas para cada nivel de detalle
+static const GLint WHEEL_STACKS[] = { 16, 4, 2, 1 };
+static const GLint WHEEL_SLICES[] = { 16, 12, 8, 6 };
+
+Aaron_Inti::Aaron_Inti(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation,
+                       CSCI441::TransformHierarchy* transforms)
+    : _isDamaged(false), _transforms(transforms) {
     _propAngle = 0.0f;
     _propAngleRotationSpeed = _PI / 16.0f;
 
-    _shaderProgramUniformLocations.mvpMtx    = mvpMtxUniformLocation;
-    _shaderProgramUniformLocations.normalMtx = normalMtxUniformLocation;
-
-    _shaderProgramUniformLocations.materialAmbientColor  = glGetUniformLocation(_shaderProgramHandle, "materialAmbientColor");
-    _shaderProgramUniformLocations.materialDiffuseColor  = glGetUniformLocation(_shaderProgramHandle, "materialDiffuseColor");
-    _shaderProgramUniformLocations.materialSpecularColor = glGetUniformLocation(_shaderProgramHandle, "materialSpecularColor");
-    _shaderProgramUniformLocations.materialShininess     = glGetUniformLocation(_shaderProgramHandle, "materialShininess");
+    setShaderProgram(shaderProgramHandle, mvpMtxUniformLocation, normalMtxUniformLocation);
 
     _colorBody = glm::vec3(1.0f, 1.0f, 1.0f);
     _scaleBody = glm::vec3(2.0f, 1.5f, 6.0f);
@@ -53,15 +52,88 @@ Aaron_Inti::Aaron_Inti(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation,
 
     _colorHeadlightReverse = glm::vec3(1.0f, 0.0f, 0.0f);
     _isMovingBackward = false;
+
+    // Las partes fijas se colocan una sola vez respecto a la raíz
+    _rootNode = _transforms->addNode();
+
+    _bodyNode = _transforms->addNode(_rootNode);
+    _transforms->setLocalMatrix(_bodyNode, glm::scale(glm::mat4(1.0f), _scaleBody));
+
+    _topNode = _transforms->addNode(_rootNode);
+    _transforms->setLocalMatrix(_topNode, glm::scale(glm::translate(glm::mat4(1.0f), _transTop), _scaleTop));
+
+    for (int i = 0; i < 2; ++i) {
+        _windowNodes[i] = _transforms->addNode(_rootNode);
+        _transforms->setLocalMatrix(_windowNodes[i], glm::scale(glm::translate(glm::mat4(1.0f), _windowPositions[i]), _scaleWindow));
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        _wheelNodes[i] = _transforms->addNode(_rootNode);
+        for (int j = 0; j < NUM_SPOKES; ++j) {
+            glm::mat4 spokeMtx = glm::rotate(glm::mat4(1.0f), glm::radians(360.0f / NUM_SPOKES * j), CSCI441::Z_AXIS);
+            spokeMtx = glm::translate(spokeMtx, glm::vec3(0.0f, 0.0f, 0.25f));
+            spokeMtx = glm::scale(spokeMtx, glm::vec3(0.05f, 0.05f, 0.5f));
+
+            _spokeNodes[i][j] = _transforms->addNode(static_cast<GLint>(_wheelNodes[i]));
+            _transforms->setLocalMatrix(_spokeNodes[i][j], spokeMtx);
+        }
+    }
+
+    _propNode = _transforms->addNode(_rootNode);
+
+    for (int i = 0; i < 2; ++i) {
+        _headlightNodes[i] = _transforms->addNode(_rootNode);
+        _transforms->setLocalMatrix(_headlightNodes[i], glm::scale(glm::translate(glm::mat4(1.0f), _headlightPositions[i]), _scaleHeadlight));
+    }
+
+    updateTransforms(glm::mat4(1.0f), getAnimationState());
+}
+
+void Aaron_Inti::setShaderProgram(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation) {
+    _shaderProgramHandle = shaderProgramHandle;
+
+    _shaderProgramUniformLocations.mvpMtx    = mvpMtxUniformLocation;
+    _shaderProgramUniformLocations.normalMtx = normalMtxUniformLocation;
+
+    _shaderProgramUniformLocations.materialAmbientColor  = glGetUniformLocation(_shaderProgramHandle, "materialAmbientColor");
+    _shaderProgramUniformLocations.materialDiffuseColor  = glGetUniformLocation(_shaderProgramHandle, "materialDiffuseColor");
+    _shaderProgramUniformLocations.materialSpecularColor = glGetUniformLocation(_shaderProgramHandle, "materialSpecularColor");
+    _shaderProgramUniformLocations.materialShininess     = glGetUniformLocation(_shaderProgramHandle, "materialShininess");
+}
+
+Aaron_Inti::AnimationState Aaron_Inti::getAnimationState() const {
+    return { _propAngle, _isMovingBackward, _headlightState };
+}
+
+void Aaron_Inti::updateTransforms(const glm::mat4& modelMtx, const AnimationState& animation) {
+    _drawnAnimation = animation;
+    _transforms->setLocalMatrix(_rootNode, modelMtx);
+
+    for (int i = 0; i < 4; ++i) {
+        glm::mat4 wheelMtx = glm::translate(glm::mat4(1.0f), _wheelPositions[i]);
+        wheelMtx = glm::rotate(wheelMtx, glm::radians(-90.0f), CSCI441::Z_AXIS);
+        wheelMtx = glm::rotate(wheelMtx, animation.propAngle, CSCI441::Y_AXIS);
+        wheelMtx = glm::scale(wheelMtx, _scaleWheel);
+        _transforms->setLocalMatrix(_wheelNodes[i], wheelMtx);
+    }
+
+    glm::mat4 propMtx = glm::translate(glm::mat4(1.0f), _transProp);
+    propMtx = glm::rotate(propMtx, animation.propAngle, CSCI441::Z_AXIS);
+    propMtx = glm::scale(propMtx, _scaleProp);
+    _transforms->setLocalMatrix(_propNode, propMtx);
 }
 
-void Aaron_Inti::drawVehicle(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) {
-    _drawCarBody(modelMtx, viewMtx, projMtx);
-    _drawCarTop(modelMtx, viewMtx, projMtx);
-    _drawCarWindows(modelMtx, viewMtx, projMtx);
-    _drawCarWheels(modelMtx, viewMtx, projMtx);
-    _drawCarPropeller(modelMtx, viewMtx, projMtx);
-    _drawCarHeadlights(modelMtx, viewMtx, projMtx);
+void Aaron_Inti::drawVehicle(const glm::mat4& viewMtx, const glm::mat4& projMtx, const glm::mat4& viewProjMtx) {
+    // Esfera envolvente del vehículo (6 unidades de largo)
+    glm::vec3 center = glm::vec3(_transforms->getWorldMatrix(_rootNode)[3]);
+    _levelOfDetail = _lodSelector.select(center, 3.5f, viewMtx, projMtx);
+
+    _drawCarBody(viewProjMtx);
+    _drawCarTop(viewProjMtx);
+    _drawCarWindows(viewProjMtx);
+    _drawCarWheels(viewProjMtx);
+    _drawCarPropeller(viewProjMtx);
+    _drawCarHeadlights(viewProjMtx);
 }
 
 void Aaron_Inti::moveForward() {
@@ -88,84 +160,57 @@ void Aaron_Inti::moveBackward() {
     }
 }
 
-void Aaron_Inti::_drawCarBody(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 bodyMtx = modelMtx;
-    bodyMtx = glm::scale(bodyMtx, _scaleBody);
-
-    _computeAndSendMatrixUniforms(bodyMtx, viewMtx, projMtx);
+void Aaron_Inti::_drawCarBody(const glm::mat4& viewProjMtx) const {
+    _computeAndSendMatrixUniforms(_bodyNode, viewProjMtx);
 
     _setMaterialColors(_colorBody, 32.0f);
 
     CSCI441::drawSolidCube(1.0f);
 }
 
-void Aaron_Inti::_drawCarTop(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 topMtx = modelMtx;
-    topMtx = glm::translate(topMtx, _transTop);
-    topMtx = glm::scale(topMtx, _scaleTop);
-
-    _computeAndSendMatrixUniforms(topMtx, viewMtx, projMtx);
+void Aaron_Inti::_drawCarTop(const glm::mat4& viewProjMtx) const {
+    _computeAndSendMatrixUniforms(_topNode, viewProjMtx);
 
     _setMaterialColors(_colorTop, 16.0f);
 
     CSCI441::drawSolidCube(1.0f);
 }
 
-void Aaron_Inti::_drawCarWheels(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    int numSpokes = 8;
+void Aaron_Inti::_drawCarWheels(const glm::mat4& viewProjMtx) const {
     for (int i = 0; i < 4; ++i) {
-        glm::mat4 wheelMtx = modelMtx;
-        wheelMtx = glm::translate(wheelMtx, _wheelPositions[i]);
-        wheelMtx = glm::rotate(wheelMtx, glm::radians(-90.0f), CSCI441::Z_AXIS);
-        wheelMtx = glm::rotate(wheelMtx, _propAngle, CSCI441::Y_AXIS);
-        wheelMtx = glm::scale(wheelMtx, _scaleWheel);
-
-        _computeAndSendMatrixUniforms(wheelMtx, viewMtx, projMtx);
+        _computeAndSendMatrixUniforms(_wheelNodes[i], viewProjMtx);
 
         _setMaterialColors(_colorWheel, 10.0f);
 
-        CSCI441::drawSolidCylinder(0.5f, 0.5f, 0.2f, 16, 16);
+        CSCI441::drawSolidCylinder(0.5f, 0.5f, 0.2f, WHEEL_STACKS[_levelOfDetail], WHEEL_SLICES[_levelOfDetail]);
 
-        for (int j = 0; j < numSpokes; ++j) {
-            glm::mat4 spokeMtx = wheelMtx;
-            spokeMtx = glm::rotate(spokeMtx, glm::radians(360.0f / numSpokes * j), CSCI441::Z_AXIS);
-            spokeMtx = glm::translate(spokeMtx, glm::vec3(0.0f, 0.0f, 0.25f));
-            spokeMtx = glm::scale(spokeMtx, glm::vec3(0.05f, 0.05f, 0.5f));
-
-            _computeAndSendMatrixUniforms(spokeMtx, viewMtx, projMtx);
+        for (int j = 0; j < NUM_SPOKES; ++j) {
+            _computeAndSendMatrixUniforms(_spokeNodes[i][j], viewProjMtx);
 
             CSCI441::drawSolidCube(1.0f);
         }
     }
 }
 
-void Aaron_Inti::_drawCarPropeller(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 propMtx = modelMtx;
-    propMtx = glm::translate(propMtx, _transProp);
-    propMtx = glm::rotate(propMtx, _propAngle, CSCI441::Z_AXIS);
-    propMtx = glm::scale(propMtx, _scaleProp);
-
-    _computeAndSendMatrixUniforms(propMtx, viewMtx, projMtx);
+void Aaron_Inti::_drawCarPropeller(const glm::mat4& viewProjMtx) const {
+    _computeAndSendMatrixUniforms(_propNode, viewProjMtx);
 
     _setMaterialColors(_colorProp, 32.0f);
 
     CSCI441::drawSolidCube(1.0f);
 }
 
-void Aaron_Inti::_drawCarHeadlights(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) {
+void Aaron_Inti::_drawCarHeadlights(const glm::mat4& viewProjMtx) {
     glm::vec3 headlightColor;
 
-    if (_isMovingBackward) {
-        headlightColor = _headlightState ? _colorHeadlightOn : _colorHeadlightOff;
+    if (_drawnAnimation.isMovingBackward) {
+        headlightColor = _drawnAnimation.headlightState ? _colorHeadlightOn : _colorHeadlightOff;
     } else {
         headlightColor = _colorHeadlightReverse;
     }
 
     for (int i = 0; i < 2; ++i) {
-        glm::mat4 lightMtx = modelMtx;
-        lightMtx = glm::translate(lightMtx, _headlightPositions[i]);
-        lightMtx = glm::scale(lightMtx, _scaleHeadlight);
-        _computeAndSendMatrixUniforms(lightMtx, viewMtx, projMtx);
+        _computeAndSendMatrixUniforms(_headlightNodes[i], viewProjMtx);
 
         _setMaterialColors(headlightColor, 64.0f);
 
@@ -173,15 +218,9 @@ void Aaron_Inti::_drawCarHeadlights(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::
     }
 }
 
-void Aaron_Inti::_drawCarWindows(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
+void Aaron_Inti::_drawCarWindows(const glm::mat4& viewProjMtx) const {
     for (int i = 0; i < 2; ++i) {
-        glm::mat4 windowMtx = modelMtx;
-
-        windowMtx = glm::translate(windowMtx, _windowPositions[i]);
-
-        windowMtx = glm::scale(windowMtx, _scaleWindow);
-
-        _computeAndSendMatrixUniforms(windowMtx, viewMtx, projMtx);
+        _computeAndSendMatrixUniforms(_windowNodes[i], viewProjMtx);
 
         _setMaterialColors(_colorWindow, 16.0f);
 
@@ -189,12 +228,11 @@ void Aaron_Inti::_drawCarWindows(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat
     }
 }
 
-void Aaron_Inti::_computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
-    glm::mat4 mvpMtx = projMtx * viewMtx * modelMtx;
+void Aaron_Inti::_computeAndSendMatrixUniforms(GLuint node, const glm::mat4& viewProjMtx) const {
+    glm::mat4 mvpMtx = viewProjMtx * _transforms->getWorldMatrix(node);
     glProgramUniformMatrix4fv(_shaderProgramHandle, _shaderProgramUniformLocations.mvpMtx, 1, GL_FALSE, glm::value_ptr(mvpMtx));
 
-    glm::mat3 normalMtx = glm::mat3(glm::transpose(glm::inverse(modelMtx)));
-    glProgramUniformMatrix3fv(_shaderProgramHandle, _shaderProgramUniformLocations.normalMtx, 1, GL_FALSE, glm::value_ptr(normalMtx));
+    glProgramUniformMatrix3fv(_shaderProgramHandle, _shaderProgramUniformLocations.normalMtx, 1, GL_FALSE, glm::value_ptr(_transforms->getNormalMatrix(node)));
 }
 
 void Aaron_Inti::_setMaterialColors(glm::vec3 color, float shininess) const {
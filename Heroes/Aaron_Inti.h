@@ -6,11 +6,30 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 
+#include <LODSelector.hpp>
+#include <TransformHierarchy.hpp>
+
 class Aaron_Inti {
 public:
-    Aaron_Inti(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation);
+    Aaron_Inti(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation,
+               CSCI441::TransformHierarchy* transforms);
+
+    // Cambia la variante del shader de iluminación con la que se dibuja
+    void setShaderProgram(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation);
+
+    // Lo que moveForward() y moveBackward() cambian y se ve al dibujar, copiado al terminar cada paso de simulación
+    struct AnimationState {
+        GLfloat propAngle;
+        bool isMovingBackward;
+        bool headlightState;
+    };
+    AnimationState getAnimationState() const;
+
+    // Copia la matriz del vehículo y el giro de ruedas y hélice a la jerarquía, una vez por frame
+    void updateTransforms( const glm::mat4& modelMtx, const AnimationState& animation );
 
-    void drawVehicle( glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx );
+    // Dibuja con las matrices ya calculadas, viewProjMtx se calcula una vez por vista
+    void drawVehicle( const glm::mat4& viewMtx, const glm::mat4& projMtx, const glm::mat4& viewProjMtx );
 
     void moveForward();
     void moveBackward();
@@ -59,19 +78,38 @@ private:
     glm::vec3 _colorHeadlightReverse;
     bool _isMovingBackward;
 
+    // Animación del último updateTransforms(), la que se dibuja
+    AnimationState _drawnAnimation;
+
+    // Nivel de detalle elegido según el tamaño del vehículo en pantalla
+    CSCI441::LODSelector _lodSelector;
+    GLuint _levelOfDetail = 0;
+
 
     const GLfloat _PI = glm::pi<float>();
     const GLfloat _2PI = glm::two_pi<float>();
     const GLfloat _PI_OVER_2 = glm::half_pi<float>();
 
-    void _drawCarBody(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
-    void _drawCarTop(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
-    void _drawCarWheels(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
-    void _drawCarPropeller(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
-    void _drawCarHeadlights(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx );
-    void _drawCarWindows(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
-
-    void _computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
+    // Nodos de cada parte en la jerarquía; los rayos son hijos de su rueda
+    static constexpr int NUM_SPOKES = 8;
+    CSCI441::TransformHierarchy* _transforms;
+    GLuint _rootNode;
+    GLuint _bodyNode;
+    GLuint _topNode;
+    GLuint _windowNodes[2];
+    GLuint _wheelNodes[4];
+    GLuint _spokeNodes[4][NUM_SPOKES];
+    GLuint _propNode;
+    GLuint _headlightNodes[2];
+
+    void _drawCarBody( const glm::mat4& viewProjMtx ) const;
+    void _drawCarTop( const glm::mat4& viewProjMtx ) const;
+    void _drawCarWheels( const glm::mat4& viewProjMtx ) const;
+    void _drawCarPropeller( const glm::mat4& viewProjMtx ) const;
+    void _drawCarHeadlights( const glm::mat4& viewProjMtx );
+    void _drawCarWindows( const glm::mat4& viewProjMtx ) const;
+
+    void _computeAndSendMatrixUniforms(GLuint node, const glm::mat4& viewProjMtx) const;
     void _setMaterialColors(glm::vec3 color, float shininess) const;
 };
 
@@ -3,11 +3,14 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <ctime>
 #include <algorithm>
-#include <iostream>
+#include <chrono>
 #include <sstream>
 
 // Definir STB_IMAGE_IMPLEMENTATION antes de incluir stb_image.h
 #define STB_IMAGE_IMPLEMENTATION
+// Reemplazo de operator new para contar reservas, solo con CSCI441_CHECK_HEAP_ALLOCATIONS
+#define CSCI441_HEAP_ALLOCATION_HOOKS_IMPLEMENTATION
+#include <HeapAllocationCheck.hpp>
 #include <objects.hpp>
 #include <stb_image.h>
 #include "Coin.h"
@@ -42,7 +45,6 @@ MP::MP()
       _gameState(PLAYING)
 {
     // Inicializar todas las teclas como no presionadas
-    for(auto& _key : _keys) _key = GL_FALSE;
     _mousePosition = glm::vec2(MOUSE_UNINITIALIZED, MOUSE_UNINITIALIZED);
     _leftMouseButtonState = GLFW_RELEASE;
 
@@ -80,8 +82,10 @@ MP::~MP() {
 }
 
 void MP::handleKeyEvent(GLint key, GLint action) {
-    if (key != GLFW_KEY_UNKNOWN)
-        _keys[key] = ((action == GLFW_PRESS) || (action == GLFW_REPEAT));
+    // El movimiento lo aplica el siguiente paso de simulación; las teclas de abajo actúan ya en este hilo
+    if (key != GLFW_KEY_UNKNOWN && action != GLFW_REPEAT && !_inputEvents.pushKey(key, action)) {
+        CSCI441_LOG_WARNING("Input event queue is full, key %d dropped", key);
+    }
 
     if (action == GLFW_PRESS) {
         switch (key) {
@@ -95,10 +99,10 @@ void MP::handleKeyEvent(GLint key, GLint action) {
                 break;
             case GLFW_KEY_Z:
                 _currentCameraMode = ARCBALL;
-                _arcballCam->setLookAtPoint(_planePosition + glm::vec3(0.0f, 1.0f, 0.0f));
+                _arcballCam->setLookAtPoint(_frameState.heroPosition + glm::vec3(0.0f, 1.0f, 0.0f));
                 _arcballCam->setCameraView(
-                    _planePosition + glm::vec3(0.0f, 10.0f, 20.0f),
-                    _planePosition + glm::vec3(0.0f, 1.0f, 0.0f),
+                    _frameState.heroPosition + glm::vec3(0.0f, 10.0f, 20.0f),
+                    _frameState.heroPosition + glm::vec3(0.0f, 1.0f, 0.0f),
                     CSCI441::Y_AXIS
                 );
                 break;
@@ -108,10 +112,38 @@ void MP::handleKeyEvent(GLint key, GLint action) {
                 break;
             case GLFW_KEY_1:
                 _isSmallViewportActive = !_isSmallViewportActive;
+                // Al volver a mostrarse la textura tiene una imagen vieja
+                _pPictureInPicture->invalidate();
+                break;
+            case GLFW_KEY_L:
+                // Alternar iluminación por vértice / por píxel, la variante se compila la primera vez
+                _perPixelLighting = !_perPixelLighting;
+                _selectLightingVariants();
+                CSCI441::HeapAllocationCheck::skipFrame();
+                break;
+            case GLFW_KEY_P:
+                // Los contadores de OpenGL solo se instalan mientras el overlay está visible
+                _isPerformanceOverlayVisible = !_isPerformanceOverlayVisible;
+                if (_isPerformanceOverlayVisible) {
+                    CSCI441::GLCallCounter::install();
+                    CSCI441::GLCallCounter::reset();
+                    // El primer frame del overlay crea sus contadores
+                    CSCI441::HeapAllocationCheck::skipFrame();
+                } else {
+                    CSCI441::GLCallCounter::uninstall();
+                }
                 break;
             case GLFW_KEY_R:
-                if (_gameState == WON || _gameState == LOST) {
-                    _resetGame();
+                if (_frameState.gameState == WON || _frameState.gameState == LOST) {
+                    // La partida se reinicia en el siguiente paso de simulación, en su propio hilo
+                    _resetRequested = true;
+
+                    // Restablecer la cámara si es necesario
+                    _arcballCam->setCameraView(
+                        glm::vec3(0.0f, 20.0f, 20.0f), // Posición del ojo
+                        glm::vec3(10.0f, 10.0f, 0.0f),    // Punto de mirada (posición del plano)
+                        CSCI441::Y_AXIS                 // Vector hacia arriba
+                    );
                 }
                 break;
             default:
@@ -176,6 +208,7 @@ void MP::mSetupGLFW() {
     glfwSetKeyCallback(mpWindow, A3_engine_keyboard_callback);
     glfwSetMouseButtonCallback(mpWindow, A3_engine_mouse_button_callback);
     glfwSetCursorPosCallback(mpWindow, A3_engine_cursor_callback);
+    glfwSetFramebufferSizeCallback(mpWindow, A3_engine_framebuffer_size_callback);
 }
 
 void MP::mSetupOpenGL() {
@@ -186,77 +219,204 @@ void MP::mSetupOpenGL() {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);	        // Usar ecuación de blending "source alpha"
 
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);	                    // Limpiar el buffer de color a negro
+
+    // Las texturas se decodifican en segundo plano y se suben poco a poco en cada cuadro
+    _pTextureLoader = new CSCI441::AsyncTextureLoader();
+    CSCI441::AssetManager::instance().setAsyncTextureLoader(_pTextureLoader);
 }
 
 void MP::mSetupShaders() {
-    // Obtener el Shader Program
-    _lightingShaderProgram = new CSCI441::ShaderProgram("shaders/A3.v.glsl", "shaders/A3.f.glsl");
+    // Propiedades de la luz direccional
+    _sceneLights.direction = glm::vec3(-1.0f, -1.0f, 1.0f);
+    _sceneLights.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
+    _sceneLights.diffuseColor = glm::vec3(1.0f, 1.0f, 1.0f);
+    _sceneLights.specularColor = glm::vec3(1.0f, 1.0f, 1.0f);
 
-    // Uniformes generales del Shader
-    _lightingShaderUniformLocations.mvpMatrix      = _lightingShaderProgram->getUniformLocation("mvpMatrix");
-    _lightingShaderUniformLocations.normalMatrix   = _lightingShaderProgram->getUniformLocation("normalMatrix");
-    _lightingShaderUniformLocations.eyePosition    = _lightingShaderProgram->getUniformLocation("eyePosition");
+    // Propiedades de la luz puntual
+    _sceneLights.pointPos = glm::vec3(0.0f, 2.0f, 0.0f);
+    _sceneLights.pointColor = glm::vec3(0.9f, 0.8f, 0.4f);
+    _sceneLights.pointConstant = 1.0f;
+    _sceneLights.pointLinear = 0.7f;
+    _sceneLights.pointQuadratic = 0.1f;
+
+    // Propiedades del spotlight
+    _sceneLights.spotPos = glm::vec3(-2.0f, 5.0f, -2.0f);
+    _sceneLights.spotDirection = glm::vec3(0.0f, -1.0f, 0.0f);
+    _sceneLights.spotColor = glm::vec3(0.7f, 0.7f, 0.7f);
+    _sceneLights.spotCutoff = glm::cos(glm::radians(15.0f));
+    _sceneLights.spotOuterCutoff = glm::cos(glm::radians(20.0f));
+    _sceneLights.spotExponent = 30.0f;
+    _sceneLights.spotConstant = 1.0f;
+    _sceneLights.spotLinear = 0.7f;
+    _sceneLights.spotQuadratic = 0.1f;
+
+    // Las luces no cambian, así que cada variante solo compila las que aportan color
+    _pLightingShaders = new CSCI441::ShaderPermutations("shaders/A3.v.glsl", "shaders/A3.f.glsl", "shaders/lighting.glsl");
+    _pLightingShaders->setDefaultDefines({
+        { "NUM_DIRECTIONAL_LIGHTS", _hasDirectionalLight() ? "1" : "0" },
+        { "NUM_POINT_LIGHTS",       _hasPointLight()       ? "1" : "0" },
+        { "NUM_SPOT_LIGHTS",        _hasSpotLight()        ? "1" : "0" }
+    });
+    _pLightingShaders->setVariantCreatedCallback([this](CSCI441::ShaderProgram& shaderProgram) {
+        _sendLightUniforms(shaderProgram);
+        _checkLightUniforms(shaderProgram);
+    });
+    _selectLightingVariants();
 
     // Atributos generales del Shader
     _lightingShaderAttributeLocations.vPos    = _lightingShaderProgram->getAttributeLocation("vPos");
     _lightingShaderAttributeLocations.vNormal = _lightingShaderProgram->getAttributeLocation("vNormal");
 
-    // Colores del material
-    _lightingShaderUniformLocations.materialAmbientColor   = _lightingShaderProgram->getUniformLocation("materialAmbientColor");
-    _lightingShaderUniformLocations.materialDiffuseColor   = _lightingShaderProgram->getUniformLocation("materialDiffuseColor");
-    _lightingShaderUniformLocations.materialSpecularColor  = _lightingShaderProgram->getUniformLocation("materialSpecularColor");
-    _lightingShaderUniformLocations.materialShininess      = _lightingShaderProgram->getUniformLocation("materialShininess");
+    _setupSkybox();
+}
 
+bool MP::_hasDirectionalLight() const {
+    return _sceneLights.ambientColor != glm::vec3(0.0f) || _sceneLights.diffuseColor != glm::vec3(0.0f) || _sceneLights.specularColor != glm::vec3(0.0f);
+}
+
+bool MP::_hasPointLight() const {
+    return _sceneLights.pointColor != glm::vec3(0.0f);
+}
+
+bool MP::_hasSpotLight() const {
+    return _sceneLights.spotColor != glm::vec3(0.0f);
+}
+
+void MP::_sendLightUniforms(CSCI441::ShaderProgram& shaderProgram) const {
     // Uniformes de la luz direccional
-    _lightingShaderUniformLocations.lightDirection     = _lightingShaderProgram->getUniformLocation("lightDirection");
-    _lightingShaderUniformLocations.lightAmbientColor  = _lightingShaderProgram->getUniformLocation("lightAmbientColor");
-    _lightingShaderUniformLocations.lightDiffuseColor  = _lightingShaderProgram->getUniformLocation("lightDiffuseColor");
-    _lightingShaderUniformLocations.lightSpecularColor = _lightingShaderProgram->getUniformLocation("lightSpecularColor");
+    if (_hasDirectionalLight()) {
+        shaderProgram.setProgramUniform("lightDirection", _sceneLights.direction);
+        shaderProgram.setProgramUniform("lightAmbientColor", _sceneLights.ambientColor);
+        shaderProgram.setProgramUniform("lightDiffuseColor", _sceneLights.diffuseColor);
+        shaderProgram.setProgramUniform("lightSpecularColor", _sceneLights.specularColor);
+    }
 
     // Uniformes de la luz puntual
-    _lightingShaderUniformLocations.pointLightPos       = _lightingShaderProgram->getUniformLocation("pointLightPos");
-    _lightingShaderUniformLocations.pointLightColor     = _lightingShaderProgram->getUniformLocation("pointLightColor");
-    _lightingShaderUniformLocations.pointLightConstant  = _lightingShaderProgram->getUniformLocation("pointLightConstant");
-    _lightingShaderUniformLocations.pointLightLinear    = _lightingShaderProgram->getUniformLocation("pointLightLinear");
-    _lightingShaderUniformLocations.pointLightQuadratic = _lightingShaderProgram->getUniformLocation("pointLightQuadratic");
+    if (_hasPointLight()) {
+        shaderProgram.setProgramUniform("pointLightPos", _sceneLights.pointPos);
+        shaderProgram.setProgramUniform("pointLightColor", _sceneLights.pointColor);
+        shaderProgram.setProgramUniform("pointLightConstant", _sceneLights.pointConstant);
+        shaderProgram.setProgramUniform("pointLightLinear", _sceneLights.pointLinear);
+        shaderProgram.setProgramUniform("pointLightQuadratic", _sceneLights.pointQuadratic);
+    }
 
     // Uniformes del spotlight
-    _lightingShaderUniformLocations.spotLightPos            = _lightingShaderProgram->getUniformLocation("spotLightPos");
-    _lightingShaderUniformLocations.spotLightDirection      = _lightingShaderProgram->getUniformLocation("spotLightDirection");
-    _lightingShaderUniformLocations.spotLightColor          = _lightingShaderProgram->getUniformLocation("spotLightColor");
-    _lightingShaderUniformLocations.spotLightCutoff         = _lightingShaderProgram->getUniformLocation("spotLightCutoff");
-    _lightingShaderUniformLocations.spotLightOuterCutoff    = _lightingShaderProgram->getUniformLocation("spotLightOuterCutoff");
-    _lightingShaderUniformLocations.spotLightExponent       = _lightingShaderProgram->getUniformLocation("spotLightExponent");
-    _lightingShaderUniformLocations.spotLightConstant       = _lightingShaderProgram->getUniformLocation("spotLightConstant");
-    _lightingShaderUniformLocations.spotLightLinear         = _lightingShaderProgram->getUniformLocation("spotLightLinear");
-    _lightingShaderUniformLocations.spotLightQuadratic      = _lightingShaderProgram->getUniformLocation("spotLightQuadratic");
+    if (_hasSpotLight()) {
+        shaderProgram.setProgramUniform("spotLightPos", _sceneLights.spotPos);
+        shaderProgram.setProgramUniform("spotLightDirection", _sceneLights.spotDirection);
+        shaderProgram.setProgramUniform("spotLightColor", _sceneLights.spotColor);
+        shaderProgram.setProgramUniform("spotLightCutoff", _sceneLights.spotCutoff);
+        shaderProgram.setProgramUniform("spotLightOuterCutoff", _sceneLights.spotOuterCutoff);
+        shaderProgram.setProgramUniform("spotLightExponent", _sceneLights.spotExponent);
+        shaderProgram.setProgramUniform("spotLightConstant", _sceneLights.spotConstant);
+        shaderProgram.setProgramUniform("spotLightLinear", _sceneLights.spotLinear);
+        shaderProgram.setProgramUniform("spotLightQuadratic", _sceneLights.spotQuadratic);
+    }
+}
 
-    _setupSkybox();
+bool MP::_checkLightUniforms(const CSCI441::ShaderProgram& shaderProgram) const {
+    const GLuint handle = shaderProgram.getShaderProgramHandle();
+    auto isSet = [handle, &shaderProgram](const char* name) {
+        const GLint location = shaderProgram.getUniformLocation(name);
+        glm::vec3 value(0.0f);
+        if (location != -1) {
+            glGetUniformfv(handle, location, &value[0]);
+        }
+        if (value == glm::vec3(0.0f)) {
+            CSCI441_LOG_ERROR("Light uniform \"%s\" of shader variant %u is zero", name, handle);
+            return false;
+        }
+        return true;
+    };
+
+    bool lightsSet = true;
+    if (_hasDirectionalLight()) lightsSet &= isSet("lightDirection");
+    if (_hasPointLight())       lightsSet &= isSet("pointLightColor");
+    if (_hasSpotLight())        lightsSet &= isSet("spotLightColor");
+    return lightsSet;
+}
+
+void MP::_selectLightingVariants() {
+    CSCI441::ShaderPermutations::Defines defines;
+    if (_perPixelLighting) {
+        defines["PER_PIXEL_LIGHTING"] = "";
+    }
+
+    // Terreno y héroe: matrices y material como uniformes
+    _lightingShaderProgram = _pLightingShaders->getVariant(defines);
+
+    _lightingShaderUniformLocations.mvpMatrix      = _lightingShaderProgram->getUniformLocation("mvpMatrix");
+    _lightingShaderUniformLocations.normalMatrix   = _lightingShaderProgram->getUniformLocation("normalMatrix");
+    _lightingShaderUniformLocations.eyePosition    = _lightingShaderProgram->getUniformLocation("eyePosition");
+
+    // Colores del material
+    _lightingShaderUniformLocations.materialAmbientColor   = _lightingShaderProgram->getUniformLocation("materialAmbientColor");
+    _lightingShaderUniformLocations.materialDiffuseColor   = _lightingShaderProgram->getUniformLocation("materialDiffuseColor");
+    _lightingShaderUniformLocations.materialSpecularColor  = _lightingShaderProgram->getUniformLocation("materialSpecularColor");
+    _lightingShaderUniformLocations.materialShininess      = _lightingShaderProgram->getUniformLocation("materialShininess");
+
+    // Misma iluminación, pero matrices y material por dibujo llegan como atributos del lote;
+    // las ubicaciones son fijas en el shader, así que el VAO del lote sirve para todas las variantes
+    defines["INSTANCED"] = "";
+    _batchedShaderProgram = _pLightingShaders->getVariant(defines);
+    _batchedEyePositionLocation = _batchedShaderProgram->getUniformLocation("eyePosition");
+
+    if (_pPlane != nullptr) {
+        _pPlane->setShaderProgram(_lightingShaderProgram->getShaderProgramHandle(),
+                                  _lightingShaderUniformLocations.mvpMatrix,
+                                  _lightingShaderUniformLocations.normalMatrix);
+    }
 }
 
 void MP::mSetupBuffers() {
     CSCI441::setVertexAttributeLocations(_lightingShaderAttributeLocations.vPos, _lightingShaderAttributeLocations.vNormal);
 
+    // El lote lee las figuras del buffer compartido y los datos por dibujo como atributos por instancia
+    CSCI441::DrawBatcher::AttributeLocations batchedLocations;
+    batchedLocations.vPos                  = _batchedShaderProgram->getAttributeLocation("vPos");
+    batchedLocations.vNormal               = _batchedShaderProgram->getAttributeLocation("vNormal");
+    batchedLocations.mvpMatrix             = _batchedShaderProgram->getAttributeLocation("mvpMatrix");
+    batchedLocations.normalMatrix          = _batchedShaderProgram->getAttributeLocation("normalMatrix");
+    batchedLocations.materialAmbientColor  = _batchedShaderProgram->getAttributeLocation("materialAmbientColor");
+    batchedLocations.materialDiffuseColor  = _batchedShaderProgram->getAttributeLocation("materialDiffuseColor");
+    batchedLocations.materialSpecularColor = _batchedShaderProgram->getAttributeLocation("materialSpecularColor");
+    batchedLocations.materialShininess     = _batchedShaderProgram->getAttributeLocation("materialShininess");
+
+    _pDrawBatcher = new CSCI441::DrawBatcher();
+    _pDrawBatcher->setup(CSCI441::getShapeVertexBuffer(), CSCI441::getShapeIndexBuffer(),
+                         CSCI441::getShapeVertexFormat(), batchedLocations);
+    fprintf(stdout, "[INFO]: Draw batching uses %s\n",
+            _pDrawBatcher->isMultiDrawIndirectSupported() ? "glMultiDrawElementsIndirect" : "one instanced draw per mesh");
+
     // Inicializar el modelo del héroe (Aaron_Inti)
     _pPlane = new Aaron_Inti(_lightingShaderProgram->getShaderProgramHandle(),
                              _lightingShaderUniformLocations.mvpMatrix,
-                             _lightingShaderUniformLocations.normalMatrix);
+                             _lightingShaderUniformLocations.normalMatrix,
+                             &_sceneTransforms);
 
     // Inicializar las monedas
     for(int i = 0; i < 4; ++i) {
-        _coins[i] = new Coin(_lightingShaderProgram->getShaderProgramHandle(),
-                             _lightingShaderUniformLocations.mvpMatrix,
-                             _lightingShaderUniformLocations.normalMatrix);
+        _coins[i] = new Coin(&_sceneTransforms);
     }
 
     // Inicializar los zombies
     for(int i = 0; i < NUM_ZOMBIES; ++i) {
-        _zombies[i] = new Zombie(_lightingShaderProgram->getShaderProgramHandle(),
-                                 _lightingShaderUniformLocations.mvpMatrix,
-                                 _lightingShaderUniformLocations.normalMatrix);
+        _zombies[i] = new Zombie(&_sceneTransforms, &_animationScheduler);
     }
     _hudShaderProgram = new CSCI441::ShaderProgram("shaders/hud.v.glsl", "shaders/hud.f.glsl");
+    _pPerformanceOverlay = new CSCI441::PerformanceOverlay();
+    _pPerformanceOverlay->setup(_hudShaderProgram->getAttributeLocation("aPos"),
+                                _hudShaderProgram->getAttributeLocation("aTexCoords"),
+                                _hudShaderProgram->getAttributeLocation("aColor"));
+    _pDynamicResolution = new CSCI441::DynamicResolution();
+    _pPictureInPicture = new CSCI441::CachedView(_pictureInPictureSettings.width, _pictureInPictureSettings.height,
+                                                 _pictureInPictureSettings.updateRate);
+    // La proyección de la vista pequeña solo depende de su textura, no de la ventana
+    _pictureInPictureProjection = glm::perspective(glm::radians(45.0f), _pPictureInPicture->getAspectRatio(), 0.1f, 1000.0f);
+    _pDynamicResolution->setEnabled(_isDynamicResolutionEnabled);
     _createGroundBuffers();
+    _groundNode = _sceneTransforms.addNode();
+    _sceneTransforms.setLocalMatrix(_groundNode, glm::scale(glm::mat4(1.0f), glm::vec3(WORLD_SIZE, 1.0f, WORLD_SIZE)));
 
     float heartVertices[] = {
         // Posiciones    // Coordenadas de textura
@@ -442,145 +602,42 @@ void MP::mSetupScene() {
         }
     }
 
-    // Configurar la matriz de proyección
-    int width, height;
-    glfwGetFramebufferSize(mpWindow, &width, &height);
-    float aspectRatio = static_cast<float>(width) / static_cast<float>(height);
-    _projectionMatrix = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 1000.0f);
+    // Configurar la matriz de proyección; después solo se recalcula al cambiar el tamaño
+    glfwGetFramebufferSize(mpWindow, &framebufferWidth, &framebufferHeight);
+    _updateProjections();
     _cameraSpeed = glm::vec2(0.25f, 0.02f);
 
-    // Propiedades de la luz direccional
-    glm::vec3 lightDirection = glm::vec3(-1.0f, -1.0f, 1.0f);
-    glm::vec3 lightAmbientColor = glm::vec3(0.2f, 0.2f, 0.2f);
-    glm::vec3 lightDiffuseColor = glm::vec3(1.0f, 1.0f, 1.0f);
-    glm::vec3 lightSpecularColor = glm::vec3(1.0f, 1.0f, 1.0f);
-
-    // Uniformes de la luz direccional
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.lightDirection, lightDirection);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.lightAmbientColor, lightAmbientColor);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.lightDiffuseColor, lightDiffuseColor);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.lightSpecularColor, lightSpecularColor);
-
-    // Propiedades de la luz puntual
-    glm::vec3 pointLightPos = glm::vec3(0.0f, 2.0f, 0.0f);
-    glm::vec3 pointLightColor = glm::vec3(0.9f, 0.8f, 0.4f);
-    float pointLightConstant = 1.0f;
-    float pointLightLinear = 0.7f;
-    float pointLightQuadratic = 0.1f;
-
-    // Uniformes de la luz puntual
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.pointLightPos, pointLightPos);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.pointLightColor, pointLightColor);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.pointLightConstant, pointLightConstant);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.pointLightLinear, pointLightLinear);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.pointLightQuadratic, pointLightQuadratic);
-
-    // Propiedades del spotlight
-    glm::vec3 spotLightPos = glm::vec3(-2.0f, 5.0f, -2.0f);
-    glm::vec3 spotLightDirection = glm::vec3(0.0f, -1.0f, 0.0f);
-    glm::vec3 spotLightColor = glm::vec3(0.7f, 0.7f, 0.7f);
-    float spotLightCutoff = glm::cos(glm::radians(15.0f));
-    float spotLightOuterCutoff = glm::cos(glm::radians(20.0f));
-    float spotLightExponent = 30.0f;
-    float spotLightConstant = 1.0f;
-    float spotLightLinear = 0.7f;
-    float spotLightQuadratic = 0.1f;
-
-    // Uniformes del spotlight
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.spotLightPos, spotLightPos);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.spotLightDirection, spotLightDirection);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.spotLightColor, spotLightColor);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.spotLightCutoff, spotLightCutoff);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.spotLightOuterCutoff, spotLightOuterCutoff);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.spotLightExponent, spotLightExponent);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.spotLightConstant, spotLightConstant);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.spotLightLinear, spotLightLinear);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.spotLightQuadratic, spotLightQuadratic);
-
-    _setupSkybox();
-
-    int heart_width, heart_height, nrChannels;
-    unsigned char *data = stbi_load("textures/heart.png", &heart_width, &heart_height, &nrChannels, 0);
-    if (data) {
-        glGenTextures(1, &_heartTexture);
-        glBindTexture(GL_TEXTURE_2D, _heartTexture);
-
-        // Configurar los parámetros de la textura
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        GLenum format = GL_RGBA; // Asegúrate de que la imagen tenga canal alfa
-        if (nrChannels == 3)
-            format = GL_RGB;
+    // El skybox ya se creó en mSetupShaders(); crearlo otra vez tomaría una segunda referencia a su textura
 
-        glTexImage2D(GL_TEXTURE_2D, 0, format, heart_width, heart_height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+    // Las texturas del HUD se comparten a través del AssetManager
+    CSCI441::AssetManager& assetManager = CSCI441::AssetManager::instance();
 
-        stbi_image_free(data);
-    } else {
-        std::cout << "Failed to load heart texture" << std::endl;
+    _heartTexture = assetManager.acquireTexture("textures/heart.png", GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_FALSE);
+    if (_heartTexture == 0) {
+        CSCI441_LOG_ERROR("Failed to load heart texture");
     }
 
-    int win_width, win_height, win_nrChannels;
-    unsigned char *win_data = stbi_load("textures/you_win.png", &win_width, &win_height, &win_nrChannels, 0);
-    if (win_data) {
-        glGenTextures(1, &_winTexture);
-        glBindTexture(GL_TEXTURE_2D, _winTexture);
-
-        // Configurar los parámetros de la textura
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        GLenum format = GL_RGBA;
-        if (win_nrChannels == 3)
-            format = GL_RGB;
-
-        glTexImage2D(GL_TEXTURE_2D, 0, format, win_width, win_height, 0, format, GL_UNSIGNED_BYTE, win_data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        stbi_image_free(win_data);
-    } else {
-        std::cout << "Failed to load 'You Win' texture" << std::endl;
+    _winTexture = assetManager.acquireTexture("textures/you_win.png", GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_FALSE);
+    if (_winTexture == 0) {
+        CSCI441_LOG_ERROR("Failed to load 'You Win' texture");
     }
 
-    int lost_width, lost_height, lost_nrChannels;
-    unsigned char *lost_data = stbi_load("textures/you_lost.png", &lost_width, &lost_height, &lost_nrChannels, 0);
-    if (lost_data) {
-        glGenTextures(1, &_lostTexture);
-        glBindTexture(GL_TEXTURE_2D, _lostTexture);
-
-        // Configurar los parámetros de la textura
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        GLenum format = GL_RGBA;
-        if (lost_nrChannels == 3)
-            format = GL_RGB;
-
-        glTexImage2D(GL_TEXTURE_2D, 0, format, lost_width, lost_height, 0, format, GL_UNSIGNED_BYTE, lost_data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        stbi_image_free(lost_data);
-    } else {
-        std::cout << "Failed to load 'You Lost' texture" << std::endl;
+    _lostTexture = assetManager.acquireTexture("textures/you_lost.png", GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_FALSE);
+    if (_lostTexture == 0) {
+        CSCI441_LOG_ERROR("Failed to load 'You Lost' texture");
     }
 }
 
 void MP::mCleanupShaders() {
     fprintf(stdout, "[INFO]: ...deleting Shaders.\n");
-    delete _lightingShaderProgram;
+    delete _pLightingShaders;
     fprintf(stdout, "[INFO]: ...deleting Skybox Shaders.\n");
     delete _skyboxShaderProgram;
 }
 
 void MP::mCleanupBuffers() {
     fprintf(stdout, "[INFO]: ...deleting VAOs....\n");
+    delete _pDrawBatcher;
     CSCI441::deleteObjectVAOs();
     glDeleteVertexArrays(1, &_groundVAO);
     glDeleteVertexArrays(1, &_skyboxVAO);
@@ -593,113 +650,287 @@ void MP::mCleanupBuffers() {
 
     fprintf(stdout, "[INFO]: ...deleting models..\n");
     delete _pPlane;
-    glDeleteTextures(1, &_heartTexture);
+    delete _pPerformanceOverlay;
+    delete _pDynamicResolution;
+    delete _pPictureInPicture;
+
+    fprintf(stdout, "[INFO]: ...releasing textures....\n");
+    CSCI441::AssetManager& assetManager = CSCI441::AssetManager::instance();
+    assetManager.releaseTexture(_heartTexture);
+    assetManager.releaseTexture(_winTexture);
+    assetManager.releaseTexture(_lostTexture);
+    assetManager.releaseTexture(_skyboxTexture);
+    assetManager.evictUnused();
+    assetManager.setAsyncTextureLoader(nullptr);
+    delete _pTextureLoader;
 
     glDeleteVertexArrays(1, &_winVAO);
     glDeleteBuffers(1, &_winVBO);
-    glDeleteTextures(1, &_winTexture);
 
     glDeleteVertexArrays(1, &_lostVAO);
     glDeleteBuffers(1, &_lostVBO);
-    glDeleteTextures(1, &_lostTexture);
 }
 
-void MP::_renderScene(glm::mat4 viewMtx, glm::mat4 projMtx, glm::vec3 eyePosition) const {
+MP::VisibleEntities::VisibleEntities(CSCI441::FrameArena& arena) : coins(arena), zombies(arena) {
+    // Reservar el peor caso de una vez; el arena no recupera lo que suelta un vector al crecer
+    coins.reserve(4);
+    zombies.reserve(NUM_ZOMBIES);
+}
 
-    // Dibujar el Skybox
-    glDepthFunc(GL_LEQUAL);
-    _skyboxShaderProgram->useProgram();
+void MP::_cullScene(const glm::mat4& mainViewProjMtx, VisibleEntities& mainVisible,
+                    const glm::mat4* pictureInPictureViewProjMtx, VisibleEntities& pictureInPictureVisible) const {
+    glm::vec3 center;
+    float radius;
+    const auto isVisibleIn = [&](const glm::mat4* viewProjMtx) {
+        return viewProjMtx != nullptr && CSCI441::AnimationScheduler::isVisible(center, radius, *viewProjMtx);
+    };
 
-    glm::mat4 view = glm::mat4(glm::mat3(viewMtx)); // Eliminar la traslación de la matriz de vista
-    _skyboxShaderProgram->setProgramUniform("view", view);
-    _skyboxShaderProgram->setProgramUniform("projection", projMtx);
+    for (GLuint i = 0; i < 4; ++i) {
+        if (_frameState.coinActive[i]) {
+            _coins[i]->getBoundingSphere(center, radius);
+            if (isVisibleIn(&mainViewProjMtx)) mainVisible.coins.push_back(i);
+            if (isVisibleIn(pictureInPictureViewProjMtx)) pictureInPictureVisible.coins.push_back(i);
+        }
+    }
+    for (GLuint i = 0; i < NUM_ZOMBIES; ++i) {
+        if (_zombies[i] != nullptr && _frameState.zombies[i].isActive) {
+            _zombies[i]->getBoundingSphere(center, radius);
+            if (isVisibleIn(&mainViewProjMtx)) mainVisible.zombies.push_back(i);
+            if (isVisibleIn(pictureInPictureViewProjMtx)) pictureInPictureVisible.zombies.push_back(i);
+        }
+    }
+}
 
-    glBindVertexArray(_skyboxVAO);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, _skyboxTexture);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
-    glBindVertexArray(0);
-    glDepthFunc(GL_LESS);
+void MP::_renderScene(glm::mat4 viewMtx, glm::mat4 projMtx, glm::vec3 eyePosition, const VisibleEntities& visible) const {
+    // Una sola multiplicación por vista, las matrices de modelo ya están en _sceneTransforms
+    const glm::mat4 viewProjMtx = projMtx * viewMtx;
+
+    // Dibujar el Skybox
+    {
+        CSCI441_PROFILE_GPU_ZONE("Skybox");
+        glDepthFunc(GL_LEQUAL);
+        _skyboxShaderProgram->useProgram();
+
+        glm::mat4 view = glm::mat4(glm::mat3(viewMtx)); // Eliminar la traslación de la matriz de vista
+        _skyboxShaderProgram->setProgramUniform("view", view);
+        _skyboxShaderProgram->setProgramUniform("projection", projMtx);
+
+        glBindVertexArray(_skyboxVAO);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, _skyboxTexture);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+        glBindVertexArray(0);
+        glDepthFunc(GL_LESS);
+    }
 
     // Usar el shader de iluminación
     _lightingShaderProgram->useProgram();
     _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.eyePosition, eyePosition);
 
     //// INICIO DIBUJANDO EL PLANO DE TERRENO ////
-    // Dibujar el plano de terreno
-    glm::mat4 groundModelMtx = glm::scale(glm::mat4(1.0f), glm::vec3(WORLD_SIZE, 1.0f, WORLD_SIZE));
-    _computeAndSendMatrixUniforms(groundModelMtx, viewMtx, projMtx);
+    {
+        CSCI441_PROFILE_GPU_ZONE("Ground");
+        // Dibujar el plano de terreno
+        _computeAndSendMatrixUniforms(_groundNode, viewProjMtx);
+
+        glm::vec3 groundAmbientColor = glm::vec3(0.25f, 0.25f, 0.25f);
+        glm::vec3 groundDiffuseColor = glm::vec3(0.3f, 0.8f, 0.2f); // Color existente del terreno
+        glm::vec3 groundSpecularColor = glm::vec3(0.0f, 0.0f, 0.0f); // Sin especular para el terreno
+        float groundShininess = 0.1f;
+
+        _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialAmbientColor, groundAmbientColor);
+        _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialDiffuseColor, groundDiffuseColor);
+        _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialSpecularColor, groundSpecularColor);
+        _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialShininess, groundShininess);
+
+        glBindVertexArray(_groundVAO);
+        glDrawElements(GL_TRIANGLE_STRIP, _numGroundPoints, GL_UNSIGNED_SHORT, (void*)0);
+    }
+    //// FIN DIBUJANDO EL PLANO DE TERRENO ////
 
-    glm::vec3 groundAmbientColor = glm::vec3(0.25f, 0.25f, 0.25f);
-    glm::vec3 groundDiffuseColor = glm::vec3(0.3f, 0.8f, 0.2f); // Color existente del terreno
-    glm::vec3 groundSpecularColor = glm::vec3(0.0f, 0.0f, 0.0f); // Sin especular para el terreno
-    float groundShininess = 0.1f;
+    /// INICIO DIBUJANDO EL HERO (Aaron_Inti) ////
+    {
+        CSCI441_PROFILE_GPU_ZONE("Hero");
+        glm::vec3 heroAmbientColor = glm::vec3(0.1f, 0.0f, 0.0f);
+        glm::vec3 heroDiffuseColor = glm::vec3(0.7f, 0.0f, 0.0f);
+        glm::vec3 heroSpecularColor = glm::vec3(1.0f, 1.0f, 1.0f);
+        float heroShininess = 32.0f;
+
+        _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialAmbientColor, heroAmbientColor);
+        _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialDiffuseColor, heroDiffuseColor);
+        _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialSpecularColor, heroSpecularColor);
+        _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialShininess, heroShininess);
+
+        _pPlane->setDamaged(_frameState.heroDamaged);
+        _pPlane->drawVehicle(viewMtx, projMtx, viewProjMtx);
+    }
+    /// FIN DIBUJANDO EL HERO (Aaron_Inti) ////
 
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialAmbientColor, groundAmbientColor);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialDiffuseColor, groundDiffuseColor);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialSpecularColor, groundSpecularColor);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialShininess, groundShininess);
+    // Las monedas y los zombies se acumulan en el lote y se dibujan juntos al final
+    _pDrawBatcher->clear();
 
-    glBindVertexArray(_groundVAO);
-    glDrawElements(GL_TRIANGLE_STRIP, _numGroundPoints, GL_UNSIGNED_SHORT, (void*)0);
-    //// FIN DIBUJANDO EL PLANO DE TERRENO ////
+    // Dibujar las monedas
+    {
+        CSCI441_PROFILE_ZONE("Coins");
+        for (const GLuint i : visible.coins) {
+            _coins[i]->drawCoin(*_pDrawBatcher, viewMtx, projMtx, viewProjMtx);
+        }
+    }
 
-    /// INICIO DIBUJANDO EL HERO (Aaron_Inti) ////
-    glm::vec3 heroAmbientColor = glm::vec3(0.1f, 0.0f, 0.0f);
-    glm::vec3 heroDiffuseColor = glm::vec3(0.7f, 0.0f, 0.0f);
-    glm::vec3 heroSpecularColor = glm::vec3(1.0f, 1.0f, 1.0f);
-    float heroShininess = 32.0f;
+    /// INICIO DIBUJANDO LOS ZOMBIES ///
+    // Cada parte lleva su propio material en el lote
+    {
+        CSCI441_PROFILE_ZONE("Zombies");
+        // Cada zombie informa al planificador de su tamaño en pantalla
+        std::lock_guard<std::mutex> lock(_animationSchedulerMutex);
+        for(const GLuint i : visible.zombies) {
+            _zombies[i]->drawVehicle(*_pDrawBatcher, viewMtx, projMtx, viewProjMtx);
+        }
+    }
+    /// FIN DIBUJANDO LOS ZOMBIES ///
 
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialAmbientColor, heroAmbientColor);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialDiffuseColor, heroDiffuseColor);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialSpecularColor, heroSpecularColor);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialShininess, heroShininess);
+    // Una llamada por figura distinta, o una sola con multi draw indirect
+    CSCI441_PROFILE_GPU_ZONE("Coins + Zombies");
+    _batchedShaderProgram->useProgram();
+    _batchedShaderProgram->setProgramUniform(_batchedEyePositionLocation, eyePosition);
+    _pDrawBatcher->submit();
+}
 
+void MP::_updateTransforms() {
     glm::mat4 heroModelMtx(1.0f);
-    heroModelMtx = glm::translate(heroModelMtx, _planePosition);
+    heroModelMtx = glm::translate(heroModelMtx, _frameState.heroPosition);
     heroModelMtx = glm::translate(heroModelMtx, glm::vec3(0.0f, 1.3f, 0.0f));
-    heroModelMtx = glm::rotate(heroModelMtx, _planeHeading, CSCI441::Y_AXIS);
-    if (_isHeroFalling) {
+    heroModelMtx = glm::rotate(heroModelMtx, _frameState.heroHeading, CSCI441::Y_AXIS);
+    if (_frameState.heroFalling) {
         // Aplicar rotación adicional alrededor del eje X o Z para simular giro
-        heroModelMtx = glm::rotate(heroModelMtx, _heroFallRotation, CSCI441::X_AXIS);
+        heroModelMtx = glm::rotate(heroModelMtx, _frameState.heroFallRotation, CSCI441::X_AXIS);
     }
-    _pPlane->setDamaged(_isHeroDamaged);
-    _pPlane->drawVehicle(heroModelMtx, viewMtx, projMtx);
-    /// FIN DIBUJANDO EL HERO (Aaron_Inti) ////
+    _pPlane->updateTransforms(heroModelMtx, _frameState.heroAnimation);
 
-    // Dibujar las monedas
+    // Las monedas no se mueven, así que después del primer frame no se recalculan
     for (int i = 0; i < 4; ++i) {
-        if (_coins[i]->isActive()) {
-            glm::mat4 coinModelMtx(1.0f);
-            coinModelMtx = glm::translate(coinModelMtx, _coinPositions[i]);
-            // Si aplicaste alguna rotación antes, puedes mantenerla
-            // coinModelMtx = glm::rotate(coinModelMtx, glm::radians(-90.0f), CSCI441::X_AXIS);
-            _coins[i]->drawCoin(coinModelMtx, viewMtx, projMtx);
+        _coins[i]->setModelMatrix(glm::translate(glm::mat4(1.0f), _frameState.coinPositions[i]));
+    }
+
+    for(int i = 0; i < NUM_ZOMBIES; ++i) {
+        if(_zombies[i] != nullptr && _frameState.zombies[i].isActive) {
+            _zombies[i]->updateTransforms(_frameState.zombies[i]);
         }
     }
 
-    /// INICIO DIBUJANDO LOS ZOMBIES ///
-    glm::vec3 zombieAmbientColor = glm::vec3(0.0f, 0.1f, 0.0f); // Opcional: color ambiental general para zombies
-    glm::vec3 zombieDiffuseColor = glm::vec3(0.0f, 0.0f, 1.0f); // Opcional: color difuso general para zombies
-    glm::vec3 zombieSpecularColor = glm::vec3(0.5f, 0.5f, 0.5f); // Opcional: color especular general para zombies
-    float zombieShininess = 32.0f;
+    _sceneTransforms.update();
+}
 
-    // Configurar los colores del material para los zombies
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialAmbientColor, zombieAmbientColor);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialDiffuseColor, zombieDiffuseColor);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialSpecularColor, zombieSpecularColor);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialShininess, zombieShininess);
+void MP::_followHero() {
+    float Y_OFFSET = 2.0f;
+    glm::vec3 intiLookAtPoint = _frameState.heroPosition + glm::vec3(0.0f, Y_OFFSET, 0.0f);
+    _arcballCam->setLookAtPoint(intiLookAtPoint);
+    _updateIntiFirstPersonCamera();
+}
 
-    for(int i = 0; i < NUM_ZOMBIES; ++i) {
-        if(_zombies[i] != nullptr && _zombies[i]->isActive) {
-            glm::mat4 zombieModelMtx(1.0f);
-            _zombies[i]->drawVehicle(zombieModelMtx, viewMtx, projMtx);
+void MP::_sampleInput(InputState& input) {
+    std::fill(input.pressed, input.pressed + NUM_KEYS, GL_FALSE);
+    input.oldestEventTime = std::chrono::steady_clock::time_point{};
+
+    // Aplicar en orden todo lo que llegó hasta este instante
+    CSCI441::InputEvent event;
+    while (_inputEvents.pop(event)) {
+        if (input.oldestEventTime == std::chrono::steady_clock::time_point{}) {
+            input.oldestEventTime = event.timestamp;
         }
+        if (event.key < 0 || event.key >= static_cast<GLint>(NUM_KEYS)) {
+            continue;
+        }
+        const bool isPress = (event.action == GLFW_PRESS);
+        input.keys[event.key] = isPress;
+        if (isPress) input.pressed[event.key] = GL_TRUE;
+    }
+    input.cameraMode = _currentCameraMode;
+}
+
+void MP::_captureSnapshot(GameSnapshot& snapshot) const {
+    snapshot.gameState = _gameState;
+    snapshot.heroPosition = _planePosition;
+    snapshot.heroHeading = _planeHeading;
+    snapshot.heroFalling = _isHeroFalling;
+    snapshot.heroFallRotation = _heroFallRotation;
+    snapshot.heroDamaged = _isHeroDamaged;
+    snapshot.heroLives = _heroLives;
+    snapshot.heroAnimation = _pPlane->getAnimationState();
+
+    for (int i = 0; i < 4; ++i) {
+        snapshot.coinActive[i] = _coins[i]->isActive();
+        snapshot.coinPositions[i] = _coinPositions[i];
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_animationSchedulerMutex);
+        for (int i = 0; i < NUM_ZOMBIES; ++i) {
+            snapshot.zombies[i] = _zombies[i]->getState();
+        }
+    }
+
+    snapshot.simulationTimeMs = _simulationTimeMs;
+    snapshot.collisionPairsTested = _collisionPairsTested;
+    snapshot.collisionPairsColliding = _collisionPairsColliding;
+    snapshot.inputEventTime = _inputEventTime;
+}
+
+void MP::_simulate(const InputState& input, float deltaTime) {
+    if (_resetRequested.exchange(false)) {
+        _resetGame();
+    }
+    if (input.oldestEventTime != std::chrono::steady_clock::time_point{}) {
+        _inputEventTime = input.oldestEventTime;
+    }
+
+    if (_gameState == PLAYING) {
+        CSCI441_PROFILE_ZONE("Update");
+        const auto simulationStart = std::chrono::steady_clock::now();
+        _updateScene(input, deltaTime);
+        _simulationTimeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - simulationStart).count();
+    }
+}
+
+void MP::_simulationLoop() {
+    CSCI441_PROFILE_THREAD_NAME("Simulation");
+    CSCI441::FrameArena::forThisThread().setName("Simulation frame arena");
+
+    auto previousTime = std::chrono::steady_clock::now();
+    GLuint numSteps = 0;
+
+    // Esperar a que el render tome el último estado antes de leer la entrada;
+    // así la entrada nunca espera en un estado encolado más de un frame
+    while (_snapshots.waitUntilConsumed() && !_stopSimulation) {
+        CSCI441_PROFILE_ZONE("Step");
+        _sampleInput(_simulationInput);
+
+        const auto currentTime = std::chrono::steady_clock::now();
+        const float deltaTime = std::chrono::duration<float>(currentTime - previousTime).count();
+        previousTime = currentTime;
+
+        {
+            std::lock_guard<std::mutex> lock(_animationSchedulerMutex);
+            _animationScheduler.beginFrame();
+        }
+        _simulate(_simulationInput, deltaTime);
+
+        _captureSnapshot(_snapshots.getWriteBuffer());
+        _snapshots.publish();
+
+        _endFrameAllocations(numSteps, "simulation step");
+    }
+}
+
+void MP::_endFrameAllocations(GLuint& numFrames, const char* frameName) {
+    CSCI441::FrameArena::forThisThread().reset();
+    CSCI441::HeapAllocationCheck::endFrame(frameName);
+    if (++numFrames == HEAP_CHECK_WARMUP_FRAMES) {
+        CSCI441::HeapAllocationCheck::beginSteadyState();
     }
-    /// FIN DIBUJANDO LOS ZOMBIES ///
 }
 
-void MP::_updateScene(float deltaTime) {
+void MP::_updateScene(const InputState& input, float deltaTime) {
     float moveSpeed = 0.1f;
     float rotateSpeed = glm::radians(1.5f);
 
@@ -708,10 +939,10 @@ void MP::_updateScene(float deltaTime) {
     const float MIN_Z = -WORLD_SIZE + 3.0f;
     const float MAX_Z = WORLD_SIZE - 3.0f;
 
-    switch (_currentCameraMode) {
+    switch (input.cameraMode) {
         case ARCBALL:
             if (_selectedCharacter == AARON_INTI) {
-                if (_keys[GLFW_KEY_W]) {
+                if (input.isDown(GLFW_KEY_W)) {
                     glm::vec3 direction(
                         sinf(_planeHeading),
                         0.0f,
@@ -725,7 +956,7 @@ void MP::_updateScene(float deltaTime) {
                     }
                     _pPlane->moveBackward();
                 }
-                if (_keys[GLFW_KEY_S]) {
+                if (input.isDown(GLFW_KEY_S)) {
                     glm::vec3 direction(
                         sinf(_planeHeading),
                         0.0f,
@@ -739,10 +970,10 @@ void MP::_updateScene(float deltaTime) {
                     }
                     _pPlane->moveForward();
                 }
-                if (_keys[GLFW_KEY_A]) {
+                if (input.isDown(GLFW_KEY_A)) {
                     _planeHeading += rotateSpeed;
                 }
-                if (_keys[GLFW_KEY_D]) {
+                if (input.isDown(GLFW_KEY_D)) {
                     _planeHeading -= rotateSpeed;
                 }
 
@@ -750,16 +981,11 @@ void MP::_updateScene(float deltaTime) {
                     _planeHeading -= glm::two_pi<float>();
                 else if (_planeHeading < 0.0f)
                     _planeHeading += glm::two_pi<float>();
-
-                float Y_OFFSET = 2.0f;
-                glm::vec3 intiLookAtPoint = _planePosition + glm::vec3(0.0f, Y_OFFSET, 0.0f);
-                _arcballCam->setLookAtPoint(intiLookAtPoint);
-                _updateIntiFirstPersonCamera();
             }
             break;
         case FIRST_PERSON_CAM: {
             if (_selectedCharacter == AARON_INTI) {
-                if (_keys[GLFW_KEY_W]) {
+                if (input.isDown(GLFW_KEY_W)) {
                     glm::vec3 direction(
                         sinf(_planeHeading),
                         0.0f,
@@ -771,7 +997,7 @@ void MP::_updateScene(float deltaTime) {
                     _planePosition = newPosition;
                     _pPlane->moveBackward();
                 }
-                if (_keys[GLFW_KEY_S]) {
+                if (input.isDown(GLFW_KEY_S)) {
                     glm::vec3 direction(
                         sinf(_planeHeading),
                         0.0f,
@@ -783,10 +1009,10 @@ void MP::_updateScene(float deltaTime) {
                     _planePosition = newPosition;
                     _pPlane->moveForward();
                 }
-                if (_keys[GLFW_KEY_A]) {
+                if (input.isDown(GLFW_KEY_A)) {
                     _planeHeading += rotateSpeed;
                 }
-                if (_keys[GLFW_KEY_D]) {
+                if (input.isDown(GLFW_KEY_D)) {
                     _planeHeading -= rotateSpeed;
                 }
 
@@ -794,11 +1020,6 @@ void MP::_updateScene(float deltaTime) {
                     _planeHeading -= glm::two_pi<float>();
                 else if (_planeHeading < 0.0f)
                     _planeHeading += glm::two_pi<float>();
-
-                float Y_OFFSET = 2.0f;
-                glm::vec3 intiLookAtPoint = _planePosition + glm::vec3(0.0f, Y_OFFSET, 0.0f);
-                _arcballCam->setLookAtPoint(intiLookAtPoint);
-                _updateIntiFirstPersonCamera();
             }
             break;
         }
@@ -824,7 +1045,7 @@ void MP::_updateScene(float deltaTime) {
                 _coins[i]->deactivate();
 
                 // Opcional: Puedes llevar un conteo de monedas recogidas o desencadenar algún evento
-                std::cout << "¡Moneda recogida!" << std::endl;
+                CSCI441_LOG_INFO("¡Moneda recogida!");
             }
         }
     }
@@ -839,7 +1060,7 @@ void MP::_updateScene(float deltaTime) {
 
     if (allCoinsCollected && _gameState == PLAYING) {
         _gameState = WON;
-        std::cout << "¡Has ganado el juego!" << std::endl;
+        CSCI441_LOG_INFO("¡Has ganado el juego!");
     }
 
     if (_gameState == PLAYING) {
@@ -867,9 +1088,14 @@ void MP::_updateScene(float deltaTime) {
         }
 
         _moveZombies(deltaTime);
-        _collideZombiesWithZombies();
+        {
+            CSCI441_PROFILE_ZONE("Collisions");
+            _collisionPairsTested = 0;
+            _collisionPairsColliding = 0;
+            _collideZombiesWithZombies();
 
-        _collideHeroWithZombies(deltaTime);
+            _collideHeroWithZombies(deltaTime);
+        }
 
         // Actualizar el temporizador de daño del héroe
         if(_isHeroDamaged) {
@@ -891,36 +1117,128 @@ void MP::_updateScene(float deltaTime) {
             // Cuando alcance cierta altura, finalizar la caída
             if (_planePosition.y <= -60.0f) { // Altura límite
                 _gameState = LOST;
-                std::cout << "¡El héroe ha caído fuera del mundo! Game Over." << std::endl;
+                CSCI441_LOG_INFO("¡El héroe ha caído fuera del mundo! Game Over.");
             }
         }
     }
 
 }
 
+void MP::enableBenchmark(const BenchmarkSettings& settings) {
+    _isBenchmark = true;
+    _benchmarkSettings = settings;
+    setHeadless(true);
+
+    // Misma posición de zombies y monedas en cada ejecución
+    srand(1);
+}
+
+void MP::enablePipelining() {
+    _isPipelined = true;
+}
+
+void MP::setTargetFrameRate(double framesPerSecond) {
+    _framePacer.setTargetFrameRate(framesPerSecond);
+}
+
+void MP::setPictureInPicture(const PictureInPictureSettings& settings) {
+    _pictureInPictureSettings = settings;
+    _pictureInPictureSettings.width = std::max(1, settings.width);
+    _pictureInPictureSettings.height = std::max(1, settings.height);
+}
+
+void MP::disableDynamicResolution() {
+    _isDynamicResolutionEnabled = false;
+    if (_pDynamicResolution != nullptr) {
+        _pDynamicResolution->setEnabled(false);
+    }
+}
+
+void MP::handleFramebufferSizeEvent(GLint width, GLint height) {
+    framebufferWidth = width;
+    framebufferHeight = height;
+    _updateProjections();
+}
+
+void MP::_updateProjections() {
+    _pDynamicResolution->resize(framebufferWidth, framebufferHeight);
+
+    // Minimizada la ventana mide 0, y una proyección con aspecto 0 no es válida
+    if (framebufferWidth <= 0 || framebufferHeight <= 0) {
+        return;
+    }
+    _hudProjection = glm::ortho(0.0f, static_cast<float>(framebufferWidth), 0.0f, static_cast<float>(framebufferHeight));
+    // La escena reducida conserva el aspecto de la ventana, así que la proyección no depende de la escala
+    float aspectRatio = static_cast<float>(framebufferWidth) / static_cast<float>(framebufferHeight);
+    _projectionMatrix = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 1000.0f);
+}
+
 void MP::run() {
     glfwSetWindowUserPointer(mpWindow, this);
+    CSCI441_PROFILE_THREAD_NAME("Main");
+
+    if (_isBenchmark) {
+        _isBenchmarkFailed = !_runBenchmark();
+        return;
+    }
 
     // Variables para manejar el tiempo
     double previousTime = glfwGetTime();
+    GLuint numFrames = 0;
+    CSCI441::FrameArena::forThisThread().setName("Main frame arena");
+
+    _captureSnapshot(_frameState);
+    if (_isPipelined) {
+        _simulationThread = std::thread(&MP::_simulationLoop, this);
+    }
+
+    // Con la sincronización vertical al ritmo buscado la pantalla marca el paso y el limitador no espera
+    const GLFWvidmode* videoMode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    _framePacer.setRefreshRate(videoMode != nullptr ? videoMode->refreshRate : 0.0);
+    _framePacer.setSwapTearSupported(glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+                                     glfwExtensionSupported("GLX_EXT_swap_control_tear"));
+    auto frameWorkStart = std::chrono::steady_clock::now();
 
     while (!glfwWindowShouldClose(mpWindow)) {
+        CSCI441_PROFILE_FRAME();
+        CSCI441_PROFILE_ZONE("Frame");
         double currentTime = glfwGetTime();
         float deltaTime = static_cast<float>(currentTime - previousTime);
         previousTime = currentTime;
 
-        glDrawBuffer(GL_BACK);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // Subir las texturas que ya terminaron de decodificarse
+        _pTextureLoader->update();
+        if (_pTextureLoader->getNumberOfPendingTextures() > 0) {
+            CSCI441::HeapAllocationCheck::skipFrame();
+        }
+
+        if (_isPipelined) {
+            // Dibujar el último estado completo; si la simulación no terminó otro, se repite el anterior
+            if (_snapshots.acquire()) {
+                _frameState = _snapshots.getReadBuffer();
+            }
+        } else {
+            // Reparte las animaciones en bandas según lo que se vio el frame anterior
+            _animationScheduler.beginFrame();
+            _captureSnapshot(_frameState);
+        }
 
-        glfwGetFramebufferSize(mpWindow, &framebufferWidth, &framebufferHeight);
-        _hudProjection = glm::ortho(0.0f, static_cast<float>(framebufferWidth), 0.0f, static_cast<float>(framebufferHeight));
+        if (_isPerformanceOverlayVisible) {
+            _updatePerformanceOverlay(deltaTime * 1000.0f);
+        }
+        const auto renderStart = std::chrono::steady_clock::now();
 
+        glDrawBuffer(GL_BACK);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         glViewport(0, 0, framebufferWidth, framebufferHeight);
-        float aspectRatio = static_cast<float>(framebufferWidth) / static_cast<float>(framebufferHeight);
-        _projectionMatrix = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 1000.0f);
 
+        // Ajustar la resolución de la escena con el tiempo de GPU de hace unos frames
+        _pDynamicResolution->update(static_cast<float>(_framePacer.getTargetFrameTime()));
+
+        if (_frameState.gameState == PLAYING) {
+            _updateTransforms();
+            _followHero();
 
-        if (_gameState == PLAYING) {
             glm::mat4 viewMatrix;
             glm::vec3 eyePosition;
 
@@ -933,45 +1251,64 @@ void MP::run() {
                 eyePosition = _intiFirstPersonCam->getPosition();
             }
 
-            _renderScene(viewMatrix, _projectionMatrix, eyePosition);
-
-            if (_isSmallViewportActive) {
-                GLint prevViewport[4];
-                glGetIntegerv(GL_VIEWPORT, prevViewport);
-
-                glClear(GL_DEPTH_BUFFER_BIT);
-
-                GLint smallViewportWidth = framebufferWidth / 3;
-                GLint smallViewportHeight = framebufferHeight / 3;
-                GLint smallViewportX = framebufferWidth - smallViewportWidth - 10;
-                GLint smallViewportY = framebufferHeight - smallViewportHeight - 10;
-
-                glViewport(smallViewportX, smallViewportY, smallViewportWidth, smallViewportHeight);
-
-                float smallAspectRatio = static_cast<float>(smallViewportWidth) / static_cast<float>(smallViewportHeight);
-
-                glm::mat4 smallProjectionMatrix = glm::perspective(glm::radians(45.0f), smallAspectRatio, 0.1f, 1000.0f);
-
-                glm::mat4 fpViewMatrix = _intiFirstPersonCam->getViewMatrix();
-                glm::vec3 fpEyePosition = _intiFirstPersonCam->getPosition();
-
-                _renderScene(fpViewMatrix, smallProjectionMatrix, fpEyePosition);
-
-                glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+            // La vista pequeña se redibuja a su propio ritmo; si muestra la misma cámara que la escena, se copia de ella
+            const bool isPictureInPictureDue = _isSmallViewportActive && _pPictureInPicture->isUpdateDue(deltaTime);
+            const bool isPictureInPictureDrawn = isPictureInPictureDue && _currentCameraMode != FIRST_PERSON_CAM;
+            const glm::mat4 fpViewMatrix = _intiFirstPersonCam->getViewMatrix();
+            const glm::mat4 fpViewProjMatrix = _pictureInPictureProjection * fpViewMatrix;
+            VisibleEntities mainVisible(CSCI441::FrameArena::forThisThread());
+            VisibleEntities pictureInPictureVisible(CSCI441::FrameArena::forThisThread());
+            {
+                CSCI441_PROFILE_ZONE("Culling");
+                _cullScene(_projectionMatrix * viewMatrix, mainVisible,
+                           isPictureInPictureDrawn ? &fpViewProjMatrix : nullptr, pictureInPictureVisible);
+            }
 
+            // La escena se dibuja a la resolución reducida; el HUD, a la de la ventana
+            _pDynamicResolution->begin();
+            _renderScene(viewMatrix, _projectionMatrix, eyePosition, mainVisible);
+            _pDynamicResolution->end();
+
+            if (isPictureInPictureDue) {
+                CSCI441_PROFILE_GPU_ZONE("Picture in picture");
+                if (isPictureInPictureDrawn) {
+                    _pPictureInPicture->begin();
+                    _renderScene(fpViewMatrix, _pictureInPictureProjection, _intiFirstPersonCam->getPosition(), pictureInPictureVisible);
+                    _pPictureInPicture->end();
+                    glViewport(0, 0, framebufferWidth, framebufferHeight);
+                } else {
+                    // El centro de la escena con el aspecto de la textura, a la misma altura de campo de visión si cabe
+                    const float aspect = _pPictureInPicture->getAspectRatio();
+                    const GLint copyWidth = std::min(framebufferWidth, static_cast<GLint>(static_cast<float>(framebufferHeight) * aspect));
+                    const GLint copyHeight = std::min(framebufferHeight, static_cast<GLint>(static_cast<float>(framebufferWidth) / aspect));
+                    const GLint copyX = (framebufferWidth - copyWidth) / 2;
+                    const GLint copyY = (framebufferHeight - copyHeight) / 2;
+                    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+                    _pPictureInPicture->copyFrom(copyX, copyY, copyX + copyWidth, copyY + copyHeight);
+                }
             }
+
             glDisable(GL_DEPTH_TEST);
+            if (_isSmallViewportActive) {
+                _drawPictureInPicture();
+            }
             glEnable(GL_BLEND);
             glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
             // Dibujar el HUD
-            _drawHUD();
+            {
+                CSCI441_PROFILE_GPU_ZONE("HUD");
+                _drawHUD();
+                if (_isPerformanceOverlayVisible) {
+                    _drawPerformanceOverlay();
+                }
+            }
 
             // Restaurar estado de OpenGL
             glEnable(GL_DEPTH_TEST);
             glDisable(GL_BLEND);
-            _updateScene(deltaTime);
-        } else if (_gameState == WON) {
+            _renderTimeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - renderStart).count();
+        } else if (_frameState.gameState == WON) {
             // Renderizar la pantalla de victoria
             glDisable(GL_DEPTH_TEST);
             glEnable(GL_BLEND);
@@ -982,7 +1319,7 @@ void MP::run() {
             // Restaurar estado de OpenGL
             glEnable(GL_DEPTH_TEST);
             glDisable(GL_BLEND);
-        } else if (_gameState == LOST) {
+        } else if (_frameState.gameState == LOST) {
             // Renderizar la pantalla de derrota
             glDisable(GL_DEPTH_TEST);
             glEnable(GL_BLEND);
@@ -995,13 +1332,226 @@ void MP::run() {
             glDisable(GL_BLEND);
         }
 
-        glfwSwapBuffers(mpWindow);
+        // Trabajo de CPU y GPU del frame sin la espera de la sincronización vertical
+        const float cpuWorkTimeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameWorkStart).count();
+        {
+            CSCI441_PROFILE_ZONE("Swap");
+            glfwSwapBuffers(mpWindow);
+        }
+        _recordInputLatency();
+        const int swapInterval = _framePacer.getSwapInterval();
+        if (_framePacer.update(std::max(cpuWorkTimeMs, _pDynamicResolution->getGPUTime())) != swapInterval) {
+            glfwSwapInterval(_framePacer.getSwapInterval());
+        }
+        // Las teclas que reservan memoria marcan el frame siguiente, que empieza aquí
+        _endFrameAllocations(numFrames, "frame");
+        {
+            CSCI441_PROFILE_ZONE("Pacing");
+            _framePacer.limit();
+        }
+        frameWorkStart = std::chrono::steady_clock::now();
+        // Los callbacks encolan los eventos; en paralelo los consume el siguiente paso al empezar
         glfwPollEvents();
 
+        if (!_isPipelined) {
+            // Entrada leída ahora, se dibuja en el siguiente frame igual que en el modo en paralelo
+            _sampleInput(_simulationInput);
+            _simulate(_simulationInput, deltaTime);
+        }
+    }
+
+    if (_isPipelined) {
+        _stopSimulation = true;
+        _snapshots.cancel();
+        _simulationThread.join();
+    }
+    CSCI441::FrameArena::writeReport();
+    _writeInputLatencyReport();
+
+    // Mientras el contexto sigue vivo para leer las consultas de la GPU
+    CSCI441_PROFILE_WRITE_TRACE("mp_trace.json");
+}
+
+void MP::_recordInputLatency() {
+    const auto eventTime = _frameState.inputEventTime;
+    if (eventTime == std::chrono::steady_clock::time_point{} || eventTime == _presentedInputEventTime) {
+        return;
+    }
+    _presentedInputEventTime = eventTime;
+
+    _inputLatencyMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - eventTime).count();
+    _inputLatencySamples[_numInputLatencySamples % NUM_INPUT_LATENCY_SAMPLES] = _inputLatencyMs;
+    _numInputLatencySamples++;
+}
+
+void MP::_writeInputLatencyReport() const {
+    const GLuint numSamples = std::min(_numInputLatencySamples, NUM_INPUT_LATENCY_SAMPLES);
+    if (numSamples == 0) {
+        return;
+    }
+
+    // Solo las últimas NUM_INPUT_LATENCY_SAMPLES mediciones
+    std::vector<float> samples(_inputLatencySamples, _inputLatencySamples + numSamples);
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&samples](float p) {
+        return samples[static_cast<size_t>(p * static_cast<float>(samples.size() - 1) + 0.5f)];
+    };
+    CSCI441_LOG_INFO("Input to present latency over %u inputs: p50 %.2f ms, p99 %.2f ms, max %.2f ms",
+                     numSamples, percentile(0.50f), percentile(0.99f), samples.back());
+    if (_inputEvents.getNumberOfDroppedEvents() > 0) {
+        CSCI441_LOG_WARNING("%zu input events were dropped, the input queue was full", _inputEvents.getNumberOfDroppedEvents());
     }
 }
 
 
+bool MP::_runBenchmark() {
+    const int WIDTH = _benchmarkSettings.width;
+    const int HEIGHT = _benchmarkSettings.height;
+    const int NUM_FRAMES = _benchmarkSettings.numFrames;
+    // Paso de simulación fijo para que cada ejecución dibuje los mismos cuadros
+    const float FRAME_STEP = 1.0f / 60.0f;
+
+    // La ventana está oculta, así que se dibuja en un FBO del tamaño pedido
+    glGenRenderbuffers(1, &_benchmarkColorRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, _benchmarkColorRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WIDTH, HEIGHT);
+    glGenRenderbuffers(1, &_benchmarkDepthRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, _benchmarkDepthRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, WIDTH, HEIGHT);
+
+    glGenFramebuffers(1, &_benchmarkFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, _benchmarkFBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _benchmarkColorRBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _benchmarkDepthRBO);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        CSCI441_LOG_ERROR("Benchmark framebuffer is incomplete");
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return false;
+    }
+
+    framebufferWidth = WIDTH;
+    framebufferHeight = HEIGHT;
+    _hudProjection = glm::ortho(0.0f, static_cast<float>(WIDTH), 0.0f, static_cast<float>(HEIGHT));
+    _projectionMatrix = glm::perspective(glm::radians(45.0f), static_cast<float>(WIDTH) / static_cast<float>(HEIGHT), 0.1f, 1000.0f);
+
+    fprintf(stdout, "[INFO]: Benchmark: %d frames at %dx%d on %s\n", NUM_FRAMES, WIDTH, HEIGHT, glGetString(GL_RENDERER));
+
+    CSCI441::FrameStatistics frameStatistics;
+    frameStatistics.reserve(NUM_FRAMES);
+    GLuint numFrames = 0;
+    CSCI441::FrameArena::forThisThread().setName("Main frame arena");
+    CSCI441::GLCallCounter::install();
+
+    for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+        CSCI441_PROFILE_FRAME();
+        CSCI441_PROFILE_ZONE("Frame");
+        const auto frameStart = std::chrono::steady_clock::now();
+        CSCI441::GLCallCounter::reset();
+
+        _pTextureLoader->update();
+        _animationScheduler.beginFrame();
+
+        glBindFramebuffer(GL_FRAMEBUFFER, _benchmarkFBO);
+        glViewport(0, 0, WIDTH, HEIGHT);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        _captureSnapshot(_frameState);
+        _updateTransforms();
+
+        glm::mat4 viewMatrix;
+        glm::vec3 eyePosition;
+        _setBenchmarkCamera(frame, viewMatrix, eyePosition);
+        {
+            VisibleEntities mainVisible(CSCI441::FrameArena::forThisThread());
+            VisibleEntities pictureInPictureVisible(CSCI441::FrameArena::forThisThread());
+            _cullScene(_projectionMatrix * viewMatrix, mainVisible, nullptr, pictureInPictureVisible);
+            _renderScene(viewMatrix, _projectionMatrix, eyePosition, mainVisible);
+        }
+
+        glDisable(GL_DEPTH_TEST);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        {
+            CSCI441_PROFILE_GPU_ZONE("HUD");
+            _drawHUD();
+        }
+        glEnable(GL_DEPTH_TEST);
+        glDisable(GL_BLEND);
+
+        // Solo avanzan los zombies; el héroe queda quieto y la partida no puede terminar
+        {
+            CSCI441_PROFILE_ZONE("Update");
+            _moveZombies(FRAME_STEP);
+            CSCI441_PROFILE_ZONE("Collisions");
+            _collideZombiesWithZombies();
+        }
+
+        // Esperar a la GPU para que el tiempo del cuadro incluya el render
+        {
+            CSCI441_PROFILE_ZONE("Finish");
+            glFinish();
+        }
+        const std::chrono::duration<double, std::milli> frameTime = std::chrono::steady_clock::now() - frameStart;
+        frameStatistics.addFrame(frameTime.count(), CSCI441::GLCallCounter::getDrawCalls(), CSCI441::GLCallCounter::getStateChanges());
+        _endFrameAllocations(numFrames, "benchmark frame");
+
+        glfwPollEvents();
+    }
+
+    CSCI441::GLCallCounter::uninstall();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glDeleteFramebuffers(1, &_benchmarkFBO);
+    glDeleteRenderbuffers(1, &_benchmarkColorRBO);
+    glDeleteRenderbuffers(1, &_benchmarkDepthRBO);
+
+    const std::string RESOLUTION = std::to_string(WIDTH) + "x" + std::to_string(HEIGHT);
+    const bool isReportWritten = frameStatistics.writeJSON(_benchmarkSettings.reportFilename.c_str(), {
+        { "renderer", reinterpret_cast<const char*>(glGetString(GL_RENDERER)) },
+        { "version", reinterpret_cast<const char*>(glGetString(GL_VERSION)) },
+        { "resolution", RESOLUTION },
+        { "camera_path", "arcball orbit around the hero, then free camera flyover" }
+    });
+    if (isReportWritten) {
+        fprintf(stdout, "[INFO]: Benchmark frame time p50 %.3f ms, p99 %.3f ms; report written to %s\n",
+                frameStatistics.getFrameTimePercentile(50.0), frameStatistics.getFrameTimePercentile(99.0),
+                _benchmarkSettings.reportFilename.c_str());
+    }
+    CSCI441::FrameArena::writeReport();
+
+    CSCI441_PROFILE_WRITE_TRACE("mp_trace.json");
+    return isReportWritten;
+}
+
+void MP::_setBenchmarkCamera(int frame, glm::mat4& viewMtx, glm::vec3& eyePosition) {
+    const int HALF = std::max(_benchmarkSettings.numFrames / 2, 1);
+
+    if (frame < HALF) {
+        // Primera mitad: el ArcballCam da una vuelta al héroe acercándose y bajando
+        const float t = static_cast<float>(frame) / static_cast<float>(HALF);
+        const float angle = t * glm::two_pi<float>();
+        const float radius = glm::mix(30.0f, 10.0f, t);
+        const float height = glm::mix(15.0f, 4.0f, t);
+        const glm::vec3 lookAt = _frameState.heroPosition + glm::vec3(0.0f, 2.0f, 0.0f);
+
+        _arcballCam->setCameraView(lookAt + glm::vec3(radius * sinf(angle), height, radius * cosf(angle)), lookAt, CSCI441::Y_AXIS);
+        viewMtx = _arcballCam->getViewMatrix();
+        eyePosition = _arcballCam->getPosition();
+    } else {
+        // Segunda mitad: la FreeCam sobrevuela el mundo en círculo mirando hacia el centro
+        const float t = static_cast<float>(frame - HALF) / static_cast<float>(std::max(_benchmarkSettings.numFrames - HALF, 1));
+        const float angle = t * glm::two_pi<float>();
+        const float radius = WORLD_SIZE * 0.6f;
+
+        _intiFirstPersonCam->setPosition(glm::vec3(radius * sinf(angle), 8.0f, radius * cosf(angle)));
+        _intiFirstPersonCam->setTheta(-angle);
+        _intiFirstPersonCam->setPhi(glm::half_pi<float>() - 0.2f);
+        _intiFirstPersonCam->recomputeOrientation();
+        viewMtx = _intiFirstPersonCam->getViewMatrix();
+        eyePosition = _intiFirstPersonCam->getPosition();
+    }
+}
+
 void MP::_collideHeroWithZombies(float deltaTime) {
     float heroRadius = 2.0f; // Ajusta según el tamaño de tu héroe
 
@@ -1014,19 +1564,21 @@ void MP::_collideHeroWithZombies(float deltaTime) {
         float distance = glm::length(delta);
 
         float sumRadius = heroRadius + zombie->radius;
+        _collisionPairsTested++;
 
         // Si hay colisión
         if(distance < sumRadius) {
+            _collisionPairsColliding++;
             // Manejar colisión
             if(!_isHeroDamaged) {
                 _isHeroDamaged = true;
                 _heroDamageTime = 0.0f; // Iniciar temporizador de daño
-                std::cout << "¡El héroe ha sido golpeado por un zombie!" << std::endl;
+                CSCI441_LOG_INFO("¡El héroe ha sido golpeado por un zombie!");
 
                 // Decrementar vidas
                 _heroLives--;
                 if(_heroLives <= 0) {
-                    std::cout << "¡El héroe ha perdido todas sus vidas!" << std::endl;
+                    CSCI441_LOG_INFO("¡El héroe ha perdido todas sus vidas!");
                     _gameState = LOST;
                 }
 
@@ -1047,16 +1599,16 @@ void MP::_collideHeroWithZombies(float deltaTime) {
 
 void MP::_updateIntiFirstPersonCamera() {
     glm::vec3 offset(0.0f, 4.0f, 0.0f);
-    glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), _planeHeading, CSCI441::Y_AXIS);
+    glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), _frameState.heroHeading, CSCI441::Y_AXIS);
     glm::vec3 rotatedOffset = glm::vec3(rotation * glm::vec4(offset, 0.0f));
 
-    glm::vec3 cameraPosition = _planePosition + rotatedOffset;
+    glm::vec3 cameraPosition = _frameState.heroPosition + rotatedOffset;
     _intiFirstPersonCam->setPosition(cameraPosition);
 
     glm::vec3 facingDirection = glm::vec3(
-        sinf(_planeHeading),
+        sinf(_frameState.heroHeading),
         0.0f,
-        cosf(_planeHeading)
+        cosf(_frameState.heroHeading)
     );
 
     glm::vec3 backwardDirection = -facingDirection;
@@ -1066,40 +1618,8 @@ void MP::_updateIntiFirstPersonCamera() {
 }
 
 GLuint MP::loadCubemap(const std::vector<std::string>& faces) {
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
-
-    int width, height, nrChannels;
-    for(GLuint i = 0; i < faces.size(); i++) {
-        unsigned char *data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
-        if (data) {
-            GLenum format = GL_RGB;
-            if (nrChannels == 1)
-                format = GL_RED;
-            else if (nrChannels == 3)
-                format = GL_RGB;
-            else if (nrChannels == 4)
-                format = GL_RGBA;
-
-            glTexImage2D(
-                GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
-                0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data
-            );
-            stbi_image_free(data);
-        }
-        else {
-            fprintf(stderr, "Cubemap texture failed to load at path: %s\n", faces[i].c_str());
-            stbi_image_free(data);
-        }
-    }
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
-    return textureID;
+    // Las seis caras se decodifican en paralelo; mientras tanto se muestra una textura provisional
+    return _pTextureLoader->loadCubeMapTexture(faces, GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
 }
 
 void MP::_setupSkybox() {
@@ -1166,7 +1686,18 @@ void MP::_setupSkybox() {
         "textures/skybox/front.bmp",
         "textures/skybox/back.bmp"
     };
-    _skyboxTexture = loadCubemap(faces);
+    // Preferir el cubemap cocinado (comprimido y con mipmaps); si no existe, cargar las seis imágenes
+    const std::string cookedSkybox = "textures/skybox/skybox.ktx";
+    _skyboxTexture = CSCI441::AssetManager::instance().acquireTexture({cookedSkybox}, "skybox", [&](size_t& bytes) {
+        return CSCI441::TextureUtils::loadAndRegisterKTXTexture(cookedSkybox.c_str(), GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR,
+                                                                GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, GL_TRUE, &bytes);
+    });
+    if (_skyboxTexture == 0) {
+        _skyboxTexture = CSCI441::AssetManager::instance().acquireTexture(faces, "skybox", [&](size_t& bytes) {
+            bytes = CSCI441::AsyncTextureLoader::estimateBytes(faces[0].c_str(), 6, true);
+            return loadCubemap(faces);
+        });
+    }
     _skyboxShaderProgram = new CSCI441::ShaderProgram("shaders/skybox.v.glsl", "shaders/skybox.f.glsl");
     _skyboxShaderProgram->useProgram();
     _skyboxShaderProgram->setProgramUniform("skybox", 0);
@@ -1174,6 +1705,7 @@ void MP::_setupSkybox() {
 
 
 void MP::_moveZombies(float deltaTime) {
+    std::lock_guard<std::mutex> lock(_animationSchedulerMutex);
     for(int i = 0; i < NUM_ZOMBIES; ++i) {
         if (_zombies[i] != nullptr && _zombies[i]->isActive) {
             _zombies[i]->update(deltaTime, _planePosition);
@@ -1182,6 +1714,10 @@ void MP::_moveZombies(float deltaTime) {
 }
 
 void MP::_collideZombiesWithZombies() {
+    // Pares cuyas esferas se tocan al empezar el paso; la lista vive en el arena del paso
+    CSCI441::FrameVector<std::pair<Zombie*, Zombie*>> pairs(CSCI441::FrameArena::forThisThread());
+    pairs.reserve(NUM_ZOMBIES * (NUM_ZOMBIES - 1) / 2);
+
     for(unsigned int i = 0; i < NUM_ZOMBIES; i++) {
         Zombie* zombie1 = _zombies[i];
         if(zombie1 == nullptr) continue;
@@ -1190,52 +1726,20 @@ void MP::_collideZombiesWithZombies() {
             Zombie* zombie2 = _zombies[j];
             if(zombie2 == nullptr) continue;
 
-            // Calcular la distancia entre los zombies
-            glm::vec3 delta = zombie1->position - zombie2->position;
-            float distance = glm::length(delta);
-
-            // Calcular la suma de los radios
-            float sumRadius = zombie1->radius + zombie2->radius;
-
-            // Si hay colisión
-            if(distance < sumRadius) {
-                // Normalizar el vector de colisión
-                glm::vec3 collisionNormal = glm::normalize(delta);
-
-                // Calcular la velocidad relativa en la dirección normal
-                glm::vec3 relativeVelocity = zombie1->velocity - zombie2->velocity;
-                float velocityAlongNormal = glm::dot(relativeVelocity, collisionNormal);
-
-                // Evitar calcular si las velocidades se están separando
-                if(velocityAlongNormal > 0)
-                    continue;
-
-                // Coeficiente de restitución (elasticidad del rebote)
-                float e = 0.5f; // Ajusta este valor entre 0 (inelástico) y 1 (elástico)
-
-                // Calcular el impulso escalar
-                float j = -(1 + e) * velocityAlongNormal;
-                j /= 2; // Suponiendo masas iguales
-
-                // Calcular el impulso vectorial
-                glm::vec3 impulse = j * 80*collisionNormal;
-
-                // Actualizar las velocidades de los zombies
-                zombie1->velocity += impulse;
-                zombie2->velocity -= impulse;
-
-                // Separar los zombies para evitar superposición
-                float penetrationDepth = sumRadius - distance;
-                glm::vec3 correction = (penetrationDepth / 2.0f) * collisionNormal;
-                zombie1->position += correction;
-                zombie2->position -= correction;
-
-                // Ajustar la rotación para que sigan mirando al héroe
-                zombie1->rotationAngle = atan2f(-zombie1->velocity.x, -zombie1->velocity.z);
-                zombie2->rotationAngle = atan2f(-zombie2->velocity.x, -zombie2->velocity.z);
+            _collisionPairsTested++;
+            if(glm::length(zombie1->position - zombie2->position) < zombie1->radius + zombie2->radius) {
+                pairs.emplace_back(zombie1, zombie2);
             }
         }
     }
+
+    // Resolver los pares en el orden en que se encontraron; collideWith vuelve a medir la distancia
+    // porque la corrección de un par puede haber separado los siguientes
+    for(const auto& pair : pairs) {
+        if(pair.first->collideWith(*pair.second)) {
+            _collisionPairsColliding++;
+        }
+    }
 }
 
 
@@ -1252,7 +1756,7 @@ void MP::_drawHUD() {
     float heartWidth = 50.0f;
     float heartHeight = 50.0f;
 
-    for(int i = 0; i < _heroLives; ++i) {
+    for(int i = 0; i < _frameState.heroLives; ++i) {
         glm::mat4 model = glm::mat4(1.0f);
 
         // Posición del corazón
@@ -1270,6 +1774,77 @@ void MP::_drawHUD() {
     glBindVertexArray(0);
 }
 
+void MP::_drawPictureInPicture() {
+    _hudShaderProgram->useProgram();
+    _hudShaderProgram->setProgramUniform("projection", _hudProjection);
+
+    glBindVertexArray(_heartVAO);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, _pPictureInPicture->getTexture());
+    _hudShaderProgram->setProgramUniform("texture1", 0);
+
+    // Un tercio del alto de la ventana en la esquina superior derecha, con el aspecto de la textura
+    const float height = static_cast<float>(framebufferHeight) / 3.0f;
+    const float width = height * _pPictureInPicture->getAspectRatio();
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(framebufferWidth) - width - 10.0f,
+                                                                static_cast<float>(framebufferHeight) - height - 10.0f, 0.0f));
+    model = glm::scale(model, glm::vec3(width, height, 1.0f));
+    _hudShaderProgram->setProgramUniform("model", model);
+
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+}
+
+void MP::_updatePerformanceOverlay(float frameTimeMs) {
+    // En modo en paralelo la simulación corre a la vez que el render, no dentro del frame
+    _pPerformanceOverlay->addFrame(frameTimeMs, _frameState.simulationTimeMs, _renderTimeMs);
+
+    GLuint activeEntities = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (_frameState.coinActive[i]) activeEntities++;
+    }
+    for (int i = 0; i < NUM_ZOMBIES; ++i) {
+        if (_frameState.zombies[i].isActive) activeEntities++;
+    }
+    GLuint culledEntities;
+    {
+        std::lock_guard<std::mutex> lock(_animationSchedulerMutex);
+        culledEntities = _animationScheduler.getNumberOfEntities(CSCI441::AnimationScheduler::FROZEN);
+    }
+
+    // Los contadores de OpenGL cubren el frame anterior completo, incluido el overlay
+    _pPerformanceOverlay->setCounter("Draw calls", CSCI441::GLCallCounter::getDrawCalls());
+    _pPerformanceOverlay->setCounter("State changes", CSCI441::GLCallCounter::getStateChanges());
+    _pPerformanceOverlay->setCounter("Uniform updates", CSCI441::GLCallCounter::getUniformUpdates());
+    _pPerformanceOverlay->setCounter("Buffer bytes", CSCI441::GLCallCounter::getBufferBytesUploaded());
+    _pPerformanceOverlay->setCounter("Active entities", activeEntities);
+    // Zombies que no se vieron en ninguna vista el frame anterior
+    _pPerformanceOverlay->setCounter("Culled entities", culledEntities);
+    _pPerformanceOverlay->setCounter("Collision pairs", _frameState.collisionPairsTested);
+    _pPerformanceOverlay->setCounter("Collisions", _frameState.collisionPairsColliding);
+    // Desde que se leyó la entrada del estado dibujado hasta que terminó su glfwSwapBuffers
+    _pPerformanceOverlay->setCounter("Input latency us", static_cast<GLuint>(_inputLatencyMs * 1000.0f));
+    _pPerformanceOverlay->setCounter("Scene GPU us", static_cast<GLuint>(_pDynamicResolution->getGPUTime() * 1000.0f));
+    _pPerformanceOverlay->setCounter("Resolution %", static_cast<GLuint>(_pDynamicResolution->getScale() * 100.0f + 0.5f));
+    _pPerformanceOverlay->setCounter("Missed frames", _framePacer.getNumberOfMissedFrames());
+    _pPerformanceOverlay->setCounter("PiP updates", _pPictureInPicture->getNumberOfUpdates());
+    CSCI441::GLCallCounter::reset();
+}
+
+void MP::_drawPerformanceOverlay() {
+    _hudShaderProgram->useProgram();
+    _hudShaderProgram->setProgramUniform("projection", _hudProjection);
+    _hudShaderProgram->setProgramUniform("model", glm::mat4(1.0f));
+    _hudShaderProgram->setProgramUniform("useVertexColor", 1);
+    glActiveTexture(GL_TEXTURE0);
+    _hudShaderProgram->setProgramUniform("texture1", 0);
+
+    // Esquina superior izquierda, los corazones están a la derecha
+    _pPerformanceOverlay->draw(10.0f, static_cast<float>(framebufferHeight) - 10.0f);
+
+    _hudShaderProgram->setProgramUniform("useVertexColor", 0);
+}
+
 void MP::_drawWinScreen() {
     _hudShaderProgram->useProgram();
     _hudShaderProgram->setProgramUniform("projection", _hudProjection);
@@ -1357,18 +1932,9 @@ void MP::_resetGame() {
 
     // Reactivar todas las monedas
     for(int i = 0; i < 4; ++i) {
-        _coins[i] = new Coin(_lightingShaderProgram->getShaderProgramHandle(),
-                             _lightingShaderUniformLocations.mvpMatrix,
-                             _lightingShaderUniformLocations.normalMatrix);
+        _coins[i]->reactivate();
     }
 
-    // Restablecer la cámara si es necesario
-    _arcballCam->setCameraView(
-        glm::vec3(0.0f, 20.0f, 20.0f), // Posición del ojo
-        glm::vec3(10.0f, 10.0f, 0.0f),    // Punto de mirada (posición del plano)
-        CSCI441::Y_AXIS                 // Vector hacia arriba
-    );
-    _updateIntiFirstPersonCamera();
 }
 
 bool MP::_isOutOfBounds(const glm::vec3& position, float margin = 0.0f) {
@@ -1377,13 +1943,12 @@ bool MP::_isOutOfBounds(const glm::vec3& position, float margin = 0.0f) {
            position.z < -BOUNDARY || position.z > BOUNDARY;
 }
 
-void MP::_computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
+void MP::_computeAndSendMatrixUniforms(GLuint node, const glm::mat4& viewProjMtx) const {
     // Precompute the Model-View-Projection matrix on the CPU
-    glm::mat4 mvpMtx = projMtx * viewMtx * modelMtx;
+    glm::mat4 mvpMtx = viewProjMtx * _sceneTransforms.getWorldMatrix(node);
     // Then send it to the shader on the GPU to apply to every vertex
     _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.mvpMatrix, mvpMtx);
-    glm::mat3 normalMtx = glm::transpose(glm::inverse(glm::mat3(modelMtx)));
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.normalMatrix, normalMtx);
+    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.normalMatrix, _sceneTransforms.getNormalMatrix(node));
 }
 
 //*************************************************************************************
@@ -1410,3 +1975,10 @@ void A3_engine_mouse_button_callback(GLFWwindow *window, int button, int action,
     // Pasar el botón del mouse y la acción al engine
     engine->handleMouseButtonEvent(button, action);
 }
+
+void A3_engine_framebuffer_size_callback(GLFWwindow *window, int width, int height ) {
+    auto engine = static_cast<MP*>(glfwGetWindowUserPointer(window));
+
+    // Pasar el nuevo tamaño del framebuffer al engine
+    engine->handleFramebufferSizeEvent(width, height);
+}
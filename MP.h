@@ -2,8 +2,25 @@
 #define MP_ENGINE_H
 
 #include "Cameras/ArcballCam.h"
+#include <AssetManager.hpp>
+#include <AsyncTextureLoader.hpp>
+#include <CachedView.hpp>
+#include <DrawBatcher.hpp>
+#include <DynamicResolution.hpp>
+#include <FrameArena.hpp>
+#include <FramePacer.hpp>
+#include <FrameStatistics.hpp>
+#include <GLCallCounter.hpp>
+#include <HeapAllocationCheck.hpp>
+#include <InputQueue.hpp>
+#include <Logger.hpp>
 #include <OpenGLEngine.hpp>
+#include <PerformanceOverlay.hpp>
+#include <Profiler.hpp>
+#include <ShaderPermutations.hpp>
 #include <ShaderProgram.hpp>
+#include <TransformHierarchy.hpp>
+#include <TripleBuffer.hpp>
 #include "FreeCam.hpp"
 
 #include "Heroes/Aaron_Inti.h"
@@ -12,6 +29,10 @@
 
 #include "stb_image.h"
 #include <glad/gl.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <string>
 
@@ -36,6 +57,65 @@ public:
      */
     void run() final;
 
+    /**
+     * @brief Opciones del modo benchmark sin ventana visible.
+     */
+    struct BenchmarkSettings {
+        int numFrames = 600;
+        int width = 1280;
+        int height = 720;
+        std::string reportFilename = "benchmark.json";
+    };
+
+    /**
+     * @brief Activa el modo benchmark: ventana oculta, render a un FBO y cámara con recorrido fijo.
+     * run() dibuja numFrames cuadros y escribe un informe JSON en lugar de abrir el juego.
+     * @note Debe llamarse antes de initialize().
+     */
+    void enableBenchmark(const BenchmarkSettings& settings);
+    /**
+     * @brief Indica si el benchmark terminó sin informe, por ejemplo porque el FBO estaba incompleto.
+     */
+    bool hasBenchmarkFailed() const { return _isBenchmarkFailed; }
+
+    /**
+     * @brief Activa el modo en paralelo: un hilo simula y publica el estado mientras el hilo de OpenGL dibuja el último publicado.
+     * La simulación nunca va más de un estado por delante del render, así que la entrada llega a pantalla con a lo sumo un frame más de retraso.
+     * @note Debe llamarse antes de run().
+     */
+    void enablePipelining();
+
+    /**
+     * @brief Fija los cuadros por segundo que se intentan mantener; 0 deja el ritmo a la sincronización vertical.
+     * @note Debe llamarse antes de run().
+     */
+    void setTargetFrameRate(double framesPerSecond);
+
+    /**
+     * @brief Dibuja siempre la escena a la resolución de la ventana, sin reducirla cuando la GPU no llega.
+     */
+    void disableDynamicResolution();
+
+    /**
+     * @brief Opciones de la vista pequeña en primera persona (tecla 1).
+     */
+    struct PictureInPictureSettings {
+        int width = 384;            // resolución de la textura, independiente de la ventana
+        int height = 216;
+        float updateRate = 30.0f;   // veces por segundo que se vuelve a dibujar, 0 en cada frame
+    };
+
+    /**
+     * @brief Cambia la resolución y el ritmo de la vista pequeña.
+     * @note Debe llamarse antes de initialize().
+     */
+    void setPictureInPicture(const PictureInPictureSettings& settings);
+
+    /**
+     * @brief Recalcula las proyecciones y el destino de la escena cuando cambia el tamaño del framebuffer.
+     */
+    void handleFramebufferSizeEvent(GLint width, GLint height);
+
     /**
      * @brief Maneja eventos de teclado.
      *
@@ -93,6 +173,21 @@ private:
     Zombie* _zombies[NUM_ZOMBIES]; // Arreglo para almacenar los ocho zombies
     glm::vec3 _zombiePositions[NUM_ZOMBIES]; // Arreglo para las posiciones de los zombies
 
+    // Decide cada cuántos frames se anima cada zombie según su tamaño en pantalla
+    CSCI441::AnimationScheduler _animationScheduler;
+    // En modo en paralelo la simulación actualiza las animaciones mientras el render las observa
+    mutable std::mutex _animationSchedulerMutex;
+
+    // Matrices de modelo y normales de todas las partes, recalculadas solo cuando cambian
+    CSCI441::TransformHierarchy _sceneTransforms;
+    GLuint _groundNode;
+
+    // Zombies y monedas se dibujan juntos con pocas llamadas desde el buffer compartido de figuras
+    CSCI441::DrawBatcher* _pDrawBatcher = nullptr;
+    // Variante instanciada del shader de iluminación, propiedad de _pLightingShaders
+    CSCI441::ShaderProgram* _batchedShaderProgram = nullptr;
+    GLint _batchedEyePositionLocation;
+
     struct CameraFrame {
         glm::vec3 eye;
         glm::vec3 direction;
@@ -117,25 +212,91 @@ private:
     void mCleanupBuffers() final;
     void mCleanupShaders() final;
 
-    // Dibuja la escena desde un punto de vista específico de la cámara
-    void _renderScene(glm::mat4 viewMtx, glm::mat4 projMtx, glm::vec3 eyePosition) const;
+    // Índices de las monedas y zombies que se ven desde una vista; las listas viven en el arena
+    // del frame, así que solo valen hasta el final del frame en que _cullScene las llenó
+    struct VisibleEntities {
+        explicit VisibleEntities(CSCI441::FrameArena& arena);
+        CSCI441::FrameVector<GLuint> coins;
+        CSCI441::FrameVector<GLuint> zombies;
+    };
 
-    // Actualiza elementos de la escena basados en el tiempo y la entrada
-    void _updateScene(float deltaTime);
+    // Dibuja la escena desde un punto de vista específico de la cámara
+    // con solo las monedas y zombies que _cullScene encontró en esa vista
+    void _renderScene(glm::mat4 viewMtx, glm::mat4 projMtx, glm::vec3 eyePosition, const VisibleEntities& visible) const;
 
-    static constexpr GLuint NUM_KEYS = GLFW_KEY_LAST;
-    GLboolean _keys[NUM_KEYS];
+    static constexpr GLuint NUM_KEYS = GLFW_KEY_LAST + 1;
 
     glm::vec2 _mousePosition;
     GLint _leftMouseButtonState;
 
-    enum CameraMode { ARCBALL, FIRST_PERSON_CAM } _currentCameraMode;
+    enum CameraMode { ARCBALL, FIRST_PERSON_CAM };
+    // Lo cambian las teclas en el hilo de OpenGL y lo lee la simulación al empezar cada paso
+    std::atomic<CameraMode> _currentCameraMode;
+
+    // Eventos de teclado con su hora de llegada; el callback los encola y el paso de simulación los consume
+    CSCI441::InputQueue _inputEvents;
+
+    // Entrada que usa un paso de simulación, construida por el hilo que simula a partir de _inputEvents
+    struct InputState {
+        GLboolean keys[NUM_KEYS];               // teclas mantenidas al empezar el paso
+        GLboolean pressed[NUM_KEYS];            // pulsadas desde el paso anterior, aunque ya se hayan soltado
+        CameraMode cameraMode;
+        // Evento más antiguo que consumió el paso, vacío si no llegó ninguno
+        std::chrono::steady_clock::time_point oldestEventTime;
+
+        // Una pulsación corta entre dos pasos cuenta como un paso con la tecla mantenida
+        bool isDown(GLint key) const { return keys[key] || pressed[key]; }
+    };
+    // Solo la usa el hilo que simula: el principal o el de simulación
+    InputState _simulationInput{};
+
+    // Todo lo que se dibuja de un paso de simulación; el render solo lee de aquí
+    struct GameSnapshot {
+        GameState gameState;
+        glm::vec3 heroPosition;
+        float heroHeading;
+        bool heroFalling;
+        float heroFallRotation;
+        bool heroDamaged;
+        int heroLives;
+        Aaron_Inti::AnimationState heroAnimation;
+        bool coinActive[4];
+        glm::vec3 coinPositions[4];
+        Zombie::State zombies[NUM_ZOMBIES];
+
+        float simulationTimeMs;
+        GLuint collisionPairsTested;
+        GLuint collisionPairsColliding;
+        std::chrono::steady_clock::time_point inputEventTime;
+    };
+
+    // Estado que se está dibujando en este frame
+    GameSnapshot _frameState{};
+
+    // Actualiza elementos de la escena basados en el tiempo y la entrada
+    void _updateScene(const InputState& input, float deltaTime);
+
+    // Un paso completo: reinicio pedido con R y, si se está jugando, _updateScene
+    void _simulate(const InputState& input, float deltaTime);
+    std::atomic<bool> _resetRequested{false};
+    // Llegada del evento más antiguo que consumió el último paso, para medir cuánto tarda en verse
+    std::chrono::steady_clock::time_point _inputEventTime;
+
+    // Consume los eventos encolados justo al empezar el paso
+    void _sampleInput(InputState& input);
+    void _captureSnapshot(GameSnapshot& snapshot) const;
+
+    // Copia el estado del frame a la jerarquía de transformaciones, una vez por frame antes de dibujar
+    void _updateTransforms();
+
+    // Las cámaras siguen al héroe dibujado, no al que la simulación ya movió
+    void _followHero();
 
     ArcballCam* _arcballCam;
     CSCI441::FreeCam* _intiFirstPersonCam;
     glm::vec2 _cameraSpeed;
 
-    Aaron_Inti* _pPlane;
+    Aaron_Inti* _pPlane = nullptr;
 
 
     static constexpr GLfloat WORLD_SIZE = 105.0f;
@@ -144,38 +305,57 @@ private:
 
     void _createGroundBuffers();
 
+    // Variantes de A3 compiladas bajo demanda según luces, instancias e iluminación por píxel
+    CSCI441::ShaderPermutations* _pLightingShaders = nullptr;
+    // Variante sin instancias para el terreno y el héroe, propiedad de _pLightingShaders
     CSCI441::ShaderProgram* _lightingShaderProgram = nullptr;
+    bool _perPixelLighting = false;
+
+    // Luces de la escena; una luz negra no se compila en el shader
+    struct SceneLights {
+        glm::vec3 direction;
+        glm::vec3 ambientColor;
+        glm::vec3 diffuseColor;
+        glm::vec3 specularColor;
+
+        glm::vec3 pointPos;
+        glm::vec3 pointColor;
+        float pointConstant;
+        float pointLinear;
+        float pointQuadratic;
+
+        glm::vec3 spotPos;
+        glm::vec3 spotDirection;
+        glm::vec3 spotColor;
+        float spotCutoff;
+        float spotOuterCutoff;
+        float spotExponent;
+        float spotConstant;
+        float spotLinear;
+        float spotQuadratic;
+    } _sceneLights;
+
+    bool _hasDirectionalLight() const;
+    bool _hasPointLight() const;
+    bool _hasSpotLight() const;
+
+    // Envía las luces a una variante recién compilada, solo las que la variante declara
+    void _sendLightUniforms(CSCI441::ShaderProgram& shaderProgram) const;
+    // Lee de vuelta el color de cada luz activa; una variante iluminada con luces en cero indica un nombre de uniforme mal resuelto
+    bool _checkLightUniforms(const CSCI441::ShaderProgram& shaderProgram) const;
+
+    // Elige las variantes instanciada y sin instancias para el modo de iluminación actual
+    void _selectLightingVariants();
 
     struct LightingShaderUniformLocations {
         GLint mvpMatrix;
         GLint normalMatrix;
         GLint eyePosition;
 
-        GLint lightDirection;
-        GLint lightAmbientColor;
-        GLint lightDiffuseColor;
-        GLint lightSpecularColor;
-
         GLint materialAmbientColor;
         GLint materialDiffuseColor;
         GLint materialSpecularColor;
         GLint materialShininess;
-
-        GLint pointLightPos;
-        GLint pointLightColor;
-        GLint pointLightConstant;
-        GLint pointLightLinear;
-        GLint pointLightQuadratic;
-
-        GLint spotLightPos;
-        GLint spotLightDirection;
-        GLint spotLightColor;
-        GLint spotLightCutoff;
-        GLint spotLightOuterCutoff;
-        GLint spotLightExponent;
-        GLint spotLightConstant;
-        GLint spotLightLinear;
-        GLint spotLightQuadratic;
     } _lightingShaderUniformLocations;
 
     struct LightingShaderAttributeLocations {
@@ -183,7 +363,7 @@ private:
         GLint vNormal;
     } _lightingShaderAttributeLocations;
 
-    void _computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const;
+    void _computeAndSendMatrixUniforms(GLuint node, const glm::mat4& viewProjMtx) const;
 
     bool _isShiftPressed;
     bool _isLeftMouseButtonPressed;
@@ -203,6 +383,7 @@ private:
     CSCI441::ShaderProgram* _skyboxShaderProgram = nullptr;
 
     GLuint loadCubemap(const std::vector<std::string>& faces);
+    CSCI441::AsyncTextureLoader* _pTextureLoader = nullptr;
     void _setupSkybox();
     void _moveZombies(float deltaTime);
     void _collideZombiesWithZombies();
@@ -214,11 +395,89 @@ private:
     void _collideHeroWithZombies(float deltaTime);
 
     GLuint _heartTexture;
+
+    // PERFORMANCE OVERLAY
+    // Tecla P: gráfico de tiempos por frame y contadores del motor, dibujado con el shader del HUD
+    CSCI441::PerformanceOverlay* _pPerformanceOverlay = nullptr;
+    bool _isPerformanceOverlayVisible = false;
+    float _simulationTimeMs = 0.0f;
+    float _renderTimeMs = 0.0f;
+    float _inputLatencyMs = 0.0f;
+
+    // INPUT LATENCY
+    // Desde que llega un evento hasta que vuelve glfwSwapBuffers con el primer frame que lo refleja
+    static constexpr GLuint NUM_INPUT_LATENCY_SAMPLES = 1024;
+    float _inputLatencySamples[NUM_INPUT_LATENCY_SAMPLES] = {};
+    GLuint _numInputLatencySamples = 0;
+    std::chrono::steady_clock::time_point _presentedInputEventTime;
+
+    // Se llama tras cada glfwSwapBuffers; un paso repetido en varios frames solo cuenta la primera vez
+    void _recordInputLatency();
+    void _writeInputLatencyReport() const;
+    GLuint _collisionPairsTested = 0;
+    GLuint _collisionPairsColliding = 0;
+
+    // Pasa al overlay los tiempos y contadores del frame anterior y reinicia los contadores
+    void _updatePerformanceOverlay(float frameTimeMs);
+    void _drawPerformanceOverlay();
+
+    // PIPELINING
+    bool _isPipelined = false;
+    // Triple buffer: la simulación escribe uno, el render lee otro y el tercero guarda el último publicado
+    CSCI441::TripleBuffer<GameSnapshot> _snapshots;
+    std::thread _simulationThread;
+    std::atomic<bool> _stopSimulation{false};
+    void _simulationLoop();
+
+    // PICTURE IN PICTURE
+    // Tecla 1: la vista en primera persona se dibuja en una textura a su propia resolución y ritmo
+    // y se compone sobre la escena como un cuadro más del HUD
+    PictureInPictureSettings _pictureInPictureSettings;
+    CSCI441::CachedView* _pPictureInPicture = nullptr;
+    glm::mat4 _pictureInPictureProjection;
+    void _drawPictureInPicture();
+
+    // CULLING
+    // Una pasada para todas las vistas: la esfera de cada entidad se calcula una vez y se prueba contra cada una;
+    // pictureInPictureViewProjMtx es nullptr en los frames que no redibujan la vista pequeña
+    void _cullScene(const glm::mat4& mainViewProjMtx, VisibleEntities& mainVisible,
+                    const glm::mat4* pictureInPictureViewProjMtx, VisibleEntities& pictureInPictureVisible) const;
+
+    // FRAME PACING
+    // Limita los cuadros por segundo y quita la sincronización vertical mientras los frames no llegan
+    CSCI441::FramePacer _framePacer;
+    // La escena se dibuja a menor resolución cuando la GPU se pasa del presupuesto y se escala antes del HUD
+    CSCI441::DynamicResolution* _pDynamicResolution = nullptr;
+    bool _isDynamicResolutionEnabled = true;
+
+    // Solo cuando cambia el tamaño del framebuffer, no en cada frame
+    void _updateProjections();
+
+    // MEMORY
+    // Los primeros frames compilan variantes, crean contadores y llenan buffers; después no debe reservarse memoria
+    static constexpr GLuint HEAP_CHECK_WARMUP_FRAMES = 120;
+
+    // Reinicia la arena del hilo y, con CSCI441_CHECK_HEAP_ALLOCATIONS, comprueba que el frame no usó el heap
+    static void _endFrameAllocations(GLuint& numFrames, const char* frameName);
+
+    // BENCHMARK
+    bool _isBenchmark = false;
+    bool _isBenchmarkFailed = false;
+    BenchmarkSettings _benchmarkSettings;
+    GLuint _benchmarkFBO = 0;
+    GLuint _benchmarkColorRBO = 0;
+    GLuint _benchmarkDepthRBO = 0;
+
+    // Dibuja los cuadros del recorrido en el FBO y escribe el informe; devuelve false si no pudo escribirlo
+    bool _runBenchmark();
+    // Coloca el ArcballCam (primera mitad) o la FreeCam (segunda mitad) en el recorrido del cuadro dado
+    void _setBenchmarkCamera(int frame, glm::mat4& viewMtx, glm::vec3& eyePosition);
 };
 
 // Declaración de las funciones de callback
 void A3_engine_keyboard_callback(GLFWwindow *window, int key, int scancode, int action, int mods );
 void A3_engine_cursor_callback(GLFWwindow *window, double x, double y );
 void A3_engine_mouse_button_callback(GLFWwindow *window, int button, int action, int mods );
+void A3_engine_framebuffer_size_callback(GLFWwindow *window, int width, int height );
 
 #endif // MP_ENGINE_H
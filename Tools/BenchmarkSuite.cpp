@@ -0,0 +1,736 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2024
+ *
+ *  Project: MP
+ *  File: Tools/BenchmarkSuite.cpp
+ *
+ *  Description:
+ *      Suite de benchmarks del juego (objetivo MP_bench).  Escribe un JSON con
+ *      la mediana y el mínimo de milisegundos por iteración de cada prueba,
+ *      para comparar versiones y detectar regresiones.
+ *
+ *      Micro benchmarks:
+ *          collision_*         colisiones entre zombies, todos los pares (como
+ *                              MP::_collideZombiesWithZombies) contra una rejilla
+ *          matrices_*          matrices de mundo y normales calculadas por parte
+ *                              contra TransformHierarchy::update()
+ *          skinning_*          skinning MD5 escalar contra CPUSkinner
+ *          obj_parse, ply_parse
+ *                              ModelLoader con mallas sintéticas, incluye la subida a la GPU
+ *          objects_*           generación de las formas de objects.hpp y consulta en caché
+ *          uniform_*           setProgramUniform() por nombre contra por ubicación
+ *
+ *      Macro benchmarks:
+ *          headless_simulation pasos de simulación por segundo con 1k, 10k y 100k zombies
+ *          offscreen_render    cuadros por segundo del modo --benchmark del juego
+ *
+ *      Las pruebas que necesitan OpenGL usan un contexto oculto (OSMesa si no
+ *      hay pantalla); con --no-gl, o si no hay contexto, se omiten.  Debe
+ *      ejecutarse desde la carpeta del proyecto para encontrar shaders/ y textures/.
+ *
+ *      Uso:
+ *          MP_bench [--output FILE] [--filter TEXT] [--zombies N[,N...]] [--frames N] [--no-gl]
+ *          (por defecto MP_bench.json, todas las pruebas, 1000,10000,100000 zombies, 600 cuadros)
+ *
+ */
+
+#include "SkinningModel.h"
+#include "../MP.h"
+
+#include <objects.hpp>
+#include <ModelLoader.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// \desc Resultado de una prueba, una entrada del JSON.
+struct BenchmarkResult {
+    std::string group;
+    std::string name;
+    std::string parameters;
+    int iterations;
+    int repetitions;
+    double medianMs;            // por iteración
+    double minMs;               // por iteración
+};
+
+/// \desc Guarda los resultados, decide qué pruebas se ejecutan y escribe el informe.
+class BenchmarkSuite {
+public:
+    explicit BenchmarkSuite(std::string filter) : _filter(std::move(filter)), _isValid(true) {}
+
+    /// \desc true si la prueba pasa el filtro de --filter.
+    bool isSelected(const std::string& name) const {
+        return _filter.empty() || name.find(_filter) != std::string::npos;
+    }
+
+    /// \desc Ejecuta body una vez para calentar y luego repetitions veces iterations llamadas.
+    template<typename Body>
+    void measure(const char* group, const std::string& name, const std::string& parameters,
+                 int iterations, int repetitions, Body body) {
+        if (!isSelected(name)) return;
+
+        body();
+        std::vector<double> samples;
+        for (int r = 0; r < repetitions; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) body();
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            samples.push_back(elapsed.count() / iterations);
+        }
+        std::sort(samples.begin(), samples.end());
+        add({ group, name, parameters, iterations, repetitions, samples[samples.size() / 2], samples.front() });
+    }
+
+    /// \desc Añade un resultado medido fuera de measure().
+    void add(const BenchmarkResult& result) {
+        printf("  %-28s %-34s %12.4f ms  (min %.4f ms)\n", result.name.c_str(), result.parameters.c_str(), result.medianMs, result.minMs);
+        fflush(stdout);
+        _results.push_back(result);
+    }
+
+    /// \desc Registra una comprobación; si falla el informe queda marcado como no válido.
+    void check(bool passed, const char* description) {
+        if (!passed) {
+            fprintf(stderr, "[ERROR]: check failed: %s\n", description);
+            _isValid = false;
+        }
+    }
+
+    void addMetadata(const std::string& key, const std::string& value) { _metadata.emplace_back(key, value); }
+
+    bool isValid() const { return _isValid; }
+
+    bool writeJSON(const char* filename) const;
+
+private:
+    std::string _filter;
+    bool _isValid;
+    std::vector<BenchmarkResult> _results;
+    std::vector< std::pair<std::string, std::string> > _metadata;
+
+    static std::string _escapeJSON(const std::string& text);
+};
+
+bool BenchmarkSuite::writeJSON(const char* filename) const {
+    FILE* file = fopen(filename, "w");
+    if (file == nullptr) {
+        fprintf(stderr, "[ERROR]: could not write \"%s\"\n", filename);
+        return false;
+    }
+
+    fprintf(file, "{\n  \"metadata\": {");
+    for (size_t i = 0; i < _metadata.size(); ++i) {
+        fprintf(file, "%s\n    \"%s\": \"%s\"", i == 0 ? "" : ",", _escapeJSON(_metadata[i].first).c_str(), _escapeJSON(_metadata[i].second).c_str());
+    }
+    fprintf(file, "%s},\n", _metadata.empty() ? "" : "\n  ");
+    fprintf(file, "  \"valid\": %s,\n", _isValid ? "true" : "false");
+    fprintf(file, "  \"benchmarks\": [");
+    for (size_t i = 0; i < _results.size(); ++i) {
+        const BenchmarkResult& result = _results[i];
+        fprintf(file, "%s\n    { \"group\": \"%s\", \"name\": \"%s\", \"parameters\": \"%s\", \"iterations\": %d, \"repetitions\": %d, "
+                      "\"median_ms\": %.6f, \"min_ms\": %.6f, \"per_second\": %.2f }",
+                i == 0 ? "" : ",", result.group.c_str(), result.name.c_str(), _escapeJSON(result.parameters).c_str(),
+                result.iterations, result.repetitions, result.medianMs, result.minMs,
+                result.medianMs > 0.0 ? 1000.0 / result.medianMs : 0.0);
+    }
+    fprintf(file, "%s]\n}\n", _results.empty() ? "" : "\n  ");
+
+    fclose(file);
+    return true;
+}
+
+std::string BenchmarkSuite::_escapeJSON(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (const char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) escaped += c;
+    }
+    return escaped;
+}
+
+//*************************************************************************************
+//
+// Colisiones
+
+// Mismo radio que Zombie
+static const float ZOMBIE_RADIUS = 1.0f;
+
+/// \desc Mitad del lado del mundo para numZombies, un zombie cada 16 unidades cuadradas.
+static float arenaHalfSize(size_t numZombies) {
+    return 2.0f * std::sqrt(static_cast<float>(numZombies));
+}
+
+/// \desc Rejilla uniforme en XZ con celdas del diámetro de un zombie: solo se prueban pares
+///       en la misma celda o en celdas vecinas.  Se reconstruye en cada paso con un
+///       ordenamiento por conteo, sin reservar memoria una vez alcanzado el tamaño máximo.
+class UniformGrid {
+public:
+    UniformGrid(float halfSize, float cellSize)
+        : _origin(-halfSize),
+          _inverseCellSize(1.0f / cellSize),
+          _cellsPerSide(static_cast<int>(std::ceil(2.0f * halfSize / cellSize))) {
+        _cellStart.resize(static_cast<size_t>(_cellsPerSide) * _cellsPerSide + 1);
+    }
+
+    /// \desc Ordena los objetos por celda; position(i) devuelve la posición del objeto i.
+    template<typename GetPosition>
+    void build(size_t numObjects, GetPosition position) {
+        _cells.resize(numObjects);
+        _objects.resize(numObjects);
+        std::fill(_cellStart.begin(), _cellStart.end(), 0);
+        for (size_t i = 0; i < numObjects; ++i) {
+            const glm::vec3 p = position(i);
+            _cells[i] = _cellIndex(_cellCoordinate(p.x), _cellCoordinate(p.z));
+            _cellStart[_cells[i] + 1]++;
+        }
+        for (size_t c = 1; c < _cellStart.size(); ++c) _cellStart[c] += _cellStart[c - 1];
+        // _cellStart[c] avanza mientras se llena la celda c y termina al inicio de c + 1
+        for (size_t i = 0; i < numObjects; ++i) _objects[_cellStart[_cells[i]]++] = static_cast<GLuint>(i);
+        for (size_t c = _cellStart.size() - 1; c > 0; --c) _cellStart[c] = _cellStart[c - 1];
+        _cellStart[0] = 0;
+    }
+
+    /// \desc Llama pair(i, j) una vez por cada par de objetos en celdas vecinas.
+    template<typename Pair>
+    void forEachPair(Pair pair) const {
+        // media vecindad: cada par de celdas vecinas se visita una sola vez
+        static const int NEIGHBORS[4][2] = { {1, 0}, {-1, 1}, {0, 1}, {1, 1} };
+        for (int z = 0; z < _cellsPerSide; ++z) {
+            for (int x = 0; x < _cellsPerSide; ++x) {
+                const GLuint cell = _cellIndex(x, z);
+                for (GLuint a = _cellStart[cell]; a < _cellStart[cell + 1]; ++a) {
+                    for (GLuint b = a + 1; b < _cellStart[cell + 1]; ++b) pair(_objects[a], _objects[b]);
+                }
+                for (const auto& offset : NEIGHBORS) {
+                    const int nx = x + offset[0], nz = z + offset[1];
+                    if (nx < 0 || nx >= _cellsPerSide || nz >= _cellsPerSide) continue;
+                    const GLuint neighbor = _cellIndex(nx, nz);
+                    for (GLuint a = _cellStart[cell]; a < _cellStart[cell + 1]; ++a) {
+                        for (GLuint b = _cellStart[neighbor]; b < _cellStart[neighbor + 1]; ++b) pair(_objects[a], _objects[b]);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    float _origin;
+    float _inverseCellSize;
+    int _cellsPerSide;
+    std::vector<GLuint> _cellStart;     // primer objeto de cada celda, más el final
+    std::vector<GLuint> _cells;         // celda de cada objeto
+    std::vector<GLuint> _objects;       // objetos ordenados por celda
+
+    // fuera del mundo se usa la celda del borde, lo que conserva la vecindad
+    int _cellCoordinate(float value) const {
+        const int coordinate = static_cast<int>(std::floor((value - _origin) * _inverseCellSize));
+        return std::min(std::max(coordinate, 0), _cellsPerSide - 1);
+    }
+    GLuint _cellIndex(int x, int z) const { return static_cast<GLuint>(z * _cellsPerSide + x); }
+};
+
+/// \desc Misma prueba de contacto que Zombie::collideWith().
+static bool overlaps(const glm::vec3& a, const glm::vec3& b) {
+    return glm::length(a - b) < 2.0f * ZOMBIE_RADIUS;
+}
+
+static void benchmarkCollisions(BenchmarkSuite& suite) {
+    for (const size_t numZombies : { size_t(12), size_t(1000), size_t(4000) }) {
+        const float halfSize = arenaHalfSize(numZombies);
+        std::mt19937 rng(441);
+        std::uniform_real_distribution<float> coordinate(-halfSize, halfSize);
+        std::vector<glm::vec3> positions(numZombies);
+        for (auto& position : positions) position = glm::vec3(coordinate(rng), 1.5f, coordinate(rng));
+
+        const std::string parameters = "zombies=" + std::to_string(numZombies);
+        const int iterations = static_cast<int>(std::max<size_t>(1, 4000000 / (numZombies * numZombies)));
+
+        size_t allPairsContacts = 0;
+        suite.measure("micro", "collision_all_pairs", parameters, iterations, 5, [&]() {
+            allPairsContacts = 0;
+            for (size_t i = 0; i < numZombies; ++i) {
+                for (size_t j = i + 1; j < numZombies; ++j) {
+                    if (overlaps(positions[i], positions[j])) allPairsContacts++;
+                }
+            }
+        });
+
+        UniformGrid grid(halfSize, 2.0f * ZOMBIE_RADIUS);
+        size_t gridContacts = 0;
+        suite.measure("micro", "collision_grid", parameters, std::max(iterations, 20), 5, [&]() {
+            gridContacts = 0;
+            grid.build(numZombies, [&](size_t i) { return positions[i]; });
+            grid.forEachPair([&](GLuint i, GLuint j) {
+                if (overlaps(positions[i], positions[j])) gridContacts++;
+            });
+        });
+
+        if (suite.isSelected("collision_all_pairs") && suite.isSelected("collision_grid")) {
+            suite.check(allPairsContacts == gridContacts, "collision_grid finds the same contacts as collision_all_pairs");
+        }
+    }
+}
+
+//*************************************************************************************
+//
+// Matrices
+
+static void benchmarkMatrices(BenchmarkSuite& suite) {
+    // Como Zombie: una raíz que se mueve cada paso y nueve partes fijas con escala no uniforme
+    const int NUM_ZOMBIES = 1000;
+    const int NUM_PARTS = 9;
+
+    std::mt19937 rng(441);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.25f, 2.0f);
+    std::vector<glm::mat4> partMatrices(NUM_PARTS);
+    for (auto& partMtx : partMatrices) {
+        partMtx = glm::translate(glm::mat4(1.0f), glm::vec3(unit(rng), unit(rng), unit(rng)));
+        partMtx = glm::rotate(partMtx, unit(rng), glm::normalize(glm::vec3(unit(rng), 1.0f, unit(rng))));
+        partMtx = glm::scale(partMtx, glm::vec3(scale(rng), scale(rng), scale(rng)));
+    }
+
+    int step = 0;
+    auto rootMatrix = [&](int zombie) {
+        const float angle = 0.01f * static_cast<float>(step) + static_cast<float>(zombie);
+        glm::mat4 modelMtx = glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(zombie % 32), 1.5f, static_cast<float>(zombie / 32)));
+        return glm::rotate(modelMtx, angle, CSCI441::Y_AXIS);
+    };
+
+    std::vector<glm::mat4> worldMatrices(NUM_ZOMBIES * NUM_PARTS);
+    std::vector<glm::mat3> normalMatrices(NUM_ZOMBIES * NUM_PARTS);
+    const std::string parameters = "zombies=" + std::to_string(NUM_ZOMBIES) + " parts=" + std::to_string(NUM_PARTS);
+
+    // Cada parte en cada dibujo: producto con la raíz e inversa traspuesta
+    suite.measure("micro", "matrices_per_draw", parameters, 50, 5, [&]() {
+        step++;
+        for (int z = 0; z < NUM_ZOMBIES; ++z) {
+            const glm::mat4 rootMtx = rootMatrix(z);
+            for (int p = 0; p < NUM_PARTS; ++p) {
+                const glm::mat4 worldMtx = rootMtx * partMatrices[p];
+                worldMatrices[z * NUM_PARTS + p] = worldMtx;
+                normalMatrices[z * NUM_PARTS + p] = glm::transpose(glm::inverse(glm::mat3(worldMtx)));
+            }
+        }
+    });
+
+    CSCI441::TransformHierarchy transforms;
+    std::vector<GLuint> rootNodes(NUM_ZOMBIES);
+    for (int z = 0; z < NUM_ZOMBIES; ++z) {
+        rootNodes[z] = transforms.addNode();
+        for (int p = 0; p < NUM_PARTS; ++p) {
+            transforms.setLocalMatrix(transforms.addNode(static_cast<GLint>(rootNodes[z])), partMatrices[p]);
+        }
+    }
+    suite.measure("micro", "matrices_hierarchy", parameters, 50, 5, [&]() {
+        step++;
+        for (int z = 0; z < NUM_ZOMBIES; ++z) transforms.setLocalMatrix(rootNodes[z], rootMatrix(z));
+        transforms.update();
+    });
+
+    if (suite.isSelected("matrices_per_draw") && suite.isSelected("matrices_hierarchy")) {
+        // Misma pose en ambas rutas
+        for (int z = 0; z < NUM_ZOMBIES; ++z) transforms.setLocalMatrix(rootNodes[z], rootMatrix(z));
+        transforms.update();
+        float maxError = 0.0f;
+        for (int z = 0; z < NUM_ZOMBIES; ++z) {
+            const glm::mat4 rootMtx = rootMatrix(z);
+            for (int p = 0; p < NUM_PARTS; ++p) {
+                const GLuint node = rootNodes[z] + 1 + p;
+                const glm::mat3 expected = glm::transpose(glm::inverse(glm::mat3(rootMtx * partMatrices[p])));
+                for (int c = 0; c < 3; ++c) {
+                    maxError = std::max(maxError, glm::length(expected[c] - transforms.getNormalMatrix(node)[c]));
+                }
+            }
+        }
+        suite.check(maxError < 1e-3f, "matrices_hierarchy computes the same normal matrices as matrices_per_draw");
+    }
+}
+
+//*************************************************************************************
+//
+// Skinning
+
+static void benchmarkSkinning(BenchmarkSuite& suite) {
+    const int NUM_VERTICES = 20000;
+    const int NUM_JOINTS = 64;
+
+    std::vector<Vertex> vertices;
+    std::vector<Weight> weights;
+    makeSkinningModel(NUM_VERTICES, NUM_JOINTS, vertices, weights);
+    std::vector<Joint> skeleton(NUM_JOINTS);
+    std::vector<glm::vec3> reference(NUM_VERTICES), result(NUM_VERTICES);
+
+    CSCI441::CPUSkinner::WorkerPool callingThreadOnly(1);
+    CSCI441::CPUSkinner singleThreaded(&callingThreadOnly);
+    const GLuint singleMesh = singleThreaded.addMesh(vertices.data(), NUM_VERTICES, weights.data());
+    CSCI441::CPUSkinner multiThreaded;
+    const GLuint multiMesh = multiThreaded.addMesh(vertices.data(), NUM_VERTICES, weights.data());
+
+    const std::string parameters = "vertices=" + std::to_string(NUM_VERTICES) + " joints=" + std::to_string(NUM_JOINTS);
+    int frame = 0;
+
+    suite.measure("micro", "skinning_scalar", parameters, 20, 5, [&]() {
+        animateSkeleton(skeleton, frame++);
+        skinScalar(vertices, weights, skeleton, reference);
+    });
+    suite.measure("micro", "skinning_cpuskinner_1_thread", parameters, 20, 5, [&]() {
+        animateSkeleton(skeleton, frame++);
+        singleThreaded.setPose(skeleton.data(), NUM_JOINTS);
+        singleThreaded.skin(singleMesh, result.data());
+    });
+    suite.measure("micro", "skinning_cpuskinner", parameters + " threads=" + std::to_string(multiThreaded.getNumberOfThreads()), 20, 5, [&]() {
+        animateSkeleton(skeleton, frame++);
+        multiThreaded.setPose(skeleton.data(), NUM_JOINTS);
+        multiThreaded.skin(multiMesh, result.data());
+    });
+
+    if (suite.isSelected("skinning_scalar") && suite.isSelected("skinning_cpuskinner")) {
+        // Ambas rutas deben producir la misma pose del último frame
+        skinScalar(vertices, weights, skeleton, reference);
+        float maxError = 0.0f;
+        for (int i = 0; i < NUM_VERTICES; ++i) {
+            maxError = std::max(maxError, glm::length(reference[i] - result[i]));
+        }
+        suite.check(maxError < 1e-4f, "CPUSkinner matches the scalar MD5 skinning");
+    }
+}
+
+//*************************************************************************************
+//
+// Benchmarks con contexto OpenGL
+
+/// \desc Contexto oculto para las pruebas que llaman a OpenGL; run() las ejecuta todas.
+class GLBenchmarks final : public CSCI441::OpenGLEngine {
+public:
+    explicit GLBenchmarks(BenchmarkSuite& suite)
+        : CSCI441::OpenGLEngine(4, 1, 640, 480, "MP_bench"),
+          _suite(suite) {
+        setHeadless(true);
+        turnDebuggingOff();
+    }
+
+    void run() final;
+
+private:
+    BenchmarkSuite& _suite;
+
+    void mSetupOpenGL() final {}
+    // las formas de objects.hpp quedan en caché; se borran con este contexto para que el siguiente no las use
+    void mCleanupBuffers() final {
+        CSCI441::deleteObjectVAOs();
+        CSCI441::deleteObjectVBOs();
+    }
+
+    void _benchmarkModelLoading();
+    void _benchmarkObjects();
+    void _benchmarkUniforms();
+};
+
+void GLBenchmarks::run() {
+    _suite.addMetadata("renderer", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    _suite.addMetadata("version", reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+    _benchmarkModelLoading();
+    _benchmarkObjects();
+    _benchmarkUniforms();
+}
+
+void GLBenchmarks::_benchmarkModelLoading() {
+    // Rejilla de GRID x GRID cuadrados en dos triángulos cada uno
+    const int GRID = 128;
+    const int SIDE = GRID + 1;
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string objFilename = (directory / "mp_bench_grid.obj").string();
+    const std::string plyFilename = (directory / "mp_bench_grid.ply").string();
+
+    std::ofstream obj(objFilename);
+    for (int z = 0; z < SIDE; ++z) {
+        for (int x = 0; x < SIDE; ++x) obj << "v " << x << " " << std::sin(0.1f * static_cast<float>(x + z)) << " " << z << "\n";
+    }
+    for (int i = 0; i < SIDE * SIDE; ++i) obj << "vn 0 1 0\n";
+    for (int z = 0; z < GRID; ++z) {
+        for (int x = 0; x < GRID; ++x) {
+            const int a = z * SIDE + x + 1, b = a + 1, c = a + SIDE, d = c + 1;      // índices desde 1
+            obj << "f " << a << "//" << a << " " << c << "//" << c << " " << b << "//" << b << "\n";
+            obj << "f " << b << "//" << b << " " << c << "//" << c << " " << d << "//" << d << "\n";
+        }
+    }
+    obj.close();
+
+    std::ofstream ply(plyFilename);
+    ply << "ply\nformat ascii 1.0\nelement vertex " << SIDE * SIDE << "\nproperty float x\nproperty float y\nproperty float z\n"
+        << "element face " << 2 * GRID * GRID << "\nproperty list uchar int vertex_indices\nend_header\n";
+    for (int z = 0; z < SIDE; ++z) {
+        for (int x = 0; x < SIDE; ++x) ply << x << " " << std::sin(0.1f * static_cast<float>(x + z)) << " " << z << "\n";
+    }
+    for (int z = 0; z < GRID; ++z) {
+        for (int x = 0; x < GRID; ++x) {
+            const int a = z * SIDE + x, b = a + 1, c = a + SIDE, d = c + 1;
+            ply << "3 " << a << " " << c << " " << b << "\n3 " << b << " " << c << " " << d << "\n";
+        }
+    }
+    ply.close();
+
+    const std::string parameters = "triangles=" + std::to_string(2 * GRID * GRID);
+    bool isLoaded = true;
+    _suite.measure("micro", "obj_parse", parameters, 3, 3, [&]() {
+        CSCI441::ModelLoader model;
+        isLoaded = model.loadModelFile(objFilename, false, true) && isLoaded;
+    });
+    _suite.measure("micro", "ply_parse", parameters, 3, 3, [&]() {
+        CSCI441::ModelLoader model;
+        isLoaded = model.loadModelFile(plyFilename, false, true) && isLoaded;
+    });
+    _suite.check(isLoaded, "ModelLoader loads the generated OBJ and PLY files");
+
+    std::filesystem::remove(objFilename);
+    std::filesystem::remove(plyFilename);
+}
+
+void GLBenchmarks::_benchmarkObjects() {
+    // Cada llamada pide un tamaño nuevo, así que se genera la forma y se vuelven a subir los buffers compartidos
+    int shape = 0;
+    auto nextSize = [&]() { return 1.0f + 0.001f * static_cast<float>(++shape); };
+
+    _suite.measure("micro", "objects_sphere_generate", "stacks=20 slices=20", 20, 3, [&]() {
+        (void)CSCI441::getSolidSphereMesh(nextSize(), 20, 20);
+    });
+    _suite.measure("micro", "objects_cone_generate", "stacks=20 slices=20", 20, 3, [&]() {
+        (void)CSCI441::getSolidConeMesh(nextSize(), 1.0f, 20, 20);
+    });
+    _suite.measure("micro", "objects_torus_generate", "sides=20 rings=20", 20, 3, [&]() {
+        (void)CSCI441::getSolidTorusMesh(0.5f, nextSize(), 20, 20);
+    });
+    // Lo que pagan los zombies cada frame: la forma ya existe
+    _suite.measure("micro", "objects_sphere_cached", "stacks=20 slices=20", 10000, 5, [&]() {
+        (void)CSCI441::getSolidSphereMesh(1.0f, 20, 20);
+    });
+}
+
+void GLBenchmarks::_benchmarkUniforms() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string vertexFilename = (directory / "mp_bench.v.glsl").string();
+    const std::string fragmentFilename = (directory / "mp_bench.f.glsl").string();
+
+    // Los mismos uniformes que envía cada parte dibujada sin DrawBatcher
+    std::ofstream vertexShader(vertexFilename);
+    vertexShader << "#version 410 core\n"
+                    "uniform mat4 mvpMatrix;\n"
+                    "uniform mat3 normalMatrix;\n"
+                    "uniform vec3 materialDiffuseColor;\n"
+                    "layout(location = 0) in vec3 vPos;\n"
+                    "layout(location = 1) in vec3 vNormal;\n"
+                    "out vec3 color;\n"
+                    "void main() {\n"
+                    "    gl_Position = mvpMatrix * vec4(vPos, 1.0);\n"
+                    "    color = materialDiffuseColor * max(normalize(normalMatrix * vNormal).z, 0.0);\n"
+                    "}\n";
+    vertexShader.close();
+    std::ofstream fragmentShader(fragmentFilename);
+    fragmentShader << "#version 410 core\n"
+                      "in vec3 color;\n"
+                      "out vec4 fragColorOut;\n"
+                      "void main() {\n"
+                      "    fragColorOut = vec4(color, 1.0);\n"
+                      "}\n";
+    fragmentShader.close();
+
+    auto shaderProgram = std::make_unique<CSCI441::ShaderProgram>(vertexFilename.c_str(), fragmentFilename.c_str());
+    std::filesystem::remove(vertexFilename);
+    std::filesystem::remove(fragmentFilename);
+
+    const GLint mvpLocation = shaderProgram->getUniformLocation("mvpMatrix");
+    const GLint normalLocation = shaderProgram->getUniformLocation("normalMatrix");
+    const GLint colorLocation = shaderProgram->getUniformLocation("materialDiffuseColor");
+    _suite.check(mvpLocation != -1 && normalLocation != -1 && colorLocation != -1, "uniform benchmark shader links");
+
+    // Tres uniformes por parte, como _computeAndSendMatrixUniforms() y los materiales
+    const int NUM_DRAWS = 1000;
+    const glm::mat4 mvpMtx(1.0f);
+    const glm::mat3 normalMtx(1.0f);
+    const glm::vec3 color(0.0f, 1.0f, 0.0f);
+
+    _suite.measure("micro", "uniform_by_name", "draws=" + std::to_string(NUM_DRAWS), 20, 5, [&]() {
+        for (int i = 0; i < NUM_DRAWS; ++i) {
+            shaderProgram->setProgramUniform("mvpMatrix", mvpMtx);
+            shaderProgram->setProgramUniform("normalMatrix", normalMtx);
+            shaderProgram->setProgramUniform("materialDiffuseColor", color);
+        }
+    });
+    _suite.measure("micro", "uniform_by_location", "draws=" + std::to_string(NUM_DRAWS), 20, 5, [&]() {
+        for (int i = 0; i < NUM_DRAWS; ++i) {
+            shaderProgram->setProgramUniform(mvpLocation, mvpMtx);
+            shaderProgram->setProgramUniform(normalLocation, normalMtx);
+            shaderProgram->setProgramUniform(colorLocation, color);
+        }
+    });
+    glFinish();
+}
+
+//*************************************************************************************
+//
+// Macro benchmarks
+
+/// \desc Pasos de la simulación sin render: movimiento de los zombies, caídas y colisiones.
+static void benchmarkSimulation(BenchmarkSuite& suite, const std::vector<size_t>& zombieCounts) {
+    const float STEP = 1.0f / 60.0f;
+    const int TICKS = 60;
+
+    if (!suite.isSelected("headless_simulation")) return;
+
+    for (const size_t numZombies : zombieCounts) {
+        const std::string parameters = "zombies=" + std::to_string(numZombies);
+        const float halfSize = arenaHalfSize(numZombies);
+        CSCI441::TransformHierarchy transforms;
+        std::vector< std::unique_ptr<Zombie> > zombies;
+        zombies.reserve(numZombies);
+
+        std::mt19937 rng(441);
+        std::uniform_real_distribution<float> coordinate(-halfSize, halfSize);
+        std::uniform_int_distribution<int> coin(0, 1);
+        for (size_t i = 0; i < numZombies; ++i) {
+            zombies.push_back(std::make_unique<Zombie>(&transforms));
+            zombies.back()->position = glm::vec3(coordinate(rng), 1.5f, coordinate(rng));
+            zombies.back()->speedMultiplier = coin(rng) ? 0.7f : 1.0f;
+        }
+
+        UniformGrid grid(halfSize, 2.0f * ZOMBIE_RADIUS);
+        int tick = 0;
+
+        // El héroe da vueltas alrededor del centro y los zombies lo persiguen, como en MP::_updateScene()
+        suite.measure("macro", "headless_simulation", parameters, TICKS, 3, [&]() {
+            const float angle = 0.2f * STEP * static_cast<float>(tick++);
+            const glm::vec3 heroPosition(0.5f * halfSize * std::cos(angle), 0.0f, 0.5f * halfSize * std::sin(angle));
+
+            const float BOUNDARY = halfSize + 1.0f;
+            for (const auto& zombie : zombies) {
+                if (!zombie->isFalling && (std::abs(zombie->position.x) > BOUNDARY || std::abs(zombie->position.z) > BOUNDARY)) {
+                    zombie->isFalling = true;
+                    zombie->fallRotation = 0.0f;
+                }
+                if (zombie->isActive) zombie->update(STEP, heroPosition);
+            }
+
+            grid.build(numZombies, [&](size_t i) { return zombies[i]->position; });
+            grid.forEachPair([&](GLuint i, GLuint j) {
+                zombies[i]->collideWith(*zombies[j]);
+            });
+        });
+    }
+}
+
+/// \desc Cuadros por segundo del modo --benchmark del juego, render a un FBO con cámara fija.
+static void benchmarkOffscreenRender(BenchmarkSuite& suite, int numFrames) {
+    if (!suite.isSelected("offscreen_render")) return;
+
+    MP::BenchmarkSettings settings;
+    settings.numFrames = numFrames;
+    settings.reportFilename = "MP_bench_frames.json";
+
+    auto engine = std::make_unique<MP>();
+    engine->enableBenchmark(settings);
+    engine->initialize();
+    if (engine->getError() == CSCI441::OpenGLEngine::OPENGL_ENGINE_ERROR_NO_ERROR) {
+        const auto start = std::chrono::steady_clock::now();
+        engine->run();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        const double frameMs = elapsed.count() / numFrames;
+        suite.add({ "macro", "offscreen_render",
+                    "frames=" + std::to_string(numFrames) + " size=" + std::to_string(settings.width) + "x" + std::to_string(settings.height),
+                    numFrames, 1, frameMs, frameMs });
+        suite.addMetadata("frame_report", settings.reportFilename);
+    }
+    engine->shutdown();
+}
+
+//*************************************************************************************
+
+int main(int argc, char* argv[]) {
+    std::string output = "MP_bench.json";
+    std::string filter;
+    std::vector<size_t> zombieCounts = { 1000, 10000, 100000 };
+    int numFrames = MP::BenchmarkSettings().numFrames;
+    bool useOpenGL = true;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--zombies") == 0 && i + 1 < argc) {
+            zombieCounts.clear();
+            const std::string counts = argv[++i];
+            for (size_t start = 0; start != std::string::npos; ) {
+                const size_t comma = counts.find(',', start);
+                zombieCounts.push_back(strtoul(counts.substr(start, comma - start).c_str(), nullptr, 10));
+                start = comma == std::string::npos ? comma : comma + 1;
+            }
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            numFrames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--no-gl") == 0) {
+            useOpenGL = false;
+        } else {
+            fprintf(stderr, "Usage: %s [--output FILE] [--filter TEXT] [--zombies N[,N...]] [--frames N] [--no-gl]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    zombieCounts.erase(std::remove(zombieCounts.begin(), zombieCounts.end(), size_t(0)), zombieCounts.end());
+    if (numFrames <= 0 || zombieCounts.empty()) {
+        fprintf(stderr, "Usage: %s [--output FILE] [--filter TEXT] [--zombies N[,N...]] [--frames N] [--no-gl]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Los mensajes del juego en cada cuadro no deben mezclarse con las mediciones
+    CSCI441::Logger::instance().setMinimumSeverity(CSCI441::Logger::SEVERITY_WARNING);
+
+    BenchmarkSuite suite(filter);
+    suite.addMetadata("hardware_threads", std::to_string(std::thread::hardware_concurrency()));
+#ifdef NDEBUG
+    suite.addMetadata("build", "release");
+#else
+    suite.addMetadata("build", "debug");
+#endif
+
+    printf("Micro benchmarks\n");
+    benchmarkCollisions(suite);
+    benchmarkMatrices(suite);
+    benchmarkSkinning(suite);
+    if (useOpenGL) {
+        auto glBenchmarks = std::make_unique<GLBenchmarks>(suite);
+        glBenchmarks->initialize();
+        if (glBenchmarks->getError() == CSCI441::OpenGLEngine::OPENGL_ENGINE_ERROR_NO_ERROR) {
+            glBenchmarks->run();
+        } else {
+            // el juego tampoco podría crear su contexto
+            fprintf(stderr, "[WARN]: OpenGL benchmarks skipped, could not create an OpenGL context\n");
+            useOpenGL = false;
+        }
+        glBenchmarks->shutdown();
+    }
+
+    printf("Macro benchmarks\n");
+    benchmarkSimulation(suite, zombieCounts);
+    if (useOpenGL) {
+        benchmarkOffscreenRender(suite, numFrames);
+    }
+
+    if (!suite.writeJSON(output.c_str())) return EXIT_FAILURE;
+    printf("Report written to %s\n", output.c_str());
+    return suite.isValid() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
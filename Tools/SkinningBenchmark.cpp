@@ -0,0 +1,90 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2024
+ *
+ *  Project: MP
+ *  File: Tools/SkinningBenchmark.cpp
+ *
+ *  Description:
+ *      Compara el skinning en CPU de MD5Model: el ciclo escalar original
+ *      (AoS sobre vértices y pesos, un cuaternión por peso) contra CPUSkinner
+ *      (flujos SoA por número de influencias, matrices 3x4 por frame, SSE e
+ *      hilos).  Genera un modelo MD5 sintético, no necesita contexto OpenGL,
+ *      así que también corre en la ruta de CI sin GPU.
+ *
+ *      Uso:
+ *          skinning_benchmark [vertices] [joints] [frames]
+ *          (por defecto 50000 vértices, 64 joints, 200 frames)
+ *
+ */
+
+#include "SkinningModel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/// \desc Mide milisegundos por frame de una función de skinning.
+template<typename SkinFunction>
+static double timeFrames(int frames, std::vector<Joint>& skeleton, SkinFunction skinFrame) {
+    const auto start = std::chrono::steady_clock::now();
+    for(int frame = 0; frame < frames; ++frame) {
+        animateSkeleton(skeleton, frame);
+        skinFrame();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+}
+
+int main(int argc, char* argv[]) {
+    const int numVertices = argc > 1 ? std::atoi(argv[1]) : 50000;
+    const int numJoints   = argc > 2 ? std::atoi(argv[2]) : 64;
+    const int frames      = argc > 3 ? std::atoi(argv[3]) : 200;
+    if( numVertices <= 0 || numJoints <= 0 || frames <= 0 ) {
+        fprintf(stderr, "Usage: %s [vertices] [joints] [frames]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Vertex> vertices;
+    std::vector<Weight> weights;
+    makeSkinningModel(numVertices, numJoints, vertices, weights);
+    std::vector<Joint> skeleton(numJoints);
+
+    std::vector<glm::vec3> reference(numVertices), result(numVertices);
+
+    CSCI441::CPUSkinner::WorkerPool callingThreadOnly(1);
+    CSCI441::CPUSkinner singleThreaded(&callingThreadOnly);
+    const GLuint singleMesh = singleThreaded.addMesh(vertices.data(), numVertices, weights.data());
+    CSCI441::CPUSkinner multiThreaded;
+    const GLuint multiMesh = multiThreaded.addMesh(vertices.data(), numVertices, weights.data());
+
+    printf("Skinning %d vertices, %zu weights, %d joints, %d frames\n", numVertices, weights.size(), numJoints, frames);
+
+    const double scalarMs = timeFrames(frames, skeleton, [&]() {
+        skinScalar(vertices, weights, skeleton, reference);
+    });
+    printf("  scalar AoS              %8.3f ms/frame\n", scalarMs);
+
+    const double singleMs = timeFrames(frames, skeleton, [&]() {
+        singleThreaded.setPose(skeleton.data(), numJoints);
+        singleThreaded.skin(singleMesh, result.data());
+    });
+    printf("  CPUSkinner, 1 thread    %8.3f ms/frame  (%.2fx)\n", singleMs, scalarMs / singleMs);
+
+    const double multiMs = timeFrames(frames, skeleton, [&]() {
+        multiThreaded.setPose(skeleton.data(), numJoints);
+        multiThreaded.skin(multiMesh, result.data());
+    });
+    printf("  CPUSkinner, %2u threads  %8.3f ms/frame  (%.2fx)\n", multiThreaded.getNumberOfThreads(), multiMs, scalarMs / multiMs);
+
+    // Ambas rutas deben producir la misma pose del último frame
+    skinScalar(vertices, weights, skeleton, reference);
+    float maxError = 0.0f;
+    for(int i = 0; i < numVertices; ++i) {
+        maxError = std::max(maxError, glm::length(reference[i] - result[i]));
+    }
+    printf("  max position difference %g\n", maxError);
+
+    return maxError < 1e-4f ? EXIT_SUCCESS : EXIT_FAILURE;
+}
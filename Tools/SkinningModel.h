@@ -0,0 +1,94 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2024
+ *
+ *  Project: MP
+ *  File: Tools/SkinningModel.h
+ *
+ *  Description:
+ *      Modelo MD5 sintético y el ciclo de skinning escalar original de
+ *      MD5Model, compartidos por skinning_benchmark y MP_bench para que ambos
+ *      midan exactamente lo mismo.
+ *
+ */
+
+#ifndef SKINNING_MODEL_H
+#define SKINNING_MODEL_H
+
+#include <CPUSkinner.hpp>
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Mismos campos que los tipos de MD5Model usados al hacer skinning
+struct Joint {
+    glm::vec3 position;
+    glm::quat orientation;
+};
+struct Vertex {
+    glm::vec2 texCoord;
+    GLint start;
+    GLint count;
+};
+struct Weight {
+    GLint joint;
+    GLfloat bias;
+    glm::vec3 position;
+};
+
+/// \desc Ruta original de MD5Model::_prepareMesh().
+inline void skinScalar(const std::vector<Vertex>& vertices, const std::vector<Weight>& weights,
+                       const std::vector<Joint>& skeleton, std::vector<glm::vec3>& out) {
+    for(size_t i = 0; i < vertices.size(); ++i) {
+        glm::vec3 finalVertex = {0.0f, 0.0f, 0.0f };
+        for(GLint j = 0; j < vertices[i].count; ++j) {
+            const Weight *weight = &weights[vertices[i].start + j];
+            const Joint  *joint  = &skeleton[weight->joint];
+            glm::vec3 weightedVertex = glm::rotate(joint->orientation, glm::vec4(weight->position, 0.0f));
+            finalVertex.x += (joint->position.x + weightedVertex.x) * weight->bias;
+            finalVertex.y += (joint->position.y + weightedVertex.y) * weight->bias;
+            finalVertex.z += (joint->position.z + weightedVertex.z) * weight->bias;
+        }
+        out[i] = finalVertex;
+    }
+}
+
+/// \desc Pose animada para el frame dado.
+inline void animateSkeleton(std::vector<Joint>& skeleton, int frame) {
+    for(size_t j = 0; j < skeleton.size(); ++j) {
+        const float angle = 0.01f * static_cast<float>(frame) + 0.1f * static_cast<float>(j);
+        skeleton[j].orientation = glm::normalize( glm::angleAxis(angle, glm::normalize(glm::vec3(1.0f, 0.5f * static_cast<float>(j % 3), 0.25f))) );
+        skeleton[j].position = glm::vec3( static_cast<float>(j) * 0.1f, std::sin(angle), 0.0f );
+    }
+}
+
+/// \desc Modelo sintético: de 1 a 4 influencias por vértice, como los personajes MD5 típicos.
+inline void makeSkinningModel(int numVertices, int numJoints, std::vector<Vertex>& vertices, std::vector<Weight>& weights) {
+    std::mt19937 rng(441);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> influenceCount(1, 4);
+    std::uniform_int_distribution<int> jointIndex(0, numJoints - 1);
+
+    vertices.assign(numVertices, Vertex());
+    weights.clear();
+    for(auto& vertex : vertices) {
+        vertex.texCoord = glm::vec2(0.0f);
+        vertex.start = static_cast<GLint>(weights.size());
+        vertex.count = influenceCount(rng);
+        float total = 0.0f;
+        for(GLint w = 0; w < vertex.count; ++w) {
+            Weight weight;
+            weight.joint = jointIndex(rng);
+            weight.bias = unit(rng) + 1.5f;
+            weight.position = glm::vec3(unit(rng), unit(rng), unit(rng));
+            total += weight.bias;
+            weights.push_back(weight);
+        }
+        for(GLint w = 0; w < vertex.count; ++w) weights[vertex.start + w].bias /= total;
+    }
+}
+
+#endif //SKINNING_MODEL_H
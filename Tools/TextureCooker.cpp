@@ -0,0 +1,127 @@
+/*
+ *  CSCI 441, Computer Graphics, Fall 2024
+ *
+ *  Project: MP
+ *  File: Tools/TextureCooker.cpp
+ *
+ *  Description:
+ *      Herramienta offline que convierte imágenes (PNG, BMP, JPG, ...) en
+ *      contenedores KTX con la cadena de mipmaps precalculada y comprimidos
+ *      en BC1/BC3/BC7.  El juego carga el .ktx si existe junto a la imagen
+ *      original, evitando decodificar PNG y generar mipmaps al iniciar.
+ *
+ *      Uso:
+ *          texture_cooker [--format auto|bc1|bc3|bc7|rgba] [--flip] -o salida.ktx entrada.png
+ *          texture_cooker --cube [--format ...] -o salida.ktx +x -x +y -y +z -z
+ *
+ */
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#include <KTXUtils.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using CSCI441::KTXUtils::Format;
+
+/// \desc Imprime el modo de uso de la herramienta.
+static void printUsage(const char* programName) {
+    fprintf(stderr, "Usage: %s [--format auto|bc1|bc3|bc7|rgba] [--flip] -o output.ktx input\n", programName);
+    fprintf(stderr, "       %s --cube [--format auto|bc1|bc3|bc7|rgba] -o output.ktx +x -x +y -y +z -z\n", programName);
+}
+
+/// \desc Carga una imagen como RGBA de 8 bits.
+static bool loadImage(const char* filename, bool flipOnY, CSCI441::KTXUtils::Image& image) {
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load(flipOnY);
+    unsigned char* data = stbi_load(filename, &width, &height, &channels, 4);
+    if (!data) {
+        fprintf(stderr, "[ERROR]: could not load \"%s\": %s\n", filename, stbi_failure_reason());
+        return false;
+    }
+    image.width = static_cast<uint32_t>(width);
+    image.height = static_cast<uint32_t>(height);
+    image.pixels.assign(data, data + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(data);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string formatName = "auto";
+    std::string outputFilename;
+    std::vector<std::string> inputFilenames;
+    bool isCubeMap = false;
+    bool flipOnY = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            formatName = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputFilename = argv[++i];
+        } else if (strcmp(argv[i], "--cube") == 0) {
+            isCubeMap = true;
+        } else if (strcmp(argv[i], "--flip") == 0) {
+            flipOnY = true;
+        } else {
+            inputFilenames.emplace_back(argv[i]);
+        }
+    }
+
+    const size_t numFaces = isCubeMap ? 6 : 1;
+    if (outputFilename.empty() || inputFilenames.size() != numFaces) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Cargar todas las caras y generar sus mipmaps
+    std::vector<std::vector<CSCI441::KTXUtils::Image>> faceChains;
+    bool anyAlpha = false;
+    for (const auto& inputFilename : inputFilenames) {
+        CSCI441::KTXUtils::Image base;
+        if (!loadImage(inputFilename.c_str(), flipOnY, base)) return EXIT_FAILURE;
+        if (!faceChains.empty() && (base.width != faceChains[0][0].width || base.height != faceChains[0][0].height)) {
+            fprintf(stderr, "[ERROR]: all cube map faces must have the same size\n");
+            return EXIT_FAILURE;
+        }
+        anyAlpha = anyAlpha || CSCI441::KTXUtils::hasAlpha(base);
+        faceChains.push_back(CSCI441::KTXUtils::generateMipChain(base));
+    }
+
+    Format format;
+    if (formatName == "auto")      format = anyAlpha ? Format::BC3 : Format::BC1;
+    else if (formatName == "bc1")  format = Format::BC1;
+    else if (formatName == "bc3")  format = Format::BC3;
+    else if (formatName == "bc7")  format = Format::BC7;
+    else if (formatName == "rgba") format = Format::RGBA8;
+    else {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    CSCI441::KTXUtils::Texture texture;
+    texture.format = format;
+    texture.width = faceChains[0][0].width;
+    texture.height = faceChains[0][0].height;
+    texture.numFaces = static_cast<uint32_t>(numFaces);
+    texture.flippedOnY = flipOnY;
+    texture.levels.resize(faceChains[0].size());
+
+    size_t sourceBytes = 0, cookedBytes = 0;
+    for (size_t level = 0; level < texture.levels.size(); level++) {
+        for (const auto& chain : faceChains) {
+            texture.levels[level].push_back(CSCI441::KTXUtils::encode(chain[level], format));
+            sourceBytes += chain[level].pixels.size();
+            cookedBytes += texture.levels[level].back().size();
+        }
+    }
+
+    if (!CSCI441::KTXUtils::writeKTX(outputFilename.c_str(), texture)) return EXIT_FAILURE;
+
+    printf("[INFO]: %s: %ux%u, %zu face(s), %zu mip level(s), %zu -> %zu bytes\n",
+           outputFilename.c_str(), texture.width, texture.height, numFaces, texture.levels.size(), sourceBytes, cookedBytes);
+    return EXIT_SUCCESS;
+}
@@ -14,21 +14,112 @@
 
 #include "MP.h"
 
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
-
+// Lee "ANCHOxALTO" con los dos valores positivos y nada más detrás
+static bool parseSize(const char* text, int& width, int& height) {
+    int parsedWidth = 0, parsedHeight = 0, length = 0;
+    if (sscanf(text, "%dx%d%n", &parsedWidth, &parsedHeight, &length) != 2 || text[length] != '\0'
+        || parsedWidth <= 0 || parsedHeight <= 0) {
+        return false;
+    }
+    width = parsedWidth;
+    height = parsedHeight;
+    return true;
+}
 
 ///*****************************************************************************
 //
 // Our main function
-int main() {
+//
+// --benchmark [--frames N] [--size WIDTHxHEIGHT] [--report FILE]
+//      renders a fixed camera path offscreen and writes a JSON report instead of playing
+// --pipelined
+//      simulates on a second thread while the main thread renders the latest state
+// --verbose
+//      also prints debug messages
+// --target-fps N
+//      frame rate to hold (60 by default, 0 leaves it to vertical sync)
+// --native-resolution
+//      always renders the scene at window resolution instead of scaling it to fit the frame budget
+// --pip-size WIDTHxHEIGHT, --pip-rate HZ
+//      resolution and refreshes per second of the first-person inset (key 1), 0 Hz redraws it every frame
+int main(int argc, char* argv[]) {
+
+    bool benchmark = false;
+    bool pipelined = false;
+    bool verbose = false;
+    double targetFramesPerSecond = 60.0;
+    bool nativeResolution = false;
+    MP::PictureInPictureSettings pictureInPictureSettings;
+    MP::BenchmarkSettings benchmarkSettings;
+    const char* const USAGE = "Usage: %s [--pipelined] [--verbose] [--target-fps N] [--native-resolution] [--pip-size WIDTHxHEIGHT] [--pip-rate HZ] [--benchmark [--frames N] [--size WIDTHxHEIGHT] [--report FILE]]\n";
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--benchmark") == 0) {
+            benchmark = true;
+        } else if (strcmp(argv[i], "--pipelined") == 0) {
+            pipelined = true;
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else if (strcmp(argv[i], "--target-fps") == 0 && i + 1 < argc) {
+            targetFramesPerSecond = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--native-resolution") == 0) {
+            nativeResolution = true;
+        } else if (strcmp(argv[i], "--pip-size") == 0 && i + 1 < argc) {
+            if (!parseSize(argv[++i], pictureInPictureSettings.width, pictureInPictureSettings.height)) {
+                fprintf(stderr, USAGE, argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--pip-rate") == 0 && i + 1 < argc) {
+            pictureInPictureSettings.updateRate = static_cast<float>(atof(argv[++i]));
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            // Solo un entero positivo; cualquier otro valor se rechaza después del bucle
+            char* end = nullptr;
+            const long numFrames = strtol(argv[++i], &end, 10);
+            benchmarkSettings.numFrames = (*end == '\0' && numFrames > 0 && numFrames <= INT_MAX) ? static_cast<int>(numFrames) : 0;
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (!parseSize(argv[++i], benchmarkSettings.width, benchmarkSettings.height)) {
+                fprintf(stderr, USAGE, argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc) {
+            benchmarkSettings.reportFilename = argv[++i];
+        } else {
+            fprintf(stderr, USAGE, argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (benchmarkSettings.numFrames <= 0) {
+        fprintf(stderr, USAGE, argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Arranca el hilo del logger antes del primer frame para que no reserve memoria durante el juego
+    CSCI441::Logger::instance().setMinimumSeverity(verbose ? CSCI441::Logger::SEVERITY_DEBUG : CSCI441::Logger::SEVERITY_INFO);
 
     auto labEngine = new MP();
+    if (benchmark) {
+        labEngine->enableBenchmark(benchmarkSettings);
+    } else if (pipelined) {
+        labEngine->enablePipelining();
+    }
+    labEngine->setTargetFrameRate(targetFramesPerSecond);
+    labEngine->setPictureInPicture(pictureInPictureSettings);
+    if (nativeResolution) {
+        labEngine->disableDynamicResolution();
+    }
     labEngine->initialize();
-    if (labEngine->getError() == CSCI441::OpenGLEngine::OPENGL_ENGINE_ERROR_NO_ERROR) {
+    // Sin contexto o sin informe del benchmark el proceso termina con error para que los scripts lo noten
+    bool isSuccessful = labEngine->getError() == CSCI441::OpenGLEngine::OPENGL_ENGINE_ERROR_NO_ERROR;
+    if (isSuccessful) {
         labEngine->run();
+        isSuccessful = !labEngine->hasBenchmarkFailed();
     }
     labEngine->shutdown();
     delete labEngine;
 
-	return EXIT_SUCCESS;
+	return isSuccessful ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -1,14 +1,56 @@
 #version 410 core
 
+// Compiled through CSCI441::ShaderPermutations, see A3.v.glsl for the feature defines
+
 // uniform inputs
+#ifdef PER_PIXEL_LIGHTING
+uniform vec3 eyePosition;               // eye position
+#ifndef INSTANCED
+uniform vec3 materialAmbientColor;
+uniform vec3 materialDiffuseColor;
+uniform vec3 materialSpecularColor;
+uniform float materialShininess;
+#endif
+#endif
+#ifdef USE_TEXTURE
+uniform sampler2D diffuseMap;           // texture modulating the lit color
+#endif
 
 // varying inputs
+#ifdef PER_PIXEL_LIGHTING
+layout(location = 0) in vec3 fragPosition;      // interpolated position for this fragment
+layout(location = 1) in vec3 fragNormal;        // interpolated normal for this fragment
+#ifdef INSTANCED
+layout(location = 2) flat in vec3 fragAmbientColor;
+layout(location = 3) flat in vec3 fragDiffuseColor;
+layout(location = 4) flat in vec3 fragSpecularColor;
+layout(location = 5) flat in float fragShininess;
+#endif
+#else
 layout(location = 0) in vec3 color;     // interpolated color for this fragment
+#endif
+#ifdef USE_TEXTURE
+layout(location = 6) in vec2 texCoord;  // interpolated texture coordinate for this fragment
+#endif
 
 // outputs
 out vec4 fragColorOut;                  // color to apply to this fragment
 
 void main() {
+#ifdef PER_PIXEL_LIGHTING
+    // light this fragment with the interpolated normal
+#ifdef INSTANCED
+    Material material = Material(fragAmbientColor, fragDiffuseColor, fragSpecularColor, fragShininess);
+#else
+    Material material = Material(materialAmbientColor, materialDiffuseColor, materialSpecularColor, materialShininess);
+#endif
+    vec3 color = calculateLighting(material, normalize(fragNormal), fragPosition, normalize(eyePosition - fragPosition));
+#endif
+
+#ifdef USE_TEXTURE
+    fragColorOut = vec4(color * texture(diffuseMap, texCoord).rgb, 1.0);
+#else
     // pass the interpolated color through as output
     fragColorOut = vec4(color, 1.0);
-}
\ No newline at end of file
+#endif
+}
@@ -1,107 +1,59 @@
 #version 410 core
 
+// Compiled through CSCI441::ShaderPermutations with shaders/lighting.glsl.
+// Feature defines, all off unless set:
+//   INSTANCED           matrices and material are per-instance attributes filled by CSCI441::DrawBatcher
+//   PER_PIXEL_LIGHTING  lighting is evaluated in A3.f.glsl instead of per vertex
+//   USE_TEXTURE         the lit color is modulated by diffuseMap
+// Light counts are described in shaders/lighting.glsl.
+
 // Uniform inputs
-uniform mat4 mvpMatrix;                 // Model-View-Projection Matrix
-uniform mat3 normalMatrix;              // Normal matrix
 uniform vec3 eyePosition;               // Eye position
 
 // Attribute inputs
 layout(location = 0) in vec3 vPos;      // Vertex position
 layout(location = 1) in vec3 vNormal;   // Vertex normal
+#ifdef USE_TEXTURE
+layout(location = 2) in vec2 vTexCoord; // Vertex texture coordinate
+#endif
+
+#ifdef INSTANCED
+// Per-draw attribute inputs
+layout(location = 3) in mat4 mvpMatrix;                 // Model-View-Projection Matrix, locations 3-6
+layout(location = 7) in mat3 normalMatrix;              // Normal matrix, locations 7-9
+
+// Material properties
+layout(location = 10) in vec3 materialAmbientColor;
+layout(location = 11) in vec3 materialDiffuseColor;
+layout(location = 12) in vec3 materialSpecularColor;
+layout(location = 13) in float materialShininess;
+#else
+uniform mat4 mvpMatrix;                 // Model-View-Projection Matrix
+uniform mat3 normalMatrix;              // Normal matrix
 
 // Material properties
 uniform vec3 materialAmbientColor;
 uniform vec3 materialDiffuseColor;
 uniform vec3 materialSpecularColor;
 uniform float materialShininess;
-
-// Directional Light properties
-uniform vec3 lightDirection;
-uniform vec3 lightAmbientColor;
-uniform vec3 lightDiffuseColor;
-uniform vec3 lightSpecularColor;
-
-// Point Light properties
-uniform vec3 pointLightPos;
-uniform vec3 pointLightColor;
-uniform float pointLightConstant;
-uniform float pointLightLinear;
-uniform float pointLightQuadratic;
-
-// Spotlight properties
-uniform vec3 spotLightPos;
-uniform vec3 spotLightDirection;
-uniform vec3 spotLightColor;
-uniform float spotLightCutoff;
-uniform float spotLightOuterCutoff;
-uniform float spotLightExponent;
-uniform float spotLightConstant;
-uniform float spotLightLinear;
-uniform float spotLightQuadratic;
+#endif
 
 // Varying outputs
+#ifdef PER_PIXEL_LIGHTING
+layout(location = 0) out vec3 fragPosition;     // Position to light in the fragment shader
+layout(location = 1) out vec3 fragNormal;       // Normal to light in the fragment shader
+#ifdef INSTANCED
+layout(location = 2) flat out vec3 fragAmbientColor;
+layout(location = 3) flat out vec3 fragDiffuseColor;
+layout(location = 4) flat out vec3 fragSpecularColor;
+layout(location = 5) flat out float fragShininess;
+#endif
+#else
 layout(location = 0) out vec3 color;    // Color to pass to fragment shader
-
-vec3 calculateDirectionalLight(vec3 normal, vec3 viewVector) {
-    // Compute light vector
-    vec3 lightVector = normalize(-lightDirection);
-
-    // Ambient component
-    vec3 ambient = lightAmbientColor * materialAmbientColor;
-
-    // Diffuse component
-    float diffuseFactor = max(dot(normal, lightVector), 0.0);
-    vec3 diffuse = lightDiffuseColor * materialDiffuseColor * diffuseFactor;
-
-    // Specular component
-    vec3 reflectVector = reflect(-lightVector, normal);
-    float specularFactor = pow(max(dot(viewVector, reflectVector), 0.0), materialShininess);
-    vec3 specular = lightSpecularColor * materialSpecularColor * specularFactor;
-
-    // Sum all components
-    return ambient + diffuse + specular;
-}
-
-vec3 calculatePointLight(vec3 normal, vec3 fragPosition, vec3 viewVector) {
-    vec3 lightDirection = normalize(pointLightPos - fragPosition);
-    float difference = max(dot(normal, lightDirection), 0.0);
-    vec3 reflectDirection = reflect(-lightDirection, normal);
-    float specularFactor = pow(max(dot(viewVector, reflectDirection), 0.0), materialShininess);
-
-    float distance = length(pointLightPos - fragPosition);
-    float attenuation = 1.0 / (pointLightConstant + pointLightLinear * distance + pointLightQuadratic * (distance * distance));
-
-    vec3 ambient = pointLightColor * materialAmbientColor;
-    vec3 diffuse = difference * pointLightColor;
-    vec3 specular = specularFactor * pointLightColor;
-
-    return (ambient + diffuse + specular) * attenuation;
-}
-
-vec3 calculateSpotlight(vec3 normal, vec3 fragPosition, vec3 viewVector) {
-    vec3 lightDirection = normalize(spotLightPos - fragPosition);
-    float theta = dot(lightDirection, normalize(-spotLightDirection));
-
-    if (theta > spotLightCutoff) {
-        float difference = max(dot(normal, lightDirection), 0.0);
-        vec3 reflectDirection = reflect(-lightDirection, normal);
-        float specularFactor = pow(max(dot(viewVector, reflectDirection), 0.0), materialShininess);
-
-        float distance = length(spotLightPos - fragPosition);
-        float attenuation = 1.0 / (spotLightConstant + spotLightLinear * distance + spotLightQuadratic * (distance * distance));
-
-        float intensity = clamp((theta - spotLightOuterCutoff) / (spotLightCutoff - spotLightOuterCutoff), 0.0, 1.0);
-        intensity = pow(intensity, spotLightExponent);
-
-        vec3 ambient = spotLightColor * materialAmbientColor;
-        vec3 diffuse = difference * spotLightColor;
-        vec3 specular = specularFactor * spotLightColor;
-
-        return (ambient + diffuse + specular) * intensity * attenuation;
-    }
-
-    return vec3(0.0); // Outside spotlight cone
-}
+#endif
+#ifdef USE_TEXTURE
+layout(location = 6) out vec2 texCoord; // Texture coordinate to pass to fragment shader
+#endif
 
 void main() {
     // Transform & output the vertex in clip space
@@ -112,13 +64,25 @@ void main() {
 
     // Compute view vector
     vec3 fragmentPos = vec3(vPos);
+
+#ifdef PER_PIXEL_LIGHTING
+    fragPosition = fragmentPos;
+    fragNormal = normal;
+#ifdef INSTANCED
+    fragAmbientColor = materialAmbientColor;
+    fragDiffuseColor = materialDiffuseColor;
+    fragSpecularColor = materialSpecularColor;
+    fragShininess = materialShininess;
+#endif
+#else
     vec3 viewVector = normalize(eyePosition - fragmentPos);
 
-    // Calculate all light sources
-    vec3 directionalLight = calculateDirectionalLight(normal, viewVector);
-    vec3 pointLight = calculatePointLight(normal, fragmentPos, viewVector);
-    vec3 spotlight = calculateSpotlight(normal, fragmentPos, viewVector);
+    // Calculate all enabled light sources
+    Material material = Material(materialAmbientColor, materialDiffuseColor, materialSpecularColor, materialShininess);
+    color = calculateLighting(material, normal, fragmentPos, viewVector);
+#endif
 
-    // Combine lighting
-    color = directionalLight + pointLight + spotlight;
+#ifdef USE_TEXTURE
+    texCoord = vTexCoord;
+#endif
 }
@@ -2,10 +2,11 @@
 out vec4 FragColor;
 
 in vec2 TexCoords;
+in vec4 Color;
 
 uniform sampler2D texture1;
 
 void main()
 {
-    FragColor = texture(texture1, TexCoords);
+    FragColor = texture(texture1, TexCoords) * Color;
 }
@@ -1,15 +1,21 @@
 #version 410 core
 layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec2 aTexCoords;
+layout (location = 2) in vec4 aColor;      // only read when useVertexColor is set
 
 out vec2 TexCoords;
+out vec4 Color;
 
 uniform mat4 projection;
 
 uniform mat4 model;
 
+// set by the performance overlay, whose texture is a glyph atlas tinted per vertex
+uniform bool useVertexColor;
+
 void main()
 {
     gl_Position = projection * model * vec4(aPos.xy, 0.0, 1.0);
     TexCoords = aTexCoords;
+    Color = useVertexColor ? aColor : vec4(1.0);
 }
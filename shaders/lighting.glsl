@@ -0,0 +1,133 @@
+// Lighting shared by A3.v.glsl and A3.f.glsl.  CSCI441::ShaderPermutations inserts
+// this file after the feature defines, so a light type costs nothing in variants
+// where its count is 0.  Each light type is a uniform array; setting a uniform by
+// its plain name sets the first light.
+
+#ifndef NUM_DIRECTIONAL_LIGHTS
+#define NUM_DIRECTIONAL_LIGHTS 1
+#endif
+#ifndef NUM_POINT_LIGHTS
+#define NUM_POINT_LIGHTS 1
+#endif
+#ifndef NUM_SPOT_LIGHTS
+#define NUM_SPOT_LIGHTS 1
+#endif
+
+struct Material {
+    vec3 ambientColor;
+    vec3 diffuseColor;
+    vec3 specularColor;
+    float shininess;
+};
+
+#if NUM_DIRECTIONAL_LIGHTS > 0
+// Directional Light properties
+uniform vec3 lightDirection[NUM_DIRECTIONAL_LIGHTS];
+uniform vec3 lightAmbientColor[NUM_DIRECTIONAL_LIGHTS];
+uniform vec3 lightDiffuseColor[NUM_DIRECTIONAL_LIGHTS];
+uniform vec3 lightSpecularColor[NUM_DIRECTIONAL_LIGHTS];
+
+vec3 calculateDirectionalLight(int i, Material material, vec3 normal, vec3 viewVector) {
+    // Compute light vector
+    vec3 lightVector = normalize(-lightDirection[i]);
+
+    // Ambient component
+    vec3 ambient = lightAmbientColor[i] * material.ambientColor;
+
+    // Diffuse component
+    float diffuseFactor = max(dot(normal, lightVector), 0.0);
+    vec3 diffuse = lightDiffuseColor[i] * material.diffuseColor * diffuseFactor;
+
+    // Specular component
+    vec3 reflectVector = reflect(-lightVector, normal);
+    float specularFactor = pow(max(dot(viewVector, reflectVector), 0.0), material.shininess);
+    vec3 specular = lightSpecularColor[i] * material.specularColor * specularFactor;
+
+    // Sum all components
+    return ambient + diffuse + specular;
+}
+#endif
+
+#if NUM_POINT_LIGHTS > 0
+// Point Light properties
+uniform vec3 pointLightPos[NUM_POINT_LIGHTS];
+uniform vec3 pointLightColor[NUM_POINT_LIGHTS];
+uniform float pointLightConstant[NUM_POINT_LIGHTS];
+uniform float pointLightLinear[NUM_POINT_LIGHTS];
+uniform float pointLightQuadratic[NUM_POINT_LIGHTS];
+
+vec3 calculatePointLight(int i, Material material, vec3 normal, vec3 fragPosition, vec3 viewVector) {
+    vec3 lightDirection = normalize(pointLightPos[i] - fragPosition);
+    float difference = max(dot(normal, lightDirection), 0.0);
+    vec3 reflectDirection = reflect(-lightDirection, normal);
+    float specularFactor = pow(max(dot(viewVector, reflectDirection), 0.0), material.shininess);
+
+    float distance = length(pointLightPos[i] - fragPosition);
+    float attenuation = 1.0 / (pointLightConstant[i] + pointLightLinear[i] * distance + pointLightQuadratic[i] * (distance * distance));
+
+    vec3 ambient = pointLightColor[i] * material.ambientColor;
+    vec3 diffuse = difference * pointLightColor[i];
+    vec3 specular = specularFactor * pointLightColor[i];
+
+    return (ambient + diffuse + specular) * attenuation;
+}
+#endif
+
+#if NUM_SPOT_LIGHTS > 0
+// Spotlight properties
+uniform vec3 spotLightPos[NUM_SPOT_LIGHTS];
+uniform vec3 spotLightDirection[NUM_SPOT_LIGHTS];
+uniform vec3 spotLightColor[NUM_SPOT_LIGHTS];
+uniform float spotLightCutoff[NUM_SPOT_LIGHTS];
+uniform float spotLightOuterCutoff[NUM_SPOT_LIGHTS];
+uniform float spotLightExponent[NUM_SPOT_LIGHTS];
+uniform float spotLightConstant[NUM_SPOT_LIGHTS];
+uniform float spotLightLinear[NUM_SPOT_LIGHTS];
+uniform float spotLightQuadratic[NUM_SPOT_LIGHTS];
+
+vec3 calculateSpotlight(int i, Material material, vec3 normal, vec3 fragPosition, vec3 viewVector) {
+    vec3 lightDirection = normalize(spotLightPos[i] - fragPosition);
+    float theta = dot(lightDirection, normalize(-spotLightDirection[i]));
+
+    if (theta > spotLightCutoff[i]) {
+        float difference = max(dot(normal, lightDirection), 0.0);
+        vec3 reflectDirection = reflect(-lightDirection, normal);
+        float specularFactor = pow(max(dot(viewVector, reflectDirection), 0.0), material.shininess);
+
+        float distance = length(spotLightPos[i] - fragPosition);
+        float attenuation = 1.0 / (spotLightConstant[i] + spotLightLinear[i] * distance + spotLightQuadratic[i] * (distance * distance));
+
+        float intensity = clamp((theta - spotLightOuterCutoff[i]) / (spotLightCutoff[i] - spotLightOuterCutoff[i]), 0.0, 1.0);
+        intensity = pow(intensity, spotLightExponent[i]);
+
+        vec3 ambient = spotLightColor[i] * material.ambientColor;
+        vec3 diffuse = difference * spotLightColor[i];
+        vec3 specular = specularFactor * spotLightColor[i];
+
+        return (ambient + diffuse + specular) * intensity * attenuation;
+    }
+
+    return vec3(0.0); // Outside spotlight cone
+}
+#endif
+
+// Sum of every enabled light at one point
+vec3 calculateLighting(Material material, vec3 normal, vec3 fragPosition, vec3 viewVector) {
+    vec3 color = vec3(0.0);
+#if NUM_DIRECTIONAL_LIGHTS > 0
+    for (int i = 0; i < NUM_DIRECTIONAL_LIGHTS; i++) {
+        color += calculateDirectionalLight(i, material, normal, viewVector);
+    }
+#endif
+#if NUM_POINT_LIGHTS > 0
+    for (int i = 0; i < NUM_POINT_LIGHTS; i++) {
+        color += calculatePointLight(i, material, normal, fragPosition, viewVector);
+    }
+#endif
+#if NUM_SPOT_LIGHTS > 0
+    for (int i = 0; i < NUM_SPOT_LIGHTS; i++) {
+        color += calculateSpotlight(i, material, normal, fragPosition, viewVector);
+    }
+#endif
+    return color;
+}